@@ -57,4 +57,367 @@ mkdir report/reordered_tiling
 # reordered_tiling_unrolling
 echo "> reordered_tiling_unrolling"
 mkdir report/reordered_tiling_unrolling
-./benchsuite/benchsuite-custom.sh
\ No newline at end of file
+./benchsuite/benchsuite-custom.sh
+
+# reordered_tiling (dataflow: output/B/A-stationary on rectangular shapes)
+echo "> reordered_tiling_dataflow"
+mkdir report/reordered_tiling_dataflow
+./benchsuite/benchsuite-shapes.sh \
+    report/reordered_tiling_dataflow/$PREFIX-reordered_tiling_dataflow.txt \
+    ./build/riscv64/reordered_tiling \
+    SHAPES="4096x64x16,4096x256x64,8x4096x512,4x4096x4096,1024x1024x1024" \
+    DATAFLOW="0,1,2,3" \
+    KERNEL="8" \
+    LMUL="1,2"
+
+
+# reordered_tiling (fused pack-and-compute on the first row block)
+echo "> reordered_tiling_fused"
+mkdir report/reordered_tiling_fused
+./benchsuite/benchsuite-params.sh \
+    report/reordered_tiling_fused/$PREFIX-reordered_tiling_fused.txt \
+    ./build/riscv64/reordered_tiling \
+    SIZE="256,512,1024,2048,4096" \
+    KERNEL="2,4,8,16" \
+    LMUL="-2,1,2,4,8" \
+    PACK=1
+
+# reordered_tiling (pre-packed B reused across calls, small M latency)
+echo "> reordered_tiling_prepack"
+mkdir report/reordered_tiling_prepack
+for prepack in 0 1; do
+    ./benchsuite/benchsuite-shapes.sh \
+        report/reordered_tiling_prepack/$PREFIX-reordered_tiling_prepack.txt \
+        ./build/riscv64/reordered_tiling \
+        SHAPES="1x4096x4096,4x4096x4096,8x4096x4096,16x4096x4096,32x4096x4096,64x4096x4096" \
+        DATAFLOW="1" \
+        KERNEL="0" \
+        LMUL="1,2,4" \
+        PREPACK=$prepack \
+        REPEAT=50
+done
+
+# reordered_tiling (plan/execute, columns of C split among threads)
+echo "> reordered_tiling_plan"
+mkdir report/reordered_tiling_plan
+for threads in 1 2 4 8; do
+    ./benchsuite/benchsuite-shapes.sh \
+        report/reordered_tiling_plan/$PREFIX-reordered_tiling_plan.txt \
+        ./build/riscv64/reordered_tiling \
+        SHAPES="1x4096x4096,16x4096x4096,64x4096x4096,1024x1024x1024,2048x2048x2048" \
+        DATAFLOW="0" \
+        KERNEL="0" \
+        LMUL="0" \
+        PLAN=1 \
+        THREADS=$threads \
+        REPEAT=10
+done
+
+# reordered_tiling (strided batch of small problems, parallel over the batch)
+echo "> reordered_tiling_batch"
+mkdir report/reordered_tiling_batch
+for threads in 1 2 4 8; do
+    ./benchsuite/benchsuite-shapes.sh \
+        report/reordered_tiling_batch/$PREFIX-reordered_tiling_batch.txt \
+        ./build/riscv64/reordered_tiling \
+        SHAPES="16x64x64,32x64x64,16x128x128,64x64x64" \
+        DATAFLOW="0" \
+        KERNEL="0" \
+        LMUL="0" \
+        BATCH=1000 \
+        THREADS=$threads \
+        REPEAT=5
+done
+
+# reordered_tiling (grouped GEMM, MoE-like experts with growing M, global tile list)
+echo "> reordered_tiling_group"
+mkdir report/reordered_tiling_group
+for threads in 1 2 4 8; do
+    ./benchsuite/benchsuite-shapes.sh \
+        report/reordered_tiling_group/$PREFIX-reordered_tiling_group.txt \
+        ./build/riscv64/reordered_tiling \
+        SHAPES="256x1024x1024,512x2048x512" \
+        DATAFLOW="0" \
+        KERNEL="0" \
+        LMUL="0" \
+        GROUP=8 \
+        THREADS=$threads
+done
+
+# reordered_tiling (small square shapes: unrolled kernels with KERNEL=0, output-stationary tiles with KERNEL=4)
+echo "> reordered_tiling_small"
+mkdir report/reordered_tiling_small
+for kernel in 0 4; do
+    ./benchsuite/benchsuite-shapes.sh \
+        report/reordered_tiling_small/$PREFIX-reordered_tiling_small.txt \
+        ./build/riscv64/reordered_tiling \
+        SHAPES="4x4x4,8x8x8,16x16x16,32x32x32,48x48x48,64x64x64" \
+        DATAFLOW="0" \
+        KERNEL=$kernel \
+        REPEAT=100000
+done
+
+# reordered_tiling (decoder / skinny shapes: GEMV and streaming kernels with KERNEL=0, tiles with KERNEL=2)
+echo "> reordered_tiling_skinny"
+mkdir report/reordered_tiling_skinny
+for kernel in 0 2; do
+    ./benchsuite/benchsuite-shapes.sh \
+        report/reordered_tiling_skinny/$PREFIX-reordered_tiling_skinny.txt \
+        ./build/riscv64/reordered_tiling \
+        SHAPES="1x4096x4096,2x4096x4096,4x4096x4096,8x4096x4096,4096x1x4096,4096x4x4096,4096x8x4096" \
+        DATAFLOW="0" \
+        KERNEL=$kernel \
+        REPEAT=10
+done
+
+# reordered_tiling (indexed rows: gather of A / scatter of C inside the kernel)
+echo "> reordered_tiling_indexed"
+mkdir report/reordered_tiling_indexed
+for indexed in 0 1; do
+    ./benchsuite/benchsuite-shapes.sh \
+        report/reordered_tiling_indexed/$PREFIX-reordered_tiling_indexed.txt \
+        ./build/riscv64/reordered_tiling \
+        SHAPES="64x1024x1024,256x1024x1024,1024x1024x1024" \
+        DATAFLOW="1" \
+        KERNEL="8" \
+        LMUL="2" \
+        INDEXED=$indexed
+done
+
+# reordered_tiling_zvfh (fp16 inputs with fp32 accumulation: DTYPE=1 fp32 C, DTYPE=2 fp16 C, against fp32)
+echo "> reordered_tiling_f16"
+mkdir report/reordered_tiling_f16
+for dtype in 0 1 2; do
+    ./benchsuite/benchsuite-shapes.sh \
+        report/reordered_tiling_f16/$PREFIX-reordered_tiling_f16.txt \
+        ./build/riscv64/reordered_tiling_zvfh \
+        SHAPES="512x512x512,1024x1024x1024,4096x4096x4096" \
+        DATAFLOW="1" \
+        KERNEL="8" \
+        LMUL="2" \
+        PLAN=1 \
+        DTYPE=$dtype
+done
+
+# reordered_tiling_zvfbfwma (bf16 inputs with fp32 accumulation: DTYPE=3, against fp32)
+echo "> reordered_tiling_bf16"
+mkdir report/reordered_tiling_bf16
+for dtype in 0 3; do
+    ./benchsuite/benchsuite-shapes.sh \
+        report/reordered_tiling_bf16/$PREFIX-reordered_tiling_bf16.txt \
+        ./build/riscv64/reordered_tiling_zvfbfwma \
+        SHAPES="512x512x512,1024x1024x1024,4096x4096x4096" \
+        DATAFLOW="1" \
+        KERNEL="8" \
+        LMUL="2" \
+        PLAN=1 \
+        DTYPE=$dtype
+done
+
+# reordered_tiling (u8 x s8 inputs with int32 accumulation, fp32 output: DTYPE=16, against fp32)
+echo "> reordered_tiling_i8"
+mkdir report/reordered_tiling_i8
+for dtype in 0 16; do
+    ./benchsuite/benchsuite-shapes.sh \
+        report/reordered_tiling_i8/$PREFIX-reordered_tiling_i8.txt \
+        ./build/riscv64/reordered_tiling \
+        SHAPES="512x512x512,1024x1024x1024,4096x4096x4096" \
+        DATAFLOW="1" \
+        KERNEL="8" \
+        LMUL="2" \
+        DTYPE=$dtype
+done
+
+# reordered_tiling (int4 weights, group-wise scales, dequantised while packing: DTYPE=17, against fp32)
+echo "> reordered_tiling_q4"
+mkdir report/reordered_tiling_q4
+for dtype in 0 17; do
+    ./benchsuite/benchsuite-shapes.sh \
+        report/reordered_tiling_q4/$PREFIX-reordered_tiling_q4.txt \
+        ./build/riscv64/reordered_tiling \
+        SHAPES="1x4096x4096,4x4096x4096,8x4096x4096,512x4096x4096" \
+        DATAFLOW="1" \
+        KERNEL="8" \
+        LMUL="2" \
+        DTYPE=$dtype \
+        REPEAT=10
+done
+
+# reordered_tiling (double precision: DTYPE=4, fp64 tuning table and explicit tiles, against fp32)
+echo "> reordered_tiling_f64"
+mkdir report/reordered_tiling_f64
+./benchsuite/benchsuite-shapes.sh \
+    report/reordered_tiling_f64/$PREFIX-reordered_tiling_f64.txt \
+    ./build/riscv64/reordered_tiling \
+    SHAPES="512x512x512,1024x1024x1024,4096x4096x4096" \
+    DATAFLOW="1" \
+    KERNEL="8" \
+    LMUL="2" \
+    PLAN=1
+for tile in "0 0" "8 2" "4 4" "2 8" "16 1"; do
+    set -- $tile
+    ./benchsuite/benchsuite-shapes.sh \
+        report/reordered_tiling_f64/$PREFIX-reordered_tiling_f64.txt \
+        ./build/riscv64/reordered_tiling \
+        SHAPES="512x512x512,1024x1024x1024,4096x4096x4096" \
+        DATAFLOW="1" \
+        KERNEL=$1 \
+        LMUL=$2 \
+        PLAN=1 \
+        DTYPE=4
+done
+
+# reordered_tiling (complex float: DTYPE=18, one pass with segment loads, 4x the flops of fp32)
+echo "> reordered_tiling_c32"
+mkdir report/reordered_tiling_c32
+for dtype in 0 18; do
+    ./benchsuite/benchsuite-shapes.sh \
+        report/reordered_tiling_c32/$PREFIX-reordered_tiling_c32.txt \
+        ./build/riscv64/reordered_tiling \
+        SHAPES="512x512x512,1024x1024x1024,4096x4096x4096" \
+        DATAFLOW="1" \
+        KERNEL="8" \
+        LMUL="2" \
+        DTYPE=$dtype
+done
+
+# reordered_tiling (Q15 fixed point: DTYPE=19, int16 panels and vwmacc, against fp32)
+echo "> reordered_tiling_q15"
+mkdir report/reordered_tiling_q15
+for dtype in 0 19; do
+    ./benchsuite/benchsuite-shapes.sh \
+        report/reordered_tiling_q15/$PREFIX-reordered_tiling_q15.txt \
+        ./build/riscv64/reordered_tiling \
+        SHAPES="512x512x512,1024x1024x1024,4096x4096x4096" \
+        DATAFLOW="1" \
+        KERNEL="8" \
+        LMUL="2" \
+        DTYPE=$dtype
+done
+
+# reordered_tiling (binary XNOR-popcount: DTYPE=20, SWAR popcount / Zvbb vcpop.v, against fp32)
+echo "> reordered_tiling_bin"
+mkdir report/reordered_tiling_bin
+for exe in reordered_tiling reordered_tiling_zvbb; do
+    for dtype in 0 20; do
+        ./benchsuite/benchsuite-shapes.sh \
+            report/reordered_tiling_bin/$PREFIX-reordered_tiling_bin.txt \
+            ./build/riscv64/$exe \
+            SHAPES="512x512x512,1024x1024x1024,4096x4096x4096" \
+            DATAFLOW="1" \
+            KERNEL="8" \
+            LMUL="2" \
+            DTYPE=$dtype
+    done
+done
+
+# reordered_tiling (semiring: min-plus / max-plus against plus-times, same 8 x m2 tile, plan)
+echo "> reordered_tiling_semiring"
+mkdir report/reordered_tiling_semiring
+for threads in 1 4; do
+    for semiring in 0 1 2; do
+        ./benchsuite/benchsuite-shapes.sh \
+            report/reordered_tiling_semiring/$PREFIX-reordered_tiling_semiring.txt \
+            ./build/riscv64/reordered_tiling \
+            SHAPES="512x512x512,1024x1024x1024,2048x2048x2048" \
+            DATAFLOW="1" \
+            KERNEL="8" \
+            LMUL="2" \
+            PLAN=1 \
+            THREADS=$threads \
+            SEMIRING=$semiring
+    done
+done
+
+# reordered_tiling (epilogue bias + GELU + residual: fused in the plan vs separate pass after multiply_gemm)
+echo "> reordered_tiling_epilogue"
+mkdir report/reordered_tiling_epilogue
+for plan in 0 1; do
+    for act in 0 1 2 3; do
+        ./benchsuite/benchsuite-shapes.sh \
+            report/reordered_tiling_epilogue/$PREFIX-reordered_tiling_epilogue.txt \
+            ./build/riscv64/reordered_tiling \
+            SHAPES="64x4096x4096,1024x1024x1024,4096x4096x4096" \
+            DATAFLOW="1" \
+            KERNEL="8" \
+            LMUL="2" \
+            PLAN=$plan \
+            EPILOGUE=17 \
+            ACT=$act
+    done
+done
+
+# reordered_tiling (MLP act(X W1) W2: fused gemm_mlp vs two GEMMs and an activation pass)
+echo "> reordered_tiling_mlp"
+mkdir report/reordered_tiling_mlp
+for plan in 0 1; do
+    for threads in 1 4; do
+        ./benchsuite/benchsuite-shapes.sh \
+            report/reordered_tiling_mlp/$PREFIX-reordered_tiling_mlp.txt \
+            ./build/riscv64/reordered_tiling \
+            SHAPES="64x1024x1024,512x1024x1024,2048x1024x1024" \
+            DATAFLOW="1" \
+            KERNEL="8" \
+            LMUL="2" \
+            PLAN=$plan \
+            THREADS=$threads \
+            MLP=4096 \
+            ACT=2
+    done
+done
+
+# reordered_tiling (attention, 8 heads, d=64: fused online softmax vs scores materialised by two GEMMs)
+echo "> reordered_tiling_attention"
+mkdir report/reordered_tiling_attention
+for plan in 0 1; do
+    for causal in 0 1; do
+        ./benchsuite/benchsuite-shapes.sh \
+            report/reordered_tiling_attention/$PREFIX-reordered_tiling_attention.txt \
+            ./build/riscv64/reordered_tiling \
+            SHAPES="512x512x64,1024x1024x64,2048x2048x64" \
+            DATAFLOW="1" \
+            KERNEL="8" \
+            LMUL="2" \
+            PLAN=$plan \
+            THREADS=4 \
+            ATTENTION=8 \
+            CAUSAL=$causal
+    done
+done
+
+# reordered_tiling (k nearest neighbours, k=10: fused distance + top-k heaps vs GEMM, distance matrix and top-k pass)
+echo "> reordered_tiling_knn"
+mkdir report/reordered_tiling_knn
+for plan in 0 1; do
+    for threads in 1 4; do
+        ./benchsuite/benchsuite-shapes.sh \
+            report/reordered_tiling_knn/$PREFIX-reordered_tiling_knn.txt \
+            ./build/riscv64/reordered_tiling \
+            SHAPES="1024x16384x128,4096x16384x128,1024x65536x64" \
+            DATAFLOW="1" \
+            KERNEL="8" \
+            LMUL="2" \
+            PLAN=$plan \
+            THREADS=$threads \
+            KNN=10
+    done
+done
+
+# reordered_tiling (convolution, 3x3 and 1x1 layers: implicit GEMM / direct 1x1 vs im2col + GEMM)
+# SHAPES: image size x output channels x input channels
+echo "> reordered_tiling_conv"
+mkdir report/reordered_tiling_conv
+for plan in 0 1; do
+    for conv in 1 2; do
+        for filter in 1 3; do
+            ./benchsuite/benchsuite-shapes.sh \
+                report/reordered_tiling_conv/$PREFIX-reordered_tiling_conv.txt \
+                ./build/riscv64/reordered_tiling \
+                SHAPES="56x64x64,28x128x128,14x256x256" \
+                PLAN=$plan \
+                THREADS=4 \
+                CONV=$conv \
+                FILTER=$filter
+        done
+    done
+done
@@ -2,7 +2,7 @@
 
 # Controllo argomenti minimi (almeno file ed exe)
 if [ $# -lt 2 ]; then
-    echo "Usage: $0 <out-filename_path> <executable_path> [SIZE=...] [KERNEL=...] [LMUL=...]"
+    echo "Usage: $0 <out-filename_path> <executable_path> [SIZE=...] [KERNEL=...] [LMUL=...] [OTHER=value ...]"
     echo "Example: $0 report/out.txt ./build/exe SIZE=\"256,512\" KERNEL=\"4,8\" LMUL=\"1,2\""
     exit 1
 fi
@@ -33,20 +33,24 @@ for arg in "${@:3}"; do
         LMUL=*)
             IFS=',' read -r -a lmuls <<< "${arg#LMUL=}"
             ;;
+        *)
+            # parametri fissi passati invariati all'eseguibile (es. PACK=1)
+            extra+=("$arg")
+            ;;
     esac
 done
 
-echo "benchsuite-params.sh (executable: $EXE) (params: SIZE='${sizes[@]}' KERNEL='${kernels[@]}' LMUL='${lmuls[@]}' )"
+echo "benchsuite-params.sh (executable: $EXE) (params: SIZE='${sizes[@]}' KERNEL='${kernels[@]}' LMUL='${lmuls[@]}' ${extra[@]} )"
 
-echo "benchsuite-params.sh (executable: $EXE) (params: SIZE='${sizes[@]}' KERNEL='${kernels[@]}' LMUL='${lmuls[@]}' )" >> "$FILE"
+echo "benchsuite-params.sh (executable: $EXE) (params: SIZE='${sizes[@]}' KERNEL='${kernels[@]}' LMUL='${lmuls[@]}' ${extra[@]} )" >> "$FILE"
 
 
 
 for size in "${sizes[@]}"; do
     for kernel in "${kernels[@]}"; do
         for lmul in "${lmuls[@]}"; do
-            echo "$EXE) SIZE=$size KERNEL=$kernel LMUL=$lmul"
-            perf stat -e L1-dcache-loads,L1-dcache-load-misses "$EXE" SIZE="$size" KERNEL="$kernel" LMUL="$lmul" &>> "$FILE"
+            echo "$EXE) SIZE=$size KERNEL=$kernel LMUL=$lmul ${extra[@]}"
+            perf stat -e L1-dcache-loads,L1-dcache-load-misses "$EXE" SIZE="$size" KERNEL="$kernel" LMUL="$lmul" "${extra[@]}" &>> "$FILE"
         done
     done
 done
@@ -0,0 +1,65 @@
+#!/bin/bash
+
+# Controllo argomenti minimi (almeno file ed exe)
+if [ $# -lt 2 ]; then
+    echo "Usage: $0 <out-filename_path> <executable_path> [SHAPES=MxNxK,...] [DATAFLOW=...] [KERNEL=...] [LMUL=...]"
+    echo "Example: $0 report/out.txt ./build/exe SHAPES=\"4096x64x64,8x4096x4096\" DATAFLOW=\"1,2,3\" KERNEL=\"8\" LMUL=\"1\""
+    exit 1
+fi
+
+FILE="$1"
+EXE="$2"
+
+# Verifica che l'eseguibile esista
+if [ ! -x "$EXE" ]; then
+    echo "Error: executable '$EXE' not found or not executable"
+    exit 1
+fi
+
+# Crea la directory report se non esiste
+mkdir -p report
+
+# default: solo selezione automatica
+dataflows=(0)
+kernels=(0)
+lmuls=(1)
+extra=()
+
+# --- PARSING ARGOMENTI NOMINATI ---
+for arg in "${@:3}"; do
+    case $arg in
+        SHAPES=*)
+            IFS=',' read -r -a shapes <<< "${arg#SHAPES=}"
+            ;;
+        DATAFLOW=*)
+            IFS=',' read -r -a dataflows <<< "${arg#DATAFLOW=}"
+            ;;
+        KERNEL=*)
+            IFS=',' read -r -a kernels <<< "${arg#KERNEL=}"
+            ;;
+        LMUL=*)
+            IFS=',' read -r -a lmuls <<< "${arg#LMUL=}"
+            ;;
+        *)
+            # altri parametri passati invariati all'eseguibile (es. PREPACK=1)
+            extra+=("$arg")
+            ;;
+    esac
+done
+
+echo "benchsuite-shapes.sh (executable: $EXE) (params: SHAPES='${shapes[@]}' DATAFLOW='${dataflows[@]}' KERNEL='${kernels[@]}' LMUL='${lmuls[@]}' EXTRA='${extra[@]}' )"
+
+echo "benchsuite-shapes.sh (executable: $EXE) (params: SHAPES='${shapes[@]}' DATAFLOW='${dataflows[@]}' KERNEL='${kernels[@]}' LMUL='${lmuls[@]}' EXTRA='${extra[@]}' )" >> "$FILE"
+
+
+for shape in "${shapes[@]}"; do
+    IFS='x' read -r m n k <<< "$shape"
+    for dataflow in "${dataflows[@]}"; do
+        for kernel in "${kernels[@]}"; do
+            for lmul in "${lmuls[@]}"; do
+                echo "$EXE) M=$m N=$n K=$k DATAFLOW=$dataflow KERNEL=$kernel LMUL=$lmul ${extra[@]}"
+                perf stat -e L1-dcache-loads,L1-dcache-load-misses "$EXE" M="$m" N="$n" K="$k" DATAFLOW="$dataflow" KERNEL="$kernel" LMUL="$lmul" "${extra[@]}" &>> "$FILE"
+            done
+        done
+    done
+done
@@ -0,0 +1,4336 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <riscv_vector.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#include "utils.h"
+#include "reordered_gemm.h"
+#include "small_gemm.h"
+#include "reordered_gemm_kernel.h"
+
+// compile-time debug level of the kernels and of the packing (-DDEBUG_ENABLED=3 prints every panel),
+// plan and execute print with the debug level of the context
+#ifndef DEBUG_ENABLED
+#define DEBUG_ENABLED 0
+#endif
+
+// alignment of the pre-packed panels (one cache line)
+#define PACKED_B_ALIGN 64
+
+struct packed_b {
+    int layout;                 // PACKED_B_PANELS
+    int k, n;                   // shape of the original B (K x N, row-major)
+    int lmul;                   // LMUL of the kernels the panels are sized for
+    int tw;                     // panel width: vsetvl_e32m{lmul}(N)
+    int panels;                 // ceil(N / tw)
+    size_t panel_stride;        // floats between two panels: k * tw
+    float* data;
+    void* map;                  // file mapping holding data (packed_b_load), NULL if owned
+    size_t map_bytes;
+};
+
+// half precision kernel (reordered_gemm_f16.c)
+void kernel_f16_8_m2(const _Float16* A, const _Float16* B, void* C, int M, int N, int K,
+                     int lda, int ldb, int ldc, int out_f16, float* ws);
+// bfloat16 kernel (reordered_gemm_bf16.c)
+void kernel_bf16_8_m2(const __bf16* A, const __bf16* B, float* C, int M, int N, int K,
+                      int lda, int ldb, int ldc, float* ws);
+// double precision kernels (reordered_gemm_f64.c)
+int f64_max_rows(int lmul);
+int f64_panel_width(int N, int lmul);
+void kernel_f64(const double* A, const double* B, double* C, int M, int N, int K,
+                int lda, int ldb, int ldc, int th, int lmul, double* ws);
+// semiring kernels (reordered_gemm_semiring.c)
+void kernel_minplus_8_m2(float* mat1, float* mat2, float* res, int M, int N, int K, int lda, int ldb, int ldc, float* ws, int pack_mode);
+void kernel_maxplus_8_m2(float* mat1, float* mat2, float* res, int M, int N, int K, int lda, int ldb, int ldc, float* ws, int pack_mode);
+// fused epilogue kernel (reordered_gemm_epilogue.c)
+void kernel_ep_8_m2(float* mat1, float* mat2, float* res, int M, int N, int K, int lda, int ldb, int ldc,
+                    float* ws, int pack_mode, const gemm_epilogue_t* ep);
+
+int get_vlen(){
+    size_t VLMAX8 = __riscv_vsetvlmax_e8m1();
+    int VLEN = VLMAX8 * 8;
+    return VLEN;
+}
+
+void kernel_2_m1(float* mat1, float* mat2, float* res, int M, int N, int K, int lda, int ldb, int ldc, float* ws, int pack_mode) {
+
+    float (*A)[lda] = (float (*)[lda]) mat1;
+    float (*B)[ldb] = (float (*)[ldb]) mat2;
+    float (*C)[ldc] = (float (*)[ldc]) res;
+
+    const int Th = 2;
+    int Tw = __riscv_vsetvl_e32m1(N);
+
+    //printf("Tw:%d\n", Tw);
+    
+    // ordered B: K x Tw, in the caller workspace ws if given (pre-packed mode: the panels are already in mat2)
+    float* oB = (ws || pack_mode == PACK_PREPACKED) ? ws : malloc(sizeof(float) * K * Tw);
+
+    size_t vl;
+
+    for (int jh = 0; jh < N; jh += Tw) {
+        for (int ih = 0; ih + Th <= M; ih += Th) {
+        
+            if (ih == 0 && jh % Tw == 0 && pack_mode == PACK_SEPARATE) {
+                reordering_rvv(&B[0][jh], oB, K, ldb, Tw, N - jh);
+
+                if( DEBUG_ENABLED >= 3 ){
+                    printf("ih==0 ==> orderedB");
+                    print_lmatrixf32(oB, Tw, K * Tw);
+                }
+            }
+
+            // fused mode: the first row block reads B directly and fills oB
+            // pre-packed mode: panel jh / Tw is read in place from mat2, ldb is the panel width
+            const int fused = (ih == 0 && pack_mode == PACK_FUSED);
+            const float* pB = fused ? &B[0][jh] : oB;
+            int ldp = fused ? ldb : Tw;
+            if (pack_mode == PACK_PREPACKED) {
+                pB = mat2 + (size_t)(jh / Tw) * K * ldb;
+                ldp = ldb;
+            }
+
+            // Tw deciso a runtime
+            vl = __riscv_vsetvl_e32m1(N - jh);
+
+            // accumulatori: uno per ogni riga del tile
+            vfloat32m1_t vc0 = __riscv_vfmv_v_f_f32m1(0.0f, vl);
+            vfloat32m1_t vc1 = __riscv_vfmv_v_f_f32m1(0.0f, vl);
+
+            #if UNROLL == 2
+            #pragma GCC unroll 2
+            #elif UNROLL == 4
+            #pragma GCC unroll 4
+            #elif UNROLL == 8
+            #pragma GCC unroll 8
+            #elif UNROLL == 16
+            #pragma GCC unroll 16
+            #else
+            #pragma GCC unroll 1
+            #endif
+            for (int k = 0; k < K; ++k) {
+
+                // carica B[k][jh : jh+vl]
+                vfloat32m1_t vb =
+                    __riscv_vle32_v_f32m1(&pB[k * ldp], vl);
+
+                // fused mode: pack the row just loaded
+                if (fused)
+                    __riscv_vse32_v_f32m1(&oB[k * Tw], vb, vl);
+
+                // outer product
+                vc0 = __riscv_vfmacc_vf_f32m1(
+                    vc0, A[ih + 0][k], vb, vl);
+
+                vc1 = __riscv_vfmacc_vf_f32m1(
+                    vc1, A[ih + 1][k], vb, vl);
+            }
+
+            // store
+            __riscv_vse32_v_f32m1(&C[ih + 0][jh], vc0, vl);
+            __riscv_vse32_v_f32m1(&C[ih + 1][jh], vc1, vl);
+
+            if( DEBUG_ENABLED >= 3 ){
+                ///printf("Computation block C(%d:%d) finished! \n", ih, jh);
+                printf("> C  iter!!\n");
+                print_lmatrixf32((float*) C, ldc, M * ldc);
+            }
+
+        }
+    }
+
+    if (oB != ws) free(oB);
+}
+
+void kernel_2_m2(float* mat1, float* mat2, float* res, int M, int N, int K, int lda, int ldb, int ldc, float* ws, int pack_mode) {
+
+    float (*A)[lda] = (float (*)[lda]) mat1;
+    float (*B)[ldb] = (float (*)[ldb]) mat2;
+    float (*C)[ldc] = (float (*)[ldc]) res;
+
+    const int Th = 2;
+    int Tw = __riscv_vsetvl_e32m2(N);
+
+    //printf("Tw:%d\n", Tw);
+    
+    // ordered B: K x Tw, in the caller workspace ws if given (pre-packed mode: the panels are already in mat2)
+    float* oB = (ws || pack_mode == PACK_PREPACKED) ? ws : malloc(sizeof(float) * K * Tw);
+
+    size_t vl;
+
+    for (int jh = 0; jh < N; jh += Tw) {
+        for (int ih = 0; ih + Th <= M; ih += Th) {
+        
+            if (ih == 0 && jh % Tw == 0 && pack_mode == PACK_SEPARATE) {
+                reordering_rvv(&B[0][jh], oB, K, ldb, Tw, N - jh);
+
+                if( DEBUG_ENABLED >= 3 ){
+                    printf("ih==0 ==> orderedB");
+                    print_lmatrixf32(oB, Tw, K * Tw);
+                }
+            }
+
+            // fused mode: the first row block reads B directly and fills oB
+            // pre-packed mode: panel jh / Tw is read in place from mat2, ldb is the panel width
+            const int fused = (ih == 0 && pack_mode == PACK_FUSED);
+            const float* pB = fused ? &B[0][jh] : oB;
+            int ldp = fused ? ldb : Tw;
+            if (pack_mode == PACK_PREPACKED) {
+                pB = mat2 + (size_t)(jh / Tw) * K * ldb;
+                ldp = ldb;
+            }
+
+            // Tw deciso a runtime
+            vl = __riscv_vsetvl_e32m2(N - jh);
+
+            // accumulatori: uno per ogni riga del tile
+            vfloat32m2_t vc0 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
+            vfloat32m2_t vc1 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
+
+            #if UNROLL == 2
+            #pragma GCC unroll 2
+            #elif UNROLL == 4
+            #pragma GCC unroll 4
+            #elif UNROLL == 8
+            #pragma GCC unroll 8
+            #elif UNROLL == 16
+            #pragma GCC unroll 16
+            #else
+            #pragma GCC unroll 1
+            #endif
+            for (int k = 0; k < K; ++k) {
+
+                // carica B[k][jh : jh+vl]
+                vfloat32m2_t vb =
+                    __riscv_vle32_v_f32m2(&pB[k * ldp], vl);
+
+                // fused mode: pack the row just loaded
+                if (fused)
+                    __riscv_vse32_v_f32m2(&oB[k * Tw], vb, vl);
+
+                // outer product
+                vc0 = __riscv_vfmacc_vf_f32m2(
+                    vc0, A[ih + 0][k], vb, vl);
+
+                vc1 = __riscv_vfmacc_vf_f32m2(
+                    vc1, A[ih + 1][k], vb, vl);
+            }
+
+            // store
+            __riscv_vse32_v_f32m2(&C[ih + 0][jh], vc0, vl);
+            __riscv_vse32_v_f32m2(&C[ih + 1][jh], vc1, vl);
+
+            if( DEBUG_ENABLED >= 3 ){
+                ///printf("Computation block C(%d:%d) finished! \n", ih, jh);
+                printf("> C  iter!!\n");
+                print_lmatrixf32((float*) C, ldc, M * ldc);
+            }
+
+        }
+    }
+
+    if (oB != ws) free(oB);
+}
+
+void kernel_2_m4(float* mat1, float* mat2, float* res, int M, int N, int K, int lda, int ldb, int ldc, float* ws, int pack_mode) {
+
+    float (*A)[lda] = (float (*)[lda]) mat1;
+    float (*B)[ldb] = (float (*)[ldb]) mat2;
+    float (*C)[ldc] = (float (*)[ldc]) res;
+
+    const int Th = 2;
+    int Tw = __riscv_vsetvl_e32m4(N);
+
+    //printf("Tw:%d\n", Tw);
+    
+    // ordered B: K x Tw, in the caller workspace ws if given (pre-packed mode: the panels are already in mat2)
+    float* oB = (ws || pack_mode == PACK_PREPACKED) ? ws : malloc(sizeof(float) * K * Tw);
+
+    size_t vl;
+
+    for (int jh = 0; jh < N; jh += Tw) {
+        for (int ih = 0; ih + Th <= M; ih += Th) {
+        
+            if (ih == 0 && jh % Tw == 0 && pack_mode == PACK_SEPARATE) {
+                reordering_rvv(&B[0][jh], oB, K, ldb, Tw, N - jh);
+
+                if( DEBUG_ENABLED >= 3 ){
+                    printf("ih==0 ==> orderedB");
+                    print_lmatrixf32(oB, Tw, K * Tw);
+                }
+            }
+
+            // fused mode: the first row block reads B directly and fills oB
+            // pre-packed mode: panel jh / Tw is read in place from mat2, ldb is the panel width
+            const int fused = (ih == 0 && pack_mode == PACK_FUSED);
+            const float* pB = fused ? &B[0][jh] : oB;
+            int ldp = fused ? ldb : Tw;
+            if (pack_mode == PACK_PREPACKED) {
+                pB = mat2 + (size_t)(jh / Tw) * K * ldb;
+                ldp = ldb;
+            }
+
+            // Tw deciso a runtime
+            vl = __riscv_vsetvl_e32m4(N - jh);
+
+            // accumulatori: uno per ogni riga del tile
+            vfloat32m4_t vc0 = __riscv_vfmv_v_f_f32m4(0.0f, vl);
+            vfloat32m4_t vc1 = __riscv_vfmv_v_f_f32m4(0.0f, vl);
+
+            #if UNROLL == 2
+            #pragma GCC unroll 2
+            #elif UNROLL == 4
+            #pragma GCC unroll 4
+            #elif UNROLL == 8
+            #pragma GCC unroll 8
+            #elif UNROLL == 16
+            #pragma GCC unroll 16
+            #else
+            #pragma GCC unroll 1
+            #endif
+            for (int k = 0; k < K; ++k) {
+
+                // carica B[k][jh : jh+vl]
+                vfloat32m4_t vb =
+                    __riscv_vle32_v_f32m4(&pB[k * ldp], vl);
+
+                // fused mode: pack the row just loaded
+                if (fused)
+                    __riscv_vse32_v_f32m4(&oB[k * Tw], vb, vl);
+
+                // outer product
+                vc0 = __riscv_vfmacc_vf_f32m4(
+                    vc0, A[ih + 0][k], vb, vl);
+
+                vc1 = __riscv_vfmacc_vf_f32m4(
+                    vc1, A[ih + 1][k], vb, vl);
+            }
+
+            // store
+            __riscv_vse32_v_f32m4(&C[ih + 0][jh], vc0, vl);
+            __riscv_vse32_v_f32m4(&C[ih + 1][jh], vc1, vl);
+
+            if( DEBUG_ENABLED >= 3 ){
+                ///printf("Computation block C(%d:%d) finished! \n", ih, jh);
+                printf("> C  iter!!\n");
+                print_lmatrixf32((float*) C, ldc, M * ldc);
+            }
+
+        }
+    }
+
+    if (oB != ws) free(oB);
+}
+
+void kernel_2_m8(float* mat1, float* mat2, float* res, int M, int N, int K, int lda, int ldb, int ldc, float* ws, int pack_mode) {
+
+    float (*A)[lda] = (float (*)[lda]) mat1;
+    float (*B)[ldb] = (float (*)[ldb]) mat2;
+    float (*C)[ldc] = (float (*)[ldc]) res;
+
+    const int Th = 2;
+    int Tw = __riscv_vsetvl_e32m8(N);
+
+    //printf("Tw:%d\n", Tw);
+    
+    // ordered B: K x Tw, in the caller workspace ws if given (pre-packed mode: the panels are already in mat2)
+    float* oB = (ws || pack_mode == PACK_PREPACKED) ? ws : malloc(sizeof(float) * K * Tw);
+
+    size_t vl;
+
+    for (int jh = 0; jh < N; jh += Tw) {
+        for (int ih = 0; ih + Th <= M; ih += Th) {
+        
+            if (ih == 0 && jh % Tw == 0 && pack_mode == PACK_SEPARATE) {
+                reordering_rvv(&B[0][jh], oB, K, ldb, Tw, N - jh);
+
+                if( DEBUG_ENABLED >= 3 ){
+                    printf("ih==0 ==> orderedB");
+                    print_lmatrixf32(oB, Tw, K * Tw);
+                }
+            }
+
+            // fused mode: the first row block reads B directly and fills oB
+            // pre-packed mode: panel jh / Tw is read in place from mat2, ldb is the panel width
+            const int fused = (ih == 0 && pack_mode == PACK_FUSED);
+            const float* pB = fused ? &B[0][jh] : oB;
+            int ldp = fused ? ldb : Tw;
+            if (pack_mode == PACK_PREPACKED) {
+                pB = mat2 + (size_t)(jh / Tw) * K * ldb;
+                ldp = ldb;
+            }
+
+            // Tw deciso a runtime
+            vl = __riscv_vsetvl_e32m8(N - jh);
+
+            // accumulatori: uno per ogni riga del tile
+            vfloat32m8_t vc0 = __riscv_vfmv_v_f_f32m8(0.0f, vl);
+            vfloat32m8_t vc1 = __riscv_vfmv_v_f_f32m8(0.0f, vl);
+
+            #if UNROLL == 2
+            #pragma GCC unroll 2
+            #elif UNROLL == 4
+            #pragma GCC unroll 4
+            #elif UNROLL == 8
+            #pragma GCC unroll 8
+            #elif UNROLL == 16
+            #pragma GCC unroll 16
+            #else
+            #pragma GCC unroll 1
+            #endif
+            for (int k = 0; k < K; ++k) {
+
+                // carica B[k][jh : jh+vl]
+                vfloat32m8_t vb =
+                    __riscv_vle32_v_f32m8(&pB[k * ldp], vl);
+
+                // fused mode: pack the row just loaded
+                if (fused)
+                    __riscv_vse32_v_f32m8(&oB[k * Tw], vb, vl);
+
+                // outer product
+                vc0 = __riscv_vfmacc_vf_f32m8(
+                    vc0, A[ih + 0][k], vb, vl);
+
+                vc1 = __riscv_vfmacc_vf_f32m8(
+                    vc1, A[ih + 1][k], vb, vl);
+            }
+
+            // store
+            __riscv_vse32_v_f32m8(&C[ih + 0][jh], vc0, vl);
+            __riscv_vse32_v_f32m8(&C[ih + 1][jh], vc1, vl);
+
+            if( DEBUG_ENABLED >= 3 ){
+                ///printf("Computation block C(%d:%d) finished! \n", ih, jh);
+                printf("> C  iter!!\n");
+                print_lmatrixf32((float*) C, ldc, M * ldc);
+            }
+
+        }
+    }
+
+    if (oB != ws) free(oB);
+}
+
+void kernel_2_mf2(float* mat1, float* mat2, float* res, int M, int N, int K, int lda, int ldb, int ldc, float* ws, int pack_mode) {
+
+    float (*A)[lda] = (float (*)[lda]) mat1;
+    float (*B)[ldb] = (float (*)[ldb]) mat2;
+    float (*C)[ldc] = (float (*)[ldc]) res;
+
+    const int Th = 2;
+    int Tw = __riscv_vsetvl_e32mf2(N);
+
+    //printf("Tw:%d\n", Tw);
+    
+    // ordered B: K x Tw, in the caller workspace ws if given (pre-packed mode: the panels are already in mat2)
+    float* oB = (ws || pack_mode == PACK_PREPACKED) ? ws : malloc(sizeof(float) * K * Tw);
+
+    size_t vl;
+
+    for (int jh = 0; jh < N; jh += Tw) {
+        for (int ih = 0; ih + Th <= M; ih += Th) {
+        
+            if (ih == 0 && jh % Tw == 0 && pack_mode == PACK_SEPARATE) {
+                reordering_rvv(&B[0][jh], oB, K, ldb, Tw, N - jh);
+
+                if( DEBUG_ENABLED >= 3 ){
+                    printf("ih==0 ==> orderedB");
+                    print_lmatrixf32(oB, Tw, K * Tw);
+                }
+            }
+
+            // fused mode: the first row block reads B directly and fills oB
+            // pre-packed mode: panel jh / Tw is read in place from mat2, ldb is the panel width
+            const int fused = (ih == 0 && pack_mode == PACK_FUSED);
+            const float* pB = fused ? &B[0][jh] : oB;
+            int ldp = fused ? ldb : Tw;
+            if (pack_mode == PACK_PREPACKED) {
+                pB = mat2 + (size_t)(jh / Tw) * K * ldb;
+                ldp = ldb;
+            }
+
+            // Tw deciso a runtime
+            vl = __riscv_vsetvl_e32mf2(N - jh);
+
+            // accumulatori: uno per ogni riga del tile
+            vfloat32mf2_t vc0 = __riscv_vfmv_v_f_f32mf2(0.0f, vl);
+            vfloat32mf2_t vc1 = __riscv_vfmv_v_f_f32mf2(0.0f, vl);
+
+            #if UNROLL == 2
+            #pragma GCC unroll 2
+            #elif UNROLL == 4
+            #pragma GCC unroll 4
+            #elif UNROLL == 8
+            #pragma GCC unroll 8
+            #elif UNROLL == 16
+            #pragma GCC unroll 16
+            #else
+            #pragma GCC unroll 1
+            #endif
+            for (int k = 0; k < K; ++k) {
+
+                // carica B[k][jh : jh+vl]
+                vfloat32mf2_t vb =
+                    __riscv_vle32_v_f32mf2(&pB[k * ldp], vl);
+
+                // fused mode: pack the row just loaded
+                if (fused)
+                    __riscv_vse32_v_f32mf2(&oB[k * Tw], vb, vl);
+
+                // outer product
+                vc0 = __riscv_vfmacc_vf_f32mf2(
+                    vc0, A[ih + 0][k], vb, vl);
+
+                vc1 = __riscv_vfmacc_vf_f32mf2(
+                    vc1, A[ih + 1][k], vb, vl);
+            }
+
+            // store
+            __riscv_vse32_v_f32mf2(&C[ih + 0][jh], vc0, vl);
+            __riscv_vse32_v_f32mf2(&C[ih + 1][jh], vc1, vl);
+
+            if( DEBUG_ENABLED >= 3 ){
+                ///printf("Computation block C(%d:%d) finished! \n", ih, jh);
+                printf("> C  iter!!\n");
+                print_lmatrixf32((float*) C, ldc, M * ldc);
+            }
+
+        }
+    }
+
+    if (oB != ws) free(oB);
+}
+
+
+
+void kernel_4_m1(float* mat1, float* mat2, float* res, int M, int N, int K, int lda, int ldb, int ldc, float* ws, int pack_mode) {
+
+    float (*A)[lda] = (float (*)[lda]) mat1;
+    float (*B)[ldb] = (float (*)[ldb]) mat2;
+    float (*C)[ldc] = (float (*)[ldc]) res;
+
+    const int Th = 4;
+    int Tw = __riscv_vsetvl_e32m1(N);
+
+    //printf("Tw:%d\n", Tw);
+    
+    // ordered B: K x Tw, in the caller workspace ws if given (pre-packed mode: the panels are already in mat2)
+    float* oB = (ws || pack_mode == PACK_PREPACKED) ? ws : malloc(sizeof(float) * K * Tw);
+
+    size_t vl;
+
+    for (int jh = 0; jh < N; jh += Tw) {
+        for (int ih = 0; ih + Th <= M; ih += Th) {
+        
+            if (ih == 0 && jh % Tw == 0 && pack_mode == PACK_SEPARATE) {
+                reordering_rvv(&B[0][jh], oB, K, ldb, Tw, N - jh);
+
+                if( DEBUG_ENABLED >= 3 ){
+                    printf("ih==0 ==> orderedB");
+                    print_lmatrixf32(oB, Tw, K * Tw);
+                }
+            }
+
+            // fused mode: the first row block reads B directly and fills oB
+            // pre-packed mode: panel jh / Tw is read in place from mat2, ldb is the panel width
+            const int fused = (ih == 0 && pack_mode == PACK_FUSED);
+            const float* pB = fused ? &B[0][jh] : oB;
+            int ldp = fused ? ldb : Tw;
+            if (pack_mode == PACK_PREPACKED) {
+                pB = mat2 + (size_t)(jh / Tw) * K * ldb;
+                ldp = ldb;
+            }
+
+            // Tw deciso a runtime
+            ////vl = __riscv_vsetvl_e32m1(N - jh);
+            vl = __riscv_vsetvl_e32m1(N - jh);
+
+            // accumulatori: uno per ogni riga del tile
+            vfloat32m1_t vc0 = __riscv_vfmv_v_f_f32m1(0.0f, vl);
+            vfloat32m1_t vc1 = __riscv_vfmv_v_f_f32m1(0.0f, vl);
+            vfloat32m1_t vc2 = __riscv_vfmv_v_f_f32m1(0.0f, vl);
+            vfloat32m1_t vc3 = __riscv_vfmv_v_f_f32m1(0.0f, vl);
+
+            #if UNROLL == 2
+            #pragma GCC unroll 2
+            #elif UNROLL == 4
+            #pragma GCC unroll 4
+            #elif UNROLL == 8
+            #pragma GCC unroll 8
+            #elif UNROLL == 16
+            #pragma GCC unroll 16
+            #else
+            #pragma GCC unroll 1
+            #endif
+            for (int k = 0; k < K; ++k) {
+
+                // carica B[k][jh : jh+vl]
+                vfloat32m1_t vb =
+                    __riscv_vle32_v_f32m1(&pB[k * ldp], vl);
+
+                // fused mode: pack the row just loaded
+                if (fused)
+                    __riscv_vse32_v_f32m1(&oB[k * Tw], vb, vl);
+
+                // outer product
+                vc0 = __riscv_vfmacc_vf_f32m1(
+                    vc0, A[ih + 0][k], vb, vl);
+
+                vc1 = __riscv_vfmacc_vf_f32m1(
+                    vc1, A[ih + 1][k], vb, vl);
+
+                vc2 = __riscv_vfmacc_vf_f32m1(
+                    vc2, A[ih + 2][k], vb, vl);
+
+                vc3 = __riscv_vfmacc_vf_f32m1(
+                    vc3, A[ih + 3][k], vb, vl);
+            }
+
+            // store
+            __riscv_vse32_v_f32m1(&C[ih + 0][jh], vc0, vl);
+            __riscv_vse32_v_f32m1(&C[ih + 1][jh], vc1, vl);
+            __riscv_vse32_v_f32m1(&C[ih + 2][jh], vc2, vl);
+            __riscv_vse32_v_f32m1(&C[ih + 3][jh], vc3, vl);
+
+            if( DEBUG_ENABLED >= 3 ){
+                ///printf("Computation block C(%d:%d) finished! \n", ih, jh);
+                printf("> C  iter!!\n");
+                print_lmatrixf32((float*) C, ldc, M * ldc);
+            }
+
+        }
+    }
+
+    if (oB != ws) free(oB);
+}
+
+void kernel_4_m2(float* mat1, float* mat2, float* res, int M, int N, int K, int lda, int ldb, int ldc, float* ws, int pack_mode) {
+
+    float (*A)[lda] = (float (*)[lda]) mat1;
+    float (*B)[ldb] = (float (*)[ldb]) mat2;
+    float (*C)[ldc] = (float (*)[ldc]) res;
+
+    const int Th = 4;
+    int Tw = __riscv_vsetvl_e32m2(N);
+
+    //printf("Tw:%d\n", Tw);
+    
+    // ordered B: K x Tw, in the caller workspace ws if given (pre-packed mode: the panels are already in mat2)
+    float* oB = (ws || pack_mode == PACK_PREPACKED) ? ws : malloc(sizeof(float) * K * Tw);
+
+    size_t vl;
+
+    for (int jh = 0; jh < N; jh += Tw) {
+        for (int ih = 0; ih + Th <= M; ih += Th) {
+        
+            if (ih == 0 && jh % Tw == 0 && pack_mode == PACK_SEPARATE) {
+                reordering_rvv(&B[0][jh], oB, K, ldb, Tw, N - jh);
+
+                if( DEBUG_ENABLED >= 3 ){
+                    printf("ih==0 ==> orderedB");
+                    print_lmatrixf32(oB, Tw, K * Tw);
+                }
+            }
+
+            // fused mode: the first row block reads B directly and fills oB
+            // pre-packed mode: panel jh / Tw is read in place from mat2, ldb is the panel width
+            const int fused = (ih == 0 && pack_mode == PACK_FUSED);
+            const float* pB = fused ? &B[0][jh] : oB;
+            int ldp = fused ? ldb : Tw;
+            if (pack_mode == PACK_PREPACKED) {
+                pB = mat2 + (size_t)(jh / Tw) * K * ldb;
+                ldp = ldb;
+            }
+
+            // Tw deciso a runtime
+            ////vl = __riscv_vsetvl_e32m1(N - jh);
+            vl = __riscv_vsetvl_e32m2(N - jh);
+
+            // accumulatori: uno per ogni riga del tile
+            vfloat32m2_t vc0 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
+            vfloat32m2_t vc1 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
+            vfloat32m2_t vc2 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
+            vfloat32m2_t vc3 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
+
+            #if UNROLL == 2
+            #pragma GCC unroll 2
+            #elif UNROLL == 4
+            #pragma GCC unroll 4
+            #elif UNROLL == 8
+            #pragma GCC unroll 8
+            #elif UNROLL == 16
+            #pragma GCC unroll 16
+            #else
+            #pragma GCC unroll 1
+            #endif
+            for (int k = 0; k < K; ++k) {
+
+                // carica B[k][jh : jh+vl]
+                vfloat32m2_t vb =
+                    __riscv_vle32_v_f32m2(&pB[k * ldp], vl);
+
+                // fused mode: pack the row just loaded
+                if (fused)
+                    __riscv_vse32_v_f32m2(&oB[k * Tw], vb, vl);
+
+                // outer product
+                vc0 = __riscv_vfmacc_vf_f32m2(
+                    vc0, A[ih + 0][k], vb, vl);
+
+                vc1 = __riscv_vfmacc_vf_f32m2(
+                    vc1, A[ih + 1][k], vb, vl);
+
+                vc2 = __riscv_vfmacc_vf_f32m2(
+                    vc2, A[ih + 2][k], vb, vl);
+
+                vc3 = __riscv_vfmacc_vf_f32m2(
+                    vc3, A[ih + 3][k], vb, vl);
+            }
+
+            // store
+            __riscv_vse32_v_f32m2(&C[ih + 0][jh], vc0, vl);
+            __riscv_vse32_v_f32m2(&C[ih + 1][jh], vc1, vl);
+            __riscv_vse32_v_f32m2(&C[ih + 2][jh], vc2, vl);
+            __riscv_vse32_v_f32m2(&C[ih + 3][jh], vc3, vl);
+
+            if( DEBUG_ENABLED >= 3 ){
+                ///printf("Computation block C(%d:%d) finished! \n", ih, jh);
+                printf("> C  iter!!\n");
+                print_lmatrixf32((float*) C, ldc, M * ldc);
+            }
+
+        }
+    }
+
+    if (oB != ws) free(oB);
+}
+
+void kernel_4_m4(float* mat1, float* mat2, float* res, int M, int N, int K, int lda, int ldb, int ldc, float* ws, int pack_mode) {
+
+    float (*A)[lda] = (float (*)[lda]) mat1;
+    float (*B)[ldb] = (float (*)[ldb]) mat2;
+    float (*C)[ldc] = (float (*)[ldc]) res;
+
+    const int Th = 4;
+    int Tw = __riscv_vsetvl_e32m4(N);
+
+    //printf("Tw:%d\n", Tw);
+    
+    // ordered B: K x Tw, in the caller workspace ws if given (pre-packed mode: the panels are already in mat2)
+    float* oB = (ws || pack_mode == PACK_PREPACKED) ? ws : malloc(sizeof(float) * K * Tw);
+
+    size_t vl;
+
+    for (int jh = 0; jh < N; jh += Tw) {
+        for (int ih = 0; ih + Th <= M; ih += Th) {
+        
+            if (ih == 0 && jh % Tw == 0 && pack_mode == PACK_SEPARATE) {
+                reordering_rvv(&B[0][jh], oB, K, ldb, Tw, N - jh);
+
+                if( DEBUG_ENABLED >= 3 ){
+                    printf("ih==0 ==> orderedB");
+                    print_lmatrixf32(oB, Tw, K * Tw);
+                }
+            }
+
+            // fused mode: the first row block reads B directly and fills oB
+            // pre-packed mode: panel jh / Tw is read in place from mat2, ldb is the panel width
+            const int fused = (ih == 0 && pack_mode == PACK_FUSED);
+            const float* pB = fused ? &B[0][jh] : oB;
+            int ldp = fused ? ldb : Tw;
+            if (pack_mode == PACK_PREPACKED) {
+                pB = mat2 + (size_t)(jh / Tw) * K * ldb;
+                ldp = ldb;
+            }
+
+            // Tw deciso a runtime
+            ////vl = __riscv_vsetvl_e32m1(N - jh);
+            vl = __riscv_vsetvl_e32m4(N - jh);
+
+            // accumulatori: uno per ogni riga del tile
+            vfloat32m4_t vc0 = __riscv_vfmv_v_f_f32m4(0.0f, vl);
+            vfloat32m4_t vc1 = __riscv_vfmv_v_f_f32m4(0.0f, vl);
+            vfloat32m4_t vc2 = __riscv_vfmv_v_f_f32m4(0.0f, vl);
+            vfloat32m4_t vc3 = __riscv_vfmv_v_f_f32m4(0.0f, vl);
+
+            #if UNROLL == 2
+            #pragma GCC unroll 2
+            #elif UNROLL == 4
+            #pragma GCC unroll 4
+            #elif UNROLL == 8
+            #pragma GCC unroll 8
+            #elif UNROLL == 16
+            #pragma GCC unroll 16
+            #else
+            #pragma GCC unroll 1
+            #endif
+            for (int k = 0; k < K; ++k) {
+
+                // carica B[k][jh : jh+vl]
+                vfloat32m4_t vb =
+                    __riscv_vle32_v_f32m4(&pB[k * ldp], vl);
+
+                // fused mode: pack the row just loaded
+                if (fused)
+                    __riscv_vse32_v_f32m4(&oB[k * Tw], vb, vl);
+
+                // outer product
+                vc0 = __riscv_vfmacc_vf_f32m4(
+                    vc0, A[ih + 0][k], vb, vl);
+
+                vc1 = __riscv_vfmacc_vf_f32m4(
+                    vc1, A[ih + 1][k], vb, vl);
+
+                vc2 = __riscv_vfmacc_vf_f32m4(
+                    vc2, A[ih + 2][k], vb, vl);
+
+                vc3 = __riscv_vfmacc_vf_f32m4(
+                    vc3, A[ih + 3][k], vb, vl);
+            }
+
+            // store
+            __riscv_vse32_v_f32m4(&C[ih + 0][jh], vc0, vl);
+            __riscv_vse32_v_f32m4(&C[ih + 1][jh], vc1, vl);
+            __riscv_vse32_v_f32m4(&C[ih + 2][jh], vc2, vl);
+            __riscv_vse32_v_f32m4(&C[ih + 3][jh], vc3, vl);
+
+            if( DEBUG_ENABLED >= 3 ){
+                ///printf("Computation block C(%d:%d) finished! \n", ih, jh);
+                printf("> C  iter!!\n");
+                print_lmatrixf32((float*) C, ldc, M * ldc);
+            }
+        }
+    }
+
+    if (oB != ws) free(oB);
+}
+
+void kernel_4_m8(float* mat1, float* mat2, float* res, int M, int N, int K, int lda, int ldb, int ldc, float* ws, int pack_mode) {
+
+    float (*A)[lda] = (float (*)[lda]) mat1;
+    float (*B)[ldb] = (float (*)[ldb]) mat2;
+    float (*C)[ldc] = (float (*)[ldc]) res;
+
+    const int Th = 4;
+    int Tw = __riscv_vsetvl_e32m8(N);
+
+    //printf("Tw:%d\n", Tw);
+    
+    // ordered B: K x Tw, in the caller workspace ws if given (pre-packed mode: the panels are already in mat2)
+    float* oB = (ws || pack_mode == PACK_PREPACKED) ? ws : malloc(sizeof(float) * K * Tw);
+
+    size_t vl;
+
+    for (int jh = 0; jh < N; jh += Tw) {
+        for (int ih = 0; ih + Th <= M; ih += Th) {
+        
+            if (ih == 0 && jh % Tw == 0 && pack_mode == PACK_SEPARATE) {
+                reordering_rvv(&B[0][jh], oB, K, ldb, Tw, N - jh);
+
+                if( DEBUG_ENABLED >= 3 ){
+                    printf("ih==0 ==> orderedB");
+                    print_lmatrixf32(oB, Tw, K * Tw);
+                }
+            }
+
+            // fused mode: the first row block reads B directly and fills oB
+            // pre-packed mode: panel jh / Tw is read in place from mat2, ldb is the panel width
+            const int fused = (ih == 0 && pack_mode == PACK_FUSED);
+            const float* pB = fused ? &B[0][jh] : oB;
+            int ldp = fused ? ldb : Tw;
+            if (pack_mode == PACK_PREPACKED) {
+                pB = mat2 + (size_t)(jh / Tw) * K * ldb;
+                ldp = ldb;
+            }
+
+            // Tw deciso a runtime
+            ////vl = __riscv_vsetvl_e32m1(N - jh);
+            vl = __riscv_vsetvl_e32m8(N - jh);
+
+            // accumulatori: uno per ogni riga del tile
+            vfloat32m8_t vc0 = __riscv_vfmv_v_f_f32m8(0.0f, vl);
+            vfloat32m8_t vc1 = __riscv_vfmv_v_f_f32m8(0.0f, vl);
+            vfloat32m8_t vc2 = __riscv_vfmv_v_f_f32m8(0.0f, vl);
+            vfloat32m8_t vc3 = __riscv_vfmv_v_f_f32m8(0.0f, vl);
+
+            #if UNROLL == 2
+            #pragma GCC unroll 2
+            #elif UNROLL == 4
+            #pragma GCC unroll 4
+            #elif UNROLL == 8
+            #pragma GCC unroll 8
+            #elif UNROLL == 16
+            #pragma GCC unroll 16
+            #else
+            #pragma GCC unroll 1
+            #endif
+            for (int k = 0; k < K; ++k) {
+
+                // carica B[k][jh : jh+vl]
+                vfloat32m8_t vb =
+                    __riscv_vle32_v_f32m8(&pB[k * ldp], vl);
+
+                // fused mode: pack the row just loaded
+                if (fused)
+                    __riscv_vse32_v_f32m8(&oB[k * Tw], vb, vl);
+
+                // outer product
+                vc0 = __riscv_vfmacc_vf_f32m8(
+                    vc0, A[ih + 0][k], vb, vl);
+
+                vc1 = __riscv_vfmacc_vf_f32m8(
+                    vc1, A[ih + 1][k], vb, vl);
+
+                vc2 = __riscv_vfmacc_vf_f32m8(
+                    vc2, A[ih + 2][k], vb, vl);
+
+                vc3 = __riscv_vfmacc_vf_f32m8(
+                    vc3, A[ih + 3][k], vb, vl);
+            }
+
+            // store
+            __riscv_vse32_v_f32m8(&C[ih + 0][jh], vc0, vl);
+            __riscv_vse32_v_f32m8(&C[ih + 1][jh], vc1, vl);
+            __riscv_vse32_v_f32m8(&C[ih + 2][jh], vc2, vl);
+            __riscv_vse32_v_f32m8(&C[ih + 3][jh], vc3, vl);
+
+            if( DEBUG_ENABLED >= 3 ){
+                ///printf("Computation block C(%d:%d) finished! \n", ih, jh);
+                printf("> C  iter!!\n");
+                print_lmatrixf32((float*) C, ldc, M * ldc);
+            }
+
+        }
+    }
+
+    if (oB != ws) free(oB);
+}
+
+void kernel_4_mf2(float* mat1, float* mat2, float* res, int M, int N, int K, int lda, int ldb, int ldc, float* ws, int pack_mode) {
+
+    float (*A)[lda] = (float (*)[lda]) mat1;
+    float (*B)[ldb] = (float (*)[ldb]) mat2;
+    float (*C)[ldc] = (float (*)[ldc]) res;
+
+    const int Th = 4;
+    int Tw = __riscv_vsetvl_e32mf2(N);
+
+    //printf("Tw:%d\n", Tw);
+    
+    // ordered B: K x Tw, in the caller workspace ws if given (pre-packed mode: the panels are already in mat2)
+    float* oB = (ws || pack_mode == PACK_PREPACKED) ? ws : malloc(sizeof(float) * K * Tw);
+
+    size_t vl;
+
+    for (int jh = 0; jh < N; jh += Tw) {
+        for (int ih = 0; ih + Th <= M; ih += Th) {
+        
+            if (ih == 0 && jh % Tw == 0 && pack_mode == PACK_SEPARATE) {
+                reordering_rvv(&B[0][jh], oB, K, ldb, Tw, N - jh);
+
+                if( DEBUG_ENABLED >= 3 ){
+                    printf("ih==0 ==> orderedB");
+                    print_lmatrixf32(oB, Tw, K * Tw);
+                }
+            }
+
+            // fused mode: the first row block reads B directly and fills oB
+            // pre-packed mode: panel jh / Tw is read in place from mat2, ldb is the panel width
+            const int fused = (ih == 0 && pack_mode == PACK_FUSED);
+            const float* pB = fused ? &B[0][jh] : oB;
+            int ldp = fused ? ldb : Tw;
+            if (pack_mode == PACK_PREPACKED) {
+                pB = mat2 + (size_t)(jh / Tw) * K * ldb;
+                ldp = ldb;
+            }
+
+            // Tw deciso a runtime
+            ////vl = __riscv_vsetvl_e32mf2(N - jh);
+            vl = __riscv_vsetvl_e32mf2(N - jh);
+
+            // accumulatori: uno per ogni riga del tile
+            vfloat32mf2_t vc0 = __riscv_vfmv_v_f_f32mf2(0.0f, vl);
+            vfloat32mf2_t vc1 = __riscv_vfmv_v_f_f32mf2(0.0f, vl);
+            vfloat32mf2_t vc2 = __riscv_vfmv_v_f_f32mf2(0.0f, vl);
+            vfloat32mf2_t vc3 = __riscv_vfmv_v_f_f32mf2(0.0f, vl);
+
+            #if UNROLL == 2
+            #pragma GCC unroll 2
+            #elif UNROLL == 4
+            #pragma GCC unroll 4
+            #elif UNROLL == 8
+            #pragma GCC unroll 8
+            #elif UNROLL == 16
+            #pragma GCC unroll 16
+            #else
+            #pragma GCC unroll 1
+            #endif
+            for (int k = 0; k < K; ++k) {
+
+                // carica B[k][jh : jh+vl]
+                vfloat32mf2_t vb =
+                    __riscv_vle32_v_f32mf2(&pB[k * ldp], vl);
+
+                // fused mode: pack the row just loaded
+                if (fused)
+                    __riscv_vse32_v_f32mf2(&oB[k * Tw], vb, vl);
+
+                // outer product
+                vc0 = __riscv_vfmacc_vf_f32mf2(
+                    vc0, A[ih + 0][k], vb, vl);
+
+                vc1 = __riscv_vfmacc_vf_f32mf2(
+                    vc1, A[ih + 1][k], vb, vl);
+
+                vc2 = __riscv_vfmacc_vf_f32mf2(
+                    vc2, A[ih + 2][k], vb, vl);
+
+                vc3 = __riscv_vfmacc_vf_f32mf2(
+                    vc3, A[ih + 3][k], vb, vl);
+            }
+
+            // store
+            __riscv_vse32_v_f32mf2(&C[ih + 0][jh], vc0, vl);
+            __riscv_vse32_v_f32mf2(&C[ih + 1][jh], vc1, vl);
+            __riscv_vse32_v_f32mf2(&C[ih + 2][jh], vc2, vl);
+            __riscv_vse32_v_f32mf2(&C[ih + 3][jh], vc3, vl);
+
+            if( DEBUG_ENABLED >= 3 ){
+                ///printf("Computation block C(%d:%d) finished! \n", ih, jh);
+                printf("> C  iter!!\n");
+                print_lmatrixf32((float*) C, ldc, M * ldc);
+            }
+
+        }
+    }
+
+    if (oB != ws) free(oB);
+}
+
+
+void kernel_8_m1(float* mat1, float* mat2, float* res, int M, int N, int K, int lda, int ldb, int ldc, float* ws, int pack_mode) {
+
+    float (*A)[lda] = (float (*)[lda]) mat1;
+    float (*B)[ldb] = (float (*)[ldb]) mat2;
+    float (*C)[ldc] = (float (*)[ldc]) res;
+
+    const int Th = 8;
+    int Tw = __riscv_vsetvl_e32m1(N);
+
+    //printf("Tw:%d\n", Tw);
+    
+    // ordered B: K x Tw, in the caller workspace ws if given (pre-packed mode: the panels are already in mat2)
+    float* oB = (ws || pack_mode == PACK_PREPACKED) ? ws : malloc(sizeof(float) * K * Tw);
+
+    size_t vl;
+
+    for (int jh = 0; jh < N; jh += Tw) {
+        for (int ih = 0; ih + Th <= M; ih += Th) {
+        
+            if (ih == 0 && jh % Tw == 0 && pack_mode == PACK_SEPARATE) {
+                reordering_rvv(&B[0][jh], oB, K, ldb, Tw, N - jh);
+
+                if( DEBUG_ENABLED >= 3 ){
+                    printf("ih==0 ==> orderedB");
+                    print_lmatrixf32(oB, Tw, K * Tw);
+                }
+            }
+
+            // fused mode: the first row block reads B directly and fills oB
+            // pre-packed mode: panel jh / Tw is read in place from mat2, ldb is the panel width
+            const int fused = (ih == 0 && pack_mode == PACK_FUSED);
+            const float* pB = fused ? &B[0][jh] : oB;
+            int ldp = fused ? ldb : Tw;
+            if (pack_mode == PACK_PREPACKED) {
+                pB = mat2 + (size_t)(jh / Tw) * K * ldb;
+                ldp = ldb;
+            }
+
+            // Tw deciso a runtime
+            ////vl = __riscv_vsetvl_e32m1(N - jh);
+            vl = __riscv_vsetvl_e32m1(N - jh);
+
+            // accumulatori: uno per ogni riga del tile
+            vfloat32m1_t vc0 = __riscv_vfmv_v_f_f32m1(0.0f, vl);
+            vfloat32m1_t vc1 = __riscv_vfmv_v_f_f32m1(0.0f, vl);
+            vfloat32m1_t vc2 = __riscv_vfmv_v_f_f32m1(0.0f, vl);
+            vfloat32m1_t vc3 = __riscv_vfmv_v_f_f32m1(0.0f, vl);
+            vfloat32m1_t vc4 = __riscv_vfmv_v_f_f32m1(0.0f, vl);
+            vfloat32m1_t vc5 = __riscv_vfmv_v_f_f32m1(0.0f, vl);
+            vfloat32m1_t vc6 = __riscv_vfmv_v_f_f32m1(0.0f, vl);
+            vfloat32m1_t vc7 = __riscv_vfmv_v_f_f32m1(0.0f, vl);
+
+            #if UNROLL == 2
+            #pragma GCC unroll 2
+            #elif UNROLL == 4
+            #pragma GCC unroll 4
+            #elif UNROLL == 8
+            #pragma GCC unroll 8
+            #elif UNROLL == 16
+            #pragma GCC unroll 16
+            #else
+            #pragma GCC unroll 1
+            #endif
+            for (int k = 0; k < K; ++k) {
+
+                // carica B[k][jh : jh+vl]
+                vfloat32m1_t vb =
+                    __riscv_vle32_v_f32m1(&pB[k * ldp], vl);
+
+                // fused mode: pack the row just loaded
+                if (fused)
+                    __riscv_vse32_v_f32m1(&oB[k * Tw], vb, vl);
+
+                // outer product
+                vc0 = __riscv_vfmacc_vf_f32m1(
+                    vc0, A[ih + 0][k], vb, vl);
+
+                vc1 = __riscv_vfmacc_vf_f32m1(
+                    vc1, A[ih + 1][k], vb, vl);
+
+                vc2 = __riscv_vfmacc_vf_f32m1(
+                    vc2, A[ih + 2][k], vb, vl);
+
+                vc3 = __riscv_vfmacc_vf_f32m1(
+                    vc3, A[ih + 3][k], vb, vl);
+
+                vc4 = __riscv_vfmacc_vf_f32m1(
+                    vc4, A[ih + 4][k], vb, vl);
+
+                vc5 = __riscv_vfmacc_vf_f32m1(
+                    vc5, A[ih + 5][k], vb, vl);
+
+                vc6 = __riscv_vfmacc_vf_f32m1(
+                    vc6, A[ih + 6][k], vb, vl);
+
+                vc7 = __riscv_vfmacc_vf_f32m1(
+                    vc7, A[ih + 7][k], vb, vl);
+            }
+
+            // store
+            __riscv_vse32_v_f32m1(&C[ih + 0][jh], vc0, vl);
+            __riscv_vse32_v_f32m1(&C[ih + 1][jh], vc1, vl);
+            __riscv_vse32_v_f32m1(&C[ih + 2][jh], vc2, vl);
+            __riscv_vse32_v_f32m1(&C[ih + 3][jh], vc3, vl);
+            __riscv_vse32_v_f32m1(&C[ih + 4][jh], vc4, vl);
+            __riscv_vse32_v_f32m1(&C[ih + 5][jh], vc5, vl);
+            __riscv_vse32_v_f32m1(&C[ih + 6][jh], vc6, vl);
+            __riscv_vse32_v_f32m1(&C[ih + 7][jh], vc7, vl);
+
+            if( DEBUG_ENABLED >= 3 ){
+                ///printf("Computation block C(%d:%d) finished! \n", ih, jh);
+                printf("> C  iter!!\n");
+                print_lmatrixf32((float*) C, ldc, M * ldc);
+            }
+
+        }
+    }
+
+    if (oB != ws) free(oB);
+}
+
+void kernel_8_m2(float* mat1, float* mat2, float* res, int M, int N, int K, int lda, int ldb, int ldc, float* ws, int pack_mode) {
+
+    float (*A)[lda] = (float (*)[lda]) mat1;
+    float (*B)[ldb] = (float (*)[ldb]) mat2;
+    float (*C)[ldc] = (float (*)[ldc]) res;
+
+    const int Th = 8;
+    int Tw = __riscv_vsetvl_e32m2(N);
+
+    //printf("Tw:%d\n", Tw);
+    
+    // ordered B: K x Tw, in the caller workspace ws if given (pre-packed mode: the panels are already in mat2)
+    float* oB = (ws || pack_mode == PACK_PREPACKED) ? ws : malloc(sizeof(float) * K * Tw);
+
+    size_t vl;
+
+    for (int jh = 0; jh < N; jh += Tw) {
+        for (int ih = 0; ih + Th <= M; ih += Th) {
+        
+            if (ih == 0 && jh % Tw == 0 && pack_mode == PACK_SEPARATE) {
+                reordering_rvv(&B[0][jh], oB, K, ldb, Tw, N - jh);
+
+                if( DEBUG_ENABLED >= 3 ){
+                    printf("ih==0 ==> orderedB");
+                    print_lmatrixf32(oB, Tw, K * Tw);
+                }
+            }
+
+            // fused mode: the first row block reads B directly and fills oB
+            // pre-packed mode: panel jh / Tw is read in place from mat2, ldb is the panel width
+            const int fused = (ih == 0 && pack_mode == PACK_FUSED);
+            const float* pB = fused ? &B[0][jh] : oB;
+            int ldp = fused ? ldb : Tw;
+            if (pack_mode == PACK_PREPACKED) {
+                pB = mat2 + (size_t)(jh / Tw) * K * ldb;
+                ldp = ldb;
+            }
+
+            // Tw deciso a runtime
+            ////vl = __riscv_vsetvl_e32m1(N - jh);
+            vl = __riscv_vsetvl_e32m2(N - jh);
+
+            // accumulatori: uno per ogni riga del tile
+            vfloat32m2_t vc0 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
+            vfloat32m2_t vc1 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
+            vfloat32m2_t vc2 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
+            vfloat32m2_t vc3 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
+            vfloat32m2_t vc4 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
+            vfloat32m2_t vc5 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
+            vfloat32m2_t vc6 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
+            vfloat32m2_t vc7 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
+
+            #if UNROLL == 2
+            #pragma GCC unroll 2
+            #elif UNROLL == 4
+            #pragma GCC unroll 4
+            #elif UNROLL == 8
+            #pragma GCC unroll 8
+            #elif UNROLL == 16
+            #pragma GCC unroll 16
+            #else
+            #pragma GCC unroll 1
+            #endif
+            for (int k = 0; k < K; ++k) {
+
+                // carica B[k][jh : jh+vl]
+                vfloat32m2_t vb =
+                    __riscv_vle32_v_f32m2(&pB[k * ldp], vl);
+
+                // fused mode: pack the row just loaded
+                if (fused)
+                    __riscv_vse32_v_f32m2(&oB[k * Tw], vb, vl);
+
+                // outer product
+                vc0 = __riscv_vfmacc_vf_f32m2(
+                    vc0, A[ih + 0][k], vb, vl);
+
+                vc1 = __riscv_vfmacc_vf_f32m2(
+                    vc1, A[ih + 1][k], vb, vl);
+
+                vc2 = __riscv_vfmacc_vf_f32m2(
+                    vc2, A[ih + 2][k], vb, vl);
+
+                vc3 = __riscv_vfmacc_vf_f32m2(
+                    vc3, A[ih + 3][k], vb, vl);
+
+                vc4 = __riscv_vfmacc_vf_f32m2(
+                    vc4, A[ih + 4][k], vb, vl);
+
+                vc5 = __riscv_vfmacc_vf_f32m2(
+                    vc5, A[ih + 5][k], vb, vl);
+
+                vc6 = __riscv_vfmacc_vf_f32m2(
+                    vc6, A[ih + 6][k], vb, vl);
+
+                vc7 = __riscv_vfmacc_vf_f32m2(
+                    vc7, A[ih + 7][k], vb, vl);
+            }
+
+            // store
+            __riscv_vse32_v_f32m2(&C[ih + 0][jh], vc0, vl);
+            __riscv_vse32_v_f32m2(&C[ih + 1][jh], vc1, vl);
+            __riscv_vse32_v_f32m2(&C[ih + 2][jh], vc2, vl);
+            __riscv_vse32_v_f32m2(&C[ih + 3][jh], vc3, vl);
+            __riscv_vse32_v_f32m2(&C[ih + 4][jh], vc4, vl);
+            __riscv_vse32_v_f32m2(&C[ih + 5][jh], vc5, vl);
+            __riscv_vse32_v_f32m2(&C[ih + 6][jh], vc6, vl);
+            __riscv_vse32_v_f32m2(&C[ih + 7][jh], vc7, vl);
+
+            if( DEBUG_ENABLED >= 3 ){
+                ///printf("Computation block C(%d:%d) finished! \n", ih, jh);
+                printf("> C  iter!!\n");
+                print_lmatrixf32((float*) C, ldc, M * ldc);
+            }
+
+        }
+    }
+
+    if (oB != ws) free(oB);
+}
+
+void kernel_8_m4(float* mat1, float* mat2, float* res, int M, int N, int K, int lda, int ldb, int ldc, float* ws, int pack_mode) {
+
+    float (*A)[lda] = (float (*)[lda]) mat1;
+    float (*B)[ldb] = (float (*)[ldb]) mat2;
+    float (*C)[ldc] = (float (*)[ldc]) res;
+
+    const int Th = 8;
+    int Tw = __riscv_vsetvl_e32m4(N);
+
+    //printf("Tw:%d\n", Tw);
+    
+    // ordered B: K x Tw, in the caller workspace ws if given (pre-packed mode: the panels are already in mat2)
+    float* oB = (ws || pack_mode == PACK_PREPACKED) ? ws : malloc(sizeof(float) * K * Tw);
+
+    size_t vl;
+
+    for (int jh = 0; jh < N; jh += Tw) {
+        for (int ih = 0; ih + Th <= M; ih += Th) {
+        
+            if (ih == 0 && jh % Tw == 0 && pack_mode == PACK_SEPARATE) {
+                reordering_rvv(&B[0][jh], oB, K, ldb, Tw, N - jh);
+
+                if( DEBUG_ENABLED >= 3 ){
+                    printf("ih==0 ==> orderedB");
+                    print_lmatrixf32(oB, Tw, K * Tw);
+                }
+            }
+
+            // fused mode: the first row block reads B directly and fills oB
+            // pre-packed mode: panel jh / Tw is read in place from mat2, ldb is the panel width
+            const int fused = (ih == 0 && pack_mode == PACK_FUSED);
+            const float* pB = fused ? &B[0][jh] : oB;
+            int ldp = fused ? ldb : Tw;
+            if (pack_mode == PACK_PREPACKED) {
+                pB = mat2 + (size_t)(jh / Tw) * K * ldb;
+                ldp = ldb;
+            }
+
+            // Tw deciso a runtime
+            ////vl = __riscv_vsetvl_e32m1(N - jh);
+            vl = __riscv_vsetvl_e32m4(N - jh);
+
+            // accumulatori: uno per ogni riga del tile
+            vfloat32m4_t vc0 = __riscv_vfmv_v_f_f32m4(0.0f, vl);
+            vfloat32m4_t vc1 = __riscv_vfmv_v_f_f32m4(0.0f, vl);
+            vfloat32m4_t vc2 = __riscv_vfmv_v_f_f32m4(0.0f, vl);
+            vfloat32m4_t vc3 = __riscv_vfmv_v_f_f32m4(0.0f, vl);
+            vfloat32m4_t vc4 = __riscv_vfmv_v_f_f32m4(0.0f, vl);
+            vfloat32m4_t vc5 = __riscv_vfmv_v_f_f32m4(0.0f, vl);
+            vfloat32m4_t vc6 = __riscv_vfmv_v_f_f32m4(0.0f, vl);
+            vfloat32m4_t vc7 = __riscv_vfmv_v_f_f32m4(0.0f, vl);
+
+            #if UNROLL == 2
+            #pragma GCC unroll 2
+            #elif UNROLL == 4
+            #pragma GCC unroll 4
+            #elif UNROLL == 8
+            #pragma GCC unroll 8
+            #elif UNROLL == 16
+            #pragma GCC unroll 16
+            #else
+            #pragma GCC unroll 1
+            #endif
+            for (int k = 0; k < K; ++k) {
+
+                // carica B[k][jh : jh+vl]
+                vfloat32m4_t vb =
+                    __riscv_vle32_v_f32m4(&pB[k * ldp], vl);
+
+                // fused mode: pack the row just loaded
+                if (fused)
+                    __riscv_vse32_v_f32m4(&oB[k * Tw], vb, vl);
+
+                // outer product
+                vc0 = __riscv_vfmacc_vf_f32m4(
+                    vc0, A[ih + 0][k], vb, vl);
+
+                vc1 = __riscv_vfmacc_vf_f32m4(
+                    vc1, A[ih + 1][k], vb, vl);
+
+                vc2 = __riscv_vfmacc_vf_f32m4(
+                    vc2, A[ih + 2][k], vb, vl);
+
+                vc3 = __riscv_vfmacc_vf_f32m4(
+                    vc3, A[ih + 3][k], vb, vl);
+
+                vc4 = __riscv_vfmacc_vf_f32m4(
+                    vc4, A[ih + 4][k], vb, vl);
+
+                vc5 = __riscv_vfmacc_vf_f32m4(
+                    vc5, A[ih + 5][k], vb, vl);
+
+                vc6 = __riscv_vfmacc_vf_f32m4(
+                    vc6, A[ih + 6][k], vb, vl);
+
+                vc7 = __riscv_vfmacc_vf_f32m4(
+                    vc7, A[ih + 7][k], vb, vl);
+            }
+
+            // store
+            __riscv_vse32_v_f32m4(&C[ih + 0][jh], vc0, vl);
+            __riscv_vse32_v_f32m4(&C[ih + 1][jh], vc1, vl);
+            __riscv_vse32_v_f32m4(&C[ih + 2][jh], vc2, vl);
+            __riscv_vse32_v_f32m4(&C[ih + 3][jh], vc3, vl);
+            __riscv_vse32_v_f32m4(&C[ih + 4][jh], vc4, vl);
+            __riscv_vse32_v_f32m4(&C[ih + 5][jh], vc5, vl);
+            __riscv_vse32_v_f32m4(&C[ih + 6][jh], vc6, vl);
+            __riscv_vse32_v_f32m4(&C[ih + 7][jh], vc7, vl);
+
+            if( DEBUG_ENABLED >= 3 ){
+                ///printf("Computation block C(%d:%d) finished! \n", ih, jh);
+                printf("> C  iter!!\n");
+                print_lmatrixf32((float*) C, ldc, M * ldc);
+            }
+
+        }
+    }
+
+    if (oB != ws) free(oB);
+}
+
+void kernel_8_m8(float* mat1, float* mat2, float* res, int M, int N, int K, int lda, int ldb, int ldc, float* ws, int pack_mode) {
+
+    float (*A)[lda] = (float (*)[lda]) mat1;
+    float (*B)[ldb] = (float (*)[ldb]) mat2;
+    float (*C)[ldc] = (float (*)[ldc]) res;
+
+    const int Th = 8;
+    int Tw = __riscv_vsetvl_e32m8(N);
+
+    //printf("Tw:%d\n", Tw);
+    
+    // ordered B: K x Tw, in the caller workspace ws if given (pre-packed mode: the panels are already in mat2)
+    float* oB = (ws || pack_mode == PACK_PREPACKED) ? ws : malloc(sizeof(float) * K * Tw);
+
+    size_t vl;
+
+    for (int jh = 0; jh < N; jh += Tw) {
+        for (int ih = 0; ih + Th <= M; ih += Th) {
+        
+            if (ih == 0 && jh % Tw == 0 && pack_mode == PACK_SEPARATE) {
+                reordering_rvv(&B[0][jh], oB, K, ldb, Tw, N - jh);
+
+                if( DEBUG_ENABLED >= 3 ){
+                    printf("ih==0 ==> orderedB");
+                    print_lmatrixf32(oB, Tw, K * Tw);
+                }
+            }
+
+            // fused mode: the first row block reads B directly and fills oB
+            // pre-packed mode: panel jh / Tw is read in place from mat2, ldb is the panel width
+            const int fused = (ih == 0 && pack_mode == PACK_FUSED);
+            const float* pB = fused ? &B[0][jh] : oB;
+            int ldp = fused ? ldb : Tw;
+            if (pack_mode == PACK_PREPACKED) {
+                pB = mat2 + (size_t)(jh / Tw) * K * ldb;
+                ldp = ldb;
+            }
+
+            // Tw deciso a runtime
+            ////vl = __riscv_vsetvl_e32m1(N - jh);
+            vl = __riscv_vsetvl_e32m8(N - jh);
+
+            // accumulatori: uno per ogni riga del tile
+            vfloat32m8_t vc0 = __riscv_vfmv_v_f_f32m8(0.0f, vl);
+            vfloat32m8_t vc1 = __riscv_vfmv_v_f_f32m8(0.0f, vl);
+            vfloat32m8_t vc2 = __riscv_vfmv_v_f_f32m8(0.0f, vl);
+            vfloat32m8_t vc3 = __riscv_vfmv_v_f_f32m8(0.0f, vl);
+            vfloat32m8_t vc4 = __riscv_vfmv_v_f_f32m8(0.0f, vl);
+            vfloat32m8_t vc5 = __riscv_vfmv_v_f_f32m8(0.0f, vl);
+            vfloat32m8_t vc6 = __riscv_vfmv_v_f_f32m8(0.0f, vl);
+            vfloat32m8_t vc7 = __riscv_vfmv_v_f_f32m8(0.0f, vl);
+
+            #if UNROLL == 2
+            #pragma GCC unroll 2
+            #elif UNROLL == 4
+            #pragma GCC unroll 4
+            #elif UNROLL == 8
+            #pragma GCC unroll 8
+            #elif UNROLL == 16
+            #pragma GCC unroll 16
+            #else
+            #pragma GCC unroll 1
+            #endif
+            for (int k = 0; k < K; ++k) {
+
+                // carica B[k][jh : jh+vl]
+                vfloat32m8_t vb =
+                    __riscv_vle32_v_f32m8(&pB[k * ldp], vl);
+
+                // fused mode: pack the row just loaded
+                if (fused)
+                    __riscv_vse32_v_f32m8(&oB[k * Tw], vb, vl);
+
+                // outer product
+                vc0 = __riscv_vfmacc_vf_f32m8(
+                    vc0, A[ih + 0][k], vb, vl);
+
+                vc1 = __riscv_vfmacc_vf_f32m8(
+                    vc1, A[ih + 1][k], vb, vl);
+
+                vc2 = __riscv_vfmacc_vf_f32m8(
+                    vc2, A[ih + 2][k], vb, vl);
+
+                vc3 = __riscv_vfmacc_vf_f32m8(
+                    vc3, A[ih + 3][k], vb, vl);
+
+                vc4 = __riscv_vfmacc_vf_f32m8(
+                    vc4, A[ih + 4][k], vb, vl);
+
+                vc5 = __riscv_vfmacc_vf_f32m8(
+                    vc5, A[ih + 5][k], vb, vl);
+
+                vc6 = __riscv_vfmacc_vf_f32m8(
+                    vc6, A[ih + 6][k], vb, vl);
+
+                vc7 = __riscv_vfmacc_vf_f32m8(
+                    vc7, A[ih + 7][k], vb, vl);
+            }
+
+            // store
+            __riscv_vse32_v_f32m8(&C[ih + 0][jh], vc0, vl);
+            __riscv_vse32_v_f32m8(&C[ih + 1][jh], vc1, vl);
+            __riscv_vse32_v_f32m8(&C[ih + 2][jh], vc2, vl);
+            __riscv_vse32_v_f32m8(&C[ih + 3][jh], vc3, vl);
+            __riscv_vse32_v_f32m8(&C[ih + 4][jh], vc4, vl);
+            __riscv_vse32_v_f32m8(&C[ih + 5][jh], vc5, vl);
+            __riscv_vse32_v_f32m8(&C[ih + 6][jh], vc6, vl);
+            __riscv_vse32_v_f32m8(&C[ih + 7][jh], vc7, vl);
+
+            if( DEBUG_ENABLED >= 3 ){
+                ///printf("Computation block C(%d:%d) finished! \n", ih, jh);
+                printf("> C  iter!!\n");
+                print_lmatrixf32((float*) C, ldc, M * ldc);
+            }
+
+        }
+    }
+
+    if (oB != ws) free(oB);
+}
+
+void kernel_8_mf2(float* mat1, float* mat2, float* res, int M, int N, int K, int lda, int ldb, int ldc, float* ws, int pack_mode) {
+
+    float (*A)[lda] = (float (*)[lda]) mat1;
+    float (*B)[ldb] = (float (*)[ldb]) mat2;
+    float (*C)[ldc] = (float (*)[ldc]) res;
+
+    const int Th = 8;
+    int Tw = __riscv_vsetvl_e32mf2(N);
+
+    //printf("Tw:%d\n", Tw);
+    
+    // ordered B: K x Tw, in the caller workspace ws if given (pre-packed mode: the panels are already in mat2)
+    float* oB = (ws || pack_mode == PACK_PREPACKED) ? ws : malloc(sizeof(float) * K * Tw);
+
+    size_t vl;
+
+    for (int jh = 0; jh < N; jh += Tw) {
+        for (int ih = 0; ih + Th <= M; ih += Th) {
+        
+            if (ih == 0 && jh % Tw == 0 && pack_mode == PACK_SEPARATE) {
+                reordering_rvv(&B[0][jh], oB, K, ldb, Tw, N - jh);
+
+                if( DEBUG_ENABLED >= 3 ){
+                    printf("ih==0 ==> orderedB");
+                    print_lmatrixf32(oB, Tw, K * Tw);
+                }
+            }
+
+            // fused mode: the first row block reads B directly and fills oB
+            // pre-packed mode: panel jh / Tw is read in place from mat2, ldb is the panel width
+            const int fused = (ih == 0 && pack_mode == PACK_FUSED);
+            const float* pB = fused ? &B[0][jh] : oB;
+            int ldp = fused ? ldb : Tw;
+            if (pack_mode == PACK_PREPACKED) {
+                pB = mat2 + (size_t)(jh / Tw) * K * ldb;
+                ldp = ldb;
+            }
+
+            // Tw deciso a runtime
+            ////vl = __riscv_vsetvl_e32mf2(N - jh);
+            vl = __riscv_vsetvl_e32mf2(N - jh);
+
+            // accumulatori: uno per ogni riga del tile
+            vfloat32mf2_t vc0 = __riscv_vfmv_v_f_f32mf2(0.0f, vl);
+            vfloat32mf2_t vc1 = __riscv_vfmv_v_f_f32mf2(0.0f, vl);
+            vfloat32mf2_t vc2 = __riscv_vfmv_v_f_f32mf2(0.0f, vl);
+            vfloat32mf2_t vc3 = __riscv_vfmv_v_f_f32mf2(0.0f, vl);
+            vfloat32mf2_t vc4 = __riscv_vfmv_v_f_f32mf2(0.0f, vl);
+            vfloat32mf2_t vc5 = __riscv_vfmv_v_f_f32mf2(0.0f, vl);
+            vfloat32mf2_t vc6 = __riscv_vfmv_v_f_f32mf2(0.0f, vl);
+            vfloat32mf2_t vc7 = __riscv_vfmv_v_f_f32mf2(0.0f, vl);
+
+            #if UNROLL == 2
+            #pragma GCC unroll 2
+            #elif UNROLL == 4
+            #pragma GCC unroll 4
+            #elif UNROLL == 8
+            #pragma GCC unroll 8
+            #elif UNROLL == 16
+            #pragma GCC unroll 16
+            #else
+            #pragma GCC unroll 1
+            #endif
+            for (int k = 0; k < K; ++k) {
+
+                // carica B[k][jh : jh+vl]
+                vfloat32mf2_t vb =
+                    __riscv_vle32_v_f32mf2(&pB[k * ldp], vl);
+
+                // fused mode: pack the row just loaded
+                if (fused)
+                    __riscv_vse32_v_f32mf2(&oB[k * Tw], vb, vl);
+
+                // outer product
+                vc0 = __riscv_vfmacc_vf_f32mf2(
+                    vc0, A[ih + 0][k], vb, vl);
+
+                vc1 = __riscv_vfmacc_vf_f32mf2(
+                    vc1, A[ih + 1][k], vb, vl);
+
+                vc2 = __riscv_vfmacc_vf_f32mf2(
+                    vc2, A[ih + 2][k], vb, vl);
+
+                vc3 = __riscv_vfmacc_vf_f32mf2(
+                    vc3, A[ih + 3][k], vb, vl);
+
+                vc4 = __riscv_vfmacc_vf_f32mf2(
+                    vc4, A[ih + 4][k], vb, vl);
+
+                vc5 = __riscv_vfmacc_vf_f32mf2(
+                    vc5, A[ih + 5][k], vb, vl);
+
+                vc6 = __riscv_vfmacc_vf_f32mf2(
+                    vc6, A[ih + 6][k], vb, vl);
+
+                vc7 = __riscv_vfmacc_vf_f32mf2(
+                    vc7, A[ih + 7][k], vb, vl);
+            }
+
+            // store
+            __riscv_vse32_v_f32mf2(&C[ih + 0][jh], vc0, vl);
+            __riscv_vse32_v_f32mf2(&C[ih + 1][jh], vc1, vl);
+            __riscv_vse32_v_f32mf2(&C[ih + 2][jh], vc2, vl);
+            __riscv_vse32_v_f32mf2(&C[ih + 3][jh], vc3, vl);
+            __riscv_vse32_v_f32mf2(&C[ih + 4][jh], vc4, vl);
+            __riscv_vse32_v_f32mf2(&C[ih + 5][jh], vc5, vl);
+            __riscv_vse32_v_f32mf2(&C[ih + 6][jh], vc6, vl);
+            __riscv_vse32_v_f32mf2(&C[ih + 7][jh], vc7, vl);
+
+            if( DEBUG_ENABLED >= 3 ){
+                ///printf("Computation block C(%d:%d) finished! \n", ih, jh);
+                printf("> C  iter!!\n");
+                print_lmatrixf32((float*) C, ldc, M * ldc);
+            }
+
+        }
+    }
+
+    if (oB != ws) free(oB);
+}
+
+
+void kernel_16_m1(float* mat1, float* mat2, float* res, int M, int N, int K, int lda, int ldb, int ldc, float* ws, int pack_mode) {
+
+    float (*A)[lda] = (float (*)[lda]) mat1;
+    float (*B)[ldb] = (float (*)[ldb]) mat2;
+    float (*C)[ldc] = (float (*)[ldc]) res;
+
+    const int Th = 16;
+    int Tw = __riscv_vsetvl_e32m1(N);
+
+    //printf("Tw:%d\n", Tw);
+    
+    // ordered B: K x Tw, in the caller workspace ws if given (pre-packed mode: the panels are already in mat2)
+    float* oB = (ws || pack_mode == PACK_PREPACKED) ? ws : malloc(sizeof(float) * K * Tw);
+
+    size_t vl;
+
+    for (int jh = 0; jh < N; jh += Tw) {
+        for (int ih = 0; ih + Th <= M; ih += Th) {
+        
+            if (ih == 0 && jh % Tw == 0 && pack_mode == PACK_SEPARATE) {
+                reordering_rvv(&B[0][jh], oB, K, ldb, Tw, N - jh);
+
+                if( DEBUG_ENABLED >= 3 ){
+                    printf("ih==0 ==> orderedB");
+                    print_lmatrixf32(oB, Tw, K * Tw);
+                }
+            }
+
+            // fused mode: the first row block reads B directly and fills oB
+            // pre-packed mode: panel jh / Tw is read in place from mat2, ldb is the panel width
+            const int fused = (ih == 0 && pack_mode == PACK_FUSED);
+            const float* pB = fused ? &B[0][jh] : oB;
+            int ldp = fused ? ldb : Tw;
+            if (pack_mode == PACK_PREPACKED) {
+                pB = mat2 + (size_t)(jh / Tw) * K * ldb;
+                ldp = ldb;
+            }
+
+            // Tw deciso a runtime
+            ////vl = __riscv_vsetvl_e32m1(N - jh);
+            vl = __riscv_vsetvl_e32m1(N - jh);
+
+            // accumulatori: uno per ogni riga del tile
+            vfloat32m1_t vc0 = __riscv_vfmv_v_f_f32m1(0.0f, vl);
+            vfloat32m1_t vc1 = __riscv_vfmv_v_f_f32m1(0.0f, vl);
+            vfloat32m1_t vc2 = __riscv_vfmv_v_f_f32m1(0.0f, vl);
+            vfloat32m1_t vc3 = __riscv_vfmv_v_f_f32m1(0.0f, vl);
+            vfloat32m1_t vc4 = __riscv_vfmv_v_f_f32m1(0.0f, vl);
+            vfloat32m1_t vc5 = __riscv_vfmv_v_f_f32m1(0.0f, vl);
+            vfloat32m1_t vc6 = __riscv_vfmv_v_f_f32m1(0.0f, vl);
+            vfloat32m1_t vc7 = __riscv_vfmv_v_f_f32m1(0.0f, vl);
+            vfloat32m1_t vc8 = __riscv_vfmv_v_f_f32m1(0.0f, vl);
+            vfloat32m1_t vc9 = __riscv_vfmv_v_f_f32m1(0.0f, vl);
+            vfloat32m1_t vc10 = __riscv_vfmv_v_f_f32m1(0.0f, vl);
+            vfloat32m1_t vc11 = __riscv_vfmv_v_f_f32m1(0.0f, vl);
+            vfloat32m1_t vc12 = __riscv_vfmv_v_f_f32m1(0.0f, vl);
+            vfloat32m1_t vc13 = __riscv_vfmv_v_f_f32m1(0.0f, vl);
+            vfloat32m1_t vc14 = __riscv_vfmv_v_f_f32m1(0.0f, vl);
+            vfloat32m1_t vc15 = __riscv_vfmv_v_f_f32m1(0.0f, vl);
+
+            #if UNROLL == 2
+            #pragma GCC unroll 2
+            #elif UNROLL == 4
+            #pragma GCC unroll 4
+            #elif UNROLL == 8
+            #pragma GCC unroll 8
+            #elif UNROLL == 16
+            #pragma GCC unroll 16
+            #else
+            #pragma GCC unroll 1
+            #endif
+            for (int k = 0; k < K; ++k) {
+
+                // carica B[k][jh : jh+vl]
+                vfloat32m1_t vb =
+                    __riscv_vle32_v_f32m1(&pB[k * ldp], vl);
+
+                // fused mode: pack the row just loaded
+                if (fused)
+                    __riscv_vse32_v_f32m1(&oB[k * Tw], vb, vl);
+
+                // outer product
+                vc0 = __riscv_vfmacc_vf_f32m1(
+                    vc0, A[ih + 0][k], vb, vl);
+
+                vc1 = __riscv_vfmacc_vf_f32m1(
+                    vc1, A[ih + 1][k], vb, vl);
+
+                vc2 = __riscv_vfmacc_vf_f32m1(
+                    vc2, A[ih + 2][k], vb, vl);
+
+                vc3 = __riscv_vfmacc_vf_f32m1(
+                    vc3, A[ih + 3][k], vb, vl);
+
+                vc4 = __riscv_vfmacc_vf_f32m1(
+                    vc4, A[ih + 4][k], vb, vl);
+
+                vc5 = __riscv_vfmacc_vf_f32m1(
+                    vc5, A[ih + 5][k], vb, vl);
+
+                vc6 = __riscv_vfmacc_vf_f32m1(
+                    vc6, A[ih + 6][k], vb, vl);
+
+                vc7 = __riscv_vfmacc_vf_f32m1(
+                    vc7, A[ih + 7][k], vb, vl);
+
+                vc8 = __riscv_vfmacc_vf_f32m1(
+                    vc8, A[ih + 8][k], vb, vl);
+
+                vc9 = __riscv_vfmacc_vf_f32m1(
+                    vc9, A[ih + 9][k], vb, vl);
+
+                vc10 = __riscv_vfmacc_vf_f32m1(
+                    vc10, A[ih + 10][k], vb, vl);
+
+                vc11 = __riscv_vfmacc_vf_f32m1(
+                    vc11, A[ih + 11][k], vb, vl);
+
+                vc12 = __riscv_vfmacc_vf_f32m1(
+                    vc12, A[ih + 12][k], vb, vl);
+
+                vc13 = __riscv_vfmacc_vf_f32m1(
+                    vc13, A[ih + 13][k], vb, vl);
+
+                vc14 = __riscv_vfmacc_vf_f32m1(
+                    vc14, A[ih + 14][k], vb, vl);
+
+                vc15 = __riscv_vfmacc_vf_f32m1(
+                    vc15, A[ih + 15][k], vb, vl);
+            }
+
+            // store
+            __riscv_vse32_v_f32m1(&C[ih + 0][jh], vc0, vl);
+            __riscv_vse32_v_f32m1(&C[ih + 1][jh], vc1, vl);
+            __riscv_vse32_v_f32m1(&C[ih + 2][jh], vc2, vl);
+            __riscv_vse32_v_f32m1(&C[ih + 3][jh], vc3, vl);
+            __riscv_vse32_v_f32m1(&C[ih + 4][jh], vc4, vl);
+            __riscv_vse32_v_f32m1(&C[ih + 5][jh], vc5, vl);
+            __riscv_vse32_v_f32m1(&C[ih + 6][jh], vc6, vl);
+            __riscv_vse32_v_f32m1(&C[ih + 7][jh], vc7, vl);
+            __riscv_vse32_v_f32m1(&C[ih + 8][jh], vc8, vl);
+            __riscv_vse32_v_f32m1(&C[ih + 9][jh], vc9, vl);
+            __riscv_vse32_v_f32m1(&C[ih + 10][jh], vc10, vl);
+            __riscv_vse32_v_f32m1(&C[ih + 11][jh], vc11, vl);
+            __riscv_vse32_v_f32m1(&C[ih + 12][jh], vc12, vl);
+            __riscv_vse32_v_f32m1(&C[ih + 13][jh], vc13, vl);
+            __riscv_vse32_v_f32m1(&C[ih + 14][jh], vc14, vl);
+            __riscv_vse32_v_f32m1(&C[ih + 15][jh], vc15, vl);
+
+            if( DEBUG_ENABLED >= 3 ){
+                ///printf("Computation block C(%d:%d) finished! \n", ih, jh);
+                printf("> C  iter!!\n");
+                print_lmatrixf32((float*) C, ldc, M * ldc);
+            }
+
+        }
+    }
+
+    if (oB != ws) free(oB);
+}
+
+void kernel_16_m2(float* mat1, float* mat2, float* res, int M, int N, int K, int lda, int ldb, int ldc, float* ws, int pack_mode) {
+
+    float (*A)[lda] = (float (*)[lda]) mat1;
+    float (*B)[ldb] = (float (*)[ldb]) mat2;
+    float (*C)[ldc] = (float (*)[ldc]) res;
+
+    const int Th = 16;
+    int Tw = __riscv_vsetvl_e32m2(N);
+
+    //printf("Tw:%d\n", Tw);
+    
+    // ordered B: K x Tw, in the caller workspace ws if given (pre-packed mode: the panels are already in mat2)
+    float* oB = (ws || pack_mode == PACK_PREPACKED) ? ws : malloc(sizeof(float) * K * Tw);
+
+    size_t vl;
+
+    for (int jh = 0; jh < N; jh += Tw) {
+        for (int ih = 0; ih + Th <= M; ih += Th) {
+        
+            if (ih == 0 && jh % Tw == 0 && pack_mode == PACK_SEPARATE) {
+                reordering_rvv(&B[0][jh], oB, K, ldb, Tw, N - jh);
+
+                if( DEBUG_ENABLED >= 3 ){
+                    printf("ih==0 ==> orderedB");
+                    print_lmatrixf32(oB, Tw, K * Tw);
+                }
+            }
+
+            // fused mode: the first row block reads B directly and fills oB
+            // pre-packed mode: panel jh / Tw is read in place from mat2, ldb is the panel width
+            const int fused = (ih == 0 && pack_mode == PACK_FUSED);
+            const float* pB = fused ? &B[0][jh] : oB;
+            int ldp = fused ? ldb : Tw;
+            if (pack_mode == PACK_PREPACKED) {
+                pB = mat2 + (size_t)(jh / Tw) * K * ldb;
+                ldp = ldb;
+            }
+
+            // Tw deciso a runtime
+            ////vl = __riscv_vsetvl_e32m2(N - jh);
+            vl = __riscv_vsetvl_e32m2(N - jh);
+
+            // accumulatori: uno per ogni riga del tile
+            vfloat32m2_t vc0 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
+            vfloat32m2_t vc1 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
+            vfloat32m2_t vc2 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
+            vfloat32m2_t vc3 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
+            vfloat32m2_t vc4 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
+            vfloat32m2_t vc5 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
+            vfloat32m2_t vc6 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
+            vfloat32m2_t vc7 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
+            vfloat32m2_t vc8 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
+            vfloat32m2_t vc9 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
+            vfloat32m2_t vc10 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
+            vfloat32m2_t vc11 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
+            vfloat32m2_t vc12 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
+            vfloat32m2_t vc13 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
+            vfloat32m2_t vc14 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
+            vfloat32m2_t vc15 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
+
+            #if UNROLL == 2
+            #pragma GCC unroll 2
+            #elif UNROLL == 4
+            #pragma GCC unroll 4
+            #elif UNROLL == 8
+            #pragma GCC unroll 8
+            #elif UNROLL == 16
+            #pragma GCC unroll 16
+            #else
+            #pragma GCC unroll 1
+            #endif
+            for (int k = 0; k < K; ++k) {
+
+                // carica B[k][jh : jh+vl]
+                vfloat32m2_t vb =
+                    __riscv_vle32_v_f32m2(&pB[k * ldp], vl);
+
+                // fused mode: pack the row just loaded
+                if (fused)
+                    __riscv_vse32_v_f32m2(&oB[k * Tw], vb, vl);
+
+                // outer product
+                vc0 = __riscv_vfmacc_vf_f32m2(
+                    vc0, A[ih + 0][k], vb, vl);
+
+                vc1 = __riscv_vfmacc_vf_f32m2(
+                    vc1, A[ih + 1][k], vb, vl);
+
+                vc2 = __riscv_vfmacc_vf_f32m2(
+                    vc2, A[ih + 2][k], vb, vl);
+
+                vc3 = __riscv_vfmacc_vf_f32m2(
+                    vc3, A[ih + 3][k], vb, vl);
+
+                vc4 = __riscv_vfmacc_vf_f32m2(
+                    vc4, A[ih + 4][k], vb, vl);
+
+                vc5 = __riscv_vfmacc_vf_f32m2(
+                    vc5, A[ih + 5][k], vb, vl);
+
+                vc6 = __riscv_vfmacc_vf_f32m2(
+                    vc6, A[ih + 6][k], vb, vl);
+
+                vc7 = __riscv_vfmacc_vf_f32m2(
+                    vc7, A[ih + 7][k], vb, vl);
+
+                vc8 = __riscv_vfmacc_vf_f32m2(
+                    vc8, A[ih + 8][k], vb, vl);
+
+                vc9 = __riscv_vfmacc_vf_f32m2(
+                    vc9, A[ih + 9][k], vb, vl);
+
+                vc10 = __riscv_vfmacc_vf_f32m2(
+                    vc10, A[ih + 10][k], vb, vl);
+
+                vc11 = __riscv_vfmacc_vf_f32m2(
+                    vc11, A[ih + 11][k], vb, vl);
+
+                vc12 = __riscv_vfmacc_vf_f32m2(
+                    vc12, A[ih + 12][k], vb, vl);
+
+                vc13 = __riscv_vfmacc_vf_f32m2(
+                    vc13, A[ih + 13][k], vb, vl);
+
+                vc14 = __riscv_vfmacc_vf_f32m2(
+                    vc14, A[ih + 14][k], vb, vl);
+
+                vc15 = __riscv_vfmacc_vf_f32m2(
+                    vc15, A[ih + 15][k], vb, vl);
+            }
+
+            // store
+            __riscv_vse32_v_f32m2(&C[ih + 0][jh], vc0, vl);
+            __riscv_vse32_v_f32m2(&C[ih + 1][jh], vc1, vl);
+            __riscv_vse32_v_f32m2(&C[ih + 2][jh], vc2, vl);
+            __riscv_vse32_v_f32m2(&C[ih + 3][jh], vc3, vl);
+            __riscv_vse32_v_f32m2(&C[ih + 4][jh], vc4, vl);
+            __riscv_vse32_v_f32m2(&C[ih + 5][jh], vc5, vl);
+            __riscv_vse32_v_f32m2(&C[ih + 6][jh], vc6, vl);
+            __riscv_vse32_v_f32m2(&C[ih + 7][jh], vc7, vl);
+            __riscv_vse32_v_f32m2(&C[ih + 8][jh], vc8, vl);
+            __riscv_vse32_v_f32m2(&C[ih + 9][jh], vc9, vl);
+            __riscv_vse32_v_f32m2(&C[ih + 10][jh], vc10, vl);
+            __riscv_vse32_v_f32m2(&C[ih + 11][jh], vc11, vl);
+            __riscv_vse32_v_f32m2(&C[ih + 12][jh], vc12, vl);
+            __riscv_vse32_v_f32m2(&C[ih + 13][jh], vc13, vl);
+            __riscv_vse32_v_f32m2(&C[ih + 14][jh], vc14, vl);
+            __riscv_vse32_v_f32m2(&C[ih + 15][jh], vc15, vl);
+
+            if( DEBUG_ENABLED >= 3 ){
+                ///printf("Computation block C(%d:%d) finished! \n", ih, jh);
+                printf("> C  iter!!\n");
+                print_lmatrixf32((float*) C, ldc, M * ldc);
+            }
+
+        }
+    }
+
+    if (oB != ws) free(oB);
+}
+
+void kernel_16_m4(float* mat1, float* mat2, float* res, int M, int N, int K, int lda, int ldb, int ldc, float* ws, int pack_mode) {
+
+    float (*A)[lda] = (float (*)[lda]) mat1;
+    float (*B)[ldb] = (float (*)[ldb]) mat2;
+    float (*C)[ldc] = (float (*)[ldc]) res;
+
+    const int Th = 16;
+    int Tw = __riscv_vsetvl_e32m4(N);
+
+    //printf("Tw:%d\n", Tw);
+    
+    // ordered B: K x Tw, in the caller workspace ws if given (pre-packed mode: the panels are already in mat2)
+    float* oB = (ws || pack_mode == PACK_PREPACKED) ? ws : malloc(sizeof(float) * K * Tw);
+
+    size_t vl;
+
+    for (int jh = 0; jh < N; jh += Tw) {
+        for (int ih = 0; ih + Th <= M; ih += Th) {
+        
+            if (ih == 0 && jh % Tw == 0 && pack_mode == PACK_SEPARATE) {
+                reordering_rvv(&B[0][jh], oB, K, ldb, Tw, N - jh);
+
+                if( DEBUG_ENABLED >= 3 ){
+                    printf("ih==0 ==> orderedB");
+                    print_lmatrixf32(oB, Tw, K * Tw);
+                }
+            }
+
+            // fused mode: the first row block reads B directly and fills oB
+            // pre-packed mode: panel jh / Tw is read in place from mat2, ldb is the panel width
+            const int fused = (ih == 0 && pack_mode == PACK_FUSED);
+            const float* pB = fused ? &B[0][jh] : oB;
+            int ldp = fused ? ldb : Tw;
+            if (pack_mode == PACK_PREPACKED) {
+                pB = mat2 + (size_t)(jh / Tw) * K * ldb;
+                ldp = ldb;
+            }
+
+            // Tw deciso a runtime
+            ////vl = __riscv_vsetvl_e32m4(N - jh);
+            vl = __riscv_vsetvl_e32m4(N - jh);
+
+            // accumulatori: uno per ogni riga del tile
+            vfloat32m4_t vc0 = __riscv_vfmv_v_f_f32m4(0.0f, vl);
+            vfloat32m4_t vc1 = __riscv_vfmv_v_f_f32m4(0.0f, vl);
+            vfloat32m4_t vc2 = __riscv_vfmv_v_f_f32m4(0.0f, vl);
+            vfloat32m4_t vc3 = __riscv_vfmv_v_f_f32m4(0.0f, vl);
+            vfloat32m4_t vc4 = __riscv_vfmv_v_f_f32m4(0.0f, vl);
+            vfloat32m4_t vc5 = __riscv_vfmv_v_f_f32m4(0.0f, vl);
+            vfloat32m4_t vc6 = __riscv_vfmv_v_f_f32m4(0.0f, vl);
+            vfloat32m4_t vc7 = __riscv_vfmv_v_f_f32m4(0.0f, vl);
+            vfloat32m4_t vc8 = __riscv_vfmv_v_f_f32m4(0.0f, vl);
+            vfloat32m4_t vc9 = __riscv_vfmv_v_f_f32m4(0.0f, vl);
+            vfloat32m4_t vc10 = __riscv_vfmv_v_f_f32m4(0.0f, vl);
+            vfloat32m4_t vc11 = __riscv_vfmv_v_f_f32m4(0.0f, vl);
+            vfloat32m4_t vc12 = __riscv_vfmv_v_f_f32m4(0.0f, vl);
+            vfloat32m4_t vc13 = __riscv_vfmv_v_f_f32m4(0.0f, vl);
+            vfloat32m4_t vc14 = __riscv_vfmv_v_f_f32m4(0.0f, vl);
+            vfloat32m4_t vc15 = __riscv_vfmv_v_f_f32m4(0.0f, vl);
+
+            #if UNROLL == 2
+            #pragma GCC unroll 2
+            #elif UNROLL == 4
+            #pragma GCC unroll 4
+            #elif UNROLL == 8
+            #pragma GCC unroll 8
+            #elif UNROLL == 16
+            #pragma GCC unroll 16
+            #else
+            #pragma GCC unroll 1
+            #endif
+            for (int k = 0; k < K; ++k) {
+
+                // carica B[k][jh : jh+vl]
+                vfloat32m4_t vb =
+                    __riscv_vle32_v_f32m4(&pB[k * ldp], vl);
+
+                // fused mode: pack the row just loaded
+                if (fused)
+                    __riscv_vse32_v_f32m4(&oB[k * Tw], vb, vl);
+
+                // outer product
+                vc0 = __riscv_vfmacc_vf_f32m4(
+                    vc0, A[ih + 0][k], vb, vl);
+
+                vc1 = __riscv_vfmacc_vf_f32m4(
+                    vc1, A[ih + 1][k], vb, vl);
+
+                vc2 = __riscv_vfmacc_vf_f32m4(
+                    vc2, A[ih + 2][k], vb, vl);
+
+                vc3 = __riscv_vfmacc_vf_f32m4(
+                    vc3, A[ih + 3][k], vb, vl);
+
+                vc4 = __riscv_vfmacc_vf_f32m4(
+                    vc4, A[ih + 4][k], vb, vl);
+
+                vc5 = __riscv_vfmacc_vf_f32m4(
+                    vc5, A[ih + 5][k], vb, vl);
+
+                vc6 = __riscv_vfmacc_vf_f32m4(
+                    vc6, A[ih + 6][k], vb, vl);
+
+                vc7 = __riscv_vfmacc_vf_f32m4(
+                    vc7, A[ih + 7][k], vb, vl);
+
+                vc8 = __riscv_vfmacc_vf_f32m4(
+                    vc8, A[ih + 8][k], vb, vl);
+
+                vc9 = __riscv_vfmacc_vf_f32m4(
+                    vc9, A[ih + 9][k], vb, vl);
+
+                vc10 = __riscv_vfmacc_vf_f32m4(
+                    vc10, A[ih + 10][k], vb, vl);
+
+                vc11 = __riscv_vfmacc_vf_f32m4(
+                    vc11, A[ih + 11][k], vb, vl);
+
+                vc12 = __riscv_vfmacc_vf_f32m4(
+                    vc12, A[ih + 12][k], vb, vl);
+
+                vc13 = __riscv_vfmacc_vf_f32m4(
+                    vc13, A[ih + 13][k], vb, vl);
+
+                vc14 = __riscv_vfmacc_vf_f32m4(
+                    vc14, A[ih + 14][k], vb, vl);
+
+                vc15 = __riscv_vfmacc_vf_f32m4(
+                    vc15, A[ih + 15][k], vb, vl);
+            }
+
+            // store
+            __riscv_vse32_v_f32m4(&C[ih + 0][jh], vc0, vl);
+            __riscv_vse32_v_f32m4(&C[ih + 1][jh], vc1, vl);
+            __riscv_vse32_v_f32m4(&C[ih + 2][jh], vc2, vl);
+            __riscv_vse32_v_f32m4(&C[ih + 3][jh], vc3, vl);
+            __riscv_vse32_v_f32m4(&C[ih + 4][jh], vc4, vl);
+            __riscv_vse32_v_f32m4(&C[ih + 5][jh], vc5, vl);
+            __riscv_vse32_v_f32m4(&C[ih + 6][jh], vc6, vl);
+            __riscv_vse32_v_f32m4(&C[ih + 7][jh], vc7, vl);
+            __riscv_vse32_v_f32m4(&C[ih + 8][jh], vc8, vl);
+            __riscv_vse32_v_f32m4(&C[ih + 9][jh], vc9, vl);
+            __riscv_vse32_v_f32m4(&C[ih + 10][jh], vc10, vl);
+            __riscv_vse32_v_f32m4(&C[ih + 11][jh], vc11, vl);
+            __riscv_vse32_v_f32m4(&C[ih + 12][jh], vc12, vl);
+            __riscv_vse32_v_f32m4(&C[ih + 13][jh], vc13, vl);
+            __riscv_vse32_v_f32m4(&C[ih + 14][jh], vc14, vl);
+            __riscv_vse32_v_f32m4(&C[ih + 15][jh], vc15, vl);
+
+            if( DEBUG_ENABLED >= 3 ){
+                ///printf("Computation block C(%d:%d) finished! \n", ih, jh);
+                printf("> C  iter!!\n");
+                print_lmatrixf32((float*) C, ldc, M * ldc);
+            }
+
+        }
+    }
+
+    if (oB != ws) free(oB);
+}
+
+void kernel_16_m8(float* mat1, float* mat2, float* res, int M, int N, int K, int lda, int ldb, int ldc, float* ws, int pack_mode) {
+
+    float (*A)[lda] = (float (*)[lda]) mat1;
+    float (*B)[ldb] = (float (*)[ldb]) mat2;
+    float (*C)[ldc] = (float (*)[ldc]) res;
+
+    const int Th = 16;
+    int Tw = __riscv_vsetvl_e32m8(N);
+
+    //printf("Tw:%d\n", Tw);
+    
+    // ordered B: K x Tw, in the caller workspace ws if given (pre-packed mode: the panels are already in mat2)
+    float* oB = (ws || pack_mode == PACK_PREPACKED) ? ws : malloc(sizeof(float) * K * Tw);
+
+    size_t vl;
+
+    for (int jh = 0; jh < N; jh += Tw) {
+        for (int ih = 0; ih + Th <= M; ih += Th) {
+        
+            if (ih == 0 && jh % Tw == 0 && pack_mode == PACK_SEPARATE) {
+                reordering_rvv(&B[0][jh], oB, K, ldb, Tw, N - jh);
+
+                if( DEBUG_ENABLED >= 3 ){
+                    printf("ih==0 ==> orderedB");
+                    print_lmatrixf32(oB, Tw, K * Tw);
+                }
+            }
+
+            // fused mode: the first row block reads B directly and fills oB
+            // pre-packed mode: panel jh / Tw is read in place from mat2, ldb is the panel width
+            const int fused = (ih == 0 && pack_mode == PACK_FUSED);
+            const float* pB = fused ? &B[0][jh] : oB;
+            int ldp = fused ? ldb : Tw;
+            if (pack_mode == PACK_PREPACKED) {
+                pB = mat2 + (size_t)(jh / Tw) * K * ldb;
+                ldp = ldb;
+            }
+
+            // Tw deciso a runtime
+            ////vl = __riscv_vsetvl_e32m8(N - jh);
+            vl = __riscv_vsetvl_e32m8(N - jh);
+
+            // accumulatori: uno per ogni riga del tile
+            vfloat32m8_t vc0 = __riscv_vfmv_v_f_f32m8(0.0f, vl);
+            vfloat32m8_t vc1 = __riscv_vfmv_v_f_f32m8(0.0f, vl);
+            vfloat32m8_t vc2 = __riscv_vfmv_v_f_f32m8(0.0f, vl);
+            vfloat32m8_t vc3 = __riscv_vfmv_v_f_f32m8(0.0f, vl);
+            vfloat32m8_t vc4 = __riscv_vfmv_v_f_f32m8(0.0f, vl);
+            vfloat32m8_t vc5 = __riscv_vfmv_v_f_f32m8(0.0f, vl);
+            vfloat32m8_t vc6 = __riscv_vfmv_v_f_f32m8(0.0f, vl);
+            vfloat32m8_t vc7 = __riscv_vfmv_v_f_f32m8(0.0f, vl);
+            vfloat32m8_t vc8 = __riscv_vfmv_v_f_f32m8(0.0f, vl);
+            vfloat32m8_t vc9 = __riscv_vfmv_v_f_f32m8(0.0f, vl);
+            vfloat32m8_t vc10 = __riscv_vfmv_v_f_f32m8(0.0f, vl);
+            vfloat32m8_t vc11 = __riscv_vfmv_v_f_f32m8(0.0f, vl);
+            vfloat32m8_t vc12 = __riscv_vfmv_v_f_f32m8(0.0f, vl);
+            vfloat32m8_t vc13 = __riscv_vfmv_v_f_f32m8(0.0f, vl);
+            vfloat32m8_t vc14 = __riscv_vfmv_v_f_f32m8(0.0f, vl);
+            vfloat32m8_t vc15 = __riscv_vfmv_v_f_f32m8(0.0f, vl);
+
+            #if UNROLL == 2
+            #pragma GCC unroll 2
+            #elif UNROLL == 4
+            #pragma GCC unroll 4
+            #elif UNROLL == 8
+            #pragma GCC unroll 8
+            #elif UNROLL == 16
+            #pragma GCC unroll 16
+            #else
+            #pragma GCC unroll 1
+            #endif
+            for (int k = 0; k < K; ++k) {
+
+                // carica B[k][jh : jh+vl]
+                vfloat32m8_t vb =
+                    __riscv_vle32_v_f32m8(&pB[k * ldp], vl);
+
+                // fused mode: pack the row just loaded
+                if (fused)
+                    __riscv_vse32_v_f32m8(&oB[k * Tw], vb, vl);
+
+                // outer product
+                vc0 = __riscv_vfmacc_vf_f32m8(
+                    vc0, A[ih + 0][k], vb, vl);
+
+                vc1 = __riscv_vfmacc_vf_f32m8(
+                    vc1, A[ih + 1][k], vb, vl);
+
+                vc2 = __riscv_vfmacc_vf_f32m8(
+                    vc2, A[ih + 2][k], vb, vl);
+
+                vc3 = __riscv_vfmacc_vf_f32m8(
+                    vc3, A[ih + 3][k], vb, vl);
+
+                vc4 = __riscv_vfmacc_vf_f32m8(
+                    vc4, A[ih + 4][k], vb, vl);
+
+                vc5 = __riscv_vfmacc_vf_f32m8(
+                    vc5, A[ih + 5][k], vb, vl);
+
+                vc6 = __riscv_vfmacc_vf_f32m8(
+                    vc6, A[ih + 6][k], vb, vl);
+
+                vc7 = __riscv_vfmacc_vf_f32m8(
+                    vc7, A[ih + 7][k], vb, vl);
+
+                vc8 = __riscv_vfmacc_vf_f32m8(
+                    vc8, A[ih + 8][k], vb, vl);
+
+                vc9 = __riscv_vfmacc_vf_f32m8(
+                    vc9, A[ih + 9][k], vb, vl);
+
+                vc10 = __riscv_vfmacc_vf_f32m8(
+                    vc10, A[ih + 10][k], vb, vl);
+
+                vc11 = __riscv_vfmacc_vf_f32m8(
+                    vc11, A[ih + 11][k], vb, vl);
+
+                vc12 = __riscv_vfmacc_vf_f32m8(
+                    vc12, A[ih + 12][k], vb, vl);
+
+                vc13 = __riscv_vfmacc_vf_f32m8(
+                    vc13, A[ih + 13][k], vb, vl);
+
+                vc14 = __riscv_vfmacc_vf_f32m8(
+                    vc14, A[ih + 14][k], vb, vl);
+
+                vc15 = __riscv_vfmacc_vf_f32m8(
+                    vc15, A[ih + 15][k], vb, vl);
+            }
+
+            // store
+            __riscv_vse32_v_f32m8(&C[ih + 0][jh], vc0, vl);
+            __riscv_vse32_v_f32m8(&C[ih + 1][jh], vc1, vl);
+            __riscv_vse32_v_f32m8(&C[ih + 2][jh], vc2, vl);
+            __riscv_vse32_v_f32m8(&C[ih + 3][jh], vc3, vl);
+            __riscv_vse32_v_f32m8(&C[ih + 4][jh], vc4, vl);
+            __riscv_vse32_v_f32m8(&C[ih + 5][jh], vc5, vl);
+            __riscv_vse32_v_f32m8(&C[ih + 6][jh], vc6, vl);
+            __riscv_vse32_v_f32m8(&C[ih + 7][jh], vc7, vl);
+            __riscv_vse32_v_f32m8(&C[ih + 8][jh], vc8, vl);
+            __riscv_vse32_v_f32m8(&C[ih + 9][jh], vc9, vl);
+            __riscv_vse32_v_f32m8(&C[ih + 10][jh], vc10, vl);
+            __riscv_vse32_v_f32m8(&C[ih + 11][jh], vc11, vl);
+            __riscv_vse32_v_f32m8(&C[ih + 12][jh], vc12, vl);
+            __riscv_vse32_v_f32m8(&C[ih + 13][jh], vc13, vl);
+            __riscv_vse32_v_f32m8(&C[ih + 14][jh], vc14, vl);
+            __riscv_vse32_v_f32m8(&C[ih + 15][jh], vc15, vl);
+
+            if( DEBUG_ENABLED >= 3 ){
+                ///printf("Computation block C(%d:%d) finished! \n", ih, jh);
+                printf("> C  iter!!\n");
+                print_lmatrixf32((float*) C, ldc, M * ldc);
+            }
+
+        }
+    }
+
+    if (oB != ws) free(oB);
+}
+
+void kernel_16_mf2(float* mat1, float* mat2, float* res, int M, int N, int K, int lda, int ldb, int ldc, float* ws, int pack_mode) {
+
+    float (*A)[lda] = (float (*)[lda]) mat1;
+    float (*B)[ldb] = (float (*)[ldb]) mat2;
+    float (*C)[ldc] = (float (*)[ldc]) res;
+
+    const int Th = 16;
+    int Tw = __riscv_vsetvl_e32mf2(N);
+
+    //printf("Tw:%d\n", Tw);
+    
+    // ordered B: K x Tw, in the caller workspace ws if given (pre-packed mode: the panels are already in mat2)
+    float* oB = (ws || pack_mode == PACK_PREPACKED) ? ws : malloc(sizeof(float) * K * Tw);
+
+    size_t vl;
+
+    for (int jh = 0; jh < N; jh += Tw) {
+        for (int ih = 0; ih + Th <= M; ih += Th) {
+        
+            if (ih == 0 && jh % Tw == 0 && pack_mode == PACK_SEPARATE) {
+                reordering_rvv(&B[0][jh], oB, K, ldb, Tw, N - jh);
+
+                if( DEBUG_ENABLED >= 3 ){
+                    printf("ih==0 ==> orderedB");
+                    print_lmatrixf32(oB, Tw, K * Tw);
+                }
+            }
+
+            // fused mode: the first row block reads B directly and fills oB
+            // pre-packed mode: panel jh / Tw is read in place from mat2, ldb is the panel width
+            const int fused = (ih == 0 && pack_mode == PACK_FUSED);
+            const float* pB = fused ? &B[0][jh] : oB;
+            int ldp = fused ? ldb : Tw;
+            if (pack_mode == PACK_PREPACKED) {
+                pB = mat2 + (size_t)(jh / Tw) * K * ldb;
+                ldp = ldb;
+            }
+
+            // Tw deciso a runtime
+            ////vl = __riscv_vsetvl_e32mf2(N - jh);
+            vl = __riscv_vsetvl_e32mf2(N - jh);
+
+            // accumulatori: uno per ogni riga del tile
+            vfloat32mf2_t vc0 = __riscv_vfmv_v_f_f32mf2(0.0f, vl);
+            vfloat32mf2_t vc1 = __riscv_vfmv_v_f_f32mf2(0.0f, vl);
+            vfloat32mf2_t vc2 = __riscv_vfmv_v_f_f32mf2(0.0f, vl);
+            vfloat32mf2_t vc3 = __riscv_vfmv_v_f_f32mf2(0.0f, vl);
+            vfloat32mf2_t vc4 = __riscv_vfmv_v_f_f32mf2(0.0f, vl);
+            vfloat32mf2_t vc5 = __riscv_vfmv_v_f_f32mf2(0.0f, vl);
+            vfloat32mf2_t vc6 = __riscv_vfmv_v_f_f32mf2(0.0f, vl);
+            vfloat32mf2_t vc7 = __riscv_vfmv_v_f_f32mf2(0.0f, vl);
+            vfloat32mf2_t vc8 = __riscv_vfmv_v_f_f32mf2(0.0f, vl);
+            vfloat32mf2_t vc9 = __riscv_vfmv_v_f_f32mf2(0.0f, vl);
+            vfloat32mf2_t vc10 = __riscv_vfmv_v_f_f32mf2(0.0f, vl);
+            vfloat32mf2_t vc11 = __riscv_vfmv_v_f_f32mf2(0.0f, vl);
+            vfloat32mf2_t vc12 = __riscv_vfmv_v_f_f32mf2(0.0f, vl);
+            vfloat32mf2_t vc13 = __riscv_vfmv_v_f_f32mf2(0.0f, vl);
+            vfloat32mf2_t vc14 = __riscv_vfmv_v_f_f32mf2(0.0f, vl);
+            vfloat32mf2_t vc15 = __riscv_vfmv_v_f_f32mf2(0.0f, vl);
+
+            #if UNROLL == 2
+            #pragma GCC unroll 2
+            #elif UNROLL == 4
+            #pragma GCC unroll 4
+            #elif UNROLL == 8
+            #pragma GCC unroll 8
+            #elif UNROLL == 16
+            #pragma GCC unroll 16
+            #else
+            #pragma GCC unroll 1
+            #endif
+            for (int k = 0; k < K; ++k) {
+
+                // carica B[k][jh : jh+vl]
+                vfloat32mf2_t vb =
+                    __riscv_vle32_v_f32mf2(&pB[k * ldp], vl);
+
+                // fused mode: pack the row just loaded
+                if (fused)
+                    __riscv_vse32_v_f32mf2(&oB[k * Tw], vb, vl);
+
+                // outer product
+                vc0 = __riscv_vfmacc_vf_f32mf2(
+                    vc0, A[ih + 0][k], vb, vl);
+
+                vc1 = __riscv_vfmacc_vf_f32mf2(
+                    vc1, A[ih + 1][k], vb, vl);
+
+                vc2 = __riscv_vfmacc_vf_f32mf2(
+                    vc2, A[ih + 2][k], vb, vl);
+
+                vc3 = __riscv_vfmacc_vf_f32mf2(
+                    vc3, A[ih + 3][k], vb, vl);
+
+                vc4 = __riscv_vfmacc_vf_f32mf2(
+                    vc4, A[ih + 4][k], vb, vl);
+
+                vc5 = __riscv_vfmacc_vf_f32mf2(
+                    vc5, A[ih + 5][k], vb, vl);
+
+                vc6 = __riscv_vfmacc_vf_f32mf2(
+                    vc6, A[ih + 6][k], vb, vl);
+
+                vc7 = __riscv_vfmacc_vf_f32mf2(
+                    vc7, A[ih + 7][k], vb, vl);
+
+                vc8 = __riscv_vfmacc_vf_f32mf2(
+                    vc8, A[ih + 8][k], vb, vl);
+
+                vc9 = __riscv_vfmacc_vf_f32mf2(
+                    vc9, A[ih + 9][k], vb, vl);
+
+                vc10 = __riscv_vfmacc_vf_f32mf2(
+                    vc10, A[ih + 10][k], vb, vl);
+
+                vc11 = __riscv_vfmacc_vf_f32mf2(
+                    vc11, A[ih + 11][k], vb, vl);
+
+                vc12 = __riscv_vfmacc_vf_f32mf2(
+                    vc12, A[ih + 12][k], vb, vl);
+
+                vc13 = __riscv_vfmacc_vf_f32mf2(
+                    vc13, A[ih + 13][k], vb, vl);
+
+                vc14 = __riscv_vfmacc_vf_f32mf2(
+                    vc14, A[ih + 14][k], vb, vl);
+
+                vc15 = __riscv_vfmacc_vf_f32mf2(
+                    vc15, A[ih + 15][k], vb, vl);
+            }
+
+            // store
+            __riscv_vse32_v_f32mf2(&C[ih + 0][jh], vc0, vl);
+            __riscv_vse32_v_f32mf2(&C[ih + 1][jh], vc1, vl);
+            __riscv_vse32_v_f32mf2(&C[ih + 2][jh], vc2, vl);
+            __riscv_vse32_v_f32mf2(&C[ih + 3][jh], vc3, vl);
+            __riscv_vse32_v_f32mf2(&C[ih + 4][jh], vc4, vl);
+            __riscv_vse32_v_f32mf2(&C[ih + 5][jh], vc5, vl);
+            __riscv_vse32_v_f32mf2(&C[ih + 6][jh], vc6, vl);
+            __riscv_vse32_v_f32mf2(&C[ih + 7][jh], vc7, vl);
+            __riscv_vse32_v_f32mf2(&C[ih + 8][jh], vc8, vl);
+            __riscv_vse32_v_f32mf2(&C[ih + 9][jh], vc9, vl);
+            __riscv_vse32_v_f32mf2(&C[ih + 10][jh], vc10, vl);
+            __riscv_vse32_v_f32mf2(&C[ih + 11][jh], vc11, vl);
+            __riscv_vse32_v_f32mf2(&C[ih + 12][jh], vc12, vl);
+            __riscv_vse32_v_f32mf2(&C[ih + 13][jh], vc13, vl);
+            __riscv_vse32_v_f32mf2(&C[ih + 14][jh], vc14, vl);
+            __riscv_vse32_v_f32mf2(&C[ih + 15][jh], vc15, vl);
+
+            if( DEBUG_ENABLED >= 3 ){
+                ///printf("Computation block C(%d:%d) finished! \n", ih, jh);
+                printf("> C  iter!!\n");
+                print_lmatrixf32((float*) C, ldc, M * ldc);
+            }
+
+        }
+    }
+
+    if (oB != ws) free(oB);
+}
+
+
+/*
+ * TAIL ROWS
+ * rows [i0, M) not covered by the Th x Tw tiles (M % Th != 0).
+ * B is streamed directly, no reordering: the rows are at most Th-1.
+ */
+void tail_rows(float* mat1, float* mat2, float* res, int i0, int M, int N, int K, int lda, int ldb, int ldc) {
+
+    float (*A)[lda] = (float (*)[lda]) mat1;
+    float (*B)[ldb] = (float (*)[ldb]) mat2;
+    float (*C)[ldc] = (float (*)[ldc]) res;
+
+    size_t vl;
+
+    for (int i = i0; i < M; i++) {
+        for (int jh = 0; jh < N; jh += vl) {
+            vl = __riscv_vsetvl_e32m4(N - jh);
+
+            vfloat32m4_t vc = __riscv_vfmv_v_f_f32m4(0.0f, vl);
+
+            for (int k = 0; k < K; ++k) {
+                vfloat32m4_t vb = __riscv_vle32_v_f32m4(&B[k][jh], vl);
+                vc = __riscv_vfmacc_vf_f32m4(vc, A[i][k], vb, vl);
+            }
+
+            __riscv_vse32_v_f32m4(&C[i][jh], vc, vl);
+        }
+    }
+}
+
+
+/*
+ * B-STATIONARY KERNELS (kernel_bs_m{L})
+ * Kb=8 rows of the B strip B[kh:kh+8][jh:jh+vl] stay in vb0..vb7 while all the
+ * rows of A stream: every row of C is updated with 8 fma and written back.
+ * For tall-skinny shapes (M >> N, small K) B is read once and never reordered,
+ * C is read/written ceil(K / Kb) times.
+ */
+void kernel_bs_m1(float* mat1, float* mat2, float* res, int M, int N, int K, int lda, int ldb, int ldc) {
+
+    float (*A)[lda] = (float (*)[lda]) mat1;
+    float (*B)[ldb] = (float (*)[ldb]) mat2;
+    float (*C)[ldc] = (float (*)[ldc]) res;
+
+    const int Kb = 8;
+    size_t vl;
+
+    for (int jh = 0; jh < N; jh += vl) {
+        vl = __riscv_vsetvl_e32m1(N - jh);
+
+        int kh = 0;
+        for (; kh + Kb <= K; kh += Kb) {
+
+            // B strip resident in registers
+            vfloat32m1_t vb0 = __riscv_vle32_v_f32m1(&B[kh + 0][jh], vl);
+            vfloat32m1_t vb1 = __riscv_vle32_v_f32m1(&B[kh + 1][jh], vl);
+            vfloat32m1_t vb2 = __riscv_vle32_v_f32m1(&B[kh + 2][jh], vl);
+            vfloat32m1_t vb3 = __riscv_vle32_v_f32m1(&B[kh + 3][jh], vl);
+            vfloat32m1_t vb4 = __riscv_vle32_v_f32m1(&B[kh + 4][jh], vl);
+            vfloat32m1_t vb5 = __riscv_vle32_v_f32m1(&B[kh + 5][jh], vl);
+            vfloat32m1_t vb6 = __riscv_vle32_v_f32m1(&B[kh + 6][jh], vl);
+            vfloat32m1_t vb7 = __riscv_vle32_v_f32m1(&B[kh + 7][jh], vl);
+
+            for (int i = 0; i < M; i++) {
+                vfloat32m1_t vc = (kh == 0)
+                    ? __riscv_vfmv_v_f_f32m1(0.0f, vl)
+                    : __riscv_vle32_v_f32m1(&C[i][jh], vl);
+
+                vc = __riscv_vfmacc_vf_f32m1(vc, A[i][kh + 0], vb0, vl);
+                vc = __riscv_vfmacc_vf_f32m1(vc, A[i][kh + 1], vb1, vl);
+                vc = __riscv_vfmacc_vf_f32m1(vc, A[i][kh + 2], vb2, vl);
+                vc = __riscv_vfmacc_vf_f32m1(vc, A[i][kh + 3], vb3, vl);
+                vc = __riscv_vfmacc_vf_f32m1(vc, A[i][kh + 4], vb4, vl);
+                vc = __riscv_vfmacc_vf_f32m1(vc, A[i][kh + 5], vb5, vl);
+                vc = __riscv_vfmacc_vf_f32m1(vc, A[i][kh + 6], vb6, vl);
+                vc = __riscv_vfmacc_vf_f32m1(vc, A[i][kh + 7], vb7, vl);
+
+                __riscv_vse32_v_f32m1(&C[i][jh], vc, vl);
+            }
+        }
+
+        // tail: remaining K % Kb rows of B, one at a time
+        for (; kh < K; kh++) {
+            vfloat32m1_t vb = __riscv_vle32_v_f32m1(&B[kh][jh], vl);
+
+            for (int i = 0; i < M; i++) {
+                vfloat32m1_t vc = (kh == 0)
+                    ? __riscv_vfmv_v_f_f32m1(0.0f, vl)
+                    : __riscv_vle32_v_f32m1(&C[i][jh], vl);
+
+                vc = __riscv_vfmacc_vf_f32m1(vc, A[i][kh], vb, vl);
+
+                __riscv_vse32_v_f32m1(&C[i][jh], vc, vl);
+            }
+        }
+    }
+}
+
+void kernel_bs_m2(float* mat1, float* mat2, float* res, int M, int N, int K, int lda, int ldb, int ldc) {
+
+    float (*A)[lda] = (float (*)[lda]) mat1;
+    float (*B)[ldb] = (float (*)[ldb]) mat2;
+    float (*C)[ldc] = (float (*)[ldc]) res;
+
+    const int Kb = 8;
+    size_t vl;
+
+    for (int jh = 0; jh < N; jh += vl) {
+        vl = __riscv_vsetvl_e32m2(N - jh);
+
+        int kh = 0;
+        for (; kh + Kb <= K; kh += Kb) {
+
+            // B strip resident in registers
+            vfloat32m2_t vb0 = __riscv_vle32_v_f32m2(&B[kh + 0][jh], vl);
+            vfloat32m2_t vb1 = __riscv_vle32_v_f32m2(&B[kh + 1][jh], vl);
+            vfloat32m2_t vb2 = __riscv_vle32_v_f32m2(&B[kh + 2][jh], vl);
+            vfloat32m2_t vb3 = __riscv_vle32_v_f32m2(&B[kh + 3][jh], vl);
+            vfloat32m2_t vb4 = __riscv_vle32_v_f32m2(&B[kh + 4][jh], vl);
+            vfloat32m2_t vb5 = __riscv_vle32_v_f32m2(&B[kh + 5][jh], vl);
+            vfloat32m2_t vb6 = __riscv_vle32_v_f32m2(&B[kh + 6][jh], vl);
+            vfloat32m2_t vb7 = __riscv_vle32_v_f32m2(&B[kh + 7][jh], vl);
+
+            for (int i = 0; i < M; i++) {
+                vfloat32m2_t vc = (kh == 0)
+                    ? __riscv_vfmv_v_f_f32m2(0.0f, vl)
+                    : __riscv_vle32_v_f32m2(&C[i][jh], vl);
+
+                vc = __riscv_vfmacc_vf_f32m2(vc, A[i][kh + 0], vb0, vl);
+                vc = __riscv_vfmacc_vf_f32m2(vc, A[i][kh + 1], vb1, vl);
+                vc = __riscv_vfmacc_vf_f32m2(vc, A[i][kh + 2], vb2, vl);
+                vc = __riscv_vfmacc_vf_f32m2(vc, A[i][kh + 3], vb3, vl);
+                vc = __riscv_vfmacc_vf_f32m2(vc, A[i][kh + 4], vb4, vl);
+                vc = __riscv_vfmacc_vf_f32m2(vc, A[i][kh + 5], vb5, vl);
+                vc = __riscv_vfmacc_vf_f32m2(vc, A[i][kh + 6], vb6, vl);
+                vc = __riscv_vfmacc_vf_f32m2(vc, A[i][kh + 7], vb7, vl);
+
+                __riscv_vse32_v_f32m2(&C[i][jh], vc, vl);
+            }
+        }
+
+        // tail: remaining K % Kb rows of B, one at a time
+        for (; kh < K; kh++) {
+            vfloat32m2_t vb = __riscv_vle32_v_f32m2(&B[kh][jh], vl);
+
+            for (int i = 0; i < M; i++) {
+                vfloat32m2_t vc = (kh == 0)
+                    ? __riscv_vfmv_v_f_f32m2(0.0f, vl)
+                    : __riscv_vle32_v_f32m2(&C[i][jh], vl);
+
+                vc = __riscv_vfmacc_vf_f32m2(vc, A[i][kh], vb, vl);
+
+                __riscv_vse32_v_f32m2(&C[i][jh], vc, vl);
+            }
+        }
+    }
+}
+
+
+/*
+ * A-STATIONARY KERNELS (kernel_as_{Th}_m1)
+ * the block A[ih:ih+Th][kh:kh+Ka] is loaded as vectors (va0..) and stays in
+ * registers while all the columns of B stream; the scalar A[ih+r][kh+l] is
+ * broadcast from lane l with vrgather (vector-vector fma, see test/test_fma_vv_sv.c).
+ * For short-wide shapes (few rows of A, large N) B is read once without reordering
+ * and A once, C is read/written ceil(K / Ka) times.
+ * Ka = VLMAX(e32m1), so A and B share the same register type.
+ */
+void kernel_as_4_m1(float* mat1, float* mat2, float* res, int M, int N, int K, int lda, int ldb, int ldc) {
+
+    float (*A)[lda] = (float (*)[lda]) mat1;
+    float (*B)[ldb] = (float (*)[ldb]) mat2;
+    float (*C)[ldc] = (float (*)[ldc]) res;
+
+    const int Th = 4;
+    size_t ka, vl;
+
+    for (int ih = 0; ih + Th <= M; ih += Th) {
+        for (int kh = 0; kh < K; kh += ka) {
+
+            // A block resident in registers
+            ka = __riscv_vsetvl_e32m1(K - kh);
+            vfloat32m1_t va0 = __riscv_vle32_v_f32m1(&A[ih + 0][kh], ka);
+            vfloat32m1_t va1 = __riscv_vle32_v_f32m1(&A[ih + 1][kh], ka);
+            vfloat32m1_t va2 = __riscv_vle32_v_f32m1(&A[ih + 2][kh], ka);
+            vfloat32m1_t va3 = __riscv_vle32_v_f32m1(&A[ih + 3][kh], ka);
+
+            for (int jh = 0; jh < N; jh += vl) {
+                vl = __riscv_vsetvl_e32m1(N - jh);
+
+                vfloat32m1_t vc0, vc1, vc2, vc3;
+                if (kh == 0) {
+                    vc0 = __riscv_vfmv_v_f_f32m1(0.0f, vl);
+                    vc1 = __riscv_vfmv_v_f_f32m1(0.0f, vl);
+                    vc2 = __riscv_vfmv_v_f_f32m1(0.0f, vl);
+                    vc3 = __riscv_vfmv_v_f_f32m1(0.0f, vl);
+                } else {
+                    vc0 = __riscv_vle32_v_f32m1(&C[ih + 0][jh], vl);
+                    vc1 = __riscv_vle32_v_f32m1(&C[ih + 1][jh], vl);
+                    vc2 = __riscv_vle32_v_f32m1(&C[ih + 2][jh], vl);
+                    vc3 = __riscv_vle32_v_f32m1(&C[ih + 3][jh], vl);
+                }
+
+                for (size_t l = 0; l < ka; l++) {
+                    vfloat32m1_t vb = __riscv_vle32_v_f32m1(&B[kh + l][jh], vl);
+
+                    // lane broadcast of A[ih + r][kh + l]
+                    vc0 = __riscv_vfmacc_vv_f32m1(vc0, __riscv_vrgather_vx_f32m1(va0, l, vl), vb, vl);
+                    vc1 = __riscv_vfmacc_vv_f32m1(vc1, __riscv_vrgather_vx_f32m1(va1, l, vl), vb, vl);
+                    vc2 = __riscv_vfmacc_vv_f32m1(vc2, __riscv_vrgather_vx_f32m1(va2, l, vl), vb, vl);
+                    vc3 = __riscv_vfmacc_vv_f32m1(vc3, __riscv_vrgather_vx_f32m1(va3, l, vl), vb, vl);
+                }
+
+                __riscv_vse32_v_f32m1(&C[ih + 0][jh], vc0, vl);
+                __riscv_vse32_v_f32m1(&C[ih + 1][jh], vc1, vl);
+                __riscv_vse32_v_f32m1(&C[ih + 2][jh], vc2, vl);
+                __riscv_vse32_v_f32m1(&C[ih + 3][jh], vc3, vl);
+            }
+        }
+    }
+}
+
+void kernel_as_8_m1(float* mat1, float* mat2, float* res, int M, int N, int K, int lda, int ldb, int ldc) {
+
+    float (*A)[lda] = (float (*)[lda]) mat1;
+    float (*B)[ldb] = (float (*)[ldb]) mat2;
+    float (*C)[ldc] = (float (*)[ldc]) res;
+
+    const int Th = 8;
+    size_t ka, vl;
+
+    for (int ih = 0; ih + Th <= M; ih += Th) {
+        for (int kh = 0; kh < K; kh += ka) {
+
+            // A block resident in registers
+            ka = __riscv_vsetvl_e32m1(K - kh);
+            vfloat32m1_t va0 = __riscv_vle32_v_f32m1(&A[ih + 0][kh], ka);
+            vfloat32m1_t va1 = __riscv_vle32_v_f32m1(&A[ih + 1][kh], ka);
+            vfloat32m1_t va2 = __riscv_vle32_v_f32m1(&A[ih + 2][kh], ka);
+            vfloat32m1_t va3 = __riscv_vle32_v_f32m1(&A[ih + 3][kh], ka);
+            vfloat32m1_t va4 = __riscv_vle32_v_f32m1(&A[ih + 4][kh], ka);
+            vfloat32m1_t va5 = __riscv_vle32_v_f32m1(&A[ih + 5][kh], ka);
+            vfloat32m1_t va6 = __riscv_vle32_v_f32m1(&A[ih + 6][kh], ka);
+            vfloat32m1_t va7 = __riscv_vle32_v_f32m1(&A[ih + 7][kh], ka);
+
+            for (int jh = 0; jh < N; jh += vl) {
+                vl = __riscv_vsetvl_e32m1(N - jh);
+
+                vfloat32m1_t vc0, vc1, vc2, vc3, vc4, vc5, vc6, vc7;
+                if (kh == 0) {
+                    vc0 = __riscv_vfmv_v_f_f32m1(0.0f, vl);
+                    vc1 = __riscv_vfmv_v_f_f32m1(0.0f, vl);
+                    vc2 = __riscv_vfmv_v_f_f32m1(0.0f, vl);
+                    vc3 = __riscv_vfmv_v_f_f32m1(0.0f, vl);
+                    vc4 = __riscv_vfmv_v_f_f32m1(0.0f, vl);
+                    vc5 = __riscv_vfmv_v_f_f32m1(0.0f, vl);
+                    vc6 = __riscv_vfmv_v_f_f32m1(0.0f, vl);
+                    vc7 = __riscv_vfmv_v_f_f32m1(0.0f, vl);
+                } else {
+                    vc0 = __riscv_vle32_v_f32m1(&C[ih + 0][jh], vl);
+                    vc1 = __riscv_vle32_v_f32m1(&C[ih + 1][jh], vl);
+                    vc2 = __riscv_vle32_v_f32m1(&C[ih + 2][jh], vl);
+                    vc3 = __riscv_vle32_v_f32m1(&C[ih + 3][jh], vl);
+                    vc4 = __riscv_vle32_v_f32m1(&C[ih + 4][jh], vl);
+                    vc5 = __riscv_vle32_v_f32m1(&C[ih + 5][jh], vl);
+                    vc6 = __riscv_vle32_v_f32m1(&C[ih + 6][jh], vl);
+                    vc7 = __riscv_vle32_v_f32m1(&C[ih + 7][jh], vl);
+                }
+
+                for (size_t l = 0; l < ka; l++) {
+                    vfloat32m1_t vb = __riscv_vle32_v_f32m1(&B[kh + l][jh], vl);
+
+                    // lane broadcast of A[ih + r][kh + l]
+                    vc0 = __riscv_vfmacc_vv_f32m1(vc0, __riscv_vrgather_vx_f32m1(va0, l, vl), vb, vl);
+                    vc1 = __riscv_vfmacc_vv_f32m1(vc1, __riscv_vrgather_vx_f32m1(va1, l, vl), vb, vl);
+                    vc2 = __riscv_vfmacc_vv_f32m1(vc2, __riscv_vrgather_vx_f32m1(va2, l, vl), vb, vl);
+                    vc3 = __riscv_vfmacc_vv_f32m1(vc3, __riscv_vrgather_vx_f32m1(va3, l, vl), vb, vl);
+                    vc4 = __riscv_vfmacc_vv_f32m1(vc4, __riscv_vrgather_vx_f32m1(va4, l, vl), vb, vl);
+                    vc5 = __riscv_vfmacc_vv_f32m1(vc5, __riscv_vrgather_vx_f32m1(va5, l, vl), vb, vl);
+                    vc6 = __riscv_vfmacc_vv_f32m1(vc6, __riscv_vrgather_vx_f32m1(va6, l, vl), vb, vl);
+                    vc7 = __riscv_vfmacc_vv_f32m1(vc7, __riscv_vrgather_vx_f32m1(va7, l, vl), vb, vl);
+                }
+
+                __riscv_vse32_v_f32m1(&C[ih + 0][jh], vc0, vl);
+                __riscv_vse32_v_f32m1(&C[ih + 1][jh], vc1, vl);
+                __riscv_vse32_v_f32m1(&C[ih + 2][jh], vc2, vl);
+                __riscv_vse32_v_f32m1(&C[ih + 3][jh], vc3, vl);
+                __riscv_vse32_v_f32m1(&C[ih + 4][jh], vc4, vl);
+                __riscv_vse32_v_f32m1(&C[ih + 5][jh], vc5, vl);
+                __riscv_vse32_v_f32m1(&C[ih + 6][jh], vc6, vl);
+                __riscv_vse32_v_f32m1(&C[ih + 7][jh], vc7, vl);
+            }
+        }
+    }
+}
+
+
+/*
+ * GEMV / SHORT-WIDE (kernel_sw)
+ * M <= 8 (decoder inference): the M rows of C for one column chunk stay in
+ * registers while B streams once, row-major and never packed; every B element
+ * is loaded once and used M times. Bandwidth-bound by design.
+ * Up to 4 rows per chunk with m4 (20 registers), 5..8 rows with m2 (18 registers).
+ * gemv_t (y = x^T B) is the single row, with two accumulators on even/odd k
+ * so the fma chain does not serialise on the latency.
+ */
+void gemv_t(const float* x, const float* B, float* y, int K, int N, int ldb) {
+
+    size_t vl;
+
+    for (int jh = 0; jh < N; jh += vl) {
+        vl = __riscv_vsetvl_e32m4(N - jh);
+
+        vfloat32m4_t vc0 = __riscv_vfmv_v_f_f32m4(0.0f, vl);
+        vfloat32m4_t vc1 = __riscv_vfmv_v_f_f32m4(0.0f, vl);
+
+        int k = 0;
+        for (; k + 2 <= K; k += 2) {
+            vfloat32m4_t vb0 = __riscv_vle32_v_f32m4(&B[(size_t)(k + 0) * ldb + jh], vl);
+            vfloat32m4_t vb1 = __riscv_vle32_v_f32m4(&B[(size_t)(k + 1) * ldb + jh], vl);
+            vc0 = __riscv_vfmacc_vf_f32m4(vc0, x[k + 0], vb0, vl);
+            vc1 = __riscv_vfmacc_vf_f32m4(vc1, x[k + 1], vb1, vl);
+        }
+        if (k < K) {
+            vfloat32m4_t vb0 = __riscv_vle32_v_f32m4(&B[(size_t)k * ldb + jh], vl);
+            vc0 = __riscv_vfmacc_vf_f32m4(vc0, x[k], vb0, vl);
+        }
+
+        __riscv_vse32_v_f32m4(&y[jh], __riscv_vfadd_vv_f32m4(vc0, vc1, vl), vl);
+    }
+}
+
+// R rows (constant once inlined: the unused accumulators disappear)
+static inline __attribute__((always_inline))
+void short_wide_m4(const float* A, const float* B, float* C, const int R, int N, int K, int lda, int ldb, int ldc) {
+
+    size_t vl;
+
+    for (int jh = 0; jh < N; jh += vl) {
+        vl = __riscv_vsetvl_e32m4(N - jh);
+
+        vfloat32m4_t vc0 = __riscv_vfmv_v_f_f32m4(0.0f, vl);
+        vfloat32m4_t vc1 = __riscv_vfmv_v_f_f32m4(0.0f, vl);
+        vfloat32m4_t vc2 = __riscv_vfmv_v_f_f32m4(0.0f, vl);
+        vfloat32m4_t vc3 = __riscv_vfmv_v_f_f32m4(0.0f, vl);
+
+        for (int k = 0; k < K; k++) {
+            vfloat32m4_t vb = __riscv_vle32_v_f32m4(&B[(size_t)k * ldb + jh], vl);
+
+            vc0 = __riscv_vfmacc_vf_f32m4(vc0, A[0 * lda + k], vb, vl);
+            if (R > 1) vc1 = __riscv_vfmacc_vf_f32m4(vc1, A[1 * lda + k], vb, vl);
+            if (R > 2) vc2 = __riscv_vfmacc_vf_f32m4(vc2, A[2 * lda + k], vb, vl);
+            if (R > 3) vc3 = __riscv_vfmacc_vf_f32m4(vc3, A[3 * lda + k], vb, vl);
+        }
+
+        __riscv_vse32_v_f32m4(&C[0 * ldc + jh], vc0, vl);
+        if (R > 1) __riscv_vse32_v_f32m4(&C[1 * ldc + jh], vc1, vl);
+        if (R > 2) __riscv_vse32_v_f32m4(&C[2 * ldc + jh], vc2, vl);
+        if (R > 3) __riscv_vse32_v_f32m4(&C[3 * ldc + jh], vc3, vl);
+    }
+}
+
+static inline __attribute__((always_inline))
+void short_wide_m2(const float* A, const float* B, float* C, const int R, int N, int K, int lda, int ldb, int ldc) {
+
+    size_t vl;
+
+    for (int jh = 0; jh < N; jh += vl) {
+        vl = __riscv_vsetvl_e32m2(N - jh);
+
+        vfloat32m2_t vc0 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
+        vfloat32m2_t vc1 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
+        vfloat32m2_t vc2 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
+        vfloat32m2_t vc3 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
+        vfloat32m2_t vc4 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
+        vfloat32m2_t vc5 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
+        vfloat32m2_t vc6 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
+        vfloat32m2_t vc7 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
+
+        for (int k = 0; k < K; k++) {
+            vfloat32m2_t vb = __riscv_vle32_v_f32m2(&B[(size_t)k * ldb + jh], vl);
+
+            vc0 = __riscv_vfmacc_vf_f32m2(vc0, A[0 * lda + k], vb, vl);
+            vc1 = __riscv_vfmacc_vf_f32m2(vc1, A[1 * lda + k], vb, vl);
+            vc2 = __riscv_vfmacc_vf_f32m2(vc2, A[2 * lda + k], vb, vl);
+            vc3 = __riscv_vfmacc_vf_f32m2(vc3, A[3 * lda + k], vb, vl);
+            vc4 = __riscv_vfmacc_vf_f32m2(vc4, A[4 * lda + k], vb, vl);
+            if (R > 5) vc5 = __riscv_vfmacc_vf_f32m2(vc5, A[5 * lda + k], vb, vl);
+            if (R > 6) vc6 = __riscv_vfmacc_vf_f32m2(vc6, A[6 * lda + k], vb, vl);
+            if (R > 7) vc7 = __riscv_vfmacc_vf_f32m2(vc7, A[7 * lda + k], vb, vl);
+        }
+
+        __riscv_vse32_v_f32m2(&C[0 * ldc + jh], vc0, vl);
+        __riscv_vse32_v_f32m2(&C[1 * ldc + jh], vc1, vl);
+        __riscv_vse32_v_f32m2(&C[2 * ldc + jh], vc2, vl);
+        __riscv_vse32_v_f32m2(&C[3 * ldc + jh], vc3, vl);
+        __riscv_vse32_v_f32m2(&C[4 * ldc + jh], vc4, vl);
+        if (R > 5) __riscv_vse32_v_f32m2(&C[5 * ldc + jh], vc5, vl);
+        if (R > 6) __riscv_vse32_v_f32m2(&C[6 * ldc + jh], vc6, vl);
+        if (R > 7) __riscv_vse32_v_f32m2(&C[7 * ldc + jh], vc7, vl);
+    }
+}
+
+// blocks of up to 8 rows
+void kernel_sw(float* mat1, float* mat2, float* res, int M, int N, int K, int lda, int ldb, int ldc) {
+
+    for (int i0 = 0; i0 < M; i0 += 8) {
+        const float* A = mat1 + (size_t)i0 * lda;
+        float* C = res + (size_t)i0 * ldc;
+
+        switch (M - i0 < 8 ? M - i0 : 8) {
+            case 1:  gemv_t(A, mat2, C, K, N, ldb); break;
+            case 2:  short_wide_m4(A, mat2, C, 2, N, K, lda, ldb, ldc); break;
+            case 3:  short_wide_m4(A, mat2, C, 3, N, K, lda, ldb, ldc); break;
+            case 4:  short_wide_m4(A, mat2, C, 4, N, K, lda, ldb, ldc); break;
+            case 5:  short_wide_m2(A, mat2, C, 5, N, K, lda, ldb, ldc); break;
+            case 6:  short_wide_m2(A, mat2, C, 6, N, K, lda, ldb, ldc); break;
+            case 7:  short_wide_m2(A, mat2, C, 7, N, K, lda, ldb, ldc); break;
+            default: short_wide_m2(A, mat2, C, 8, N, K, lda, ldb, ldc); break;
+        }
+    }
+}
+
+
+/*
+ * GEMV / TALL-SKINNY (kernel_ts)
+ * N <= 8 and many rows: Tw = N would leave most lanes empty, so the K dimension
+ * is vectorised instead. B^T (N x K, packed once per call) stays in cache, every
+ * row of A streams once and feeds N dot products: vfmacc over full chunks,
+ * one vfredusum per output, the partial chunk folded into the reduction.
+ * gemv_n (y = A x) is the N = 1 case, 4 rows at a time sharing the loads of x.
+ */
+void gemv_n(const float* A, const float* x, float* y, int M, int K, int lda) {
+
+    const size_t vlmax = __riscv_vsetvlmax_e32m4();
+    const int kfull = K - K % vlmax;
+    const size_t vt = K - kfull;
+    vfloat32m1_t vz = __riscv_vfmv_s_f_f32m1(0.0f, 1);
+
+    int i = 0;
+    for (; i + 4 <= M; i += 4) {
+        const float* a0 = A + (size_t)(i + 0) * lda;
+        const float* a1 = A + (size_t)(i + 1) * lda;
+        const float* a2 = A + (size_t)(i + 2) * lda;
+        const float* a3 = A + (size_t)(i + 3) * lda;
+
+        vfloat32m4_t vs0 = __riscv_vfmv_v_f_f32m4(0.0f, vlmax);
+        vfloat32m4_t vs1 = __riscv_vfmv_v_f_f32m4(0.0f, vlmax);
+        vfloat32m4_t vs2 = __riscv_vfmv_v_f_f32m4(0.0f, vlmax);
+        vfloat32m4_t vs3 = __riscv_vfmv_v_f_f32m4(0.0f, vlmax);
+
+        for (int k = 0; k < kfull; k += vlmax) {
+            vfloat32m4_t vx = __riscv_vle32_v_f32m4(&x[k], vlmax);
+            vs0 = __riscv_vfmacc_vv_f32m4(vs0, __riscv_vle32_v_f32m4(&a0[k], vlmax), vx, vlmax);
+            vs1 = __riscv_vfmacc_vv_f32m4(vs1, __riscv_vle32_v_f32m4(&a1[k], vlmax), vx, vlmax);
+            vs2 = __riscv_vfmacc_vv_f32m4(vs2, __riscv_vle32_v_f32m4(&a2[k], vlmax), vx, vlmax);
+            vs3 = __riscv_vfmacc_vv_f32m4(vs3, __riscv_vle32_v_f32m4(&a3[k], vlmax), vx, vlmax);
+        }
+
+        vfloat32m1_t vr0 = __riscv_vfredusum_vs_f32m4_f32m1(vs0, vz, vlmax);
+        vfloat32m1_t vr1 = __riscv_vfredusum_vs_f32m4_f32m1(vs1, vz, vlmax);
+        vfloat32m1_t vr2 = __riscv_vfredusum_vs_f32m4_f32m1(vs2, vz, vlmax);
+        vfloat32m1_t vr3 = __riscv_vfredusum_vs_f32m4_f32m1(vs3, vz, vlmax);
+
+        if (vt) {
+            vfloat32m4_t vx = __riscv_vle32_v_f32m4(&x[kfull], vt);
+            vr0 = __riscv_vfredusum_vs_f32m4_f32m1(__riscv_vfmul_vv_f32m4(__riscv_vle32_v_f32m4(&a0[kfull], vt), vx, vt), vr0, vt);
+            vr1 = __riscv_vfredusum_vs_f32m4_f32m1(__riscv_vfmul_vv_f32m4(__riscv_vle32_v_f32m4(&a1[kfull], vt), vx, vt), vr1, vt);
+            vr2 = __riscv_vfredusum_vs_f32m4_f32m1(__riscv_vfmul_vv_f32m4(__riscv_vle32_v_f32m4(&a2[kfull], vt), vx, vt), vr2, vt);
+            vr3 = __riscv_vfredusum_vs_f32m4_f32m1(__riscv_vfmul_vv_f32m4(__riscv_vle32_v_f32m4(&a3[kfull], vt), vx, vt), vr3, vt);
+        }
+
+        y[i + 0] = __riscv_vfmv_f_s_f32m1_f32(vr0);
+        y[i + 1] = __riscv_vfmv_f_s_f32m1_f32(vr1);
+        y[i + 2] = __riscv_vfmv_f_s_f32m1_f32(vr2);
+        y[i + 3] = __riscv_vfmv_f_s_f32m1_f32(vr3);
+    }
+
+    for (; i < M; i++) {
+        const float* a0 = A + (size_t)i * lda;
+
+        vfloat32m4_t vs0 = __riscv_vfmv_v_f_f32m4(0.0f, vlmax);
+        for (int k = 0; k < kfull; k += vlmax) {
+            vfloat32m4_t vx = __riscv_vle32_v_f32m4(&x[k], vlmax);
+            vs0 = __riscv_vfmacc_vv_f32m4(vs0, __riscv_vle32_v_f32m4(&a0[k], vlmax), vx, vlmax);
+        }
+
+        vfloat32m1_t vr0 = __riscv_vfredusum_vs_f32m4_f32m1(vs0, vz, vlmax);
+        if (vt) {
+            vfloat32m4_t vx = __riscv_vle32_v_f32m4(&x[kfull], vt);
+            vr0 = __riscv_vfredusum_vs_f32m4_f32m1(__riscv_vfmul_vv_f32m4(__riscv_vle32_v_f32m4(&a0[kfull], vt), vx, vt), vr0, vt);
+        }
+
+        y[i] = __riscv_vfmv_f_s_f32m1_f32(vr0);
+    }
+}
+
+// B^T of the N <= 8 columns of B, N rows of K floats (strided loads of the columns)
+static void transpose_b(const float* B, float* Bt, int K, int N, int ldb) {
+
+    size_t vl;
+
+    for (int j = 0; j < N; j++) {
+        for (int kh = 0; kh < K; kh += vl) {
+            vl = __riscv_vsetvl_e32m4(K - kh);
+            vfloat32m4_t v = __riscv_vlse32_v_f32m4(&B[(size_t)kh * ldb + j], ldb * sizeof(float), vl);
+            __riscv_vse32_v_f32m4(&Bt[(size_t)j * K + kh], v, vl);
+        }
+    }
+}
+
+// R = N columns (constant once inlined), one row of A at a time
+static inline __attribute__((always_inline))
+void tall_skinny_m2(const float* A, const float* Bt, float* C, const int R, int M, int K, int lda, int ldc) {
+
+    const size_t vlmax = __riscv_vsetvlmax_e32m2();
+    const int kfull = K - K % vlmax;
+    const size_t vt = K - kfull;
+    vfloat32m1_t vz = __riscv_vfmv_s_f_f32m1(0.0f, 1);
+
+    const float* b0 = Bt;
+    const float* b1 = Bt + (size_t)1 * K;
+    const float* b2 = Bt + (size_t)2 * K;
+    const float* b3 = Bt + (size_t)3 * K;
+    const float* b4 = Bt + (size_t)4 * K;
+    const float* b5 = Bt + (size_t)5 * K;
+    const float* b6 = Bt + (size_t)6 * K;
+    const float* b7 = Bt + (size_t)7 * K;
+
+    for (int i = 0; i < M; i++) {
+        const float* a = A + (size_t)i * lda;
+        float* c = C + (size_t)i * ldc;
+
+        vfloat32m2_t vs0 = __riscv_vfmv_v_f_f32m2(0.0f, vlmax);
+        vfloat32m2_t vs1 = __riscv_vfmv_v_f_f32m2(0.0f, vlmax);
+        vfloat32m2_t vs2 = __riscv_vfmv_v_f_f32m2(0.0f, vlmax);
+        vfloat32m2_t vs3 = __riscv_vfmv_v_f_f32m2(0.0f, vlmax);
+        vfloat32m2_t vs4 = __riscv_vfmv_v_f_f32m2(0.0f, vlmax);
+        vfloat32m2_t vs5 = __riscv_vfmv_v_f_f32m2(0.0f, vlmax);
+        vfloat32m2_t vs6 = __riscv_vfmv_v_f_f32m2(0.0f, vlmax);
+        vfloat32m2_t vs7 = __riscv_vfmv_v_f_f32m2(0.0f, vlmax);
+
+        for (int k = 0; k < kfull; k += vlmax) {
+            vfloat32m2_t va = __riscv_vle32_v_f32m2(&a[k], vlmax);
+
+            vs0 = __riscv_vfmacc_vv_f32m2(vs0, va, __riscv_vle32_v_f32m2(&b0[k], vlmax), vlmax);
+            vs1 = __riscv_vfmacc_vv_f32m2(vs1, va, __riscv_vle32_v_f32m2(&b1[k], vlmax), vlmax);
+            if (R > 2) vs2 = __riscv_vfmacc_vv_f32m2(vs2, va, __riscv_vle32_v_f32m2(&b2[k], vlmax), vlmax);
+            if (R > 3) vs3 = __riscv_vfmacc_vv_f32m2(vs3, va, __riscv_vle32_v_f32m2(&b3[k], vlmax), vlmax);
+            if (R > 4) vs4 = __riscv_vfmacc_vv_f32m2(vs4, va, __riscv_vle32_v_f32m2(&b4[k], vlmax), vlmax);
+            if (R > 5) vs5 = __riscv_vfmacc_vv_f32m2(vs5, va, __riscv_vle32_v_f32m2(&b5[k], vlmax), vlmax);
+            if (R > 6) vs6 = __riscv_vfmacc_vv_f32m2(vs6, va, __riscv_vle32_v_f32m2(&b6[k], vlmax), vlmax);
+            if (R > 7) vs7 = __riscv_vfmacc_vv_f32m2(vs7, va, __riscv_vle32_v_f32m2(&b7[k], vlmax), vlmax);
+        }
+
+        vfloat32m1_t vr0 = __riscv_vfredusum_vs_f32m2_f32m1(vs0, vz, vlmax);
+        vfloat32m1_t vr1 = __riscv_vfredusum_vs_f32m2_f32m1(vs1, vz, vlmax);
+        vfloat32m1_t vr2 = __riscv_vfredusum_vs_f32m2_f32m1(vs2, vz, vlmax);
+        vfloat32m1_t vr3 = __riscv_vfredusum_vs_f32m2_f32m1(vs3, vz, vlmax);
+        vfloat32m1_t vr4 = __riscv_vfredusum_vs_f32m2_f32m1(vs4, vz, vlmax);
+        vfloat32m1_t vr5 = __riscv_vfredusum_vs_f32m2_f32m1(vs5, vz, vlmax);
+        vfloat32m1_t vr6 = __riscv_vfredusum_vs_f32m2_f32m1(vs6, vz, vlmax);
+        vfloat32m1_t vr7 = __riscv_vfredusum_vs_f32m2_f32m1(vs7, vz, vlmax);
+
+        if (vt) {
+            vfloat32m2_t va = __riscv_vle32_v_f32m2(&a[kfull], vt);
+
+            vr0 = __riscv_vfredusum_vs_f32m2_f32m1(__riscv_vfmul_vv_f32m2(va, __riscv_vle32_v_f32m2(&b0[kfull], vt), vt), vr0, vt);
+            vr1 = __riscv_vfredusum_vs_f32m2_f32m1(__riscv_vfmul_vv_f32m2(va, __riscv_vle32_v_f32m2(&b1[kfull], vt), vt), vr1, vt);
+            if (R > 2) vr2 = __riscv_vfredusum_vs_f32m2_f32m1(__riscv_vfmul_vv_f32m2(va, __riscv_vle32_v_f32m2(&b2[kfull], vt), vt), vr2, vt);
+            if (R > 3) vr3 = __riscv_vfredusum_vs_f32m2_f32m1(__riscv_vfmul_vv_f32m2(va, __riscv_vle32_v_f32m2(&b3[kfull], vt), vt), vr3, vt);
+            if (R > 4) vr4 = __riscv_vfredusum_vs_f32m2_f32m1(__riscv_vfmul_vv_f32m2(va, __riscv_vle32_v_f32m2(&b4[kfull], vt), vt), vr4, vt);
+            if (R > 5) vr5 = __riscv_vfredusum_vs_f32m2_f32m1(__riscv_vfmul_vv_f32m2(va, __riscv_vle32_v_f32m2(&b5[kfull], vt), vt), vr5, vt);
+            if (R > 6) vr6 = __riscv_vfredusum_vs_f32m2_f32m1(__riscv_vfmul_vv_f32m2(va, __riscv_vle32_v_f32m2(&b6[kfull], vt), vt), vr6, vt);
+            if (R > 7) vr7 = __riscv_vfredusum_vs_f32m2_f32m1(__riscv_vfmul_vv_f32m2(va, __riscv_vle32_v_f32m2(&b7[kfull], vt), vt), vr7, vt);
+        }
+
+        c[0] = __riscv_vfmv_f_s_f32m1_f32(vr0);
+        c[1] = __riscv_vfmv_f_s_f32m1_f32(vr1);
+        if (R > 2) c[2] = __riscv_vfmv_f_s_f32m1_f32(vr2);
+        if (R > 3) c[3] = __riscv_vfmv_f_s_f32m1_f32(vr3);
+        if (R > 4) c[4] = __riscv_vfmv_f_s_f32m1_f32(vr4);
+        if (R > 5) c[5] = __riscv_vfmv_f_s_f32m1_f32(vr5);
+        if (R > 6) c[6] = __riscv_vfmv_f_s_f32m1_f32(vr6);
+        if (R > 7) c[7] = __riscv_vfmv_f_s_f32m1_f32(vr7);
+    }
+}
+
+// N <= 8, ws: K * N floats for B^T (NULL: allocated here)
+void kernel_ts(float* mat1, float* mat2, float* res, int M, int N, int K, int lda, int ldb, int ldc, float* ws) {
+
+    // single column with contiguous x and y: plain gemv
+    if (N == 1 && ldb == 1 && ldc == 1) {
+        gemv_n(mat1, mat2, res, M, K, lda);
+        return;
+    }
+
+    float* Bt = ws ? ws : malloc(sizeof(float) * K * N);
+    transpose_b(mat2, Bt, K, N, ldb);
+
+    switch (N) {
+        case 1:  for (int i = 0; i < M; i++) gemv_n(mat1 + (size_t)i * lda, Bt, res + (size_t)i * ldc, 1, K, lda); break;
+        case 2:  tall_skinny_m2(mat1, Bt, res, 2, M, K, lda, ldc); break;
+        case 3:  tall_skinny_m2(mat1, Bt, res, 3, M, K, lda, ldc); break;
+        case 4:  tall_skinny_m2(mat1, Bt, res, 4, M, K, lda, ldc); break;
+        case 5:  tall_skinny_m2(mat1, Bt, res, 5, M, K, lda, ldc); break;
+        case 6:  tall_skinny_m2(mat1, Bt, res, 6, M, K, lda, ldc); break;
+        case 7:  tall_skinny_m2(mat1, Bt, res, 7, M, K, lda, ldc); break;
+        default: tall_skinny_m2(mat1, Bt, res, 8, M, K, lda, ldc); break;
+    }
+
+    if (Bt != ws) free(Bt);
+}
+
+
+enum Skinny {SKINNY_NONE, SKINNY_SHORT_WIDE, SKINNY_TALL};
+
+// few rows and many columns (decoder shapes), few columns and many rows: long K only,
+// short K stays A- / B-stationary (select_dataflow), the other shapes output-stationary
+static int skinny_shape(int M, int N, int K) {
+    if (M <= 8 && N >= 8 * M && K > 64) return SKINNY_SHORT_WIDE;
+    if (N <= 8 && M >= 8 * N && K > 64) return SKINNY_TALL;
+    return SKINNY_NONE;
+}
+
+// output-stationary kernels: os_kernels[th index][lmul index], th 2/4/8/16, lmul mf2/1/2/4/8
+typedef void (*os_kernel_t)(float* mat1, float* mat2, float* res, int M, int N, int K,
+                            int lda, int ldb, int ldc, float* ws, int pack_mode);
+
+static const os_kernel_t os_kernels[4][5] = {
+    { kernel_2_mf2,  kernel_2_m1,  kernel_2_m2,  kernel_2_m4,  kernel_2_m8  },
+    { kernel_4_mf2,  kernel_4_m1,  kernel_4_m2,  kernel_4_m4,  kernel_4_m8  },
+    { kernel_8_mf2,  kernel_8_m1,  kernel_8_m2,  kernel_8_m4,  kernel_8_m8  },
+    { kernel_16_mf2, kernel_16_m1, kernel_16_m2, kernel_16_m4, kernel_16_m8 },
+};
+
+// NULL if there is no Th x Tw(lmul) kernel
+static os_kernel_t os_kernel(int th, int lmul) {
+    int i, j;
+    switch (th) {
+        case 2:   i = 0; break;
+        case 4:   i = 1; break;
+        case 8:   i = 2; break;
+        case 16:  i = 3; break;
+        default:  return NULL;
+    }
+    switch (lmul) {
+        case -2:  j = 0; break;
+        case 1:   j = 1; break;
+        case 2:   j = 2; break;
+        case 4:   j = 3; break;
+        case 8:   j = 4; break;
+        default:  return NULL;
+    }
+    return os_kernels[i][j];
+}
+
+// 8 x m2 output-stationary kernel of a semiring, NULL for plus-times (os_kernel)
+static os_kernel_t semiring_kernel(int semiring) {
+    switch (semiring) {
+        case SEMIRING_MIN_PLUS:  return kernel_minplus_8_m2;
+        case SEMIRING_MAX_PLUS:  return kernel_maxplus_8_m2;
+        default:                 return NULL;
+    }
+}
+
+// shape based selection of the dataflow (DATAFLOW=0)
+int select_dataflow(int M, int N, int K) {
+
+    // short-wide: few rows of A, C rows are long -> keep A in registers
+    if (M <= 8 && N >= 8 * M) return A_STATIONARY;
+
+    // tall-skinny: many rows, narrow B strip with few rows -> keep B in registers
+    if (M >= 8 * N && K <= 64) return B_STATIONARY;
+
+    return OUTPUT_STATIONARY;
+}
+
+const char* pack_mode_name(int pack_mode) {
+    switch (pack_mode) {
+        case PACK_SEPARATE:       return "SEPARATE";
+        case PACK_FUSED:          return "FUSED";
+        case PACK_PREPACKED:      return "PREPACKED";
+        default:                  return "PACK_UNKNOWN";
+    }
+}
+
+const char* dataflow_name(int dataflow) {
+    switch (dataflow) {
+        case DATAFLOW_AUTO:       return "AUTO";
+        case OUTPUT_STATIONARY:   return "OUTPUT_STATIONARY";
+        case B_STATIONARY:        return "B_STATIONARY";
+        case A_STATIONARY:        return "A_STATIONARY";
+        default:                  return "DATAFLOW_UNKNOWN";
+    }
+}
+
+void multiply_gemm(float* A, float* B, float* C, int M, int N, int K, int th, int lmul, int dataflow, int pack_mode) {
+
+    // auto kernel on a small shape: unrolled kernel, no plan
+    small_gemm_t small = (th == 0 && dataflow == DATAFLOW_AUTO) ? small_gemm_lookup(M, N, K) : NULL;
+    if( small ){
+        small(A, B, C, M);
+        return;
+    }
+
+    // auto kernel on a skinny shape: streaming kernels, B never packed
+    int skinny = (th == 0 && dataflow == DATAFLOW_AUTO) ? skinny_shape(M, N, K) : SKINNY_NONE;
+    if( skinny == SKINNY_SHORT_WIDE ){
+        kernel_sw(A, B, C, M, N, K, K, N, N);
+        return;
+    }
+    if( skinny == SKINNY_TALL ){
+        kernel_ts(A, B, C, M, N, K, K, N, N, NULL);
+        return;
+    }
+
+    // kernel higher than M: biggest tile that fits, an auto kernel (0) is left to the tuning table
+    while( th > M ) th /= 2;
+
+    // B is row-major here, panels packed once go through multiply_gemm_packed
+    if( pack_mode == PACK_PREPACKED ) pack_mode = PACK_SEPARATE;
+
+    gemm_shape_t shape = { M, N, K };
+    gemm_strides_t strides = { K, N, N };
+    gemm_hints_t hints = { dataflow, th, lmul, pack_mode, NULL, NULL, SEMIRING_PLUS_TIMES, NULL };
+
+    gemm_plan_t* plan = gemm_plan(NULL, shape, strides, GEMM_F32, 1, &hints);
+    if (plan == NULL) return;
+
+    gemm_execute(NULL, plan, A, B, C);
+    gemm_destroy(plan);
+}
+
+/*
+ * PRE-PACKED B
+ * B is packed once into ceil(N / Tw) panels of K x Tw floats, the same layout
+ * reordering_rvv produces in oB: the output-stationary kernels read the panels
+ * in place (PACK_PREPACKED) and never touch the row-major B again.
+ * Tw depends on LMUL and VLEN, the handle is valid only for the LMUL it records.
+ */
+// Tw of the kernels with this LMUL, 0 if the LMUL has no kernel
+static int panel_width(int N, int lmul) {
+    switch (lmul) {
+        case -2:  return __riscv_vsetvl_e32mf2(N);
+        case 1:   return __riscv_vsetvl_e32m1(N);
+        case 2:   return __riscv_vsetvl_e32m2(N);
+        case 4:   return __riscv_vsetvl_e32m4(N);
+        case 8:   return __riscv_vsetvl_e32m8(N);
+        default:  return 0;
+    }
+}
+
+packed_b_t* pack_b(const float* B, int K, int N, int lmul) {
+
+    if (K <= 0 || N <= 0) return NULL;
+
+    int tw = panel_width(N, lmul);
+    if (tw == 0) return NULL;
+
+    packed_b_t* pack = malloc(sizeof(packed_b_t));
+    if (pack == NULL) return NULL;
+
+    pack->layout = PACKED_B_PANELS;
+    pack->k = K;
+    pack->n = N;
+    pack->lmul = lmul;
+    pack->tw = tw;
+    pack->panels = (N + tw - 1) / tw;
+    pack->panel_stride = (size_t)K * tw;
+    pack->map = NULL;
+    pack->map_bytes = 0;
+
+    size_t bytes = sizeof(float) * pack->panel_stride * pack->panels;
+    bytes = (bytes + PACKED_B_ALIGN - 1) / PACKED_B_ALIGN * PACKED_B_ALIGN;
+    pack->data = aligned_alloc(PACKED_B_ALIGN, bytes);
+    if (pack->data == NULL) {
+        free(pack);
+        return NULL;
+    }
+
+    // the columns past N in the last panel are never stored to C, keep them defined
+    if (N % tw != 0) memset(pack->data, 0, bytes);
+
+    for (int p = 0; p < pack->panels; p++) {
+        int jh = p * tw;
+        reordering_rvv((float*)B + jh, pack->data + p * pack->panel_stride, K, N, tw, N - jh);
+    }
+
+    if( DEBUG_ENABLED >= 1 ){
+        printf("pack_b> K=%d N=%d lmul=%d tw=%d panels=%d\n", K, N, lmul, tw, pack->panels);
+    }
+
+    return pack;
+}
+
+void packed_b_free(packed_b_t* pack) {
+    if (pack == NULL) return;
+    if (pack->map) munmap(pack->map, pack->map_bytes);
+    else free(pack->data);
+    free(pack);
+}
+
+int packed_b_layout(const packed_b_t* pack) { return pack->layout; }
+int packed_b_k(const packed_b_t* pack) { return pack->k; }
+int packed_b_n(const packed_b_t* pack) { return pack->n; }
+int packed_b_lmul(const packed_b_t* pack) { return pack->lmul; }
+int packed_b_tw(const packed_b_t* pack) { return pack->tw; }
+int packed_b_panels(const packed_b_t* pack) { return pack->panels; }
+const float* packed_b_data(const packed_b_t* pack) { return pack->data; }
+int packed_b_is_mapped(const packed_b_t* pack) { return pack->map != NULL; }
+
+/*
+ * PACKED B FILE
+ * the panels are written as they are in memory, behind a header describing them
+ * (see struct packed_b_file_header). On load the file is mapped read-only and the
+ * kernels read the panels straight from the mapping; if the file was packed for a
+ * different VLEN (Tw does not match) it is unpacked to row-major and packed again.
+ */
+int packed_b_save(const packed_b_t* pack, const char* path) {
+
+    struct packed_b_file_header h;
+    memset(&h, 0, sizeof(h));
+
+    memcpy(h.magic, PACKED_B_MAGIC, sizeof(h.magic));
+    h.version = PACKED_B_VERSION;
+    h.vlen = get_vlen();
+    h.layout = pack->layout;
+    h.lmul = pack->lmul;
+    h.tw = pack->tw;
+    h.kc = pack->k;
+    h.k = pack->k;
+    h.n = pack->n;
+    h.panels = pack->panels;
+    h.align = PACKED_B_ALIGN;
+    h.elem_size = sizeof(float);
+    h.data_offset = (sizeof(h) + PACKED_B_ALIGN - 1) / PACKED_B_ALIGN * PACKED_B_ALIGN;
+
+    FILE* f = fopen(path, "wb");
+    if (f == NULL) return -1;
+
+    size_t count = pack->panel_stride * pack->panels;
+    int ok = fwrite(&h, sizeof(h), 1, f) == 1;
+    for (size_t pad = sizeof(h); ok && pad < h.data_offset; pad++) ok = fputc(0, f) != EOF;
+    ok = ok && fwrite(pack->data, sizeof(float), count, f) == count;
+
+    if (fclose(f) != 0) ok = 0;
+
+    return ok ? 0 : -1;
+}
+
+packed_b_t* packed_b_load(const char* path) {
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return NULL;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(struct packed_b_file_header)) {
+        close(fd);
+        return NULL;
+    }
+
+    size_t bytes = st.st_size;
+    void* map = mmap(NULL, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) return NULL;
+
+    const struct packed_b_file_header* h = map;
+    size_t stride = (size_t)h->kc * h->tw;
+
+    // k, n, tw must fit int; the panels (panels x stride floats, checked by division:
+    // the product can wrap size_t) must fit the file after data_offset
+    if (memcmp(h->magic, PACKED_B_MAGIC, sizeof(h->magic)) != 0
+        || h->version != PACKED_B_VERSION
+        || h->layout != PACKED_B_PANELS
+        || h->elem_size != sizeof(float)
+        || h->k == 0 || h->n == 0 || h->tw == 0 || h->kc != h->k
+        || h->k > INT_MAX || h->n > INT_MAX || h->tw > INT_MAX
+        || h->panels != (h->n + h->tw - 1) / h->tw
+        || h->data_offset > bytes
+        || h->panels > (bytes - h->data_offset) / sizeof(float) / stride) {
+        munmap(map, bytes);
+        return NULL;
+    }
+
+    const float* panels = (const float*)((const char*)map + h->data_offset);
+    const int K = h->k, N = h->n, ftw = h->tw;
+    int tw = panel_width(N, h->lmul);
+
+    // same VLEN: the mapping is the packed B
+    if (tw == ftw && h->vlen == (uint32_t)get_vlen() && h->data_offset % PACKED_B_ALIGN == 0) {
+        packed_b_t* pack = malloc(sizeof(packed_b_t));
+        if (pack == NULL) {
+            munmap(map, bytes);
+            return NULL;
+        }
+
+        pack->layout = h->layout;
+        pack->k = K;
+        pack->n = N;
+        pack->lmul = h->lmul;
+        pack->tw = tw;
+        pack->panels = h->panels;
+        pack->panel_stride = stride;
+        pack->data = (float*)panels;
+        pack->map = map;
+        pack->map_bytes = bytes;
+
+        if( DEBUG_ENABLED >= 1 ){
+            printf("packed_b_load> %s vlen=%u tw=%d: mapped\n", path, h->vlen, tw);
+        }
+
+        return pack;
+    }
+
+    // VLEN mismatch: panels of the file -> row-major B -> panels for this machine
+    float* B = malloc(sizeof(float) * K * N);
+    packed_b_t* pack = NULL;
+
+    if (B != NULL) {
+        for (int p = 0; p < (int)h->panels; p++) {
+            int jh = p * ftw;
+            int width = N - jh < ftw ? N - jh : ftw;
+            reordering_rvv((float*)panels + p * stride, B + jh, K, ftw, N, width);
+        }
+        pack = pack_b(B, K, N, h->lmul);
+        free(B);
+    }
+
+    if( DEBUG_ENABLED >= 1 ){
+        printf("packed_b_load> %s vlen=%u tw=%d -> vlen=%d tw=%d: repacked\n", path, h->vlen, ftw, get_vlen(), tw);
+    }
+
+    munmap(map, bytes);
+
+    return pack;
+}
+
+/*
+ * TAIL ROWS on the packed panels
+ * same as tail_rows, B is read panel by panel (panel K x tw, row stride tw).
+ */
+static void tail_rows_panels(float* mat1, const float* panels, float* res, int i0, int M, int N, int K, int lda, int tw, int ldc) {
+
+    float (*A)[lda] = (float (*)[lda]) mat1;
+    float (*C)[ldc] = (float (*)[ldc]) res;
+
+    size_t vl;
+
+    for (int i = i0; i < M; i++) {
+        for (int j0 = 0; j0 < N; j0 += tw) {
+            const float* panel = panels + (size_t)(j0 / tw) * K * tw;
+            int width = N - j0 < tw ? N - j0 : tw;
+
+            for (int jh = 0; jh < width; jh += vl) {
+                vl = __riscv_vsetvl_e32m4(width - jh);
+
+                vfloat32m4_t vc = __riscv_vfmv_v_f_f32m4(0.0f, vl);
+
+                for (int k = 0; k < K; ++k) {
+                    vfloat32m4_t vb = __riscv_vle32_v_f32m4(&panel[k * tw + jh], vl);
+                    vc = __riscv_vfmacc_vf_f32m4(vc, A[i][k], vb, vl);
+                }
+
+                __riscv_vse32_v_f32m4(&C[i][j0 + jh], vc, vl);
+            }
+        }
+    }
+}
+
+// C (M x N) = A (M x K) * packed B, output-stationary with the LMUL of the handle
+void multiply_gemm_packed(float* A, const packed_b_t* pack, float* C, int M, int th) {
+
+    // kernel higher than M: biggest tile that fits, an auto kernel (0) is left to the tuning table
+    while( th > M ) th /= 2;
+
+    gemm_shape_t shape = { M, pack->n, pack->k };
+    gemm_strides_t strides = { pack->k, 0, pack->n };
+    gemm_hints_t hints = { OUTPUT_STATIONARY, th, pack->lmul, PACK_PREPACKED, NULL, pack, SEMIRING_PLUS_TIMES, NULL };
+
+    gemm_plan_t* plan = gemm_plan(NULL, shape, strides, GEMM_F32, 1, &hints);
+    if (plan == NULL) return;
+
+    gemm_execute(NULL, plan, A, NULL, C);
+    gemm_destroy(plan);
+}
+
+
+/*
+ * INDEXED ROWS (embedding lookups, MoE token routing)
+ * C[c_rows[i]] = A[a_rows[i]] * B for i in [0, M): no gathered copy of A and no
+ * scattered copy of C. Row block of Th=8 x Tw(m2), like kernel_8_m2:
+ * - the 8 rows of A are gathered while packing the A tile: one indexed load
+ *   (vluxei32, offsets a_rows[r] * lda) per k fills oA[k][0:8];
+ * - B panel packed once per panel with reordering_rvv;
+ * - the 8 rows of C are written back to the rows c_rows[r] (unit-stride stores).
+ * a_rows / c_rows NULL: identity. The byte offsets of the gather are 32 bit,
+ * relative to the lowest row of the block: a block spread over more than 4 GiB
+ * of A is gathered with scalar loads.
+ */
+static void tail_rows_indexed(const float* A, const int* a_rows, const float* B, float* C, const int* c_rows,
+                              int i0, int M, int N, int K, int lda, int ldb, int ldc) {
+
+    size_t vl;
+
+    for (int i = i0; i < M; i++) {
+        const float* a = A + (size_t)(a_rows ? a_rows[i] : i) * lda;
+        float* c = C + (size_t)(c_rows ? c_rows[i] : i) * ldc;
+
+        for (int jh = 0; jh < N; jh += vl) {
+            vl = __riscv_vsetvl_e32m4(N - jh);
+
+            vfloat32m4_t vc = __riscv_vfmv_v_f_f32m4(0.0f, vl);
+
+            for (int k = 0; k < K; ++k) {
+                vfloat32m4_t vb = __riscv_vle32_v_f32m4(&B[(size_t)k * ldb + jh], vl);
+                vc = __riscv_vfmacc_vf_f32m4(vc, a[k], vb, vl);
+            }
+
+            __riscv_vse32_v_f32m4(&c[jh], vc, vl);
+        }
+    }
+}
+
+int multiply_gemm_indexed(const float* A, const int* a_rows, const float* B, float* C, const int* c_rows,
+                          int M, int N, int K, int lda, int ldb, int ldc) {
+
+    const int Th = 8;
+    int Tw = __riscv_vsetvl_e32m2(N);
+
+    // a negative row would be read / written before A / C
+    for (int i = 0; i < M; i++)
+        if ((a_rows && a_rows[i] < 0) || (c_rows && c_rows[i] < 0)) return -1;
+
+    float* oA = malloc(sizeof(float) * K * Th);
+    float* oB = malloc(sizeof(float) * K * Tw);
+    if (oA == NULL || oB == NULL) {
+        free(oA);
+        free(oB);
+        return -1;
+    }
+
+    size_t vl;
+
+    for (int jh = 0; jh < N; jh += Tw) {
+        reordering_rvv((float*)&B[jh], oB, K, ldb, Tw, N - jh);
+
+        for (int ih = 0; ih + Th <= M; ih += Th) {
+
+            // gather: the 8 source rows (byte offsets from the lowest), scatter: the 8 destination rows
+            size_t row[8], lo = SIZE_MAX, hi = 0;
+            float* c[8];
+            for (int r = 0; r < Th; r++) {
+                row[r] = (size_t)(a_rows ? a_rows[ih + r] : ih + r);
+                if (row[r] < lo) lo = row[r];
+                if (row[r] > hi) hi = row[r];
+                c[r] = C + (size_t)(c_rows ? c_rows[ih + r] : ih + r) * ldc + jh;
+            }
+            const float* a0 = A + lo * lda;
+
+            if ((hi - lo) * lda * sizeof(float) <= UINT32_MAX) {
+                uint32_t off[8];
+                for (int r = 0; r < Th; r++) off[r] = (uint32_t)((row[r] - lo) * lda * sizeof(float));
+                vuint32m2_t voff = __riscv_vle32_v_u32m2(off, Th);
+
+                for (int k = 0; k < K; ++k)
+                    __riscv_vse32_v_f32m2(&oA[k * Th], __riscv_vluxei32_v_f32m2(&a0[k], voff, Th), Th);
+            }
+            else {
+                for (int r = 0; r < Th; r++)
+                    for (int k = 0; k < K; ++k) oA[k * Th + r] = A[row[r] * lda + k];
+            }
+
+            vl = __riscv_vsetvl_e32m2(N - jh);
+
+            vfloat32m2_t vc0 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
+            vfloat32m2_t vc1 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
+            vfloat32m2_t vc2 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
+            vfloat32m2_t vc3 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
+            vfloat32m2_t vc4 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
+            vfloat32m2_t vc5 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
+            vfloat32m2_t vc6 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
+            vfloat32m2_t vc7 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
+
+            for (int k = 0; k < K; ++k) {
+                vfloat32m2_t vb = __riscv_vle32_v_f32m2(&oB[k * Tw], vl);
+                const float* a = &oA[k * Th];
+
+                vc0 = __riscv_vfmacc_vf_f32m2(vc0, a[0], vb, vl);
+                vc1 = __riscv_vfmacc_vf_f32m2(vc1, a[1], vb, vl);
+                vc2 = __riscv_vfmacc_vf_f32m2(vc2, a[2], vb, vl);
+                vc3 = __riscv_vfmacc_vf_f32m2(vc3, a[3], vb, vl);
+                vc4 = __riscv_vfmacc_vf_f32m2(vc4, a[4], vb, vl);
+                vc5 = __riscv_vfmacc_vf_f32m2(vc5, a[5], vb, vl);
+                vc6 = __riscv_vfmacc_vf_f32m2(vc6, a[6], vb, vl);
+                vc7 = __riscv_vfmacc_vf_f32m2(vc7, a[7], vb, vl);
+            }
+
+            __riscv_vse32_v_f32m2(c[0], vc0, vl);
+            __riscv_vse32_v_f32m2(c[1], vc1, vl);
+            __riscv_vse32_v_f32m2(c[2], vc2, vl);
+            __riscv_vse32_v_f32m2(c[3], vc3, vl);
+            __riscv_vse32_v_f32m2(c[4], vc4, vl);
+            __riscv_vse32_v_f32m2(c[5], vc5, vl);
+            __riscv_vse32_v_f32m2(c[6], vc6, vl);
+            __riscv_vse32_v_f32m2(c[7], vc7, vl);
+        }
+    }
+
+    if (M % Th) tail_rows_indexed(A, a_rows, B, C, c_rows, M - M % Th, M, N, K, lda, ldb, ldc);
+
+    free(oA);
+    free(oB);
+    return 0;
+}
+
+
+/*
+ * CONTEXT
+ * everything a caller thread needs that is not in the plan: machine info queried
+ * once, the tuning cache and the oB workspaces. Nothing is shared between two
+ * contexts, so threads with their own context run GEMMs without locks.
+ */
+#define GEMM_TUNING_CACHE 64
+
+// tile resolved for a shape and the hints that selected it
+struct gemm_tuning_entry {
+    int valid;
+    int m, n, k;
+    int hint_dataflow, hint_th, hint_lmul;
+    int dataflow, th, lmul;
+};
+
+struct gemm_ctx {
+    int debug_level;
+
+    // machine info
+    int vlen;
+    int ncpu;
+    long l1d_size;
+    long l2_size;
+
+    // direct mapped on the shape
+    struct gemm_tuning_entry tuning[GEMM_TUNING_CACHE];
+
+    // oB of every slice of the running plan, grown on demand
+    float* ws;
+    size_t ws_size;
+
+    // tile list of gemm_execute_grouped, grown on demand
+    struct gemm_tile* tiles;
+    int tiles_size;
+};
+
+gemm_ctx_t* gemm_ctx_create(int debug_level) {
+
+    gemm_ctx_t* ctx = calloc(1, sizeof(gemm_ctx_t));
+    if (ctx == NULL) return NULL;
+
+    ctx->debug_level = debug_level;
+    ctx->vlen = get_vlen();
+
+    #if defined(__linux__)
+        ctx->ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+        ctx->l1d_size = sysconf(_SC_LEVEL1_DCACHE_SIZE);
+        ctx->l2_size = sysconf(_SC_LEVEL2_CACHE_SIZE);
+    #endif
+    if (ctx->ncpu <= 0) ctx->ncpu = 1;
+    if (ctx->l1d_size <= 0) ctx->l1d_size = 32 * 1024;
+    if (ctx->l2_size <= 0) ctx->l2_size = 512 * 1024;
+
+    if( DEBUG_ENABLED && ctx->debug_level >= 0 ){
+        printf("ctx> vlen=%d ncpu=%d l1d=%ld l2=%ld\n", ctx->vlen, ctx->ncpu, ctx->l1d_size, ctx->l2_size);
+    }
+
+    return ctx;
+}
+
+void gemm_ctx_destroy(gemm_ctx_t* ctx) {
+    if (ctx == NULL) return;
+    free(ctx->tiles);
+    free(ctx->ws);
+    free(ctx);
+}
+
+int gemm_ctx_vlen(const gemm_ctx_t* ctx) { return ctx->vlen; }
+int gemm_ctx_ncpu(const gemm_ctx_t* ctx) { return ctx->ncpu; }
+long gemm_ctx_l1d_size(const gemm_ctx_t* ctx) { return ctx->l1d_size; }
+long gemm_ctx_l2_size(const gemm_ctx_t* ctx) { return ctx->l2_size; }
+
+// workspace of at least size floats, NULL if it cannot grow (the kernels allocate their own)
+static float* gemm_ctx_ws(gemm_ctx_t* ctx, size_t size) {
+    if (ctx->ws_size < size) {
+        free(ctx->ws);
+        ctx->ws = malloc(sizeof(float) * size);
+        ctx->ws_size = ctx->ws ? size : 0;
+    }
+    return ctx->ws;
+}
+
+
+/*
+ * PLAN / EXECUTE
+ * gemm_plan does once what every multiply_gemm call used to do: dataflow and
+ * tile selection and the kernel lookup, optionally the packing of B. A plan is
+ * never modified after gemm_plan, threads can share it. gemm_execute only splits
+ * the columns of C among the threads and calls the kernel: slices are multiples
+ * of Tw, so every thread owns whole panels of B.
+ */
+struct gemm_plan {
+    int m, n, k;
+    int lda, ldb, ldc;
+    int dtype;
+    int threads;
+
+    int dataflow;               // resolved, never DATAFLOW_AUTO
+    int th;                     // rows per tile, 0 when every row goes to tail_rows
+    int lmul;
+    int pack_mode;
+    int tw;                     // panel width (output-stationary), slice unit
+    int rows;                   // rows computed by the kernel, [rows, m) by tail_rows
+    os_kernel_t kernel;         // output-stationary kernel, NULL for the other dataflows
+    small_gemm_t small;         // unrolled kernel of a small shape, replaces everything else
+    int skinny;                 // SKINNY_SHORT_WIDE / SKINNY_TALL: streaming kernels, B never packed
+    int row_split;              // slices are rows of C (slice, slices counted in rows)
+
+    int slice;                  // columns of C per thread, multiple of tw
+    int slices;
+    size_t ws_stride;           // oB floats per slice, 0 if the kernel needs none
+
+    const packed_b_t* packed;   // pre-packed B (owned if pack_owned)
+    int pack_owned;
+
+    gemm_epilogue_t epilogue;   // copy of the hints one, ldr resolved
+    int has_epilogue;
+    int epilogue_fused;         // kernel_ep_8_m2 (every row), else a pass over each slice
+    float* residual_copy;       // M x N, the residual saved there when C overlaps it (pass only)
+};
+
+/*
+ * TUNING TABLE
+ * default tile for the output-stationary dataflow when the hints leave it open:
+ * first entry with m >= m_min. Th accumulators + 1 B row fill the 32 vector
+ * registers for every entry (16 x m1, 8 x m2, 4 x m4, 2 x m8).
+ */
+static const struct gemm_tuning {
+    int m_min;
+    int th;
+    int lmul;
+} gemm_tuning_table[] = {
+    { 16, 16, 1 },
+    {  8,  8, 2 },
+    {  4,  4, 4 },
+    {  2,  2, 8 },
+    {  0,  0, 4 },              // single row: tail_rows only
+};
+
+static const struct gemm_tuning* gemm_tuning_lookup(int M) {
+    int i = 0;
+    while (M < gemm_tuning_table[i].m_min) i++;
+    return &gemm_tuning_table[i];
+}
+
+/*
+ * fp64: a register holds half the elements, Tw = VLMAX(e64 mL) is half the fp32
+ * one. 16 x m1 is left out: 2 doubles per row on VLEN 128, the A scalars would
+ * cost as much as the fmas. Fewer rows than Th run on the same tile.
+ */
+static const struct gemm_tuning gemm_tuning_table_f64[] = {
+    {  8,  8, 2 },
+    {  4,  4, 4 },
+    {  0,  2, 8 },
+};
+
+static const struct gemm_tuning* gemm_tuning_lookup_f64(int M) {
+    int i = 0;
+    while (M < gemm_tuning_table_f64[i].m_min) i++;
+    return &gemm_tuning_table_f64[i];
+}
+
+// dataflow, Th and LMUL from the hints, the open ones from select_dataflow and the tuning table
+static void gemm_resolve(int M, int N, int K, const gemm_hints_t* hints, int* dataflow, int* th, int* lmul) {
+
+    const struct gemm_tuning* tuning = gemm_tuning_lookup(M);
+
+    *dataflow = hints->dataflow == DATAFLOW_AUTO ? select_dataflow(M, N, K) : hints->dataflow;
+    *th = hints->th ? hints->th : tuning->th;
+    *lmul = hints->lmul ? hints->lmul : tuning->lmul;
+
+    if (*dataflow == B_STATIONARY) {
+        *lmul = *lmul >= 2 ? 2 : 1;
+        *th = 0;
+    }
+    else if (*dataflow == A_STATIONARY) {
+        *lmul = 1;
+        *th = (*th != 4 && M >= 8) ? 8 : 4;
+    }
+    else {
+        *dataflow = OUTPUT_STATIONARY;
+        if (os_kernel(*th, *lmul) == NULL) *th = 0;
+    }
+}
+
+// gemm_resolve through the tuning cache of the context
+static void gemm_resolve_cached(gemm_ctx_t* ctx, int M, int N, int K, const gemm_hints_t* hints, int* dataflow, int* th, int* lmul) {
+
+    if (ctx == NULL) {
+        gemm_resolve(M, N, K, hints, dataflow, th, lmul);
+        return;
+    }
+
+    unsigned h = ((unsigned)M * 73856093u) ^ ((unsigned)N * 19349663u) ^ ((unsigned)K * 83492791u);
+    struct gemm_tuning_entry* e = &ctx->tuning[h % GEMM_TUNING_CACHE];
+
+    if (!(e->valid && e->m == M && e->n == N && e->k == K && e->hint_dataflow == hints->dataflow
+          && e->hint_th == hints->th && e->hint_lmul == hints->lmul)) {
+        e->valid = 1;
+        e->m = M;
+        e->n = N;
+        e->k = K;
+        e->hint_dataflow = hints->dataflow;
+        e->hint_th = hints->th;
+        e->hint_lmul = hints->lmul;
+        gemm_resolve(M, N, K, hints, &e->dataflow, &e->th, &e->lmul);
+    }
+
+    *dataflow = e->dataflow;
+    *th = e->th;
+    *lmul = e->lmul;
+}
+
+gemm_plan_t* gemm_plan(gemm_ctx_t* ctx, gemm_shape_t shape, gemm_strides_t strides, int dtype, int threads, const gemm_hints_t* hints) {
+
+    const int M = shape.m, N = shape.n, K = shape.k;
+    const gemm_hints_t none = { DATAFLOW_AUTO, 0, 0, PACK_SEPARATE, NULL, NULL, SEMIRING_PLUS_TIMES, NULL };
+    if (hints == NULL) hints = &none;
+
+    if (dtype != GEMM_F32 && dtype != GEMM_F16 && dtype != GEMM_F16_F16 && dtype != GEMM_BF16 && dtype != GEMM_F64) return NULL;
+    if (M <= 0 || N <= 0 || K <= 0) return NULL;
+    if (hints->semiring != SEMIRING_PLUS_TIMES && (dtype != GEMM_F32 || semiring_kernel(hints->semiring) == NULL)) return NULL;
+    if (hints->epilogue && (dtype != GEMM_F32 || hints->semiring != SEMIRING_PLUS_TIMES)) return NULL;
+
+    // 0: dense row-major
+    if (strides.lda == 0) strides.lda = K;
+    if (strides.ldb == 0) strides.ldb = N;
+    if (strides.ldc == 0) strides.ldc = N;
+    if (strides.lda < K || strides.ldb < N || strides.ldc < N) return NULL;
+
+    // 0 threads: one per cpu
+    if (threads <= 0) threads = ctx ? ctx->ncpu : 1;
+
+    gemm_plan_t* plan = calloc(1, sizeof(gemm_plan_t));
+    if (plan == NULL) return NULL;
+
+    plan->m = M;
+    plan->n = N;
+    plan->k = K;
+    plan->lda = strides.lda;
+    plan->ldb = strides.ldb;
+    plan->ldc = strides.ldc;
+    plan->dtype = dtype;
+    plan->threads = threads;
+    plan->pack_mode = hints->pack_mode;
+
+    // double precision: output-stationary only, Th and LMUL from the hints or the fp64 table
+    if (dtype == GEMM_F64) {
+        const struct gemm_tuning* tuning = gemm_tuning_lookup_f64(M);
+        plan->dataflow = OUTPUT_STATIONARY;
+        plan->th = hints->th ? hints->th : tuning->th;
+        plan->lmul = hints->lmul ? hints->lmul : tuning->lmul;
+        if (hints->b || hints->packed || plan->th < 1 || plan->th > f64_max_rows(plan->lmul)
+            || (hints->dataflow != DATAFLOW_AUTO && hints->dataflow != OUTPUT_STATIONARY)
+            || hints->pack_mode != PACK_SEPARATE) {
+            gemm_destroy(plan);
+            return NULL;
+        }
+        plan->tw = f64_panel_width(N, plan->lmul);
+        plan->rows = M;
+        int units = (N + plan->tw - 1) / plan->tw;
+        int per_thread = (units + plan->threads - 1) / plan->threads;
+        plan->slice = per_thread * plan->tw;
+        plan->slices = (N + plan->slice - 1) / plan->slice;
+        plan->ws_stride = (size_t)K * plan->tw * (sizeof(double) / sizeof(float));
+        return plan;
+    }
+
+    // half precision / bfloat16: one kernel (Th=8, fp32 m2 accumulators), B packed at every call
+    if (dtype != GEMM_F32) {
+        if (hints->b || hints->packed || (hints->th && hints->th != 8) || (hints->lmul && hints->lmul != 2)
+            || (hints->dataflow != DATAFLOW_AUTO && hints->dataflow != OUTPUT_STATIONARY)
+            || hints->pack_mode != PACK_SEPARATE) {
+            gemm_destroy(plan);
+            return NULL;
+        }
+        plan->dataflow = OUTPUT_STATIONARY;
+        plan->th = 8;
+        plan->lmul = 2;
+        plan->tw = __riscv_vsetvl_e32m2(N);
+        plan->rows = M;
+        int units = (N + plan->tw - 1) / plan->tw;
+        int per_thread = (units + plan->threads - 1) / plan->threads;
+        plan->slice = per_thread * plan->tw;
+        plan->slices = (N + plan->slice - 1) / plan->slice;
+        plan->ws_stride = (size_t)K * plan->tw;
+        return plan;
+    }
+
+    // B packed by the caller or here: only the output-stationary kernels read panels
+    gemm_hints_t h = *hints;
+
+    // semiring: the 8 x m2 output-stationary tile only, every row in the kernel
+    if (h.semiring != SEMIRING_PLUS_TIMES) {
+        h.dataflow = OUTPUT_STATIONARY;
+        h.th = 8;
+        h.lmul = 2;
+        if (h.packed && h.packed->lmul != 2) {
+            gemm_destroy(plan);
+            return NULL;
+        }
+        if (plan->pack_mode == PACK_FUSED) plan->pack_mode = PACK_SEPARATE;
+    }
+
+    // epilogue: the tile left open by the hints becomes the fused 8 x m2 one
+    if (h.epilogue) {
+        plan->epilogue = *h.epilogue;
+        if (plan->epilogue.ldr == 0) plan->epilogue.ldr = N;
+        plan->has_epilogue = 1;
+        if ((h.dataflow == DATAFLOW_AUTO || h.dataflow == OUTPUT_STATIONARY) && h.th == 0 && h.lmul == 0
+            && (h.packed == NULL || h.packed->lmul == 2)) {
+            h.dataflow = OUTPUT_STATIONARY;
+            h.th = 8;
+            h.lmul = 2;
+        }
+    }
+
+    if (h.packed || h.b) {
+        h.dataflow = OUTPUT_STATIONARY;
+        if (h.packed) h.lmul = h.packed->lmul;
+        plan->pack_mode = PACK_PREPACKED;
+    }
+    else if (plan->pack_mode == PACK_PREPACKED) {
+        plan->pack_mode = PACK_SEPARATE;
+    }
+
+    gemm_resolve_cached(ctx, M, N, K, &h, &plan->dataflow, &plan->th, &plan->lmul);
+
+    if (h.packed) {
+        plan->packed = h.packed;
+    }
+    else if (h.b) {
+        plan->packed = pack_b(h.b, K, N, plan->lmul);
+        plan->pack_owned = 1;
+    }
+    if (plan->pack_mode == PACK_PREPACKED && (plan->packed == NULL || plan->packed->k != K || plan->packed->n != N)) {
+        gemm_destroy(plan);
+        return NULL;
+    }
+
+    if (plan->dataflow == B_STATIONARY) {
+        plan->rows = M;
+        plan->tw = plan->lmul == 2 ? __riscv_vsetvl_e32m2(N) : __riscv_vsetvl_e32m1(N);
+    }
+    else if (plan->dataflow == A_STATIONARY) {
+        plan->rows = M - M % plan->th;
+        plan->tw = __riscv_vsetvl_e32m1(N);
+    }
+    else {
+        plan->tw = plan->packed ? plan->packed->tw : panel_width(N, plan->lmul);
+        plan->kernel = os_kernel(plan->th, plan->lmul);
+        plan->rows = plan->th ? M - M % plan->th : 0;
+
+        // tail rows in the semiring kernel: tail_rows is plus-times
+        if (h.semiring != SEMIRING_PLUS_TIMES) {
+            plan->kernel = semiring_kernel(h.semiring);
+            plan->rows = M;
+        }
+        else if (plan->has_epilogue && plan->th == 8 && plan->lmul == 2) {
+            plan->epilogue_fused = 1;
+            plan->rows = M;
+            if (plan->pack_mode == PACK_FUSED) plan->pack_mode = PACK_SEPARATE;
+        }
+
+        // no kernel for this lmul: only the tail, streamed with m4
+        if (plan->tw == 0) plan->tw = __riscv_vsetvl_e32m4(N);
+    }
+
+    // columns per thread, whole panels
+    int units = (N + plan->tw - 1) / plan->tw;
+    int per_thread = (units + plan->threads - 1) / plan->threads;
+    plan->slice = per_thread * plan->tw;
+    plan->slices = (N + plan->slice - 1) / plan->slice;
+
+    // oB of each slice, taken from the context at execution
+    if (plan->kernel && plan->pack_mode != PACK_PREPACKED) plan->ws_stride = (size_t)K * plan->tw;
+
+    // nothing forced by the hints: the shape picks a specialised path
+    const int open = h.dataflow == DATAFLOW_AUTO && h.th == 0 && h.lmul == 0 && plan->packed == NULL;
+
+    // small shape, dense: one unrolled call, one thread
+    if (open && strides.lda == K && strides.ldb == N && strides.ldc == N) {
+        plan->small = small_gemm_lookup(M, N, K);
+    }
+    if (plan->small) {
+        plan->rows = M;
+        plan->slice = N;
+        plan->slices = 1;
+        plan->ws_stride = 0;
+    }
+    // B streamed once, columns split over the threads
+    else if (open && skinny_shape(M, N, K) == SKINNY_SHORT_WIDE) {
+        plan->skinny = SKINNY_SHORT_WIDE;
+        plan->kernel = NULL;
+        plan->rows = M;
+        plan->tw = M <= 4 ? __riscv_vsetvl_e32m4(N) : __riscv_vsetvl_e32m2(N);
+        units = (N + plan->tw - 1) / plan->tw;
+        per_thread = (units + plan->threads - 1) / plan->threads;
+        plan->slice = per_thread * plan->tw;
+        plan->slices = (N + plan->slice - 1) / plan->slice;
+        plan->ws_stride = 0;
+    }
+    // dot products, rows split over the threads
+    else if (open && skinny_shape(M, N, K) == SKINNY_TALL) {
+        plan->skinny = SKINNY_TALL;
+        plan->kernel = NULL;
+        plan->rows = M;
+        plan->row_split = 1;
+        plan->slice = (M + plan->threads - 1) / plan->threads;
+        plan->slices = (M + plan->slice - 1) / plan->slice;
+        plan->ws_stride = (size_t)K * N;
+    }
+
+    // epilogue pass: room for a residual that C overwrites, reserved here so that execution cannot fail.
+    // Only the execution whose C overlaps the residual writes it, and two of them at once would race on C anyway
+    if (plan->has_epilogue && !plan->epilogue_fused && plan->epilogue.residual) {
+        plan->residual_copy = malloc(sizeof(float) * M * N);
+        if (plan->residual_copy == NULL) {
+            gemm_destroy(plan);
+            return NULL;
+        }
+    }
+
+    if( DEBUG_ENABLED && ctx && ctx->debug_level >= 0 ){
+        printf("kernel> dataflow=%s th=%d lmul=%d pack=%s tail_rows=%d small=%d skinny=%d\n", dataflow_name(plan->dataflow),
+            plan->th, plan->lmul, pack_mode_name(plan->pack_mode), M - plan->rows, plan->small != NULL, plan->skinny);
+    }
+
+    return plan;
+}
+
+// the epilogue of the columns [j0, ...) of C
+static gemm_epilogue_t epilogue_at(const gemm_epilogue_t* ep, int j0) {
+    gemm_epilogue_t e = *ep;
+    if (e.col_scale) e.col_scale += j0;
+    if (e.bias) e.bias += j0;
+    if (e.residual) e.residual += j0;
+    return e;
+}
+
+// residual of the slice (M x width, row stride ldr) sharing memory with the slice of C (row stride ldc)
+static int residual_overlaps(const float* R, int ldr, const float* C, int ldc, int M, int width) {
+    const char* r0 = (const char*)R;
+    const char* r1 = (const char*)(R + (size_t)(M - 1) * ldr + width);
+    const char* c0 = (const char*)C;
+    const char* c1 = (const char*)(C + (size_t)(M - 1) * ldc + width);
+    return r0 < c1 && c0 < r1;
+}
+
+static void gemm_execute_slice(const gemm_plan_t* plan, float* A, float* B, float* C, int j0, int width, float* ws) {
+
+    const int M = plan->m, K = plan->k;
+    const int lda = plan->lda, ldb = plan->ldb, ldc = plan->ldc;
+
+    float* Bs = plan->packed ? plan->packed->data + (size_t)(j0 / plan->tw) * plan->packed->panel_stride : B + j0;
+    float* Cs = C + j0;
+
+    // epilogue pass with its residual in C: saved before the kernel overwrites it
+    gemm_epilogue_t ep = plan->has_epilogue ? epilogue_at(&plan->epilogue, j0) : plan->epilogue;
+    if (plan->residual_copy && residual_overlaps(ep.residual, ep.ldr, Cs, ldc, M, width)) {
+        float* saved = plan->residual_copy + j0;
+        for (int i = 0; i < M; i++)
+            memcpy(&saved[(size_t)i * plan->n], &ep.residual[(size_t)i * ep.ldr], sizeof(float) * width);
+        ep.residual = saved;
+        ep.ldr = plan->n;
+    }
+
+    if (plan->dtype == GEMM_F64) {
+        kernel_f64((const double*)A, (const double*)B + j0, (double*)C + j0, M, width, K, lda, ldb, ldc,
+                   plan->th, plan->lmul, (double*)ws);
+        return;
+    }
+    if (plan->dtype == GEMM_BF16) {
+        kernel_bf16_8_m2((const __bf16*)A, (const __bf16*)B + j0, C + j0, M, width, K, lda, ldb, ldc, ws);
+        return;
+    }
+    if (plan->dtype != GEMM_F32) {
+        const int out_f16 = plan->dtype == GEMM_F16_F16;
+        void* Ch = out_f16 ? (void*)((_Float16*)C + j0) : (void*)(C + j0);
+        kernel_f16_8_m2((const _Float16*)A, (const _Float16*)B + j0, Ch, M, width, K, lda, ldb, ldc, out_f16, ws);
+        return;
+    }
+    if (plan->small) {
+        plan->small(A, B, C, M);
+        return;
+    }
+    if (plan->skinny == SKINNY_SHORT_WIDE) {
+        kernel_sw(A, Bs, Cs, M, width, K, lda, ldb, ldc);
+        return;
+    }
+    if (plan->skinny == SKINNY_TALL) {
+        kernel_ts(A, B, C, M, plan->n, K, lda, ldb, ldc, ws);
+        return;
+    }
+
+    if (plan->dataflow == B_STATIONARY) {
+        if (plan->lmul == 2) kernel_bs_m2(A, Bs, Cs, M, width, K, lda, ldb, ldc);
+        else kernel_bs_m1(A, Bs, Cs, M, width, K, lda, ldb, ldc);
+    }
+    else if (plan->dataflow == A_STATIONARY) {
+        if (plan->th == 8) kernel_as_8_m1(A, Bs, Cs, M, width, K, lda, ldb, ldc);
+        else kernel_as_4_m1(A, Bs, Cs, M, width, K, lda, ldb, ldc);
+    }
+    else if (plan->epilogue_fused) {
+        if (plan->packed) kernel_ep_8_m2(A, Bs, Cs, M, width, K, lda, plan->tw, ldc, NULL, PACK_PREPACKED, &ep);
+        else kernel_ep_8_m2(A, Bs, Cs, M, width, K, lda, ldb, ldc, ws, plan->pack_mode, &ep);
+        return;
+    }
+    else if (plan->kernel) {
+        // pre-packed: ldb is the panel width
+        if (plan->packed) plan->kernel(A, Bs, Cs, M, width, K, lda, plan->tw, ldc, NULL, PACK_PREPACKED);
+        else plan->kernel(A, Bs, Cs, M, width, K, lda, ldb, ldc, ws, plan->pack_mode);
+    }
+
+    if (plan->rows < M) {
+        if (plan->packed) tail_rows_panels(A, Bs, Cs, plan->rows, M, width, K, lda, plan->tw, ldc);
+        else tail_rows(A, Bs, Cs, plan->rows, M, width, K, lda, ldb, ldc);
+    }
+
+    // epilogue not fused: one pass over the slice, still in cache for the last panels
+    if (plan->has_epilogue) {
+        gemm_epilogue_apply(Cs, M, width, ldc, &ep);
+    }
+}
+
+void gemm_execute(gemm_ctx_t* ctx, const gemm_plan_t* plan, const void* A, const void* B, void* C) {
+
+    // no context: the kernels allocate oB at every call
+    float* ws = (ctx && plan->ws_stride) ? gemm_ctx_ws(ctx, plan->ws_stride * plan->slices) : NULL;
+
+    if (plan->slices == 1) {
+        gemm_execute_slice(plan, (float*)A, (float*)B, (float*)C, 0, plan->n, ws);
+        return;
+    }
+
+    // rows of C per thread, B^T packed by each of them
+    if (plan->row_split) {
+        #pragma omp parallel for num_threads(plan->threads) schedule(static)
+        for (int s = 0; s < plan->slices; s++) {
+            int i0 = s * plan->slice;
+            int rows = plan->m - i0 < plan->slice ? plan->m - i0 : plan->slice;
+            kernel_ts((float*)A + (size_t)i0 * plan->lda, (float*)B, (float*)C + (size_t)i0 * plan->ldc, rows, plan->n, plan->k,
+                      plan->lda, plan->ldb, plan->ldc, ws ? ws + s * plan->ws_stride : NULL);
+        }
+        return;
+    }
+
+    #pragma omp parallel for num_threads(plan->threads) schedule(static)
+    for (int s = 0; s < plan->slices; s++) {
+        int j0 = s * plan->slice;
+        int width = plan->n - j0 < plan->slice ? plan->n - j0 : plan->slice;
+        gemm_execute_slice(plan, (float*)A, (float*)B, (float*)C, j0, width, ws ? ws + s * plan->ws_stride : NULL);
+    }
+}
+
+/*
+ * BATCHED GEMM
+ * batch problems with the shape of the plan: one problem per iteration, the
+ * iterations spread over the threads of the plan, each thread with its own oB
+ * taken once from the context for the whole batch. With a pre-packed plan B is
+ * shared by every problem (the B pointers are ignored).
+ */
+static inline int gemm_thread_num() {
+    #ifdef _OPENMP
+    return omp_get_thread_num();
+    #else
+    return 0;
+    #endif
+}
+
+void gemm_execute_batch(gemm_ctx_t* ctx, const gemm_plan_t* plan, int batch, const void* const* A, const void* const* B, void* const* C) {
+
+    float* ws = (ctx && plan->ws_stride) ? gemm_ctx_ws(ctx, plan->ws_stride * plan->threads) : NULL;
+
+    #pragma omp parallel for num_threads(plan->threads) schedule(static)
+    for (int b = 0; b < batch; b++) {
+        float* tws = ws ? ws + gemm_thread_num() * plan->ws_stride : NULL;
+        gemm_execute_slice(plan, (float*)A[b], B ? (float*)B[b] : NULL, (float*)C[b], 0, plan->n, tws);
+    }
+}
+
+// problem b at A + b * stride_a, B + b * stride_b, C + b * stride_c (elements), stride_b 0: shared B
+void gemm_execute_strided_batch(gemm_ctx_t* ctx, const gemm_plan_t* plan, int batch,
+                                const void* A, size_t stride_a, const void* B, size_t stride_b, void* C, size_t stride_c) {
+
+    float* ws = (ctx && plan->ws_stride) ? gemm_ctx_ws(ctx, plan->ws_stride * plan->threads) : NULL;
+
+    // element sizes of the dtype: the strides are in elements
+    const size_t in = plan->dtype == GEMM_F64 ? sizeof(double) : plan->dtype == GEMM_F32 ? sizeof(float) : sizeof(uint16_t);
+    const size_t out = plan->dtype == GEMM_F64 ? sizeof(double) : plan->dtype == GEMM_F16_F16 ? sizeof(_Float16) : sizeof(float);
+
+    #pragma omp parallel for num_threads(plan->threads) schedule(static)
+    for (int b = 0; b < batch; b++) {
+        float* tws = ws ? ws + gemm_thread_num() * plan->ws_stride : NULL;
+        gemm_execute_slice(plan, (float*)((const char*)A + b * stride_a * in), B ? (float*)((const char*)B + b * stride_b * in) : NULL,
+                           (float*)((char*)C + b * stride_c * out), 0, plan->n, tws);
+    }
+}
+
+/*
+ * GROUPED GEMM
+ * problems with their own shape (MoE experts: different M, same K/N). All the
+ * problems are cut into tiles of one panel (Tw columns) by one row block of the
+ * output-stationary kernel picked for that problem, and the global tile list
+ * is scheduled dynamically over the threads: a big expert is spread over
+ * every core instead of keeping one thread busy. A problem with fewer panels
+ * than threads is split into row blocks too (GROUP_MIN_ROWS rows at least).
+ * Each K x Tw panel of B is packed once per problem, by the first row block,
+ * into its own slot of the workspace before any tile runs; PACK_FUSED keeps
+ * one tile per panel (every row), the kernel packs it while consuming B.
+ */
+#define GROUP_MIN_ROWS 64
+
+struct gemm_tile {
+    int p;                      // problem
+    int i0, rows;               // rows of C (one row block)
+    int j0, width;              // columns of C (one panel)
+    int th, tw;
+    os_kernel_t kernel;         // NULL: tail_rows only
+    float* panel;               // K x tw panel packed up front, NULL: B read by the kernel
+};
+
+static struct gemm_tile* gemm_ctx_tiles(gemm_ctx_t* ctx, int size) {
+    if (ctx->tiles_size < size) {
+        free(ctx->tiles);
+        ctx->tiles = malloc(sizeof(struct gemm_tile) * size);
+        ctx->tiles_size = ctx->tiles ? size : 0;
+    }
+    return ctx->tiles;
+}
+
+static void gemm_execute_tile(const gemm_group_entry_t* e, const struct gemm_tile* t, float* ws, int pack_mode) {
+
+    const int lda = e->lda ? e->lda : e->k;
+    const int ldb = e->ldb ? e->ldb : e->n;
+    const int ldc = e->ldc ? e->ldc : e->n;
+
+    float* A = (float*)e->a + (size_t)t->i0 * lda;
+    float* B = (float*)e->b + t->j0;
+    float* C = (float*)e->c + (size_t)t->i0 * ldc + t->j0;
+
+    // packed panel: ldb is the panel width; otherwise the kernel packs the panel once for the rows of the tile
+    int rows = 0;
+    if (t->kernel) {
+        if (t->panel) t->kernel(A, t->panel, C, t->rows, t->width, e->k, lda, t->tw, ldc, NULL, PACK_PREPACKED);
+        else t->kernel(A, B, C, t->rows, t->width, e->k, lda, ldb, ldc, ws, pack_mode);
+        rows = t->rows - t->rows % t->th;
+    }
+    if (rows < t->rows) {
+        if (t->panel) tail_rows_panels(A, t->panel, C, rows, t->rows, t->width, e->k, lda, t->tw, ldc);
+        else tail_rows(A, B, C, rows, t->rows, t->width, e->k, lda, ldb, ldc);
+    }
+}
+
+int gemm_execute_grouped(gemm_ctx_t* ctx, int count, const gemm_group_entry_t* problems, int threads, const gemm_hints_t* hints) {
+
+    const gemm_hints_t none = { DATAFLOW_AUTO, 0, 0, PACK_SEPARATE, NULL, NULL, SEMIRING_PLUS_TIMES, NULL };
+    if (hints == NULL) hints = &none;
+
+    // the tail tiles are plus-times: semirings through gemm_plan only
+    if (hints->semiring != SEMIRING_PLUS_TIMES || hints->epilogue) return -1;
+
+    // the tiles run the output-stationary kernels on row-major B
+    gemm_hints_t h = *hints;
+    h.dataflow = OUTPUT_STATIONARY;
+    h.b = NULL;
+    h.packed = NULL;
+    const int pack_mode = h.pack_mode == PACK_FUSED ? PACK_FUSED : PACK_SEPARATE;
+
+    if (threads <= 0) threads = ctx ? ctx->ncpu : 1;
+
+    // tile list: first pass counts, second pass fills
+    int ntiles = 0;
+    size_t ws_stride = 0;       // fused: oB of one thread
+    size_t ws_size = 0;         // separate: every packed panel
+    struct gemm_tile* tiles = NULL;
+    float* ws = NULL;
+
+    for (int pass = 0; pass < 2; pass++) {
+        int t = 0;
+        float* panel = ws;
+
+        for (int p = 0; p < count; p++) {
+            const gemm_group_entry_t* e = &problems[p];
+            if (e->m <= 0 || e->n <= 0 || e->k <= 0) continue;
+
+            int dataflow, th, lmul;
+            gemm_resolve_cached(ctx, e->m, e->n, e->k, &h, &dataflow, &th, &lmul);
+
+            os_kernel_t kernel = os_kernel(th, lmul);
+            int tw = kernel ? panel_width(e->n, lmul) : __riscv_vsetvl_e32m4(e->n);
+            int panels = (e->n + tw - 1) / tw;
+            const int packed = kernel && pack_mode == PACK_SEPARATE;
+
+            // row blocks of whole tiles, enough of them to give every thread a tile
+            int block = e->m;
+            if (packed && panels < threads) {
+                int blocks = (threads + panels - 1) / panels;
+                block = (e->m + blocks - 1) / blocks;
+                if (block < GROUP_MIN_ROWS) block = GROUP_MIN_ROWS;
+                block = (block + th - 1) / th * th;
+            }
+
+            if (pass == 0) {
+                if (packed) ws_size += (size_t)panels * e->k * tw;
+                else if (kernel && (size_t)e->k * tw > ws_stride) ws_stride = (size_t)e->k * tw;
+                t += panels * ((e->m + block - 1) / block);
+                continue;
+            }
+
+            for (int j0 = 0; j0 < e->n; j0 += tw) {
+                for (int i0 = 0; i0 < e->m; i0 += block, t++) {
+                    tiles[t].p = p;
+                    tiles[t].i0 = i0;
+                    tiles[t].rows = e->m - i0 < block ? e->m - i0 : block;
+                    tiles[t].j0 = j0;
+                    tiles[t].width = e->n - j0 < tw ? e->n - j0 : tw;
+                    tiles[t].th = th;
+                    tiles[t].tw = tw;
+                    tiles[t].kernel = kernel;
+                    tiles[t].panel = packed ? panel : NULL;
+                }
+                if (packed) panel += (size_t)e->k * tw;
+            }
+        }
+
+        if (pass == 0) {
+            ntiles = t;
+            if (ntiles == 0) return 0;
+
+            tiles = ctx ? gemm_ctx_tiles(ctx, ntiles) : malloc(sizeof(struct gemm_tile) * ntiles);
+            if (tiles == NULL) return -1;
+
+            // the packed panels are shared by the threads, the fused oB is one per thread
+            if (ws_size) {
+                ws = ctx ? gemm_ctx_ws(ctx, ws_size) : malloc(sizeof(float) * ws_size);
+                if (ws == NULL) {
+                    if (ctx == NULL) free(tiles);
+                    return -1;
+                }
+            }
+            else if (ctx && ws_stride) ws = gemm_ctx_ws(ctx, ws_stride * threads);
+        }
+    }
+
+    if( DEBUG_ENABLED && ctx && ctx->debug_level >= 0 ){
+        printf("grouped> problems=%d tiles=%d threads=%d packed=%ld\n", count, ntiles, threads, (long)ws_size);
+    }
+
+    #pragma omp parallel num_threads(threads)
+    {
+        // the first row block of each panel packs it, every tile waits for the packing
+        #pragma omp for schedule(dynamic)
+        for (int i = 0; i < ntiles; i++) {
+            const struct gemm_tile* t = &tiles[i];
+            const gemm_group_entry_t* e = &problems[t->p];
+            if (t->panel && t->i0 == 0)
+                reordering_rvv((const float*)e->b + t->j0, t->panel, e->k, e->ldb ? e->ldb : e->n, t->tw, t->width);
+        }
+
+        #pragma omp for schedule(dynamic)
+        for (int i = 0; i < ntiles; i++) {
+            float* tws = (ws && !ws_size) ? ws + gemm_thread_num() * ws_stride : NULL;
+            gemm_execute_tile(&problems[tiles[i].p], &tiles[i], tws, pack_mode);
+        }
+    }
+
+    if (ctx == NULL) {
+        free(tiles);
+        free(ws);
+    }
+
+    return 0;
+}
+
+void gemm_destroy(gemm_plan_t* plan) {
+    if (plan == NULL) return;
+    if (plan->pack_owned) packed_b_free((packed_b_t*)plan->packed);
+    free(plan->residual_copy);
+    free(plan);
+}
+
+void gemm_plan_print(const gemm_plan_t* plan) {
+    printf("> plan: dataflow:%s th:%d lmul:%d tw:%d pack:%s threads:%d slices:%d tail_rows:%d small:%d skinny:%d epilogue:%s\n",
+        dataflow_name(plan->dataflow), plan->th, plan->lmul, plan->tw, pack_mode_name(plan->pack_mode),
+        plan->threads, plan->slices, plan->m - plan->rows, plan->small != NULL, plan->skinny,
+        plan->epilogue_fused ? "fused\0" : plan->has_epilogue ? "pass\0" : "none\0");
+}
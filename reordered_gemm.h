@@ -0,0 +1,354 @@
+#ifndef REORDERED_GEMM_H_
+#define REORDERED_GEMM_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+enum Dataflow {
+    DATAFLOW_AUTO = 0,          // selected by shape (select_dataflow)
+    OUTPUT_STATIONARY = 1,      // C tile in registers, A scalars and B rows stream
+    B_STATIONARY = 2,           // B strip in registers, A and C rows stream
+    A_STATIONARY = 3,           // A block in registers, B and C rows stream
+};
+
+// packing of the B panel in the output-stationary kernels
+enum PackMode {
+    PACK_SEPARATE = 0,          // reordering_rvv pass over the panel before the first row block
+    PACK_FUSED = 1,             // the first row block writes oB while consuming the rows of B
+    PACK_PREPACKED = 2,         // B already packed by pack_b (used by multiply_gemm_packed)
+};
+
+// layout of a packed B
+enum PackedLayout {
+    PACKED_B_PANELS = 0,        // ceil(N / Tw) panels of K x Tw, row stride Tw
+};
+
+int get_vlen();
+
+int select_dataflow(int M, int N, int K);
+const char* dataflow_name(int dataflow);
+const char* pack_mode_name(int pack_mode);
+
+// GEMV, row-major, no packing: y (M) = A (M x K) x, y (N) = x^T B (K x N)
+void gemv_n(const float* A, const float* x, float* y, int M, int K, int lda);
+void gemv_t(const float* x, const float* B, float* y, int K, int N, int ldb);
+
+// pre-packed B: packed once, reused by every multiply_gemm_packed with the same B
+typedef struct packed_b packed_b_t;
+
+packed_b_t* pack_b(const float* B, int K, int N, int lmul);
+void packed_b_free(packed_b_t* pack);
+
+int packed_b_layout(const packed_b_t* pack);
+int packed_b_k(const packed_b_t* pack);
+int packed_b_n(const packed_b_t* pack);
+int packed_b_lmul(const packed_b_t* pack);
+int packed_b_tw(const packed_b_t* pack);
+int packed_b_panels(const packed_b_t* pack);
+const float* packed_b_data(const packed_b_t* pack);
+
+/*
+ * PACKED B FILE (little-endian)
+ * [header, 64 bytes][padding up to data_offset][panels: panels * panel_stride floats]
+ * data_offset is a multiple of align, so the panels keep their alignment when the
+ * file is mapped. A file written on another VLEN is repacked on load.
+ */
+#define PACKED_B_MAGIC      "RVVPKB\0"
+#define PACKED_B_VERSION    1
+
+struct packed_b_file_header {
+    char magic[8];              // PACKED_B_MAGIC
+    uint32_t version;           // PACKED_B_VERSION
+    uint32_t vlen;              // VLEN (bits) of the machine that packed B
+    uint32_t layout;            // enum PackedLayout
+    int32_t lmul;               // LMUL the panels are sized for (-2 = mf2)
+    uint32_t tw;                // panel width
+    uint32_t kc;                // rows of B in a panel (no K blocking: kc = k)
+    uint32_t k, n;              // shape of the original B
+    uint32_t panels;            // ceil(n / tw)
+    uint32_t align;             // alignment (bytes) of the panels
+    uint32_t elem_size;         // sizeof(float)
+    uint32_t reserved;
+    uint64_t data_offset;       // bytes from the start of the file to the first panel
+};
+
+// 0 on success, -1 on error
+int packed_b_save(const packed_b_t* pack, const char* path);
+
+// the panels are mapped in place (zero copy) when VLEN matches, repacked otherwise
+packed_b_t* packed_b_load(const char* path);
+int packed_b_is_mapped(const packed_b_t* pack);
+
+/*
+ * PLAN / EXECUTE
+ * gemm_plan resolves dataflow, tile, LMUL, workspace and (optionally) the packing
+ * of B once for a shape; gemm_execute runs it with no setup, as many times as needed.
+ */
+enum GemmDtype {
+    GEMM_F32 = 0,               // float A, B, C
+    GEMM_F16 = 1,               // _Float16 A, B, float C (fp32 accumulation)
+    GEMM_F16_F16 = 2,           // _Float16 A, B, C (fp32 accumulation, narrowed on store)
+    GEMM_BF16 = 3,              // __bf16 A, B, float C (fp32 accumulation)
+    GEMM_F64 = 4,               // double A, B, C (output-stationary, own tuning table)
+};
+
+// (sum, product) of the GEMM, gemm_hints_t.semiring
+enum Semiring {
+    SEMIRING_PLUS_TIMES = 0,    // C = sum_k A B
+    SEMIRING_MIN_PLUS = 1,      // C = min_k (A + B): shortest paths, zero +inf
+    SEMIRING_MAX_PLUS = 2,      // C = max_k (A + B): longest / critical paths, zero -inf
+};
+
+/*
+ * EPILOGUE
+ * applied to the accumulators before the store (gemm_hints_t.epilogue), in order:
+ * C = clamp(act(acc * row_scale[i] * col_scale[j] + bias[j])) + residual[i][j]
+ * NULL pointers / zero fields skip their step. Fused in the 8 x m2 output-stationary
+ * kernel (picked when the hints leave the tile open), one pass per slice otherwise.
+ */
+enum Activation {
+    ACT_NONE = 0,
+    ACT_RELU = 1,
+    ACT_GELU = 2,               // tanh approximation
+    ACT_SILU = 3,               // x * sigmoid(x)
+};
+
+typedef struct {
+    const float* row_scale;     // M values
+    const float* col_scale;     // N values (per-channel dequantisation)
+    const float* bias;          // N values
+    int act;                    // enum Activation
+    int clamp;                  // clamp to [lo, hi] after the activation
+    float lo, hi;
+    const float* residual;      // M x N, may be C itself (not fused: its old values saved in M x N floats of the plan)
+    int ldr;                    // row stride of residual, 0: N
+} gemm_epilogue_t;
+
+// the epilogue as a separate pass over C (M x N, row stride ldc)
+void gemm_epilogue_apply(float* C, int M, int N, int ldc, const gemm_epilogue_t* ep);
+
+typedef struct {
+    int m, n, k;                // C (m x n) = A (m x k) * B (k x n)
+} gemm_shape_t;
+
+typedef struct {
+    int lda, ldb, ldc;          // row strides in elements, 0: dense row-major (k, n, n)
+} gemm_strides_t;
+
+typedef struct {
+    int dataflow;               // DATAFLOW_AUTO: select_dataflow
+    int th;                     // rows per tile, 0: tuning table
+    int lmul;                   // 0: tuning table
+    int pack_mode;              // PACK_SEPARATE or PACK_FUSED
+    const float* b;             // if set, B is packed at plan time and gemm_execute ignores its B
+    const packed_b_t* packed;   // if set, B already packed (not owned by the plan)
+    int semiring;               // enum Semiring: not PLUS_TIMES only GEMM_F32, output-stationary 8 x m2
+    const gemm_epilogue_t* epilogue;    // GEMM_F32, plus-times; copied by the plan, NULL: none
+} gemm_hints_t;
+
+typedef struct gemm_plan gemm_plan_t;
+
+/*
+ * CONTEXT
+ * machine info, tuning cache and workspaces of one caller: every application thread
+ * issuing GEMMs creates its own. Plans hold no mutable state and can be shared.
+ * ctx may be NULL: no cache, and the kernels allocate their workspace at every call.
+ */
+typedef struct gemm_ctx gemm_ctx_t;
+
+gemm_ctx_t* gemm_ctx_create(int debug_level);
+void gemm_ctx_destroy(gemm_ctx_t* ctx);
+int gemm_ctx_vlen(const gemm_ctx_t* ctx);
+int gemm_ctx_ncpu(const gemm_ctx_t* ctx);
+long gemm_ctx_l1d_size(const gemm_ctx_t* ctx);
+long gemm_ctx_l2_size(const gemm_ctx_t* ctx);
+
+// NULL if the shape, strides, dtype or hints have no kernel; threads 0: one per cpu
+gemm_plan_t* gemm_plan(gemm_ctx_t* ctx, gemm_shape_t shape, gemm_strides_t strides, int dtype, int threads, const gemm_hints_t* hints);
+void gemm_execute(gemm_ctx_t* ctx, const gemm_plan_t* plan, const void* A, const void* B, void* C);
+void gemm_destroy(gemm_plan_t* plan);
+
+// batch problems with the shape of the plan, parallel over the batch (threads of the plan)
+void gemm_execute_batch(gemm_ctx_t* ctx, const gemm_plan_t* plan, int batch, const void* const* A, const void* const* B, void* const* C);
+void gemm_execute_strided_batch(gemm_ctx_t* ctx, const gemm_plan_t* plan, int batch,
+                                const void* A, size_t stride_a, const void* B, size_t stride_b, void* C, size_t stride_c);
+
+// grouped GEMM: one problem per entry, each with its own shape and operands
+typedef struct {
+    int m, n, k;
+    const void* a;
+    const void* b;
+    void* c;
+    int lda, ldb, ldc;          // 0: dense row-major
+} gemm_group_entry_t;
+
+// every problem with the output-stationary kernels (tile from hints / tuning), 0 on success
+int gemm_execute_grouped(gemm_ctx_t* ctx, int count, const gemm_group_entry_t* problems, int threads, const gemm_hints_t* hints);
+void gemm_plan_print(const gemm_plan_t* plan);
+
+// one-shot wrappers: plan, execute, destroy
+// C (M x N) = A (M x K) * B (K x N), row-major
+void multiply_gemm(float* A, float* B, float* C, int M, int N, int K, int th, int lmul, int dataflow, int pack_mode);
+void multiply_gemm_packed(float* A, const packed_b_t* pack, float* C, int M, int th);
+
+// C[c_rows[i]] = A[a_rows[i]] * B, i in [0, M): rows gathered / scattered by the kernel, NULL: identity
+// 0 on success, -1 on a negative row or an allocation failure (C not written)
+int multiply_gemm_indexed(const float* A, const int* a_rows, const float* B, float* C, const int* c_rows,
+                          int M, int N, int K, int lda, int ldb, int ldc);
+
+/*
+ * FUSED MLP
+ * Y (M x O) = act(X W1 + b1) W2 + b2, X M x D, W1 D x H, W2 H x O, row-major.
+ * Row blocks of X go through the first GEMM into a hidden tile sized for L2,
+ * the second GEMM reads it back from there: the M x H activation never reaches
+ * DRAM. W1, W2 packed once at creation, b1, b2 may be NULL.
+ */
+typedef struct gemm_mlp gemm_mlp_t;
+
+gemm_mlp_t* gemm_mlp_create(gemm_ctx_t* ctx, int D, int H, int O, const float* W1, const float* b1,
+                            const float* W2, const float* b2, int act, int threads);
+// 0 on success, -1 if the hidden tile or the plans of the last block cannot be allocated (Y not written)
+int gemm_mlp_execute(gemm_ctx_t* ctx, const gemm_mlp_t* mlp, const float* X, float* Y, int M);
+void gemm_mlp_destroy(gemm_mlp_t* mlp);
+int gemm_mlp_rows(const gemm_mlp_t* mlp);
+
+// one-shot: create, execute, destroy; 0 on success, -1 on a bad shape or an allocation failure
+int multiply_mlp(const float* X, const float* W1, const float* b1, const float* W2, const float* b2, float* Y,
+                 int M, int D, int H, int O, int act);
+
+/*
+ * FUSED ATTENTION
+ * O = softmax(Q K^T * scale) V for heads independent heads (batch x heads), dense
+ * row-major per head: Q S_q x d, K S_k x d, V S_k x dv, O S_q x dv, one after the other.
+ * scale 0: 1 / sqrt(d). causal: query i sees the keys j <= i + S_k - S_q.
+ * Online softmax over key blocks: no S_q x S_k score matrix.
+ */
+// 0 on success, -1 on a bad shape or an allocation failure (O not written)
+int multiply_attention(const float* Q, const float* K, const float* V, float* O, int heads, int Sq, int Sk,
+                       int d, int dv, float scale, int causal, int threads);
+
+// X = softmax(X * scale) by rows (rows x cols, row stride ld), causal as multiply_attention
+void softmax_rows(float* X, int rows, int cols, int ld, float scale, int causal);
+
+/*
+ * NEAREST NEIGHBOURS
+ * The k nearest rows of Y (N x D) to every row of X (M x D), dense row-major,
+ * squared L2 = ||x||^2 + ||y||^2 - 2 x.y. idx, dist: M x k, nearest first
+ * (idx -1, dist +inf past N). The distances go from the GEMM accumulators to a
+ * bounded heap per query: no M x N distance matrix.
+ */
+// 0 on success, -1 on a bad shape or an allocation failure (idx, dist not written)
+int knn_search(const float* X, const float* Y, int M, int N, int D, int k, int* idx, float* dist, int threads);
+
+// unfused: the k smallest xn[i] + yn[j] - 2 G[i][j] of every row of G = X Y^T (rows x cols, row stride ld); 0 or -1 as knn_search
+int knn_select(const float* G, const float* xn, const float* yn, int rows, int cols, int ld, int k, int* idx, float* dist);
+// norms[i] = ||X[i]||^2 (rows x cols, row stride ld)
+void row_sqnorms(const float* X, int rows, int cols, int ld, float* norms);
+
+/*
+ * CONVOLUTION
+ * Y = conv(X, W) lowered to GEMMs, one per image and group, float, no bias.
+ * NCHW: X n x c x h x w, W k x c/groups x r x s (KCRS), Y n x k x oh x ow.
+ * NHWC: X n x h x w x c, W r x s x c/groups x k (RSCK), Y n x oh x ow x k.
+ */
+enum ConvLayout {
+    CONV_NCHW = 0,
+    CONV_NHWC = 1,
+};
+
+enum ConvAlgo {
+    CONV_AUTO = 0,              // CONV_1X1 when possible, CONV_IMPLICIT otherwise
+    CONV_IM2COL = 1,            // im2col buffer (r s times the image), then a plan over it
+    CONV_IMPLICIT = 2,          // no im2col: the panels are gathered from X when packed
+    CONV_1X1 = 3,               // 1x1 filter, stride 1, no padding: X is the GEMM operand as is
+};
+
+typedef struct {
+    int n, c, h, w;             // input: images, channels, height, width
+    int k, r, s;                // output channels, filter height, width
+    int stride_h, stride_w;     // 0: 1
+    int pad_h, pad_w;           // zeros on each side
+    int dil_h, dil_w;           // 0: 1
+    int groups;                 // 0: 1, divides c and k
+    int layout;                 // enum ConvLayout
+} gemm_conv_t;
+
+int gemm_conv_out_h(const gemm_conv_t* cv);
+int gemm_conv_out_w(const gemm_conv_t* cv);
+
+// 0 on success, -1 on a bad shape, an algo (enum ConvAlgo) that does not apply or an allocation failure; threads 0: one per cpu
+int gemm_conv(gemm_ctx_t* ctx, const gemm_conv_t* cv, const float* X, const float* W, float* Y, int algo, int threads);
+
+// C = A (+) B on a semiring (enum Semiring): float, row-major
+void multiply_gemm_semiring(float* A, float* B, float* C, int M, int N, int K, int semiring);
+
+// double A, B, C; th, lmul 0: fp64 tuning table (lmul 1, 2, 4, 8, th up to 16, 8, 4, 2)
+void multiply_gemm_f64(const double* A, const double* B, double* C, int M, int N, int K, int th, int lmul);
+
+// complex float A, B, C: interleaved (re, im) pairs, dimensions in complex elements
+void multiply_gemm_c32(const float* A, const float* B, float* C, int M, int N, int K);
+
+// half precision A, B (widening fma with Zvfh), C float or _Float16 (out_f16)
+void multiply_gemm_f16(const _Float16* A, const _Float16* B, void* C, int M, int N, int K, int out_f16);
+
+// bfloat16 A, B (widening fma with Zvfbfwma, widened in registers otherwise), C float
+void multiply_gemm_bf16(const __bf16* A, const __bf16* B, float* C, int M, int N, int K);
+
+// software conversions (bit exact, round to nearest even)
+float bf16_to_f32(__bf16 h);
+__bf16 f32_to_bf16(float f);
+
+/*
+ * INT8 GEMM
+ * C = epilogue(sum_k (A - a_zero) * B), A uint8_t / int8_t, B int8_t (symmetric,
+ * one scale per column), int32 accumulation.
+ */
+enum QuantOut {
+    QUANT_OUT_F32 = 0,          // float: acc * a_scale * b_scale[j]
+    QUANT_OUT_I8 = 1,           // int8_t: saturate(round(F32 / c_scale) + c_zero)
+    QUANT_OUT_S32 = 2,          // int32_t: acc (zero point of A removed)
+};
+
+typedef struct {
+    int a_unsigned;             // A is uint8_t (else int8_t)
+    int a_zero;
+    float a_scale;
+    const float* b_scale;       // N scales, NULL: 1
+    int out;                    // enum QuantOut
+    float c_scale;              // QUANT_OUT_I8 only
+    int c_zero;
+} gemm_quant_t;
+
+// largest K the int32 accumulators hold: |(A - a_zero) B| <= 255 * 128
+#define GEMM_I8_MAX_K 65793
+
+// bytes of the workspace of multiply_gemm_i8 (colsum, scales, int8 B panel)
+size_t gemm_i8_ws_size(int N, int K);
+
+// ws: gemm_i8_ws_size(N, K) bytes reused across calls (NULL: allocated per call); 0, or -1 if K > GEMM_I8_MAX_K
+int multiply_gemm_i8(const void* A, const int8_t* B, void* C, int M, int N, int K, const gemm_quant_t* q, void* ws);
+
+// Q15 fixed point: C = sat16(round(sum A B >> shift)), int32 accumulation (15: Q15 x Q15 -> Q15)
+void multiply_gemm_q15(const int16_t* A, const int16_t* B, int16_t* C, int M, int N, int K, int shift);
+
+/*
+ * BINARY GEMM
+ * +1 / -1 as bits (1 / 0), 32 per word along K, bits past K zero: A by rows
+ * (M x ceil(K / 32) words), B by columns (N x ceil(K / 32) words).
+ * C (int32) = K - 2 * popcount(a XOR b), the +1 / -1 dot product.
+ */
+void multiply_gemm_bin(const uint32_t* A, const uint32_t* B, int32_t* C, int M, int N, int K);
+void binarize_rows(const float* X, uint32_t* Xb, int rows, int cols, int ld);
+void binarize_cols(const float* X, uint32_t* Xb, int rows, int cols, int ld);
+
+/*
+ * INT4 WEIGHT-ONLY GEMM
+ * B row k: (N + 1) / 2 bytes, column j in byte j / 2 (low nibble for even j),
+ * weight = (nibble - 8) * scales[k / group][j] (ceil(K / group) x N scales).
+ * A and C fp32, B dequantised in the packing stage (in registers for M <= 8).
+ */
+void multiply_gemm_q4(const float* A, const uint8_t* B, const float* scales, int group, float* C, int M, int N, int K);
+void quantize_q4(const float* B, uint8_t* Bq, float* scales, int K, int N, int group);
+void dequantize_q4(const uint8_t* Bq, const float* scales, float* B, int K, int N, int group);
+
+#endif /* REORDERED_GEMM_H_ */
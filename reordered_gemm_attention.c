@@ -0,0 +1,254 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <riscv_vector.h>
+#include "reordered_gemm.h"
+#include "rvv_math.h"
+#include "reordered_gemm_kernel.h"
+
+/*
+ * FUSED ATTENTION (flash-attention style)
+ * O = softmax(Q K^T * scale) V per head, the S_q x S_k score matrix never stored.
+ * Per head K is transposed once into panels (Kt, d x S_k): the B operand of
+ * the output-stationary tile. Per block of Th=8 query rows, and per key block
+ * of Tw = VLMAX(e32m2) keys:
+ *   S = Q_blk Kt[:, kb:kb+Tw]     8 accumulators, stored to P (8 x Tw, L1)
+ *   online softmax per row: m' = max(m, max S), p = exp(S - m'),
+ *   l = l exp(m - m') + sum p     m, l per row, the row of S in one register
+ *   O_blk = O_blk exp(m - m') + P V[kb:kb+Tw]    output-stationary tile, A = P
+ * and O_blk / l at the end. Memory: Kt (the size of K) and P, O(S) per head.
+ * Causal: query i sees the keys j <= i + S_k - S_q; key blocks past the last
+ * row of the query block are skipped, masked keys get p = 0 exactly.
+ * Threads: one task per (head, query block), dynamic schedule (the causal
+ * blocks are uneven).
+ */
+
+#define ATT_TH 8
+
+// exp of one float (no libm)
+static float exp_f32(float x) {
+    vfloat32m2_t v = exp_f32m2(__riscv_vfmv_v_f_f32m2(x, 1), 1);
+    return __riscv_vfmv_f_s_f32m2_f32(v);
+}
+
+// K (rows x d, row stride ld) transposed into Kt (d x rows, row stride ldt)
+static void transpose_k(const float* K, float* Kt, int rows, int d, int ld, int ldt) {
+    size_t vl;
+    for (int j = 0; j < rows; j += vl) {
+        vl = __riscv_vsetvl_e32m2(rows - j);
+        for (int k = 0; k < d; k++)
+            __riscv_vse32_v_f32m2(&Kt[(size_t)k * ldt + j], __riscv_vlse32_v_f32m2(&K[(size_t)j * ld + k], sizeof(float) * ld, vl), vl);
+    }
+}
+
+#define PV_LOAD(r, vc) vc = __riscv_vfmul_vf_f32m2(__riscv_vle32_v_f32m2(&O[(size_t)(r) * ldo + j], vl), alpha[r], vl)
+
+// O (R x dv) = O * alpha + P (R x nk) V (nk x dv): R constant once inlined
+static inline __attribute__((always_inline))
+void pv_tile(const float* P, int ldp, const float* V, int ldv, float* O, int ldo, const float* alpha,
+             const int R, int nk, int dv) {
+
+    size_t vl;
+    for (int j = 0; j < dv; j += vl) {
+        vl = __riscv_vsetvl_e32m2(dv - j);
+
+        vfloat32m2_t vc0, vc1, vc2, vc3, vc4, vc5, vc6, vc7;
+        PV_LOAD(0, vc0);
+        if (R > 1) PV_LOAD(1, vc1);
+        if (R > 2) PV_LOAD(2, vc2);
+        if (R > 3) PV_LOAD(3, vc3);
+        if (R > 4) PV_LOAD(4, vc4);
+        if (R > 5) PV_LOAD(5, vc5);
+        if (R > 6) PV_LOAD(6, vc6);
+        if (R > 7) PV_LOAD(7, vc7);
+
+        for (int c = 0; c < nk; c++) {
+            vfloat32m2_t vb = __riscv_vle32_v_f32m2(&V[(size_t)c * ldv + j], vl);
+
+            vc0 = __riscv_vfmacc_vf_f32m2(vc0, P[0 * ldp + c], vb, vl);
+            if (R > 1) vc1 = __riscv_vfmacc_vf_f32m2(vc1, P[1 * ldp + c], vb, vl);
+            if (R > 2) vc2 = __riscv_vfmacc_vf_f32m2(vc2, P[2 * ldp + c], vb, vl);
+            if (R > 3) vc3 = __riscv_vfmacc_vf_f32m2(vc3, P[3 * ldp + c], vb, vl);
+            if (R > 4) vc4 = __riscv_vfmacc_vf_f32m2(vc4, P[4 * ldp + c], vb, vl);
+            if (R > 5) vc5 = __riscv_vfmacc_vf_f32m2(vc5, P[5 * ldp + c], vb, vl);
+            if (R > 6) vc6 = __riscv_vfmacc_vf_f32m2(vc6, P[6 * ldp + c], vb, vl);
+            if (R > 7) vc7 = __riscv_vfmacc_vf_f32m2(vc7, P[7 * ldp + c], vb, vl);
+        }
+
+        __riscv_vse32_v_f32m2(&O[0 * ldo + j], vc0, vl);
+        if (R > 1) __riscv_vse32_v_f32m2(&O[1 * ldo + j], vc1, vl);
+        if (R > 2) __riscv_vse32_v_f32m2(&O[2 * ldo + j], vc2, vl);
+        if (R > 3) __riscv_vse32_v_f32m2(&O[3 * ldo + j], vc3, vl);
+        if (R > 4) __riscv_vse32_v_f32m2(&O[4 * ldo + j], vc4, vl);
+        if (R > 5) __riscv_vse32_v_f32m2(&O[5 * ldo + j], vc5, vl);
+        if (R > 6) __riscv_vse32_v_f32m2(&O[6 * ldo + j], vc6, vl);
+        if (R > 7) __riscv_vse32_v_f32m2(&O[7 * ldo + j], vc7, vl);
+    }
+}
+
+// one block of R query rows (q0: position of the first) against every key of the head
+static inline __attribute__((always_inline))
+void attention_block(const float* Q, const float* Kt, const float* V, float* O, float* P,
+                     const int R, int q0, int Sk, int d, int dv, int ldt, int Tw, float scale, int causal, int offset) {
+
+    float m[ATT_TH], l[ATT_TH], alpha[ATT_TH];
+    for (int r = 0; r < R; r++) {
+        m[r] = -__builtin_inff();
+        l[r] = 0.0f;
+    }
+    for (int r = 0; r < R; r++)
+        for (int j = 0; j < dv; j++) O[(size_t)r * dv + j] = 0.0f;
+
+    // causal: no key past the last row of the block
+    int kend = causal ? q0 + R + offset : Sk;
+    if (kend > Sk) kend = Sk;
+
+    for (int kb = 0; kb < kend; kb += Tw) {
+        size_t vl = __riscv_vsetvl_e32m2(kend - kb);
+
+        os_tile_f32m2(Q, d, &Kt[kb], ldt, P, Tw, R, d, vl);
+
+        // online softmax, row by row: the row of scores in one register
+        for (int r = 0; r < R; r++) {
+            float* p = &P[(size_t)r * Tw];
+
+            // keys [kb, kb + n) visible to this row
+            int n = causal ? q0 + r + offset + 1 - kb : (int)vl;
+            if (n > (int)vl) n = vl;
+            if (n <= 0) {
+                for (size_t c = 0; c < vl; c++) p[c] = 0.0f;
+                alpha[r] = 1.0f;
+                continue;
+            }
+
+            vfloat32m2_t s = __riscv_vfmul_vf_f32m2(__riscv_vle32_v_f32m2(p, n), scale, n);
+            float mb = __riscv_vfmv_f_s_f32m1_f32(__riscv_vfredmax_vs_f32m2_f32m1(s, __riscv_vfmv_s_f_f32m1(m[r], 1), n));
+
+            vfloat32m2_t e = exp_f32m2(__riscv_vfsub_vf_f32m2(s, mb, n), n);
+            float sum = __riscv_vfmv_f_s_f32m1_f32(__riscv_vfredusum_vs_f32m2_f32m1(e, __riscv_vfmv_s_f_f32m1(0.0f, 1), n));
+
+            alpha[r] = exp_f32(m[r] - mb);
+            l[r] = l[r] * alpha[r] + sum;
+            m[r] = mb;
+
+            __riscv_vse32_v_f32m2(p, e, n);
+            for (size_t c = n; c < vl; c++) p[c] = 0.0f;
+        }
+
+        pv_tile(P, Tw, &V[(size_t)kb * dv], dv, O, dv, alpha, R, vl, dv);
+    }
+
+    // O / l (rows with no visible key: 0)
+    for (int r = 0; r < R; r++) {
+        float inv = l[r] > 0.0f ? 1.0f / l[r] : 0.0f;
+        size_t vl;
+        for (int j = 0; j < dv; j += vl) {
+            vl = __riscv_vsetvl_e32m2(dv - j);
+            float* o = &O[(size_t)r * dv + j];
+            __riscv_vse32_v_f32m2(o, __riscv_vfmul_vf_f32m2(__riscv_vle32_v_f32m2(o, vl), inv, vl), vl);
+        }
+    }
+}
+
+int multiply_attention(const float* Q, const float* K, const float* V, float* O, int heads, int Sq, int Sk,
+                       int d, int dv, float scale, int causal, int threads) {
+
+    if (heads <= 0 || Sq <= 0 || Sk <= 0 || d <= 0 || dv <= 0) return -1;
+    if (threads <= 0) threads = 1;
+
+    // 1 / sqrt(d) without libm
+    if (scale == 0.0f)
+        scale = 1.0f / __riscv_vfmv_f_s_f32m1_f32(__riscv_vfsqrt_v_f32m1(__riscv_vfmv_v_f_f32m1((float)d, 1), 1));
+
+    const int Tw = __riscv_vsetvlmax_e32m2();
+    const int offset = Sk - Sq;
+    const int blocks = (Sq + ATT_TH - 1) / ATT_TH;
+
+    // K^T of every head, once
+    float* Kt = malloc(sizeof(float) * heads * d * Sk);
+    if (Kt == NULL) return -1;
+
+    #pragma omp parallel for num_threads(threads) schedule(static)
+    for (int h = 0; h < heads; h++)
+        transpose_k(K + (size_t)h * Sk * d, Kt + (size_t)h * d * Sk, Sk, d, d, Sk);
+
+    int failed = 0;
+
+    #pragma omp parallel num_threads(threads)
+    {
+        float* P = malloc(sizeof(float) * ATT_TH * Tw);
+        if (P == NULL) {
+            #pragma omp atomic write
+            failed = 1;
+        }
+
+        // a thread without P: no block runs, O is left unwritten
+        #pragma omp barrier
+        if (!failed) {
+            #pragma omp for schedule(dynamic)
+            for (int t = 0; t < heads * blocks; t++) {
+                const int h = t / blocks;
+                const int q0 = (t % blocks) * ATT_TH;
+
+                const float* q = Q + ((size_t)h * Sq + q0) * d;
+                const float* kt = Kt + (size_t)h * d * Sk;
+                const float* v = V + (size_t)h * Sk * dv;
+                float* o = O + ((size_t)h * Sq + q0) * dv;
+
+                switch (Sq - q0 < ATT_TH ? Sq - q0 : ATT_TH) {
+                    case 8:  attention_block(q, kt, v, o, P, 8, q0, Sk, d, dv, Sk, Tw, scale, causal, offset); break;
+                    case 7:  attention_block(q, kt, v, o, P, 7, q0, Sk, d, dv, Sk, Tw, scale, causal, offset); break;
+                    case 6:  attention_block(q, kt, v, o, P, 6, q0, Sk, d, dv, Sk, Tw, scale, causal, offset); break;
+                    case 5:  attention_block(q, kt, v, o, P, 5, q0, Sk, d, dv, Sk, Tw, scale, causal, offset); break;
+                    case 4:  attention_block(q, kt, v, o, P, 4, q0, Sk, d, dv, Sk, Tw, scale, causal, offset); break;
+                    case 3:  attention_block(q, kt, v, o, P, 3, q0, Sk, d, dv, Sk, Tw, scale, causal, offset); break;
+                    case 2:  attention_block(q, kt, v, o, P, 2, q0, Sk, d, dv, Sk, Tw, scale, causal, offset); break;
+                    default: attention_block(q, kt, v, o, P, 1, q0, Sk, d, dv, Sk, Tw, scale, causal, offset); break;
+                }
+            }
+        }
+
+        free(P);
+    }
+
+    free(Kt);
+    return failed ? -1 : 0;
+}
+
+void softmax_rows(float* X, int rows, int cols, int ld, float scale, int causal) {
+
+    const int offset = cols - rows;
+
+    for (int i = 0; i < rows; i++) {
+        float* x = &X[(size_t)i * ld];
+
+        // columns [0, n) visible to the row, the others 0
+        int n = causal ? i + offset + 1 : cols;
+        if (n > cols) n = cols;
+        if (n < 0) n = 0;
+        for (int j = n; j < cols; j++) x[j] = 0.0f;
+        if (n == 0) continue;
+
+        size_t vl;
+        float mx = -__builtin_inff();
+        for (int j = 0; j < n; j += vl) {
+            vl = __riscv_vsetvl_e32m2(n - j);
+            vfloat32m2_t s = __riscv_vfmul_vf_f32m2(__riscv_vle32_v_f32m2(&x[j], vl), scale, vl);
+            mx = __riscv_vfmv_f_s_f32m1_f32(__riscv_vfredmax_vs_f32m2_f32m1(s, __riscv_vfmv_s_f_f32m1(mx, 1), vl));
+        }
+
+        float sum = 0.0f;
+        for (int j = 0; j < n; j += vl) {
+            vl = __riscv_vsetvl_e32m2(n - j);
+            vfloat32m2_t s = __riscv_vfmul_vf_f32m2(__riscv_vle32_v_f32m2(&x[j], vl), scale, vl);
+            vfloat32m2_t e = exp_f32m2(__riscv_vfsub_vf_f32m2(s, mx, vl), vl);
+            sum = __riscv_vfmv_f_s_f32m1_f32(__riscv_vfredusum_vs_f32m2_f32m1(e, __riscv_vfmv_s_f_f32m1(sum, 1), vl));
+            __riscv_vse32_v_f32m2(&x[j], e, vl);
+        }
+
+        const float inv = 1.0f / sum;
+        for (int j = 0; j < n; j += vl) {
+            vl = __riscv_vsetvl_e32m2(n - j);
+            __riscv_vse32_v_f32m2(&x[j], __riscv_vfmul_vf_f32m2(__riscv_vle32_v_f32m2(&x[j], vl), inv, vl), vl);
+        }
+    }
+}
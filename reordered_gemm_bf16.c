@@ -0,0 +1,143 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <riscv_vector.h>
+#include "reordered_gemm.h"
+
+/*
+ * BFLOAT16 (bf16 A and B, fp32 accumulation and C)
+ * same scheme as kernel_f16_8_m2: Th=8 rows x Tw = VLMAX(e32m2) columns, the
+ * B panel reordered once per panel as bf16 (K x Tw, half the bytes of oB).
+ * With Zvfbfwma the widening fma (vfwmaccbf16_vf) consumes the bf16 rows.
+ * Without it the rows are widened in registers: bf16 is the upper half of an
+ * fp32, so zero-extend to 32 bit, shift left by 16 and reinterpret; the panel
+ * stays bf16 and the bandwidth gain is kept, the fma is the fp32 one.
+ */
+float bf16_to_f32(__bf16 h) {
+    uint16_t b;
+    memcpy(&b, &h, sizeof(b));
+    uint32_t u = (uint32_t)b << 16;
+    float f;
+    memcpy(&f, &u, sizeof(f));
+    return f;
+}
+
+// round to nearest even, NaN kept quiet
+__bf16 f32_to_bf16(float f) {
+    uint32_t u;
+    memcpy(&u, &f, sizeof(u));
+    uint16_t b = (u & 0x7fffffff) > 0x7f800000 ? (uint16_t)((u >> 16) | 0x40) : (uint16_t)((u + 0x7fff + ((u >> 16) & 1)) >> 16);
+    __bf16 h;
+    memcpy(&h, &b, sizeof(h));
+    return h;
+}
+
+// B[0:rows][0:width] (row stride ld) into the panel (row stride ts), 16 bit copy
+static void reordering_bf16(const __bf16* mat2, __bf16* omat2, int rows, int ld, int ts, int width) {
+    if (width > ts) width = ts;
+
+    for (int i = 0; i < rows; i++) {
+        const uint16_t* src = (const uint16_t*)(mat2 + (size_t)ld * i);
+        uint16_t* dst = (uint16_t*)(omat2 + (size_t)ts * i);
+
+        size_t vl;
+        for (int j = 0; j < width; j += vl) {
+            vl = __riscv_vsetvl_e16m8(width - j);
+            __riscv_vse16_v_u16m8(&dst[j], __riscv_vle16_v_u16m8(&src[j], vl), vl);
+        }
+    }
+}
+
+// row of the panel as consumed by the fma, acc += a * row
+#if defined(__riscv_zvfbfwma)
+#define BF16_ROW_T vbfloat16m1_t
+#define BF16_ROW(pb, vl) __riscv_vle16_v_bf16m1((pb), (vl))
+#define BF16_FMA(vc, a, vb, vl) __riscv_vfwmaccbf16_vf_f32m2((vc), (a), (vb), (vl))
+#else
+static inline vfloat32m2_t bf16_widen(const __bf16* p, size_t vl) {
+    vuint32m2_t w = __riscv_vzext_vf2_u32m2(__riscv_vle16_v_u16m1((const uint16_t*)p, vl), vl);
+    return __riscv_vreinterpret_v_u32m2_f32m2(__riscv_vsll_vx_u32m2(w, 16, vl));
+}
+#define BF16_ROW_T vfloat32m2_t
+#define BF16_ROW(pb, vl) bf16_widen((pb), (vl))
+#define BF16_FMA(vc, a, vb, vl) __riscv_vfmacc_vf_f32m2((vc), bf16_to_f32(a), (vb), (vl))
+#endif
+
+// ws: at least K * Tw / 2 floats (NULL: allocated here)
+void kernel_bf16_8_m2(const __bf16* A, const __bf16* B, float* C, int M, int N, int K,
+                      int lda, int ldb, int ldc, float* ws) {
+
+    const int Th = 8;
+    int Tw = __riscv_vsetvl_e32m2(N);
+
+    __bf16* oB = ws ? (__bf16*)ws : malloc(sizeof(__bf16) * K * Tw);
+
+    size_t vl;
+
+    for (int jh = 0; jh < N; jh += Tw) {
+        reordering_bf16(&B[jh], oB, K, ldb, Tw, N - jh);
+
+        vl = __riscv_vsetvl_e32m2(N - jh);
+
+        int ih = 0;
+        for (; ih + Th <= M; ih += Th) {
+            const __bf16* a0 = A + (size_t)(ih + 0) * lda;
+            const __bf16* a1 = A + (size_t)(ih + 1) * lda;
+            const __bf16* a2 = A + (size_t)(ih + 2) * lda;
+            const __bf16* a3 = A + (size_t)(ih + 3) * lda;
+            const __bf16* a4 = A + (size_t)(ih + 4) * lda;
+            const __bf16* a5 = A + (size_t)(ih + 5) * lda;
+            const __bf16* a6 = A + (size_t)(ih + 6) * lda;
+            const __bf16* a7 = A + (size_t)(ih + 7) * lda;
+
+            vfloat32m2_t vc0 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
+            vfloat32m2_t vc1 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
+            vfloat32m2_t vc2 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
+            vfloat32m2_t vc3 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
+            vfloat32m2_t vc4 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
+            vfloat32m2_t vc5 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
+            vfloat32m2_t vc6 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
+            vfloat32m2_t vc7 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
+
+            for (int k = 0; k < K; ++k) {
+                // loaded (and widened without Zvfbfwma) once, shared by the 8 rows
+                BF16_ROW_T vb = BF16_ROW(&oB[(size_t)k * Tw], vl);
+
+                vc0 = BF16_FMA(vc0, a0[k], vb, vl);
+                vc1 = BF16_FMA(vc1, a1[k], vb, vl);
+                vc2 = BF16_FMA(vc2, a2[k], vb, vl);
+                vc3 = BF16_FMA(vc3, a3[k], vb, vl);
+                vc4 = BF16_FMA(vc4, a4[k], vb, vl);
+                vc5 = BF16_FMA(vc5, a5[k], vb, vl);
+                vc6 = BF16_FMA(vc6, a6[k], vb, vl);
+                vc7 = BF16_FMA(vc7, a7[k], vb, vl);
+            }
+
+            __riscv_vse32_v_f32m2(&C[(size_t)(ih + 0) * ldc + jh], vc0, vl);
+            __riscv_vse32_v_f32m2(&C[(size_t)(ih + 1) * ldc + jh], vc1, vl);
+            __riscv_vse32_v_f32m2(&C[(size_t)(ih + 2) * ldc + jh], vc2, vl);
+            __riscv_vse32_v_f32m2(&C[(size_t)(ih + 3) * ldc + jh], vc3, vl);
+            __riscv_vse32_v_f32m2(&C[(size_t)(ih + 4) * ldc + jh], vc4, vl);
+            __riscv_vse32_v_f32m2(&C[(size_t)(ih + 5) * ldc + jh], vc5, vl);
+            __riscv_vse32_v_f32m2(&C[(size_t)(ih + 6) * ldc + jh], vc6, vl);
+            __riscv_vse32_v_f32m2(&C[(size_t)(ih + 7) * ldc + jh], vc7, vl);
+        }
+
+        // tail rows (M % Th) on the same panel
+        for (; ih < M; ih++) {
+            const __bf16* a0 = A + (size_t)ih * lda;
+
+            vfloat32m2_t vc0 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
+            for (int k = 0; k < K; ++k)
+                vc0 = BF16_FMA(vc0, a0[k], BF16_ROW(&oB[(size_t)k * Tw], vl), vl);
+
+            __riscv_vse32_v_f32m2(&C[(size_t)ih * ldc + jh], vc0, vl);
+        }
+    }
+
+    if ((float*)oB != ws) free(oB);
+}
+
+void multiply_gemm_bf16(const __bf16* A, const __bf16* B, float* C, int M, int N, int K) {
+    kernel_bf16_8_m2(A, B, C, M, N, K, K, N, N, NULL);
+}
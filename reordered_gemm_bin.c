@@ -0,0 +1,168 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <riscv_vector.h>
+#include "reordered_gemm.h"
+
+/*
+ * BINARY (XNOR-POPCOUNT)
+ * +1 / -1 values as bits (1 / 0), 32 per uint32_t word along K: A row-major
+ * (M x KW words, KW = ceil(K / 32)), B by columns (N x KW words, the layout of
+ * binarised weights), bits past K zero in both.
+ * dot(a, b) = K - 2 * popcount(a XOR b): the XNOR count is K minus the
+ * mismatches, C is int32.
+ *
+ * same output-stationary scheme as kernel_8_m2: Th=8 rows x Tw = VLMAX(e32m2)
+ * columns, the B panel (KW x Tw words) reordered once per panel with a strided
+ * load (the columns of B are rows in memory). Per word and row: one XOR with
+ * the A word, one per-element popcount (vcpop.v with Zvbb, SWAR otherwise),
+ * one add.
+ */
+
+// B columns [0:width] (KW words each, column stride ld) into the panel (row stride ts)
+static void reordering_bin(const uint32_t* mat2, uint32_t* omat2, int words, int ld, int ts, int width) {
+    if (width > ts) width = ts;
+
+    size_t vl;
+    for (int j = 0; j < width; j += vl) {
+        vl = __riscv_vsetvl_e32m2(width - j);
+        for (int w = 0; w < words; w++)
+            __riscv_vse32_v_u32m2(&omat2[(size_t)ts * w + j],
+                                  __riscv_vlse32_v_u32m2(&mat2[(size_t)ld * j + w], sizeof(uint32_t) * ld, vl), vl);
+    }
+}
+
+static inline vuint32m2_t popcount_u32m2(vuint32m2_t x, size_t vl) {
+#if defined(__riscv_zvbb)
+    return __riscv_vcpop_v_u32m2(x, vl);
+#else
+    x = __riscv_vsub_vv_u32m2(x, __riscv_vand_vx_u32m2(__riscv_vsrl_vx_u32m2(x, 1, vl), 0x55555555, vl), vl);
+    x = __riscv_vadd_vv_u32m2(__riscv_vand_vx_u32m2(x, 0x33333333, vl),
+                              __riscv_vand_vx_u32m2(__riscv_vsrl_vx_u32m2(x, 2, vl), 0x33333333, vl), vl);
+    x = __riscv_vand_vx_u32m2(__riscv_vadd_vv_u32m2(x, __riscv_vsrl_vx_u32m2(x, 4, vl), vl), 0x0f0f0f0f, vl);
+    return __riscv_vsrl_vx_u32m2(__riscv_vmul_vx_u32m2(x, 0x01010101, vl), 24, vl);
+#endif
+}
+
+// mismatches of the A word a against the B words in vb
+#define BIN_ACC(vc, a, vb, vl) __riscv_vadd_vv_u32m2((vc), popcount_u32m2(__riscv_vxor_vx_u32m2((vb), (a), (vl)), (vl)), (vl))
+
+// one row of C: K - 2 * mismatches
+static inline void store_row_bin(int32_t* res, vuint32m2_t vc, int K, size_t vl) {
+    vint32m2_t v = __riscv_vreinterpret_v_u32m2_i32m2(__riscv_vsll_vx_u32m2(vc, 1, vl));
+    __riscv_vse32_v_i32m2(res, __riscv_vrsub_vx_i32m2(v, K, vl), vl);
+}
+
+// lda, ldb in words; ws: KW * Tw floats (NULL: allocated here)
+void kernel_bin_8_m2(const uint32_t* A, const uint32_t* B, int32_t* C, int M, int N, int K,
+                     int lda, int ldb, int ldc, float* ws) {
+
+    const int Th = 8;
+    const int KW = (K + 31) / 32;
+    int Tw = __riscv_vsetvl_e32m2(N);
+
+    uint32_t* oB = ws ? (uint32_t*)ws : malloc(sizeof(uint32_t) * KW * Tw);
+
+    size_t vl;
+
+    for (int jh = 0; jh < N; jh += Tw) {
+        reordering_bin(&B[(size_t)jh * ldb], oB, KW, ldb, Tw, N - jh);
+
+        vl = __riscv_vsetvl_e32m2(N - jh);
+
+        int ih = 0;
+        for (; ih + Th <= M; ih += Th) {
+            const uint32_t* a0 = A + (size_t)(ih + 0) * lda;
+            const uint32_t* a1 = A + (size_t)(ih + 1) * lda;
+            const uint32_t* a2 = A + (size_t)(ih + 2) * lda;
+            const uint32_t* a3 = A + (size_t)(ih + 3) * lda;
+            const uint32_t* a4 = A + (size_t)(ih + 4) * lda;
+            const uint32_t* a5 = A + (size_t)(ih + 5) * lda;
+            const uint32_t* a6 = A + (size_t)(ih + 6) * lda;
+            const uint32_t* a7 = A + (size_t)(ih + 7) * lda;
+
+            vuint32m2_t vc0 = __riscv_vmv_v_x_u32m2(0, vl);
+            vuint32m2_t vc1 = __riscv_vmv_v_x_u32m2(0, vl);
+            vuint32m2_t vc2 = __riscv_vmv_v_x_u32m2(0, vl);
+            vuint32m2_t vc3 = __riscv_vmv_v_x_u32m2(0, vl);
+            vuint32m2_t vc4 = __riscv_vmv_v_x_u32m2(0, vl);
+            vuint32m2_t vc5 = __riscv_vmv_v_x_u32m2(0, vl);
+            vuint32m2_t vc6 = __riscv_vmv_v_x_u32m2(0, vl);
+            vuint32m2_t vc7 = __riscv_vmv_v_x_u32m2(0, vl);
+
+            for (int w = 0; w < KW; ++w) {
+                vuint32m2_t vb = __riscv_vle32_v_u32m2(&oB[(size_t)w * Tw], vl);
+
+                vc0 = BIN_ACC(vc0, a0[w], vb, vl);
+                vc1 = BIN_ACC(vc1, a1[w], vb, vl);
+                vc2 = BIN_ACC(vc2, a2[w], vb, vl);
+                vc3 = BIN_ACC(vc3, a3[w], vb, vl);
+                vc4 = BIN_ACC(vc4, a4[w], vb, vl);
+                vc5 = BIN_ACC(vc5, a5[w], vb, vl);
+                vc6 = BIN_ACC(vc6, a6[w], vb, vl);
+                vc7 = BIN_ACC(vc7, a7[w], vb, vl);
+            }
+
+            store_row_bin(&C[(size_t)(ih + 0) * ldc + jh], vc0, K, vl);
+            store_row_bin(&C[(size_t)(ih + 1) * ldc + jh], vc1, K, vl);
+            store_row_bin(&C[(size_t)(ih + 2) * ldc + jh], vc2, K, vl);
+            store_row_bin(&C[(size_t)(ih + 3) * ldc + jh], vc3, K, vl);
+            store_row_bin(&C[(size_t)(ih + 4) * ldc + jh], vc4, K, vl);
+            store_row_bin(&C[(size_t)(ih + 5) * ldc + jh], vc5, K, vl);
+            store_row_bin(&C[(size_t)(ih + 6) * ldc + jh], vc6, K, vl);
+            store_row_bin(&C[(size_t)(ih + 7) * ldc + jh], vc7, K, vl);
+        }
+
+        // tail rows (M % Th) on the same panel
+        for (; ih < M; ih++) {
+            const uint32_t* a0 = A + (size_t)ih * lda;
+
+            vuint32m2_t vc0 = __riscv_vmv_v_x_u32m2(0, vl);
+            for (int w = 0; w < KW; ++w)
+                vc0 = BIN_ACC(vc0, a0[w], __riscv_vle32_v_u32m2(&oB[(size_t)w * Tw], vl), vl);
+
+            store_row_bin(&C[(size_t)ih * ldc + jh], vc0, K, vl);
+        }
+    }
+
+    if ((float*)oB != ws) free(oB);
+}
+
+void multiply_gemm_bin(const uint32_t* A, const uint32_t* B, int32_t* C, int M, int N, int K) {
+    const int KW = (K + 31) / 32;
+    kernel_bin_8_m2(A, B, C, M, N, K, KW, KW, N, NULL);
+}
+
+// rows of X (rows x cols, row stride ld) as bits, x >= 0 -> 1: ceil(cols / 32) words per row
+void binarize_rows(const float* X, uint32_t* Xb, int rows, int cols, int ld) {
+    const int KW = (cols + 31) / 32;
+
+    for (int i = 0; i < rows; i++) {
+        for (int w = 0; w < KW; w++) {
+            uint32_t word = 0;
+            for (int b = 0; b < 32 && 32 * w + b < cols; b++)
+                if (X[(size_t)i * ld + 32 * w + b] >= 0.0f) word |= 1u << b;
+            Xb[(size_t)i * KW + w] = word;
+        }
+    }
+}
+
+// columns of X (rows x cols, row stride ld) as bits: ceil(rows / 32) words per column, a row of X per bit
+void binarize_cols(const float* X, uint32_t* Xb, int rows, int cols, int ld) {
+    const int KW = (rows + 31) / 32;
+
+    size_t vl;
+    for (int j = 0; j < cols; j += vl) {
+        vl = __riscv_vsetvl_e32m2(cols - j);
+
+        for (int w = 0; w < KW; w++) {
+            vuint32m2_t word = __riscv_vmv_v_x_u32m2(0, vl);
+
+            for (int b = 0; b < 32 && 32 * w + b < rows; b++) {
+                vbool16_t pos = __riscv_vmfge_vf_f32m2_b16(__riscv_vle32_v_f32m2(&X[(size_t)(32 * w + b) * ld + j], vl), 0.0f, vl);
+                word = __riscv_vor_vv_u32m2(word, __riscv_vmerge_vxm_u32m2(__riscv_vmv_v_x_u32m2(0, vl), 1u << b, pos, vl), vl);
+            }
+
+            __riscv_vsse32_v_u32m2(&Xb[(size_t)j * KW + w], sizeof(uint32_t) * KW, word, vl);
+        }
+    }
+}
@@ -0,0 +1,103 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <riscv_vector.h>
+#include "reordered_gemm.h"
+
+/*
+ * COMPLEX SINGLE PRECISION (A, B, C interleaved (re, im) float pairs)
+ * one output-stationary pass instead of four real GEMMs: every element of A
+ * and B is read once. The B panel is split into a real and an imaginary panel
+ * (K x Tw each) with a segment load (vlseg2e32), the C tile is written back
+ * interleaved with a segment store (vsseg2e32).
+ * Th=4 rows x Tw = VLMAX(e32m2) columns: 4 x (re, im) m2 accumulators + the
+ * two B rows, 20 of the 32 registers.
+ * 4-multiply form, one fma each: re += ar br - ai bi, im += ar bi + ai br.
+ * The 3-multiply form (Gauss) saves a product but needs the sums of the
+ * operands and extra adds: with fused multiply-add it is not cheaper.
+ */
+
+// B[0:rows][0:width] (complex, row stride ld) into the real / imaginary panels (row stride ts)
+static void reordering_c32(const float* mat2, float* omat2_re, float* omat2_im, int rows, int ld, int ts, int width) {
+    if (width > ts) width = ts;
+
+    for (int i = 0; i < rows; i++) {
+        size_t vl;
+        for (int j = 0; j < width; j += vl) {
+            vl = __riscv_vsetvl_e32m2(width - j);
+            vfloat32m2x2_t v = __riscv_vlseg2e32_v_f32m2x2(&mat2[2 * ((size_t)ld * i + j)], vl);
+            __riscv_vse32_v_f32m2(&omat2_re[(size_t)ts * i + j], __riscv_vget_v_f32m2x2_f32m2(v, 0), vl);
+            __riscv_vse32_v_f32m2(&omat2_im[(size_t)ts * i + j], __riscv_vget_v_f32m2x2_f32m2(v, 1), vl);
+        }
+    }
+}
+
+#define C32_FMA(vr, vi, a, br, bi, vl)                                  \
+    do {                                                                \
+        vr = __riscv_vfmacc_vf_f32m2(vr, (a)[0], br, vl);               \
+        vr = __riscv_vfnmsac_vf_f32m2(vr, (a)[1], bi, vl);              \
+        vi = __riscv_vfmacc_vf_f32m2(vi, (a)[0], bi, vl);               \
+        vi = __riscv_vfmacc_vf_f32m2(vi, (a)[1], br, vl);               \
+    } while (0)
+
+// R rows (constant once inlined) of one panel; A, C point to the first row, strides in complex elements
+static inline __attribute__((always_inline))
+void c32_tile(const float* A, const float* pB_re, const float* pB_im, float* C, const int R,
+              int K, int lda, int ldp, int ldc, size_t vl) {
+
+    vfloat32m2_t vr0 = __riscv_vfmv_v_f_f32m2(0.0f, vl), vi0 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
+    vfloat32m2_t vr1 = __riscv_vfmv_v_f_f32m2(0.0f, vl), vi1 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
+    vfloat32m2_t vr2 = __riscv_vfmv_v_f_f32m2(0.0f, vl), vi2 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
+    vfloat32m2_t vr3 = __riscv_vfmv_v_f_f32m2(0.0f, vl), vi3 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
+
+    for (int k = 0; k < K; k++) {
+        vfloat32m2_t br = __riscv_vle32_v_f32m2(&pB_re[(size_t)k * ldp], vl);
+        vfloat32m2_t bi = __riscv_vle32_v_f32m2(&pB_im[(size_t)k * ldp], vl);
+
+        C32_FMA(vr0, vi0, &A[2 * ((size_t)0 * lda + k)], br, bi, vl);
+        if (R > 1) C32_FMA(vr1, vi1, &A[2 * ((size_t)1 * lda + k)], br, bi, vl);
+        if (R > 2) C32_FMA(vr2, vi2, &A[2 * ((size_t)2 * lda + k)], br, bi, vl);
+        if (R > 3) C32_FMA(vr3, vi3, &A[2 * ((size_t)3 * lda + k)], br, bi, vl);
+    }
+
+    __riscv_vsseg2e32_v_f32m2x2(&C[2 * (size_t)0 * ldc], __riscv_vcreate_v_f32m2x2(vr0, vi0), vl);
+    if (R > 1) __riscv_vsseg2e32_v_f32m2x2(&C[2 * (size_t)1 * ldc], __riscv_vcreate_v_f32m2x2(vr1, vi1), vl);
+    if (R > 2) __riscv_vsseg2e32_v_f32m2x2(&C[2 * (size_t)2 * ldc], __riscv_vcreate_v_f32m2x2(vr2, vi2), vl);
+    if (R > 3) __riscv_vsseg2e32_v_f32m2x2(&C[2 * (size_t)3 * ldc], __riscv_vcreate_v_f32m2x2(vr3, vi3), vl);
+}
+
+// strides in complex elements; ws: 2 * K * Tw floats (NULL: allocated here)
+void kernel_c32_4_m2(const float* A, const float* B, float* C, int M, int N, int K,
+                     int lda, int ldb, int ldc, float* ws) {
+
+    const int Th = 4;
+    int Tw = __riscv_vsetvl_e32m2(N);
+
+    float* oB = ws ? ws : malloc(sizeof(float) * 2 * K * Tw);
+    float* oB_im = oB + (size_t)K * Tw;
+
+    size_t vl;
+
+    for (int jh = 0; jh < N; jh += Tw) {
+        reordering_c32(&B[2 * (size_t)jh], oB, oB_im, K, ldb, Tw, N - jh);
+
+        vl = __riscv_vsetvl_e32m2(N - jh);
+
+        int ih = 0;
+        for (; ih + Th <= M; ih += Th)
+            c32_tile(&A[2 * (size_t)ih * lda], oB, oB_im, &C[2 * ((size_t)ih * ldc + jh)], 4, K, lda, Tw, ldc, vl);
+
+        // tail rows (M % Th) on the same panel
+        switch (M - ih) {
+            case 3:  c32_tile(&A[2 * (size_t)ih * lda], oB, oB_im, &C[2 * ((size_t)ih * ldc + jh)], 3, K, lda, Tw, ldc, vl); break;
+            case 2:  c32_tile(&A[2 * (size_t)ih * lda], oB, oB_im, &C[2 * ((size_t)ih * ldc + jh)], 2, K, lda, Tw, ldc, vl); break;
+            case 1:  c32_tile(&A[2 * (size_t)ih * lda], oB, oB_im, &C[2 * ((size_t)ih * ldc + jh)], 1, K, lda, Tw, ldc, vl); break;
+            default: break;
+        }
+    }
+
+    if (oB != ws) free(oB);
+}
+
+void multiply_gemm_c32(const float* A, const float* B, float* C, int M, int N, int K) {
+    kernel_c32_4_m2(A, B, C, M, N, K, K, N, N, NULL);
+}
@@ -0,0 +1,344 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <riscv_vector.h>
+#include "reordered_gemm.h"
+#include "reordered_gemm_kernel.h"
+
+/*
+ * CONVOLUTION
+ * Per image and group g, with Cg = C / groups, Kg = K / groups, P = OH x OW
+ * output pixels and the reduction over Cg x R x S:
+ *   NCHW: Y_g (Kg x P)  = W_g (Kg x Cg R S, KCRS filter) col (Cg R S x P)
+ *   NHWC: Y_g (P x Kg)  = col (P x R S Cg) W_g (R S Cg x Kg, RSCK filter, row stride K)
+ * col is the im2col expansion of X: row (c, r, s) of the NCHW one holds the
+ * X[c][oh sh - ph + r dh][ow sw - pw + s dw] of every output pixel, 0 in the padding.
+ *   CONV_1X1      1x1, stride 1, no padding: col is X itself, plans over it
+ *   CONV_IM2COL   col in memory (R S times the image), plans over it
+ *   CONV_IMPLICIT no col: the operand read by rows of the tile is built from X
+ *                 when packed. NCHW: col is B, im2col_rows writes its panel
+ *                 (Cg R S x Tw, strided loads of X, zeros for the padding) in
+ *                 place of the copy of kernel_8_m2, the Kg rows of W run on it.
+ *                 NHWC: col is A, the rows of a block of 8 pixels are gathered
+ *                 (runs of Cg channels), the filter is packed into panels once.
+ * Implicit tiles: Th=8 x Tw = VLMAX(e32m2), tail rows on the same panel.
+ * Threads: one task per (image, group, panel) NCHW, (image, group, 8 pixels) NHWC.
+ */
+
+#define CONV_TH 8
+
+int gemm_conv_out_h(const gemm_conv_t* cv) {
+    const int sh = cv->stride_h ? cv->stride_h : 1, dh = cv->dil_h ? cv->dil_h : 1;
+    return (cv->h + 2 * cv->pad_h - dh * (cv->r - 1) - 1) / sh + 1;
+}
+
+int gemm_conv_out_w(const gemm_conv_t* cv) {
+    const int sw = cv->stride_w ? cv->stride_w : 1, dw = cv->dil_w ? cv->dil_w : 1;
+    return (cv->w + 2 * cv->pad_w - dw * (cv->s - 1) - 1) / sw + 1;
+}
+
+// resolved geometry of a convolution
+struct conv_geom {
+    int c, h, w, k, r, s;
+    int sh, sw, ph, pw, dh, dw;
+    int groups, cg, kg;
+    int oh, ow, p;              // output height, width, pixels
+    int kdim;                   // reduction: cg r s
+};
+
+static int conv_geom(const gemm_conv_t* cv, struct conv_geom* g) {
+    g->c = cv->c;
+    g->h = cv->h;
+    g->w = cv->w;
+    g->k = cv->k;
+    g->r = cv->r;
+    g->s = cv->s;
+    g->sh = cv->stride_h ? cv->stride_h : 1;
+    g->sw = cv->stride_w ? cv->stride_w : 1;
+    g->ph = cv->pad_h;
+    g->pw = cv->pad_w;
+    g->dh = cv->dil_h ? cv->dil_h : 1;
+    g->dw = cv->dil_w ? cv->dil_w : 1;
+    g->groups = cv->groups ? cv->groups : 1;
+
+    if (cv->n <= 0 || g->c <= 0 || g->h <= 0 || g->w <= 0 || g->k <= 0 || g->r <= 0 || g->s <= 0) return -1;
+    if (g->sh < 0 || g->sw < 0 || g->ph < 0 || g->pw < 0 || g->dh < 0 || g->dw < 0 || g->groups < 0) return -1;
+    if (g->c % g->groups || g->k % g->groups) return -1;
+    if (cv->layout != CONV_NCHW && cv->layout != CONV_NHWC) return -1;
+
+    g->cg = g->c / g->groups;
+    g->kg = g->k / g->groups;
+    g->oh = gemm_conv_out_h(cv);
+    g->ow = gemm_conv_out_w(cv);
+    if (g->oh <= 0 || g->ow <= 0) return -1;
+    g->p = g->oh * g->ow;
+    g->kdim = g->cg * g->r * g->s;
+    return 0;
+}
+
+// output columns [lo, hi) of a row whose input column ow sw + off falls in [0, w)
+static inline void conv_valid(int w, int sw, int off, int* lo, int* hi) {
+    *lo = off < 0 ? (-off + sw - 1) / sw : 0;
+    *hi = w - off > 0 ? (w - off + sw - 1) / sw : 0;
+}
+
+/*
+ * rows of the NCHW col, output pixels [p0, p0 + width), into out (row stride ldo):
+ * X is the first channel of the group. Per row and output row of pixels the
+ * padding is a run of zeros on each side, the rest one (strided) load.
+ */
+static void im2col_rows(const float* X, const struct conv_geom* g, int p0, int width, float* out, int ldo) {
+
+    const vfloat32m8_t vz = __riscv_vfmv_v_f_f32m8(0.0f, __riscv_vsetvlmax_e32m8());
+
+    for (int c = 0; c < g->cg; c++)
+        for (int r = 0; r < g->r; r++)
+            for (int s = 0; s < g->s; s++) {
+                float* o = &out[(size_t)((c * g->r + r) * g->s + s) * ldo];
+                const int off = s * g->dw - g->pw;
+                int lo, hi;
+                conv_valid(g->w, g->sw, off, &lo, &hi);
+
+                for (int p = p0; p < p0 + width;) {
+                    const int oh = p / g->ow, ow0 = p % g->ow;
+                    const int ow1 = g->ow - ow0 < p0 + width - p ? g->ow : ow0 + p0 + width - p;
+                    const int ih = oh * g->sh - g->ph + r * g->dh;
+                    float* dst = &o[p - p0 - ow0];
+
+                    // [ow0, a) zeros, [a, b) from X, [b, ow1) zeros
+                    int a = lo > ow0 ? lo : ow0, b = hi < ow1 ? hi : ow1;
+                    if (ih < 0 || ih >= g->h || a >= b) a = b = ow1;
+
+                    size_t vl;
+                    for (int j = ow0; j < a; j += vl) {
+                        vl = __riscv_vsetvl_e32m8(a - j);
+                        __riscv_vse32_v_f32m8(&dst[j], vz, vl);
+                    }
+                    if (a < b) {
+                        // input column of output column a
+                        const float* x = &X[((size_t)c * g->h + ih) * g->w + a * g->sw + off];
+                        for (int j = a; j < b; j += vl) {
+                            vl = __riscv_vsetvl_e32m8(b - j);
+                            vfloat32m8_t v = g->sw == 1 ? __riscv_vle32_v_f32m8(&x[j - a], vl)
+                                                        : __riscv_vlse32_v_f32m8(&x[(size_t)(j - a) * g->sw], sizeof(float) * g->sw, vl);
+                            __riscv_vse32_v_f32m8(&dst[j], v, vl);
+                        }
+                    }
+                    for (int j = b > a ? b : a; j < ow1; j += vl) {
+                        vl = __riscv_vsetvl_e32m8(ow1 - j);
+                        __riscv_vse32_v_f32m8(&dst[j], vz, vl);
+                    }
+
+                    p += ow1 - ow0;
+                }
+            }
+}
+
+// row of the NHWC col of output pixel p (r s cg values) into out: X is channel 0 of the group, row stride c per pixel
+static void im2col_pixel(const float* X, const struct conv_geom* g, int p, float* out) {
+
+    const int oh = p / g->ow, ow = p % g->ow;
+
+    for (int r = 0; r < g->r; r++) {
+        const int ih = oh * g->sh - g->ph + r * g->dh;
+        for (int s = 0; s < g->s; s++) {
+            const int iw = ow * g->sw - g->pw + s * g->dw;
+            float* o = &out[(size_t)(r * g->s + s) * g->cg];
+            const int pad = ih < 0 || ih >= g->h || iw < 0 || iw >= g->w;
+            const float* x = &X[((size_t)ih * g->w + iw) * g->c];
+
+            size_t vl;
+            for (int j = 0; j < g->cg; j += vl) {
+                vl = __riscv_vsetvl_e32m8(g->cg - j);
+                __riscv_vse32_v_f32m8(&o[j], pad ? __riscv_vfmv_v_f_f32m8(0.0f, vl) : __riscv_vle32_v_f32m8(&x[j], vl), vl);
+            }
+        }
+    }
+}
+
+// M rows of C (M x vl) = A (M x K) panel (K x vl): blocks of Th, then the tail
+static void conv_rows(const float* A, int lda, const float* pB, int ldp, float* C, int ldc, int M, int K, size_t vl) {
+
+    int i = 0;
+    for (; i + CONV_TH <= M; i += CONV_TH)
+        os_tile_f32m2(&A[(size_t)i * lda], lda, pB, ldp, &C[(size_t)i * ldc], ldc, 8, K, vl);
+
+    const float* a = &A[(size_t)i * lda];
+    float* c = &C[(size_t)i * ldc];
+    switch (M - i) {
+        case 7:  os_tile_f32m2(a, lda, pB, ldp, c, ldc, 7, K, vl); break;
+        case 6:  os_tile_f32m2(a, lda, pB, ldp, c, ldc, 6, K, vl); break;
+        case 5:  os_tile_f32m2(a, lda, pB, ldp, c, ldc, 5, K, vl); break;
+        case 4:  os_tile_f32m2(a, lda, pB, ldp, c, ldc, 4, K, vl); break;
+        case 3:  os_tile_f32m2(a, lda, pB, ldp, c, ldc, 3, K, vl); break;
+        case 2:  os_tile_f32m2(a, lda, pB, ldp, c, ldc, 2, K, vl); break;
+        case 1:  os_tile_f32m2(a, lda, pB, ldp, c, ldc, 1, K, vl); break;
+        default: break;
+    }
+}
+
+static int conv_implicit_nchw(const struct conv_geom* g, int n, const float* X, const float* W, float* Y, int threads) {
+
+    const int Tw = __riscv_vsetvlmax_e32m2();
+    const int panels = (g->p + Tw - 1) / Tw;
+    const int tasks = n * g->groups * panels;
+    int failed = 0;
+
+    #pragma omp parallel num_threads(threads)
+    {
+        float* panel = malloc(sizeof(float) * g->kdim * Tw);
+        if (panel == NULL) {
+            #pragma omp atomic write
+            failed = 1;
+        }
+
+        // a thread without its panel: no task runs
+        #pragma omp barrier
+        if (!failed) {
+            #pragma omp for schedule(static)
+            for (int t = 0; t < tasks; t++) {
+                const int b = t / (g->groups * panels);
+                const int gr = t / panels % g->groups;
+                const int p0 = t % panels * Tw;
+                const size_t vl = __riscv_vsetvl_e32m2(g->p - p0);
+
+                im2col_rows(X + ((size_t)b * g->c + (size_t)gr * g->cg) * g->h * g->w, g, p0, vl, panel, Tw);
+                conv_rows(W + (size_t)gr * g->kg * g->kdim, g->kdim, panel, Tw,
+                          Y + ((size_t)b * g->k + (size_t)gr * g->kg) * g->p + p0, g->p, g->kg, g->kdim, vl);
+            }
+        }
+
+        free(panel);
+    }
+
+    return failed ? -1 : 0;
+}
+
+static int conv_implicit_nhwc(const struct conv_geom* g, int n, const float* X, const float* W, float* Y, int threads) {
+
+    const int Tw = __riscv_vsetvlmax_e32m2();
+    const int panels = (g->kg + Tw - 1) / Tw;
+    const int blocks = (g->p + CONV_TH - 1) / CONV_TH;
+    const int tasks = n * g->groups * blocks;
+
+    // filter of every group in panels (kdim x Tw), once
+    float* wp = malloc(sizeof(float) * g->groups * panels * g->kdim * Tw);
+    if (wp == NULL) return -1;
+
+    for (int gr = 0; gr < g->groups; gr++)
+        for (int jp = 0; jp < panels; jp++) {
+            const int j0 = jp * Tw;
+            const size_t vl = __riscv_vsetvl_e32m2(g->kg - j0);
+            float* o = wp + ((size_t)gr * panels + jp) * g->kdim * Tw;
+            for (int k = 0; k < g->kdim; k++)
+                __riscv_vse32_v_f32m2(&o[(size_t)k * Tw], __riscv_vle32_v_f32m2(&W[(size_t)k * g->k + (size_t)gr * g->kg + j0], vl), vl);
+        }
+
+    int failed = 0;
+
+    #pragma omp parallel num_threads(threads)
+    {
+        float* rows = malloc(sizeof(float) * CONV_TH * g->kdim);
+        if (rows == NULL) {
+            #pragma omp atomic write
+            failed = 1;
+        }
+
+        // a thread without its rows: no task runs
+        #pragma omp barrier
+        if (!failed) {
+            #pragma omp for schedule(static)
+            for (int t = 0; t < tasks; t++) {
+                const int b = t / (g->groups * blocks);
+                const int gr = t / blocks % g->groups;
+                const int q0 = t % blocks * CONV_TH;
+                const int m = g->p - q0 < CONV_TH ? g->p - q0 : CONV_TH;
+
+                const float* x = X + (size_t)b * g->h * g->w * g->c + (size_t)gr * g->cg;
+                for (int i = 0; i < m; i++) im2col_pixel(x, g, q0 + i, &rows[(size_t)i * g->kdim]);
+
+                float* y = Y + ((size_t)b * g->p + q0) * g->k + (size_t)gr * g->kg;
+                for (int jp = 0; jp < panels; jp++) {
+                    const size_t vl = __riscv_vsetvl_e32m2(g->kg - jp * Tw);
+                    conv_rows(rows, g->kdim, wp + ((size_t)gr * panels + jp) * g->kdim * Tw, Tw, y + jp * Tw, g->k, m, g->kdim, vl);
+                }
+            }
+        }
+
+        free(rows);
+    }
+
+    free(wp);
+    return failed ? -1 : 0;
+}
+
+// 1x1 and im2col: one plan per group GEMM, col (NULL: X, 1x1) filled per image and group
+static int conv_gemm(gemm_ctx_t* ctx, const struct conv_geom* g, int n, int layout, const float* X, const float* W, float* Y,
+                     int im2col, int threads) {
+
+    const int nchw = layout == CONV_NCHW;
+    const int hw = g->h * g->w;
+
+    gemm_shape_t shape = nchw ? (gemm_shape_t){ g->kg, g->p, g->kdim } : (gemm_shape_t){ g->p, g->kg, g->kdim };
+    gemm_strides_t strides = nchw ? (gemm_strides_t){ g->kdim, im2col ? g->p : hw, g->p }
+                                  : (gemm_strides_t){ im2col ? g->kdim : g->c, g->k, g->k };
+
+    gemm_plan_t* plan = gemm_plan(ctx, shape, strides, GEMM_F32, threads, NULL);
+    float* col = im2col ? malloc(sizeof(float) * g->kdim * g->p) : NULL;
+    if (plan == NULL || (im2col && col == NULL)) {
+        gemm_destroy(plan);
+        free(col);
+        return -1;
+    }
+
+    for (int b = 0; b < n; b++)
+        for (int gr = 0; gr < g->groups; gr++) {
+            if (nchw) {
+                const float* x = X + ((size_t)b * g->c + (size_t)gr * g->cg) * hw;
+                if (im2col) {
+                    #pragma omp parallel for num_threads(threads) schedule(static)
+                    for (int c = 0; c < g->cg; c++) {
+                        struct conv_geom one = *g;
+                        one.cg = 1;
+                        im2col_rows(x + (size_t)c * hw, &one, 0, g->p, col + (size_t)c * g->r * g->s * g->p, g->p);
+                    }
+                }
+                gemm_execute(ctx, plan, W + (size_t)gr * g->kg * g->kdim, im2col ? col : x,
+                             Y + ((size_t)b * g->k + (size_t)gr * g->kg) * g->p);
+            }
+            else {
+                const float* x = X + (size_t)b * hw * g->c + (size_t)gr * g->cg;
+                if (im2col) {
+                    #pragma omp parallel for num_threads(threads) schedule(static)
+                    for (int p = 0; p < g->p; p++) im2col_pixel(x, g, p, col + (size_t)p * g->kdim);
+                }
+                gemm_execute(ctx, plan, im2col ? col : x, W + (size_t)gr * g->kg, Y + (size_t)b * g->p * g->k + (size_t)gr * g->kg);
+            }
+        }
+
+    gemm_destroy(plan);
+    free(col);
+    return 0;
+}
+
+int gemm_conv(gemm_ctx_t* ctx, const gemm_conv_t* cv, const float* X, const float* W, float* Y, int algo, int threads) {
+
+    struct conv_geom g;
+    if (conv_geom(cv, &g) != 0) return -1;
+    if (threads <= 0) threads = ctx ? gemm_ctx_ncpu(ctx) : 1;
+
+    // X is the col of a 1x1 filter with stride 1 and no padding
+    const int direct = g.r == 1 && g.s == 1 && g.sh == 1 && g.sw == 1 && g.ph == 0 && g.pw == 0;
+    if (algo == CONV_AUTO) algo = direct ? CONV_1X1 : CONV_IMPLICIT;
+
+    switch (algo) {
+        case CONV_1X1:
+            return direct ? conv_gemm(ctx, &g, cv->n, cv->layout, X, W, Y, 0, threads) : -1;
+        case CONV_IM2COL:
+            return conv_gemm(ctx, &g, cv->n, cv->layout, X, W, Y, 1, threads);
+        case CONV_IMPLICIT:
+            if (cv->layout == CONV_NHWC) return conv_implicit_nhwc(&g, cv->n, X, W, Y, threads);
+            return conv_implicit_nchw(&g, cv->n, X, W, Y, threads);
+        default:
+            return -1;
+    }
+}
@@ -0,0 +1,137 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <riscv_vector.h>
+#include "reordered_gemm.h"
+#include "rvv_math.h"
+#include "reordered_gemm_kernel.h"
+
+/*
+ * FUSED EPILOGUE
+ * kernel_8_m2 with the epilogue (gemm_epilogue_t) applied to the vc* accumulators
+ * before the vse32: C is written once, instead of once by the GEMM and once more
+ * (read + write) by every separate bias / activation / residual pass.
+ * Per panel the column vectors (col_scale, bias) are loaded once and stay in
+ * registers next to the 8 accumulators and the B row (22 of the 32 with m2).
+ * Tail rows (M % Th) on the same panel, with the epilogue.
+ *
+ * ACTIVATIONS
+ * exp_f32m2 (rvv_math.h), sigmoid(x) = 1 / (1 + exp(-x)),
+ * GELU (tanh form) = x * sigmoid(2 sqrt(2 / pi) (x + 0.044715 x^3)), SiLU = x * sigmoid(x).
+ */
+
+// x * sigmoid(s * x)
+static inline vfloat32m2_t mul_sigmoid_f32m2(vfloat32m2_t x, vfloat32m2_t sx, size_t vl) {
+    vfloat32m2_t e = exp_f32m2(__riscv_vfneg_v_f32m2(sx, vl), vl);
+    return __riscv_vfdiv_vv_f32m2(x, __riscv_vfadd_vf_f32m2(e, 1.0f, vl), vl);
+}
+
+static inline vfloat32m2_t activation_f32m2(vfloat32m2_t v, int act, size_t vl) {
+    switch (act) {
+        case ACT_RELU:
+            return __riscv_vfmax_vf_f32m2(v, 0.0f, vl);
+        case ACT_GELU: {
+            vfloat32m2_t x3 = __riscv_vfmul_vv_f32m2(__riscv_vfmul_vv_f32m2(v, v, vl), v, vl);
+            vfloat32m2_t u = __riscv_vfmacc_vf_f32m2(v, 0.044715f, x3, vl);
+            return mul_sigmoid_f32m2(v, __riscv_vfmul_vf_f32m2(u, 1.5957691216f, vl), vl);
+        }
+        case ACT_SILU:
+            return mul_sigmoid_f32m2(v, v, vl);
+        default:
+            return v;
+    }
+}
+
+// epilogue of row i of C, columns [j, j + vl): vscale, vbias hold col_scale, bias of those columns
+static inline __attribute__((always_inline))
+vfloat32m2_t epilogue_row(vfloat32m2_t v, const gemm_epilogue_t* ep, vfloat32m2_t vscale, vfloat32m2_t vbias,
+                          int i, int j, size_t vl) {
+    if (ep->row_scale) v = __riscv_vfmul_vf_f32m2(v, ep->row_scale[i], vl);
+    if (ep->col_scale) v = __riscv_vfmul_vv_f32m2(v, vscale, vl);
+    if (ep->bias) v = __riscv_vfadd_vv_f32m2(v, vbias, vl);
+    v = activation_f32m2(v, ep->act, vl);
+    if (ep->clamp) v = __riscv_vfmin_vf_f32m2(__riscv_vfmax_vf_f32m2(v, ep->lo, vl), ep->hi, vl);
+    if (ep->residual) v = __riscv_vfadd_vv_f32m2(v, __riscv_vle32_v_f32m2(&ep->residual[(size_t)i * ep->ldr + j], vl), vl);
+    return v;
+}
+
+#define EP_STORE(r, vc)                                                                         \
+    __riscv_vse32_v_f32m2(&C[(size_t)(r) * ldc], epilogue_row((vc), ep, vscale, vbias, i + (r), j, vl), vl)
+
+// R rows (constant once inlined) of row i, column j of C; A, C point to that row
+static inline __attribute__((always_inline))
+void ep_tile(const float* A, const float* pB, float* C, const int R, int K, int lda, int ldp, int ldc,
+             const gemm_epilogue_t* ep, vfloat32m2_t vscale, vfloat32m2_t vbias, int i, int j, size_t vl) {
+    OS_TILE_F32M2(A, lda, pB, ldp, R, K, vl, EP_STORE);
+}
+
+// ep relative to res (row 0, column 0 of this call), ldr resolved
+void kernel_ep_8_m2(float* mat1, float* mat2, float* res, int M, int N, int K, int lda, int ldb, int ldc,
+                    float* ws, int pack_mode, const gemm_epilogue_t* ep) {
+
+    const int Th = 8;
+    int Tw = __riscv_vsetvl_e32m2(N);
+
+    // ordered B: K x Tw, in the caller workspace ws if given (pre-packed mode: the panels are already in mat2)
+    float* oB = (ws || pack_mode == PACK_PREPACKED) ? ws : malloc(sizeof(float) * K * Tw);
+
+    size_t vl;
+
+    for (int jh = 0; jh < N; jh += Tw) {
+        const float* pB = oB;
+        int ldp = Tw;
+
+        // pre-packed mode: panel jh / Tw is read in place from mat2, ldb is the panel width
+        if (pack_mode == PACK_PREPACKED) {
+            pB = mat2 + (size_t)(jh / Tw) * K * ldb;
+            ldp = ldb;
+        }
+        else {
+            reordering_rvv(&mat2[jh], oB, K, ldb, Tw, N - jh);
+        }
+
+        vl = __riscv_vsetvl_e32m2(N - jh);
+
+        vfloat32m2_t vscale = ep->col_scale ? __riscv_vle32_v_f32m2(&ep->col_scale[jh], vl) : __riscv_vfmv_v_f_f32m2(1.0f, vl);
+        vfloat32m2_t vbias = ep->bias ? __riscv_vle32_v_f32m2(&ep->bias[jh], vl) : __riscv_vfmv_v_f_f32m2(0.0f, vl);
+
+        int ih = 0;
+        for (; ih + Th <= M; ih += Th)
+            ep_tile(&mat1[(size_t)ih * lda], pB, &res[(size_t)ih * ldc + jh], 8, K, lda, ldp, ldc, ep, vscale, vbias, ih, jh, vl);
+
+        // tail rows (M % Th) on the same panel
+        float* a = &mat1[(size_t)ih * lda];
+        float* c = &res[(size_t)ih * ldc + jh];
+        switch (M - ih) {
+            case 7:  ep_tile(a, pB, c, 7, K, lda, ldp, ldc, ep, vscale, vbias, ih, jh, vl); break;
+            case 6:  ep_tile(a, pB, c, 6, K, lda, ldp, ldc, ep, vscale, vbias, ih, jh, vl); break;
+            case 5:  ep_tile(a, pB, c, 5, K, lda, ldp, ldc, ep, vscale, vbias, ih, jh, vl); break;
+            case 4:  ep_tile(a, pB, c, 4, K, lda, ldp, ldc, ep, vscale, vbias, ih, jh, vl); break;
+            case 3:  ep_tile(a, pB, c, 3, K, lda, ldp, ldc, ep, vscale, vbias, ih, jh, vl); break;
+            case 2:  ep_tile(a, pB, c, 2, K, lda, ldp, ldc, ep, vscale, vbias, ih, jh, vl); break;
+            case 1:  ep_tile(a, pB, c, 1, K, lda, ldp, ldc, ep, vscale, vbias, ih, jh, vl); break;
+            default: break;
+        }
+    }
+
+    if (oB != ws) free(oB);
+}
+
+void gemm_epilogue_apply(float* C, int M, int N, int ldc, const gemm_epilogue_t* ep) {
+
+    gemm_epilogue_t e = *ep;
+    if (e.ldr == 0) e.ldr = N;
+
+    // row by row: C, residual streamed once, the column vectors stay in L1
+    for (int i = 0; i < M; i++) {
+        size_t vl;
+        for (int j = 0; j < N; j += vl) {
+            vl = __riscv_vsetvl_e32m2(N - j);
+
+            vfloat32m2_t vscale = e.col_scale ? __riscv_vle32_v_f32m2(&e.col_scale[j], vl) : __riscv_vfmv_v_f_f32m2(1.0f, vl);
+            vfloat32m2_t vbias = e.bias ? __riscv_vle32_v_f32m2(&e.bias[j], vl) : __riscv_vfmv_v_f_f32m2(0.0f, vl);
+
+            float* c = &C[(size_t)i * ldc + j];
+            __riscv_vse32_v_f32m2(c, epilogue_row(__riscv_vle32_v_f32m2(c, vl), &e, vscale, vbias, i, j, vl), vl);
+        }
+    }
+}
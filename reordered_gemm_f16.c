@@ -0,0 +1,141 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <riscv_vector.h>
+#include "reordered_gemm.h"
+
+/*
+ * HALF PRECISION (fp16 A and B, fp32 accumulation)
+ * same output-stationary scheme as kernel_8_m2: Th=8 rows x Tw columns, the B
+ * panel reordered once per panel (K x Tw halves, half the bytes of the fp32 oB).
+ * Tw = VLMAX(e32m2): the accumulators are fp32 m2, the B rows fp16 m1.
+ * With Zvfh the widening fma (vfwmacc_vf) consumes the fp16 rows directly.
+ * Without it the panel is widened to fp32 while it is reordered (software
+ * conversion, scalar) and the fp32 fma runs on it: same results, no bandwidth gain.
+ * C is fp32, or fp16 narrowed from the accumulators (out_f16).
+ */
+#if defined(__riscv_zvfh)
+#define F16_PANEL_T _Float16
+#else
+#define F16_PANEL_T float
+#endif
+
+// B[0:rows][0:width] (fp16, row stride ld) into the panel (row stride ts)
+static void reordering_f16(const _Float16* mat2, F16_PANEL_T* omat2, int rows, int ld, int ts, int width) {
+    if (width > ts) width = ts;
+
+    for (int i = 0; i < rows; i++) {
+        const _Float16* src = mat2 + (size_t)ld * i;
+        F16_PANEL_T* dst = omat2 + (size_t)ts * i;
+
+        #if defined(__riscv_zvfh)
+        size_t vl;
+        for (int j = 0; j < width; j += vl) {
+            vl = __riscv_vsetvl_e16m8(width - j);
+            __riscv_vse16_v_f16m8(&dst[j], __riscv_vle16_v_f16m8(&src[j], vl), vl);
+        }
+        #else
+        for (int j = 0; j < width; j++) dst[j] = (float)src[j];
+        #endif
+    }
+}
+
+// one row of C: fp32 or fp16
+static inline void store_row_f16(void* res, size_t offset, vfloat32m2_t vc, int out_f16, size_t vl) {
+    if (out_f16) {
+        #if defined(__riscv_zvfh)
+        __riscv_vse16_v_f16m1((_Float16*)res + offset, __riscv_vfncvt_f_f_w_f16m1(vc, vl), vl);
+        #else
+        float tmp[__riscv_vsetvlmax_e32m2()];
+        __riscv_vse32_v_f32m2(tmp, vc, vl);
+        for (size_t j = 0; j < vl; j++) ((_Float16*)res)[offset + j] = (_Float16)tmp[j];
+        #endif
+    }
+    else {
+        __riscv_vse32_v_f32m2((float*)res + offset, vc, vl);
+    }
+}
+
+// one row of A times the panel: acc += A[k] * pB[k][0:vl]
+#if defined(__riscv_zvfh)
+#define F16_FMA(vc, a, pb, vl) __riscv_vfwmacc_vf_f32m2((vc), (a), __riscv_vle16_v_f16m1((pb), (vl)), (vl))
+#else
+#define F16_FMA(vc, a, pb, vl) __riscv_vfmacc_vf_f32m2((vc), (float)(a), __riscv_vle32_v_f32m2((pb), (vl)), (vl))
+#endif
+
+// ws: K * Tw floats (NULL: allocated here)
+void kernel_f16_8_m2(const _Float16* A, const _Float16* B, void* C, int M, int N, int K,
+                     int lda, int ldb, int ldc, int out_f16, float* ws) {
+
+    const int Th = 8;
+    int Tw = __riscv_vsetvl_e32m2(N);
+
+    F16_PANEL_T* oB = ws ? (F16_PANEL_T*)ws : malloc(sizeof(F16_PANEL_T) * K * Tw);
+
+    size_t vl;
+
+    for (int jh = 0; jh < N; jh += Tw) {
+        reordering_f16(&B[jh], oB, K, ldb, Tw, N - jh);
+
+        vl = __riscv_vsetvl_e32m2(N - jh);
+
+        int ih = 0;
+        for (; ih + Th <= M; ih += Th) {
+            const _Float16* a0 = A + (size_t)(ih + 0) * lda;
+            const _Float16* a1 = A + (size_t)(ih + 1) * lda;
+            const _Float16* a2 = A + (size_t)(ih + 2) * lda;
+            const _Float16* a3 = A + (size_t)(ih + 3) * lda;
+            const _Float16* a4 = A + (size_t)(ih + 4) * lda;
+            const _Float16* a5 = A + (size_t)(ih + 5) * lda;
+            const _Float16* a6 = A + (size_t)(ih + 6) * lda;
+            const _Float16* a7 = A + (size_t)(ih + 7) * lda;
+
+            vfloat32m2_t vc0 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
+            vfloat32m2_t vc1 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
+            vfloat32m2_t vc2 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
+            vfloat32m2_t vc3 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
+            vfloat32m2_t vc4 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
+            vfloat32m2_t vc5 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
+            vfloat32m2_t vc6 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
+            vfloat32m2_t vc7 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
+
+            for (int k = 0; k < K; ++k) {
+                const F16_PANEL_T* pb = &oB[(size_t)k * Tw];
+
+                vc0 = F16_FMA(vc0, a0[k], pb, vl);
+                vc1 = F16_FMA(vc1, a1[k], pb, vl);
+                vc2 = F16_FMA(vc2, a2[k], pb, vl);
+                vc3 = F16_FMA(vc3, a3[k], pb, vl);
+                vc4 = F16_FMA(vc4, a4[k], pb, vl);
+                vc5 = F16_FMA(vc5, a5[k], pb, vl);
+                vc6 = F16_FMA(vc6, a6[k], pb, vl);
+                vc7 = F16_FMA(vc7, a7[k], pb, vl);
+            }
+
+            store_row_f16(C, (size_t)(ih + 0) * ldc + jh, vc0, out_f16, vl);
+            store_row_f16(C, (size_t)(ih + 1) * ldc + jh, vc1, out_f16, vl);
+            store_row_f16(C, (size_t)(ih + 2) * ldc + jh, vc2, out_f16, vl);
+            store_row_f16(C, (size_t)(ih + 3) * ldc + jh, vc3, out_f16, vl);
+            store_row_f16(C, (size_t)(ih + 4) * ldc + jh, vc4, out_f16, vl);
+            store_row_f16(C, (size_t)(ih + 5) * ldc + jh, vc5, out_f16, vl);
+            store_row_f16(C, (size_t)(ih + 6) * ldc + jh, vc6, out_f16, vl);
+            store_row_f16(C, (size_t)(ih + 7) * ldc + jh, vc7, out_f16, vl);
+        }
+
+        // tail rows (M % Th) on the same panel
+        for (; ih < M; ih++) {
+            const _Float16* a0 = A + (size_t)ih * lda;
+
+            vfloat32m2_t vc0 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
+            for (int k = 0; k < K; ++k)
+                vc0 = F16_FMA(vc0, a0[k], &oB[(size_t)k * Tw], vl);
+
+            store_row_f16(C, (size_t)ih * ldc + jh, vc0, out_f16, vl);
+        }
+    }
+
+    if ((float*)oB != ws) free(oB);
+}
+
+void multiply_gemm_f16(const _Float16* A, const _Float16* B, void* C, int M, int N, int K, int out_f16) {
+    kernel_f16_8_m2(A, B, C, M, N, K, K, N, N, out_f16, NULL);
+}
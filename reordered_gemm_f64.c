@@ -0,0 +1,268 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <riscv_vector.h>
+#include "reordered_gemm.h"
+
+/*
+ * DOUBLE PRECISION (fp64 A, B and C)
+ * same output-stationary scheme as the fp32 family: Th rows x Tw = VLMAX(e64 mL)
+ * columns, the B panel reordered once per panel (K x Tw doubles), Th
+ * accumulators + 1 B row in the 32 vector registers. A register holds half
+ * the elements it holds in fp32, so Tw halves for the same LMUL; LMUL mf2
+ * does not exist for e64. One tile per LMUL, with the rows (R <= Th max of
+ * the LMUL: 16 m1, 8 m2, 4 m4, 2 m8) constant once inlined, covers every Th
+ * and the tail rows.
+ */
+
+// B[0:rows][0:width] (row stride ld) into the panel (row stride ts)
+static void reordering_f64(const double* mat2, double* omat2, int rows, int ld, int ts, int width) {
+    if (width > ts) width = ts;
+
+    for (int i = 0; i < rows; i++) {
+        size_t vl;
+        for (int j = 0; j < width; j += vl) {
+            vl = __riscv_vsetvl_e64m8(width - j);
+            __riscv_vse64_v_f64m8(&omat2[(size_t)ts * i + j], __riscv_vle64_v_f64m8(&mat2[(size_t)ld * i + j], vl), vl);
+        }
+    }
+}
+
+static inline __attribute__((always_inline))
+void f64_tile_m1(const double* A, const double* pB, double* C, const int R, int K, int lda, int ldp, int ldc, size_t vl) {
+
+    vfloat64m1_t vc0 = __riscv_vfmv_v_f_f64m1(0.0, vl);
+    vfloat64m1_t vc1 = __riscv_vfmv_v_f_f64m1(0.0, vl);
+    vfloat64m1_t vc2 = __riscv_vfmv_v_f_f64m1(0.0, vl);
+    vfloat64m1_t vc3 = __riscv_vfmv_v_f_f64m1(0.0, vl);
+    vfloat64m1_t vc4 = __riscv_vfmv_v_f_f64m1(0.0, vl);
+    vfloat64m1_t vc5 = __riscv_vfmv_v_f_f64m1(0.0, vl);
+    vfloat64m1_t vc6 = __riscv_vfmv_v_f_f64m1(0.0, vl);
+    vfloat64m1_t vc7 = __riscv_vfmv_v_f_f64m1(0.0, vl);
+    vfloat64m1_t vc8 = __riscv_vfmv_v_f_f64m1(0.0, vl);
+    vfloat64m1_t vc9 = __riscv_vfmv_v_f_f64m1(0.0, vl);
+    vfloat64m1_t vc10 = __riscv_vfmv_v_f_f64m1(0.0, vl);
+    vfloat64m1_t vc11 = __riscv_vfmv_v_f_f64m1(0.0, vl);
+    vfloat64m1_t vc12 = __riscv_vfmv_v_f_f64m1(0.0, vl);
+    vfloat64m1_t vc13 = __riscv_vfmv_v_f_f64m1(0.0, vl);
+    vfloat64m1_t vc14 = __riscv_vfmv_v_f_f64m1(0.0, vl);
+    vfloat64m1_t vc15 = __riscv_vfmv_v_f_f64m1(0.0, vl);
+
+    for (int k = 0; k < K; k++) {
+        vfloat64m1_t vb = __riscv_vle64_v_f64m1(&pB[(size_t)k * ldp], vl);
+
+        vc0 = __riscv_vfmacc_vf_f64m1(vc0, A[0 * lda + k], vb, vl);
+        if (R > 1) vc1 = __riscv_vfmacc_vf_f64m1(vc1, A[1 * lda + k], vb, vl);
+        if (R > 2) vc2 = __riscv_vfmacc_vf_f64m1(vc2, A[2 * lda + k], vb, vl);
+        if (R > 3) vc3 = __riscv_vfmacc_vf_f64m1(vc3, A[3 * lda + k], vb, vl);
+        if (R > 4) vc4 = __riscv_vfmacc_vf_f64m1(vc4, A[4 * lda + k], vb, vl);
+        if (R > 5) vc5 = __riscv_vfmacc_vf_f64m1(vc5, A[5 * lda + k], vb, vl);
+        if (R > 6) vc6 = __riscv_vfmacc_vf_f64m1(vc6, A[6 * lda + k], vb, vl);
+        if (R > 7) vc7 = __riscv_vfmacc_vf_f64m1(vc7, A[7 * lda + k], vb, vl);
+        if (R > 8) vc8 = __riscv_vfmacc_vf_f64m1(vc8, A[8 * lda + k], vb, vl);
+        if (R > 9) vc9 = __riscv_vfmacc_vf_f64m1(vc9, A[9 * lda + k], vb, vl);
+        if (R > 10) vc10 = __riscv_vfmacc_vf_f64m1(vc10, A[10 * lda + k], vb, vl);
+        if (R > 11) vc11 = __riscv_vfmacc_vf_f64m1(vc11, A[11 * lda + k], vb, vl);
+        if (R > 12) vc12 = __riscv_vfmacc_vf_f64m1(vc12, A[12 * lda + k], vb, vl);
+        if (R > 13) vc13 = __riscv_vfmacc_vf_f64m1(vc13, A[13 * lda + k], vb, vl);
+        if (R > 14) vc14 = __riscv_vfmacc_vf_f64m1(vc14, A[14 * lda + k], vb, vl);
+        if (R > 15) vc15 = __riscv_vfmacc_vf_f64m1(vc15, A[15 * lda + k], vb, vl);
+    }
+
+    __riscv_vse64_v_f64m1(&C[0 * ldc], vc0, vl);
+    if (R > 1) __riscv_vse64_v_f64m1(&C[1 * ldc], vc1, vl);
+    if (R > 2) __riscv_vse64_v_f64m1(&C[2 * ldc], vc2, vl);
+    if (R > 3) __riscv_vse64_v_f64m1(&C[3 * ldc], vc3, vl);
+    if (R > 4) __riscv_vse64_v_f64m1(&C[4 * ldc], vc4, vl);
+    if (R > 5) __riscv_vse64_v_f64m1(&C[5 * ldc], vc5, vl);
+    if (R > 6) __riscv_vse64_v_f64m1(&C[6 * ldc], vc6, vl);
+    if (R > 7) __riscv_vse64_v_f64m1(&C[7 * ldc], vc7, vl);
+    if (R > 8) __riscv_vse64_v_f64m1(&C[8 * ldc], vc8, vl);
+    if (R > 9) __riscv_vse64_v_f64m1(&C[9 * ldc], vc9, vl);
+    if (R > 10) __riscv_vse64_v_f64m1(&C[10 * ldc], vc10, vl);
+    if (R > 11) __riscv_vse64_v_f64m1(&C[11 * ldc], vc11, vl);
+    if (R > 12) __riscv_vse64_v_f64m1(&C[12 * ldc], vc12, vl);
+    if (R > 13) __riscv_vse64_v_f64m1(&C[13 * ldc], vc13, vl);
+    if (R > 14) __riscv_vse64_v_f64m1(&C[14 * ldc], vc14, vl);
+    if (R > 15) __riscv_vse64_v_f64m1(&C[15 * ldc], vc15, vl);
+}
+
+static inline __attribute__((always_inline))
+void f64_tile_m2(const double* A, const double* pB, double* C, const int R, int K, int lda, int ldp, int ldc, size_t vl) {
+
+    vfloat64m2_t vc0 = __riscv_vfmv_v_f_f64m2(0.0, vl);
+    vfloat64m2_t vc1 = __riscv_vfmv_v_f_f64m2(0.0, vl);
+    vfloat64m2_t vc2 = __riscv_vfmv_v_f_f64m2(0.0, vl);
+    vfloat64m2_t vc3 = __riscv_vfmv_v_f_f64m2(0.0, vl);
+    vfloat64m2_t vc4 = __riscv_vfmv_v_f_f64m2(0.0, vl);
+    vfloat64m2_t vc5 = __riscv_vfmv_v_f_f64m2(0.0, vl);
+    vfloat64m2_t vc6 = __riscv_vfmv_v_f_f64m2(0.0, vl);
+    vfloat64m2_t vc7 = __riscv_vfmv_v_f_f64m2(0.0, vl);
+
+    for (int k = 0; k < K; k++) {
+        vfloat64m2_t vb = __riscv_vle64_v_f64m2(&pB[(size_t)k * ldp], vl);
+
+        vc0 = __riscv_vfmacc_vf_f64m2(vc0, A[0 * lda + k], vb, vl);
+        if (R > 1) vc1 = __riscv_vfmacc_vf_f64m2(vc1, A[1 * lda + k], vb, vl);
+        if (R > 2) vc2 = __riscv_vfmacc_vf_f64m2(vc2, A[2 * lda + k], vb, vl);
+        if (R > 3) vc3 = __riscv_vfmacc_vf_f64m2(vc3, A[3 * lda + k], vb, vl);
+        if (R > 4) vc4 = __riscv_vfmacc_vf_f64m2(vc4, A[4 * lda + k], vb, vl);
+        if (R > 5) vc5 = __riscv_vfmacc_vf_f64m2(vc5, A[5 * lda + k], vb, vl);
+        if (R > 6) vc6 = __riscv_vfmacc_vf_f64m2(vc6, A[6 * lda + k], vb, vl);
+        if (R > 7) vc7 = __riscv_vfmacc_vf_f64m2(vc7, A[7 * lda + k], vb, vl);
+    }
+
+    __riscv_vse64_v_f64m2(&C[0 * ldc], vc0, vl);
+    if (R > 1) __riscv_vse64_v_f64m2(&C[1 * ldc], vc1, vl);
+    if (R > 2) __riscv_vse64_v_f64m2(&C[2 * ldc], vc2, vl);
+    if (R > 3) __riscv_vse64_v_f64m2(&C[3 * ldc], vc3, vl);
+    if (R > 4) __riscv_vse64_v_f64m2(&C[4 * ldc], vc4, vl);
+    if (R > 5) __riscv_vse64_v_f64m2(&C[5 * ldc], vc5, vl);
+    if (R > 6) __riscv_vse64_v_f64m2(&C[6 * ldc], vc6, vl);
+    if (R > 7) __riscv_vse64_v_f64m2(&C[7 * ldc], vc7, vl);
+}
+
+static inline __attribute__((always_inline))
+void f64_tile_m4(const double* A, const double* pB, double* C, const int R, int K, int lda, int ldp, int ldc, size_t vl) {
+
+    vfloat64m4_t vc0 = __riscv_vfmv_v_f_f64m4(0.0, vl);
+    vfloat64m4_t vc1 = __riscv_vfmv_v_f_f64m4(0.0, vl);
+    vfloat64m4_t vc2 = __riscv_vfmv_v_f_f64m4(0.0, vl);
+    vfloat64m4_t vc3 = __riscv_vfmv_v_f_f64m4(0.0, vl);
+
+    for (int k = 0; k < K; k++) {
+        vfloat64m4_t vb = __riscv_vle64_v_f64m4(&pB[(size_t)k * ldp], vl);
+
+        vc0 = __riscv_vfmacc_vf_f64m4(vc0, A[0 * lda + k], vb, vl);
+        if (R > 1) vc1 = __riscv_vfmacc_vf_f64m4(vc1, A[1 * lda + k], vb, vl);
+        if (R > 2) vc2 = __riscv_vfmacc_vf_f64m4(vc2, A[2 * lda + k], vb, vl);
+        if (R > 3) vc3 = __riscv_vfmacc_vf_f64m4(vc3, A[3 * lda + k], vb, vl);
+    }
+
+    __riscv_vse64_v_f64m4(&C[0 * ldc], vc0, vl);
+    if (R > 1) __riscv_vse64_v_f64m4(&C[1 * ldc], vc1, vl);
+    if (R > 2) __riscv_vse64_v_f64m4(&C[2 * ldc], vc2, vl);
+    if (R > 3) __riscv_vse64_v_f64m4(&C[3 * ldc], vc3, vl);
+}
+
+static inline __attribute__((always_inline))
+void f64_tile_m8(const double* A, const double* pB, double* C, const int R, int K, int lda, int ldp, int ldc, size_t vl) {
+
+    vfloat64m8_t vc0 = __riscv_vfmv_v_f_f64m8(0.0, vl);
+    vfloat64m8_t vc1 = __riscv_vfmv_v_f_f64m8(0.0, vl);
+
+    for (int k = 0; k < K; k++) {
+        vfloat64m8_t vb = __riscv_vle64_v_f64m8(&pB[(size_t)k * ldp], vl);
+
+        vc0 = __riscv_vfmacc_vf_f64m8(vc0, A[0 * lda + k], vb, vl);
+        if (R > 1) vc1 = __riscv_vfmacc_vf_f64m8(vc1, A[1 * lda + k], vb, vl);
+    }
+
+    __riscv_vse64_v_f64m8(&C[0 * ldc], vc0, vl);
+    if (R > 1) __riscv_vse64_v_f64m8(&C[1 * ldc], vc1, vl);
+}
+
+// R rows (1 <= R <= f64_max_rows(lmul)) of one panel
+static void f64_rows(const double* A, const double* pB, double* C, int R, int lmul, int K, int lda, int ldp, int ldc, size_t vl) {
+    switch (lmul) {
+        case 1:
+            switch (R) {
+                case 1:  f64_tile_m1(A, pB, C, 1, K, lda, ldp, ldc, vl); break;
+                case 2:  f64_tile_m1(A, pB, C, 2, K, lda, ldp, ldc, vl); break;
+                case 3:  f64_tile_m1(A, pB, C, 3, K, lda, ldp, ldc, vl); break;
+                case 4:  f64_tile_m1(A, pB, C, 4, K, lda, ldp, ldc, vl); break;
+                case 5:  f64_tile_m1(A, pB, C, 5, K, lda, ldp, ldc, vl); break;
+                case 6:  f64_tile_m1(A, pB, C, 6, K, lda, ldp, ldc, vl); break;
+                case 7:  f64_tile_m1(A, pB, C, 7, K, lda, ldp, ldc, vl); break;
+                case 8:  f64_tile_m1(A, pB, C, 8, K, lda, ldp, ldc, vl); break;
+                case 9:  f64_tile_m1(A, pB, C, 9, K, lda, ldp, ldc, vl); break;
+                case 10: f64_tile_m1(A, pB, C, 10, K, lda, ldp, ldc, vl); break;
+                case 11: f64_tile_m1(A, pB, C, 11, K, lda, ldp, ldc, vl); break;
+                case 12: f64_tile_m1(A, pB, C, 12, K, lda, ldp, ldc, vl); break;
+                case 13: f64_tile_m1(A, pB, C, 13, K, lda, ldp, ldc, vl); break;
+                case 14: f64_tile_m1(A, pB, C, 14, K, lda, ldp, ldc, vl); break;
+                case 15: f64_tile_m1(A, pB, C, 15, K, lda, ldp, ldc, vl); break;
+                default: f64_tile_m1(A, pB, C, 16, K, lda, ldp, ldc, vl); break;
+            }
+            break;
+        case 2:
+            switch (R) {
+                case 1:  f64_tile_m2(A, pB, C, 1, K, lda, ldp, ldc, vl); break;
+                case 2:  f64_tile_m2(A, pB, C, 2, K, lda, ldp, ldc, vl); break;
+                case 3:  f64_tile_m2(A, pB, C, 3, K, lda, ldp, ldc, vl); break;
+                case 4:  f64_tile_m2(A, pB, C, 4, K, lda, ldp, ldc, vl); break;
+                case 5:  f64_tile_m2(A, pB, C, 5, K, lda, ldp, ldc, vl); break;
+                case 6:  f64_tile_m2(A, pB, C, 6, K, lda, ldp, ldc, vl); break;
+                case 7:  f64_tile_m2(A, pB, C, 7, K, lda, ldp, ldc, vl); break;
+                default: f64_tile_m2(A, pB, C, 8, K, lda, ldp, ldc, vl); break;
+            }
+            break;
+        case 4:
+            switch (R) {
+                case 1:  f64_tile_m4(A, pB, C, 1, K, lda, ldp, ldc, vl); break;
+                case 2:  f64_tile_m4(A, pB, C, 2, K, lda, ldp, ldc, vl); break;
+                case 3:  f64_tile_m4(A, pB, C, 3, K, lda, ldp, ldc, vl); break;
+                default: f64_tile_m4(A, pB, C, 4, K, lda, ldp, ldc, vl); break;
+            }
+            break;
+        default:
+            if (R == 1) f64_tile_m8(A, pB, C, 1, K, lda, ldp, ldc, vl);
+            else f64_tile_m8(A, pB, C, 2, K, lda, ldp, ldc, vl);
+            break;
+    }
+}
+
+// rows of the biggest tile that fits the registers with this LMUL, 0 if the LMUL has no kernel
+int f64_max_rows(int lmul) {
+    switch (lmul) {
+        case 1:   return 16;
+        case 2:   return 8;
+        case 4:   return 4;
+        case 8:   return 2;
+        default:  return 0;
+    }
+}
+
+// Tw of the kernels with this LMUL, 0 if the LMUL has no kernel
+int f64_panel_width(int N, int lmul) {
+    switch (lmul) {
+        case 1:   return __riscv_vsetvl_e64m1(N);
+        case 2:   return __riscv_vsetvl_e64m2(N);
+        case 4:   return __riscv_vsetvl_e64m4(N);
+        case 8:   return __riscv_vsetvl_e64m8(N);
+        default:  return 0;
+    }
+}
+
+// th rows per tile (th <= f64_max_rows(lmul)), the last tile takes M % th; ws: K * Tw doubles (NULL: allocated here)
+void kernel_f64(const double* A, const double* B, double* C, int M, int N, int K,
+                int lda, int ldb, int ldc, int th, int lmul, double* ws) {
+
+    int Tw = f64_panel_width(N, lmul);
+
+    double* oB = ws ? ws : malloc(sizeof(double) * K * Tw);
+
+    for (int jh = 0; jh < N; jh += Tw) {
+        reordering_f64(&B[jh], oB, K, ldb, Tw, N - jh);
+
+        size_t vl = f64_panel_width(N - jh, lmul);
+
+        for (int ih = 0; ih < M; ih += th)
+            f64_rows(&A[(size_t)ih * lda], oB, &C[(size_t)ih * ldc + jh], M - ih < th ? M - ih : th, lmul,
+                     K, lda, Tw, ldc, vl);
+    }
+
+    if (oB != ws) free(oB);
+}
+
+void multiply_gemm_f64(const double* A, const double* B, double* C, int M, int N, int K, int th, int lmul) {
+
+    gemm_shape_t shape = { M, N, K };
+    gemm_strides_t strides = { K, N, N };
+    gemm_hints_t hints = { DATAFLOW_AUTO, th, lmul, PACK_SEPARATE, NULL, NULL, SEMIRING_PLUS_TIMES, NULL };
+
+    gemm_plan_t* plan = gemm_plan(NULL, shape, strides, GEMM_F64, 1, &hints);
+    if (plan == NULL) return;
+
+    gemm_execute(NULL, plan, A, B, C);
+    gemm_destroy(plan);
+}
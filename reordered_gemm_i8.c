@@ -0,0 +1,172 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <riscv_vector.h>
+#include "reordered_gemm.h"
+
+/*
+ * INT8 (u8 / s8 A, s8 B, s32 accumulation)
+ * same output-stationary scheme as the float kernels: Th=8 rows x Tw = VLMAX(e32m2)
+ * columns, the B panel reordered once per panel as int8 (K x Tw bytes, a quarter
+ * of the fp32 oB). Every B row is sign-extended once to int16 (vsext_vf2) and
+ * shared by the 8 rows: vwmacc_vx (int16 x int16 -> int32) with the A scalar
+ * (u8 fits int16). |(A - za) B| <= 255 * 128 = 32640, so the 32 bit accumulators
+ * hold K <= GEMM_I8_MAX_K = (2^31 - 1) / 32640 = 65793 (larger K rejected).
+ * Workspace (gemm_i8_ws_size): colsum and scale (Tw int32 + Tw float), then the
+ * int8 panel, owned by the caller or allocated once per call.
+ *
+ * EPILOGUE (per panel, on the accumulators)
+ * A zero point: sum (A - za) B = sum A B - za * colsum(B), colsum computed while
+ * packing; B is symmetric (zero point 0) with one scale per column (channel).
+ *   S32: acc - za * colsum
+ *   F32: (acc - za * colsum) * a_scale * b_scale[j]
+ *   I8:  sat8(round(F32 / c_scale) + c_zero), saturating narrow with vnclip
+ */
+
+// B[0:rows][0:width] into the panel (row stride ts) and the column sums of the panel
+static void reordering_i8(const int8_t* mat2, int8_t* omat2, int32_t* colsum, int rows, int ld, int ts, int width) {
+    if (width > ts) width = ts;
+
+    size_t vl;
+    for (int j = 0; j < width; j += vl) {
+        vl = __riscv_vsetvl_e32m4(width - j);
+        vint32m4_t vs = __riscv_vmv_v_x_i32m4(0, vl);
+
+        for (int i = 0; i < rows; i++) {
+            vint8m1_t v = __riscv_vle8_v_i8m1(&mat2[(size_t)ld * i + j], vl);
+            __riscv_vse8_v_i8m1(&omat2[(size_t)ts * i + j], v, vl);
+            vs = __riscv_vadd_vv_i32m4(vs, __riscv_vsext_vf4_i32m4(v, vl), vl);
+        }
+
+        __riscv_vse32_v_i32m4(&colsum[j], vs, vl);
+    }
+}
+
+// one row of C from its accumulator
+static inline void epilogue_i8(vint32m2_t acc, void* res, size_t offset, const int32_t* colsum,
+                               const float* scale, const gemm_quant_t* q, size_t vl) {
+
+    if (q->a_zero)
+        acc = __riscv_vsub_vv_i32m2(acc, __riscv_vmul_vx_i32m2(__riscv_vle32_v_i32m2(colsum, vl), q->a_zero, vl), vl);
+
+    if (q->out == QUANT_OUT_S32) {
+        __riscv_vse32_v_i32m2((int32_t*)res + offset, acc, vl);
+        return;
+    }
+
+    vfloat32m2_t vf = __riscv_vfmul_vv_f32m2(__riscv_vfcvt_f_x_v_f32m2(acc, vl), __riscv_vle32_v_f32m2(scale, vl), vl);
+
+    if (q->out == QUANT_OUT_F32) {
+        __riscv_vse32_v_f32m2((float*)res + offset, vf, vl);
+        return;
+    }
+
+    // scale already divided by c_scale: round to nearest even, add the zero point, saturate to int8
+    vint32m2_t vi = __riscv_vadd_vx_i32m2(__riscv_vfcvt_x_f_v_i32m2(vf, vl), q->c_zero, vl);
+    vint16m1_t v16 = __riscv_vnclip_wx_i16m1(vi, 0, __RISCV_VXRM_RNU, vl);
+    __riscv_vse8_v_i8mf2((int8_t*)res + offset, __riscv_vnclip_wx_i8mf2(v16, 0, __RISCV_VXRM_RNU, vl), vl);
+}
+
+size_t gemm_i8_ws_size(int N, int K) {
+    const size_t Tw = __riscv_vsetvl_e32m2(N);
+    return (sizeof(int32_t) + sizeof(float)) * Tw + (size_t)K * Tw;
+}
+
+// a_unsigned constant once inlined: no test on the sign of A in the k loop
+static inline __attribute__((always_inline))
+void kernel_i8_tiles(const void* mat1, const int8_t* B, void* C, int M, int N, int K,
+                     int lda, int ldb, int ldc, const gemm_quant_t* q, void* ws, const int a_unsigned) {
+
+    const int Th = 8;
+    int Tw = __riscv_vsetvl_e32m2(N);
+
+    int32_t* colsum = ws;
+    float* scale = (float*)(colsum + Tw);
+    int8_t* oB = (int8_t*)(scale + Tw);
+
+    // A element as int16: the same kernel for u8 and s8
+    const uint8_t* Au = (const uint8_t*)mat1;
+    const int8_t* As = (const int8_t*)mat1;
+    #define A_AT(i, k) (a_unsigned ? (int16_t)Au[(size_t)(i) * lda + (k)] : (int16_t)As[(size_t)(i) * lda + (k)])
+
+    const float c_inv = q->out == QUANT_OUT_I8 ? 1.0f / q->c_scale : 1.0f;
+
+    size_t vl;
+
+    for (int jh = 0; jh < N; jh += Tw) {
+        reordering_i8(&B[jh], oB, colsum, K, ldb, Tw, N - jh);
+
+        vl = __riscv_vsetvl_e32m2(N - jh);
+
+        // combined scale of the panel columns
+        for (size_t j = 0; j < vl; j++)
+            scale[j] = q->a_scale * (q->b_scale ? q->b_scale[jh + j] : 1.0f) * c_inv;
+
+        int ih = 0;
+        for (; ih + Th <= M; ih += Th) {
+
+            vint32m2_t vc0 = __riscv_vmv_v_x_i32m2(0, vl);
+            vint32m2_t vc1 = __riscv_vmv_v_x_i32m2(0, vl);
+            vint32m2_t vc2 = __riscv_vmv_v_x_i32m2(0, vl);
+            vint32m2_t vc3 = __riscv_vmv_v_x_i32m2(0, vl);
+            vint32m2_t vc4 = __riscv_vmv_v_x_i32m2(0, vl);
+            vint32m2_t vc5 = __riscv_vmv_v_x_i32m2(0, vl);
+            vint32m2_t vc6 = __riscv_vmv_v_x_i32m2(0, vl);
+            vint32m2_t vc7 = __riscv_vmv_v_x_i32m2(0, vl);
+
+            for (int k = 0; k < K; ++k) {
+                // B row widened once, shared by the 8 rows
+                vint16m1_t vb = __riscv_vsext_vf2_i16m1(__riscv_vle8_v_i8mf2(&oB[(size_t)k * Tw], vl), vl);
+
+                vc0 = __riscv_vwmacc_vx_i32m2(vc0, A_AT(ih + 0, k), vb, vl);
+                vc1 = __riscv_vwmacc_vx_i32m2(vc1, A_AT(ih + 1, k), vb, vl);
+                vc2 = __riscv_vwmacc_vx_i32m2(vc2, A_AT(ih + 2, k), vb, vl);
+                vc3 = __riscv_vwmacc_vx_i32m2(vc3, A_AT(ih + 3, k), vb, vl);
+                vc4 = __riscv_vwmacc_vx_i32m2(vc4, A_AT(ih + 4, k), vb, vl);
+                vc5 = __riscv_vwmacc_vx_i32m2(vc5, A_AT(ih + 5, k), vb, vl);
+                vc6 = __riscv_vwmacc_vx_i32m2(vc6, A_AT(ih + 6, k), vb, vl);
+                vc7 = __riscv_vwmacc_vx_i32m2(vc7, A_AT(ih + 7, k), vb, vl);
+            }
+
+            epilogue_i8(vc0, C, (size_t)(ih + 0) * ldc + jh, colsum, scale, q, vl);
+            epilogue_i8(vc1, C, (size_t)(ih + 1) * ldc + jh, colsum, scale, q, vl);
+            epilogue_i8(vc2, C, (size_t)(ih + 2) * ldc + jh, colsum, scale, q, vl);
+            epilogue_i8(vc3, C, (size_t)(ih + 3) * ldc + jh, colsum, scale, q, vl);
+            epilogue_i8(vc4, C, (size_t)(ih + 4) * ldc + jh, colsum, scale, q, vl);
+            epilogue_i8(vc5, C, (size_t)(ih + 5) * ldc + jh, colsum, scale, q, vl);
+            epilogue_i8(vc6, C, (size_t)(ih + 6) * ldc + jh, colsum, scale, q, vl);
+            epilogue_i8(vc7, C, (size_t)(ih + 7) * ldc + jh, colsum, scale, q, vl);
+        }
+
+        // tail rows (M % Th) on the same panel
+        for (; ih < M; ih++) {
+            vint32m2_t vc0 = __riscv_vmv_v_x_i32m2(0, vl);
+            for (int k = 0; k < K; ++k) {
+                vint16m1_t vb = __riscv_vsext_vf2_i16m1(__riscv_vle8_v_i8mf2(&oB[(size_t)k * Tw], vl), vl);
+                vc0 = __riscv_vwmacc_vx_i32m2(vc0, A_AT(ih, k), vb, vl);
+            }
+            epilogue_i8(vc0, C, (size_t)ih * ldc + jh, colsum, scale, q, vl);
+        }
+    }
+
+    #undef A_AT
+}
+
+// ws: gemm_i8_ws_size(N, K) bytes (NULL: allocated here); -1 if K is over GEMM_I8_MAX_K or the allocation fails
+int kernel_i8_8_m2(const void* A, const int8_t* B, void* C, int M, int N, int K,
+                   int lda, int ldb, int ldc, const gemm_quant_t* q, void* ws) {
+
+    if (K > GEMM_I8_MAX_K) return -1;
+
+    void* w = ws ? ws : malloc(gemm_i8_ws_size(N, K));
+    if (w == NULL) return -1;
+
+    if (q->a_unsigned) kernel_i8_tiles(A, B, C, M, N, K, lda, ldb, ldc, q, w, 1);
+    else kernel_i8_tiles(A, B, C, M, N, K, lda, ldb, ldc, q, w, 0);
+
+    if (w != ws) free(w);
+    return 0;
+}
+
+int multiply_gemm_i8(const void* A, const int8_t* B, void* C, int M, int N, int K, const gemm_quant_t* q, void* ws) {
+    return kernel_i8_8_m2(A, B, C, M, N, K, K, N, N, q, ws);
+}
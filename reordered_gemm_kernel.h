@@ -0,0 +1,92 @@
+#ifndef REORDERED_GEMM_KERNEL_H_
+#define REORDERED_GEMM_KERNEL_H_
+
+#include <stddef.h>
+#include <riscv_vector.h>
+
+/*
+ * FP32 KERNEL HELPERS
+ * shared by the fp32 output-stationary kernels of reordered_gemm*.c (not part of
+ * the public API): the panel copy of B and the R x m2 tile (R <= 8 rows of A
+ * against one panel row, R accumulators) of the semiring, epilogue, attention,
+ * knn and convolution kernels.
+ */
+
+// copy the panel B[0:rows][0:width] (row stride ld) into omat2 with row stride ts
+// width < ts only on the last panel of B: the remaining columns are left untouched
+static inline void reordering_rvv(const float* mat2, float* omat2, int rows, int ld, int ts, int width) {
+    if (width > ts) width = ts;
+
+    for (int i = 0; i < rows; i++) {
+        const float* src = mat2 + (size_t)ld * i;
+        float* dst = omat2 + (size_t)ts * i;
+        size_t remaining = width;
+
+        while (remaining > 0) {
+            size_t vl = __riscv_vsetvl_e32m8(remaining);  // LMUL=8
+
+            vfloat32m8_t vec = __riscv_vle32_v_f32m8(src, vl);
+            __riscv_vse32_v_f32m8(dst, vec, vl);
+
+            src += vl;
+            dst += vl;
+            remaining -= vl;
+        }
+    }
+}
+
+/*
+ * R x vl tile, R constant once inlined (the unused accumulators and their guards
+ * vanish): vc0..vc7 = init, vc_r = MACC(vc_r, A[r][k], panel row k, vl) for k < K,
+ * then STORE(r, vc_r) for r < R, the caller's epilogue (a macro that may use the
+ * caller's variables, like OS_STORE).
+ */
+#define OS_TILE_F32M2_OP(A, lda, pB, ldp, R, K, vl, init, MACC, STORE)                        \
+    do {                                                                                    \
+        vfloat32m2_t vc0 = __riscv_vfmv_v_f_f32m2((init), (vl));                            \
+        vfloat32m2_t vc1 = __riscv_vfmv_v_f_f32m2((init), (vl));                            \
+        vfloat32m2_t vc2 = __riscv_vfmv_v_f_f32m2((init), (vl));                            \
+        vfloat32m2_t vc3 = __riscv_vfmv_v_f_f32m2((init), (vl));                            \
+        vfloat32m2_t vc4 = __riscv_vfmv_v_f_f32m2((init), (vl));                            \
+        vfloat32m2_t vc5 = __riscv_vfmv_v_f_f32m2((init), (vl));                            \
+        vfloat32m2_t vc6 = __riscv_vfmv_v_f_f32m2((init), (vl));                            \
+        vfloat32m2_t vc7 = __riscv_vfmv_v_f_f32m2((init), (vl));                            \
+                                                                                            \
+        for (int kk = 0; kk < (K); kk++) {                                                  \
+            vfloat32m2_t vb = __riscv_vle32_v_f32m2(&(pB)[(size_t)kk * (ldp)], (vl));       \
+                                                                                            \
+            vc0 = MACC(vc0, (A)[0 * (size_t)(lda) + kk], vb, (vl));                         \
+            if ((R) > 1) vc1 = MACC(vc1, (A)[1 * (size_t)(lda) + kk], vb, (vl));            \
+            if ((R) > 2) vc2 = MACC(vc2, (A)[2 * (size_t)(lda) + kk], vb, (vl));            \
+            if ((R) > 3) vc3 = MACC(vc3, (A)[3 * (size_t)(lda) + kk], vb, (vl));            \
+            if ((R) > 4) vc4 = MACC(vc4, (A)[4 * (size_t)(lda) + kk], vb, (vl));            \
+            if ((R) > 5) vc5 = MACC(vc5, (A)[5 * (size_t)(lda) + kk], vb, (vl));            \
+            if ((R) > 6) vc6 = MACC(vc6, (A)[6 * (size_t)(lda) + kk], vb, (vl));            \
+            if ((R) > 7) vc7 = MACC(vc7, (A)[7 * (size_t)(lda) + kk], vb, (vl));            \
+        }                                                                                   \
+                                                                                            \
+        STORE(0, vc0);                                                                      \
+        if ((R) > 1) STORE(1, vc1);                                                         \
+        if ((R) > 2) STORE(2, vc2);                                                         \
+        if ((R) > 3) STORE(3, vc3);                                                         \
+        if ((R) > 4) STORE(4, vc4);                                                         \
+        if ((R) > 5) STORE(5, vc5);                                                         \
+        if ((R) > 6) STORE(6, vc6);                                                         \
+        if ((R) > 7) STORE(7, vc7);                                                         \
+    } while (0)
+
+#define OS_FMACC(vc, a, vb, vl) __riscv_vfmacc_vf_f32m2((vc), (a), (vb), (vl))
+
+// plus-times tile
+#define OS_TILE_F32M2(A, lda, pB, ldp, R, K, vl, STORE) OS_TILE_F32M2_OP(A, lda, pB, ldp, R, K, vl, 0.0f, OS_FMACC, STORE)
+
+// row r of the tile into C (row stride ldc) of the caller
+#define OS_STORE(r, vc) __riscv_vse32_v_f32m2(&C[(size_t)(r) * ldc], (vc), vl)
+
+// C (R x vl, row stride ldc) = A (R x K) panel (K x vl, row stride ldp)
+static inline __attribute__((always_inline))
+void os_tile_f32m2(const float* A, int lda, const float* pB, int ldp, float* C, int ldc, const int R, int K, size_t vl) {
+    OS_TILE_F32M2(A, lda, pB, ldp, R, K, vl, OS_STORE);
+}
+
+#endif /* REORDERED_GEMM_KERNEL_H_ */
@@ -0,0 +1,199 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <riscv_vector.h>
+#include "reordered_gemm.h"
+#include "reordered_gemm_kernel.h"
+
+/*
+ * FUSED DISTANCE + TOP-K
+ * d(x, y) = ||x||^2 + ||y||^2 - 2 x.y (squared L2), x.y from the output-stationary
+ * tile: X (queries) is the A operand, the corpus transposed into panels (D x Tw,
+ * Tw = VLMAX(e32m2)) the B operand. The panel is packed with strided loads
+ * (vlse32) and the ||y||^2 of its Tw points come out of the same pass, in one
+ * register. Epilogue of the 8 accumulators: xn + yn - 2 acc (clamped at 0), then
+ * one vmflt against the worst distance kept by the row: only when some lane beats
+ * it the row goes through the bounded heap (max-heap of k, root = worst). Once
+ * the heaps fill up most rows of most panels stop at the compare, and the M x N
+ * distance matrix is never written.
+ * Threads: one task per KNN_QB queries, each packs every panel once for them
+ * (a pack per KNN_QB / 8 tiles) and owns their heaps (rows of idx, dist).
+ */
+
+#define KNN_TH 8
+#define KNN_QB 64
+
+// root of the max-heap hd, hi (n entries) replaced by (d, id), sifted down
+static void heap_replace(float* hd, int* hi, int n, float d, int id) {
+    int i = 0;
+    for (;;) {
+        int c = 2 * i + 1;
+        if (c >= n) break;
+        if (c + 1 < n && hd[c + 1] > hd[c]) c++;
+        if (hd[c] <= d) break;
+        hd[i] = hd[c];
+        hi[i] = hi[c];
+        i = c;
+    }
+    hd[i] = d;
+    hi[i] = id;
+}
+
+static void heap_init(float* hd, int* hi, int k) {
+    for (int i = 0; i < k; i++) {
+        hd[i] = __builtin_inff();
+        hi[i] = -1;
+    }
+}
+
+// heap to ascending order, in place
+static void heap_sort(float* hd, int* hi, int k) {
+    for (int n = k - 1; n > 0; n--) {
+        float d = hd[n];
+        int id = hi[n];
+        hd[n] = hd[0];
+        hi[n] = hi[0];
+        heap_replace(hd, hi, n, d, id);
+    }
+}
+
+// distances vd of the points [j0, j0 + vl) to one query: those under the worst kept into its heap
+static inline void heap_push(vfloat32m2_t vd, float* buf, float* hd, int* hi, int k, int j0, size_t vl) {
+    if (__riscv_vcpop_m_b16(__riscv_vmflt_vf_f32m2_b16(vd, hd[0], vl), vl) == 0) return;
+
+    __riscv_vse32_v_f32m2(buf, vd, vl);
+    for (size_t c = 0; c < vl; c++)
+        if (buf[c] < hd[0]) heap_replace(hd, hi, k, buf[c], j0 + c);
+}
+
+void row_sqnorms(const float* X, int rows, int cols, int ld, float* norms) {
+    for (int i = 0; i < rows; i++) {
+        const float* x = &X[(size_t)i * ld];
+        vfloat32m1_t vs = __riscv_vfmv_s_f_f32m1(0.0f, 1);
+        size_t vl;
+        for (int j = 0; j < cols; j += vl) {
+            vl = __riscv_vsetvl_e32m2(cols - j);
+            vfloat32m2_t v = __riscv_vle32_v_f32m2(&x[j], vl);
+            vs = __riscv_vfredusum_vs_f32m2_f32m1(__riscv_vfmul_vv_f32m2(v, v, vl), vs, vl);
+        }
+        norms[i] = __riscv_vfmv_f_s_f32m1_f32(vs);
+    }
+}
+
+// points [j0, j0 + vl) of Y (row stride ld) transposed into the panel (D x vl, row stride ts), their norms returned
+static vfloat32m2_t reordering_knn(const float* Y, float* panel, int D, int ld, int ts, size_t vl) {
+    vfloat32m2_t vn = __riscv_vfmv_v_f_f32m2(0.0f, vl);
+    for (int k = 0; k < D; k++) {
+        vfloat32m2_t v = __riscv_vlse32_v_f32m2(&Y[k], sizeof(float) * ld, vl);
+        vn = __riscv_vfmacc_vv_f32m2(vn, v, v, vl);
+        __riscv_vse32_v_f32m2(&panel[(size_t)k * ts], v, vl);
+    }
+    return vn;
+}
+
+#define KNN_PUSH(r, vc)                                                                                     \
+    heap_push(__riscv_vfmax_vf_f32m2(__riscv_vfmacc_vf_f32m2(__riscv_vfadd_vf_f32m2(vyn, xn[r], vl), -2.0f, (vc), vl), 0.0f, vl), \
+              buf, &dist[(size_t)(r) * k], &idx[(size_t)(r) * k], k, j0, vl)
+
+// R queries (constant once inlined) against the vl points of the panel; X, xn, idx, dist point to the first query
+static inline __attribute__((always_inline))
+void knn_tile(const float* X, int ldx, const float* panel, int ldp, const float* xn, vfloat32m2_t vyn,
+              const int R, int D, int k, int j0, int* idx, float* dist, float* buf, size_t vl) {
+    OS_TILE_F32M2(X, ldx, panel, ldp, R, D, vl, KNN_PUSH);
+}
+
+int knn_search(const float* X, const float* Y, int M, int N, int D, int k, int* idx, float* dist, int threads) {
+
+    if (M <= 0 || k <= 0) return -1;
+    if (threads <= 0) threads = 1;
+
+    const int Tw = __riscv_vsetvlmax_e32m2();
+    const int tasks = (M + KNN_QB - 1) / KNN_QB;
+
+    int failed = 0;
+
+    #pragma omp parallel num_threads(threads)
+    {
+        float* panel = malloc(sizeof(float) * D * Tw);
+        float* buf = malloc(sizeof(float) * Tw);
+        float xn[KNN_QB];
+        if (panel == NULL || buf == NULL) {
+            #pragma omp atomic write
+            failed = 1;
+        }
+
+        // a thread without buffers: no task runs, idx and dist are left unwritten
+        #pragma omp barrier
+        if (!failed) {
+            #pragma omp for schedule(static)
+            for (int t = 0; t < tasks; t++) {
+                const int q0 = t * KNN_QB;
+                const int rows = M - q0 < KNN_QB ? M - q0 : KNN_QB;
+                const float* x = X + (size_t)q0 * D;
+                int* hi = idx + (size_t)q0 * k;
+                float* hd = dist + (size_t)q0 * k;
+
+                row_sqnorms(x, rows, D, D, xn);
+                for (int i = 0; i < rows; i++) heap_init(&hd[(size_t)i * k], &hi[(size_t)i * k], k);
+
+                size_t vl;
+                for (int j0 = 0; j0 < N; j0 += vl) {
+                    vl = __riscv_vsetvl_e32m2(N - j0);
+                    vfloat32m2_t vyn = reordering_knn(Y + (size_t)j0 * D, panel, D, D, Tw, vl);
+
+                    int i = 0;
+                    for (; i + KNN_TH <= rows; i += KNN_TH)
+                        knn_tile(&x[(size_t)i * D], D, panel, Tw, &xn[i], vyn, 8, D, k, j0, &hi[(size_t)i * k], &hd[(size_t)i * k], buf, vl);
+
+                    // tail queries (rows % Th) on the same panel
+                    const float* a = &x[(size_t)i * D];
+                    int* ti = &hi[(size_t)i * k];
+                    float* td = &hd[(size_t)i * k];
+                    switch (rows - i) {
+                        case 7:  knn_tile(a, D, panel, Tw, &xn[i], vyn, 7, D, k, j0, ti, td, buf, vl); break;
+                        case 6:  knn_tile(a, D, panel, Tw, &xn[i], vyn, 6, D, k, j0, ti, td, buf, vl); break;
+                        case 5:  knn_tile(a, D, panel, Tw, &xn[i], vyn, 5, D, k, j0, ti, td, buf, vl); break;
+                        case 4:  knn_tile(a, D, panel, Tw, &xn[i], vyn, 4, D, k, j0, ti, td, buf, vl); break;
+                        case 3:  knn_tile(a, D, panel, Tw, &xn[i], vyn, 3, D, k, j0, ti, td, buf, vl); break;
+                        case 2:  knn_tile(a, D, panel, Tw, &xn[i], vyn, 2, D, k, j0, ti, td, buf, vl); break;
+                        case 1:  knn_tile(a, D, panel, Tw, &xn[i], vyn, 1, D, k, j0, ti, td, buf, vl); break;
+                        default: break;
+                    }
+                }
+
+                for (int i = 0; i < rows; i++) heap_sort(&hd[(size_t)i * k], &hi[(size_t)i * k], k);
+            }
+        }
+
+        free(panel);
+        free(buf);
+    }
+
+    return failed ? -1 : 0;
+}
+
+int knn_select(const float* G, const float* xn, const float* yn, int rows, int cols, int ld, int k, int* idx, float* dist) {
+
+    if (k <= 0) return -1;
+
+    float* buf = malloc(sizeof(float) * __riscv_vsetvlmax_e32m2());
+    if (buf == NULL) return -1;
+
+    for (int i = 0; i < rows; i++) {
+        float* hd = &dist[(size_t)i * k];
+        int* hi = &idx[(size_t)i * k];
+        heap_init(hd, hi, k);
+
+        size_t vl;
+        for (int j = 0; j < cols; j += vl) {
+            vl = __riscv_vsetvl_e32m2(cols - j);
+            vfloat32m2_t vd = __riscv_vfadd_vf_f32m2(__riscv_vle32_v_f32m2(&yn[j], vl), xn[i], vl);
+            vd = __riscv_vfmacc_vf_f32m2(vd, -2.0f, __riscv_vle32_v_f32m2(&G[(size_t)i * ld + j], vl), vl);
+            heap_push(__riscv_vfmax_vf_f32m2(vd, 0.0f, vl), buf, hd, hi, k, j, vl);
+        }
+
+        heap_sort(hd, hi, k);
+    }
+
+    free(buf);
+    return 0;
+}
@@ -0,0 +1,132 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <riscv_vector.h>
+#include "reordered_gemm.h"
+
+/*
+ * FUSED MLP
+ * per block of rows rows of X:
+ *   hidden (rows x H) = act(X_blk W1 + b1)    plan 1: packed W1, fused epilogue (bias, act)
+ *   Y_blk (rows x O)  = hidden W2 + b2         plan 2: packed W2, fused epilogue (bias)
+ * rows is the largest multiple of 8 (Th of the fused 8 x m2 kernel) whose hidden
+ * tile fills half of L2, the other half left to the X / Y rows and the panels of
+ * W1, W2 streaming through. The activation is applied in registers before the
+ * hidden tile is stored, and W2 reads it back from L2 right away.
+ * Both plans split the columns over the threads (H, then O).
+ */
+struct gemm_mlp {
+    int d, h, o;
+    int rows;                   // rows of X per block
+    int threads;
+    int act;
+    const float* b1;
+    const float* b2;
+
+    packed_b_t* w1;             // D x H
+    packed_b_t* w2;             // H x O
+    gemm_plan_t* plan1;         // rows x H x D
+    gemm_plan_t* plan2;         // rows x O x H
+};
+
+// the two plans of a block of rows rows
+static int mlp_plans(gemm_ctx_t* ctx, const gemm_mlp_t* mlp, int rows, gemm_plan_t** plan1, gemm_plan_t** plan2) {
+
+    const gemm_epilogue_t ep1 = { NULL, NULL, mlp->b1, mlp->act, 0, 0.0f, 0.0f, NULL, 0 };
+    const gemm_epilogue_t ep2 = { NULL, NULL, mlp->b2, ACT_NONE, 0, 0.0f, 0.0f, NULL, 0 };
+
+    gemm_shape_t shape1 = { rows, mlp->h, mlp->d };
+    gemm_shape_t shape2 = { rows, mlp->o, mlp->h };
+    gemm_strides_t strides = { 0, 0, 0 };
+    gemm_hints_t hints1 = { DATAFLOW_AUTO, 0, 0, PACK_PREPACKED, NULL, mlp->w1, SEMIRING_PLUS_TIMES, &ep1 };
+    gemm_hints_t hints2 = { DATAFLOW_AUTO, 0, 0, PACK_PREPACKED, NULL, mlp->w2, SEMIRING_PLUS_TIMES, &ep2 };
+
+    *plan1 = gemm_plan(ctx, shape1, strides, GEMM_F32, mlp->threads, &hints1);
+    *plan2 = gemm_plan(ctx, shape2, strides, GEMM_F32, mlp->threads, &hints2);
+    if (*plan1 == NULL || *plan2 == NULL) {
+        gemm_destroy(*plan1);
+        gemm_destroy(*plan2);
+        return -1;
+    }
+    return 0;
+}
+
+gemm_mlp_t* gemm_mlp_create(gemm_ctx_t* ctx, int D, int H, int O, const float* W1, const float* b1,
+                            const float* W2, const float* b2, int act, int threads) {
+
+    if (D <= 0 || H <= 0 || O <= 0) return NULL;
+
+    gemm_mlp_t* mlp = calloc(1, sizeof(gemm_mlp_t));
+    if (mlp == NULL) return NULL;
+
+    mlp->d = D;
+    mlp->h = H;
+    mlp->o = O;
+    mlp->threads = threads > 0 ? threads : (ctx ? gemm_ctx_ncpu(ctx) : 1);
+    mlp->act = act;
+    mlp->b1 = b1;
+    mlp->b2 = b2;
+
+    // hidden tile: half of L2
+    long l2 = ctx ? gemm_ctx_l2_size(ctx) : 512 * 1024;
+    mlp->rows = (int)(l2 / 2 / ((long)sizeof(float) * H)) / 8 * 8;
+    if (mlp->rows < 8) mlp->rows = 8;
+
+    // lmul 2: the panels of the fused 8 x m2 kernel
+    mlp->w1 = pack_b(W1, D, H, 2);
+    mlp->w2 = pack_b(W2, H, O, 2);
+    if (mlp->w1 == NULL || mlp->w2 == NULL || mlp_plans(ctx, mlp, mlp->rows, &mlp->plan1, &mlp->plan2) != 0) {
+        gemm_mlp_destroy(mlp);
+        return NULL;
+    }
+
+    return mlp;
+}
+
+int gemm_mlp_execute(gemm_ctx_t* ctx, const gemm_mlp_t* mlp, const float* X, float* Y, int M) {
+
+    if (M <= 0) return 0;
+
+    const int rows = M < mlp->rows ? M : mlp->rows;
+    float* hidden = malloc(sizeof(float) * rows * mlp->h);
+    if (hidden == NULL) return -1;
+
+    // last block (M % rows): its own plans
+    gemm_plan_t *tail1 = NULL, *tail2 = NULL;
+    if (M % mlp->rows && mlp_plans(ctx, mlp, M % mlp->rows, &tail1, &tail2) != 0) {
+        free(hidden);
+        return -1;
+    }
+
+    for (int i0 = 0; i0 < M; i0 += mlp->rows) {
+        const int full = M - i0 >= mlp->rows;
+        gemm_execute(ctx, full ? mlp->plan1 : tail1, X + (size_t)i0 * mlp->d, NULL, hidden);
+        gemm_execute(ctx, full ? mlp->plan2 : tail2, hidden, NULL, Y + (size_t)i0 * mlp->o);
+    }
+
+    gemm_destroy(tail1);
+    gemm_destroy(tail2);
+    free(hidden);
+    return 0;
+}
+
+void gemm_mlp_destroy(gemm_mlp_t* mlp) {
+    if (mlp == NULL) return;
+    gemm_destroy(mlp->plan1);
+    gemm_destroy(mlp->plan2);
+    packed_b_free(mlp->w1);
+    packed_b_free(mlp->w2);
+    free(mlp);
+}
+
+int gemm_mlp_rows(const gemm_mlp_t* mlp) { return mlp->rows; }
+
+int multiply_mlp(const float* X, const float* W1, const float* b1, const float* W2, const float* b2, float* Y,
+                 int M, int D, int H, int O, int act) {
+
+    gemm_mlp_t* mlp = gemm_mlp_create(NULL, D, H, O, W1, b1, W2, b2, act, 1);
+    if (mlp == NULL) return -1;
+
+    const int ret = gemm_mlp_execute(NULL, mlp, X, Y, M);
+    gemm_mlp_destroy(mlp);
+    return ret;
+}
@@ -0,0 +1,114 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <riscv_vector.h>
+#include "reordered_gemm.h"
+
+/*
+ * FIXED POINT Q15 (int16 A, B and C, int32 accumulation)
+ * same output-stationary scheme as kernel_8_m2: Th=8 rows x Tw = VLMAX(e32m2)
+ * columns, the B panel reordered once per panel as int16 (half the bytes of
+ * the fp32 oB). vwmacc_vx consumes the int16 B row and the int16 A scalar
+ * directly into the int32 accumulators: no conversion pass.
+ * The accumulators wrap like those of a 32 bit DSP: Q15 x Q15 products are
+ * Q30, the inputs need log2(K) bits of headroom.
+ *
+ * EPILOGUE
+ * C = sat16(round(acc >> shift)) in one vnclip (round to nearest, ties up):
+ * shift 15 for Q15 x Q15 -> Q15.
+ */
+
+// B[0:rows][0:width] (row stride ld) into the panel (row stride ts)
+static void reordering_q15(const int16_t* mat2, int16_t* omat2, int rows, int ld, int ts, int width) {
+    if (width > ts) width = ts;
+
+    for (int i = 0; i < rows; i++) {
+        size_t vl;
+        for (int j = 0; j < width; j += vl) {
+            vl = __riscv_vsetvl_e16m8(width - j);
+            __riscv_vse16_v_i16m8(&omat2[(size_t)ts * i + j], __riscv_vle16_v_i16m8(&mat2[(size_t)ld * i + j], vl), vl);
+        }
+    }
+}
+
+// one row of C: rounding, saturating narrow of the accumulator
+static inline void store_row_q15(int16_t* res, vint32m2_t acc, int shift, size_t vl) {
+    __riscv_vse16_v_i16m1(res, __riscv_vnclip_wx_i16m1(acc, shift, __RISCV_VXRM_RNU, vl), vl);
+}
+
+// ws: at least K * Tw / 2 floats (NULL: allocated here)
+void kernel_q15_8_m2(const int16_t* A, const int16_t* B, int16_t* C, int M, int N, int K,
+                     int lda, int ldb, int ldc, int shift, float* ws) {
+
+    const int Th = 8;
+    int Tw = __riscv_vsetvl_e32m2(N);
+
+    int16_t* oB = ws ? (int16_t*)ws : malloc(sizeof(int16_t) * K * Tw);
+
+    size_t vl;
+
+    for (int jh = 0; jh < N; jh += Tw) {
+        reordering_q15(&B[jh], oB, K, ldb, Tw, N - jh);
+
+        vl = __riscv_vsetvl_e32m2(N - jh);
+
+        int ih = 0;
+        for (; ih + Th <= M; ih += Th) {
+            const int16_t* a0 = A + (size_t)(ih + 0) * lda;
+            const int16_t* a1 = A + (size_t)(ih + 1) * lda;
+            const int16_t* a2 = A + (size_t)(ih + 2) * lda;
+            const int16_t* a3 = A + (size_t)(ih + 3) * lda;
+            const int16_t* a4 = A + (size_t)(ih + 4) * lda;
+            const int16_t* a5 = A + (size_t)(ih + 5) * lda;
+            const int16_t* a6 = A + (size_t)(ih + 6) * lda;
+            const int16_t* a7 = A + (size_t)(ih + 7) * lda;
+
+            vint32m2_t vc0 = __riscv_vmv_v_x_i32m2(0, vl);
+            vint32m2_t vc1 = __riscv_vmv_v_x_i32m2(0, vl);
+            vint32m2_t vc2 = __riscv_vmv_v_x_i32m2(0, vl);
+            vint32m2_t vc3 = __riscv_vmv_v_x_i32m2(0, vl);
+            vint32m2_t vc4 = __riscv_vmv_v_x_i32m2(0, vl);
+            vint32m2_t vc5 = __riscv_vmv_v_x_i32m2(0, vl);
+            vint32m2_t vc6 = __riscv_vmv_v_x_i32m2(0, vl);
+            vint32m2_t vc7 = __riscv_vmv_v_x_i32m2(0, vl);
+
+            for (int k = 0; k < K; ++k) {
+                vint16m1_t vb = __riscv_vle16_v_i16m1(&oB[(size_t)k * Tw], vl);
+
+                vc0 = __riscv_vwmacc_vx_i32m2(vc0, a0[k], vb, vl);
+                vc1 = __riscv_vwmacc_vx_i32m2(vc1, a1[k], vb, vl);
+                vc2 = __riscv_vwmacc_vx_i32m2(vc2, a2[k], vb, vl);
+                vc3 = __riscv_vwmacc_vx_i32m2(vc3, a3[k], vb, vl);
+                vc4 = __riscv_vwmacc_vx_i32m2(vc4, a4[k], vb, vl);
+                vc5 = __riscv_vwmacc_vx_i32m2(vc5, a5[k], vb, vl);
+                vc6 = __riscv_vwmacc_vx_i32m2(vc6, a6[k], vb, vl);
+                vc7 = __riscv_vwmacc_vx_i32m2(vc7, a7[k], vb, vl);
+            }
+
+            store_row_q15(&C[(size_t)(ih + 0) * ldc + jh], vc0, shift, vl);
+            store_row_q15(&C[(size_t)(ih + 1) * ldc + jh], vc1, shift, vl);
+            store_row_q15(&C[(size_t)(ih + 2) * ldc + jh], vc2, shift, vl);
+            store_row_q15(&C[(size_t)(ih + 3) * ldc + jh], vc3, shift, vl);
+            store_row_q15(&C[(size_t)(ih + 4) * ldc + jh], vc4, shift, vl);
+            store_row_q15(&C[(size_t)(ih + 5) * ldc + jh], vc5, shift, vl);
+            store_row_q15(&C[(size_t)(ih + 6) * ldc + jh], vc6, shift, vl);
+            store_row_q15(&C[(size_t)(ih + 7) * ldc + jh], vc7, shift, vl);
+        }
+
+        // tail rows (M % Th) on the same panel
+        for (; ih < M; ih++) {
+            const int16_t* a0 = A + (size_t)ih * lda;
+
+            vint32m2_t vc0 = __riscv_vmv_v_x_i32m2(0, vl);
+            for (int k = 0; k < K; ++k)
+                vc0 = __riscv_vwmacc_vx_i32m2(vc0, a0[k], __riscv_vle16_v_i16m1(&oB[(size_t)k * Tw], vl), vl);
+
+            store_row_q15(&C[(size_t)ih * ldc + jh], vc0, shift, vl);
+        }
+    }
+
+    if ((float*)oB != ws) free(oB);
+}
+
+void multiply_gemm_q15(const int16_t* A, const int16_t* B, int16_t* C, int M, int N, int K, int shift) {
+    kernel_q15_8_m2(A, B, C, M, N, K, K, N, N, shift, NULL);
+}
@@ -0,0 +1,165 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <riscv_vector.h>
+#include "reordered_gemm.h"
+
+/*
+ * INT4 WEIGHTS (fp32 A and C, B 4 bit with one fp32 scale per group of rows)
+ * B is never expanded in memory: the nibbles are unpacked and scaled while the
+ * B panel is built (K x Tw floats, Tw = VLMAX(e32m2)) and the fp32 fma of the
+ * 8-row tiles runs on it. With M <= 8 (decode) every B row is used by one tile
+ * only, so the panel is skipped: the row is dequantised in registers right
+ * before the fmas and B is read once, at half a byte per weight.
+ *
+ * UNPACK (vl columns from (vl + 1) / 2 bytes, no gather)
+ * byte b -> u16 (b & 0xf) | (b & 0xf0) << 4: low nibble in the low byte, high
+ * nibble in the high byte, read back as u8 the columns are in order.
+ */
+
+// vl columns of a B row (row starts at an even column), times the scales of the group
+static inline vfloat32m2_t dequant_q4(const uint8_t* row, const float* scale, size_t vl) {
+    size_t nb = (vl + 1) / 2;
+
+    vuint16m1_t w = __riscv_vzext_vf2_u16m1(__riscv_vle8_v_u8mf2(row, nb), nb);
+    w = __riscv_vor_vv_u16m1(__riscv_vand_vx_u16m1(w, 0xf, nb),
+                             __riscv_vsll_vx_u16m1(__riscv_vand_vx_u16m1(w, 0xf0, nb), 4, nb), nb);
+
+    vuint8mf2_t q = __riscv_vlmul_trunc_v_u8m1_u8mf2(__riscv_vreinterpret_v_u16m1_u8m1(w));
+    vint32m2_t vi = __riscv_vsub_vx_i32m2(__riscv_vreinterpret_v_u32m2_i32m2(__riscv_vzext_vf4_u32m2(q, vl)), 8, vl);
+
+    return __riscv_vfmul_vv_f32m2(__riscv_vfcvt_f_x_v_f32m2(vi, vl), __riscv_vle32_v_f32m2(scale, vl), vl);
+}
+
+// B[0:rows][0:width] dequantised into the panel (row stride ts)
+static void reordering_q4(const uint8_t* mat2, const float* scales, float* omat2, int rows, int ldb, int lds,
+                          int group, int ts, int width) {
+    if (width > ts) width = ts;
+
+    for (int i = 0; i < rows; i++)
+        __riscv_vse32_v_f32m2(&omat2[(size_t)ts * i], dequant_q4(&mat2[(size_t)ldb * i], &scales[(size_t)(i / group) * lds], width), width);
+}
+
+// R rows (constant once inlined) on one panel: from oB, or dequantised per k when panel is NULL
+static inline __attribute__((always_inline))
+void q4_tile(const float* A, const float* panel, const uint8_t* B, const float* scales, float* C, const int R,
+             int K, int lda, int ldb, int lds, int ldc, int group, int Tw, size_t vl) {
+
+    vfloat32m2_t vc0 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
+    vfloat32m2_t vc1 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
+    vfloat32m2_t vc2 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
+    vfloat32m2_t vc3 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
+    vfloat32m2_t vc4 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
+    vfloat32m2_t vc5 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
+    vfloat32m2_t vc6 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
+    vfloat32m2_t vc7 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
+
+    for (int kg = 0; kg < K; kg += group) {
+        const float* s = &scales[(size_t)(kg / group) * lds];
+        const int ke = kg + group < K ? kg + group : K;
+
+        for (int k = kg; k < ke; k++) {
+            vfloat32m2_t vb = panel ? __riscv_vle32_v_f32m2(&panel[(size_t)k * Tw], vl)
+                                    : dequant_q4(&B[(size_t)k * ldb], s, vl);
+
+            vc0 = __riscv_vfmacc_vf_f32m2(vc0, A[0 * lda + k], vb, vl);
+            if (R > 1) vc1 = __riscv_vfmacc_vf_f32m2(vc1, A[1 * lda + k], vb, vl);
+            if (R > 2) vc2 = __riscv_vfmacc_vf_f32m2(vc2, A[2 * lda + k], vb, vl);
+            if (R > 3) vc3 = __riscv_vfmacc_vf_f32m2(vc3, A[3 * lda + k], vb, vl);
+            if (R > 4) vc4 = __riscv_vfmacc_vf_f32m2(vc4, A[4 * lda + k], vb, vl);
+            if (R > 5) vc5 = __riscv_vfmacc_vf_f32m2(vc5, A[5 * lda + k], vb, vl);
+            if (R > 6) vc6 = __riscv_vfmacc_vf_f32m2(vc6, A[6 * lda + k], vb, vl);
+            if (R > 7) vc7 = __riscv_vfmacc_vf_f32m2(vc7, A[7 * lda + k], vb, vl);
+        }
+    }
+
+    __riscv_vse32_v_f32m2(&C[0 * ldc], vc0, vl);
+    if (R > 1) __riscv_vse32_v_f32m2(&C[1 * ldc], vc1, vl);
+    if (R > 2) __riscv_vse32_v_f32m2(&C[2 * ldc], vc2, vl);
+    if (R > 3) __riscv_vse32_v_f32m2(&C[3 * ldc], vc3, vl);
+    if (R > 4) __riscv_vse32_v_f32m2(&C[4 * ldc], vc4, vl);
+    if (R > 5) __riscv_vse32_v_f32m2(&C[5 * ldc], vc5, vl);
+    if (R > 6) __riscv_vse32_v_f32m2(&C[6 * ldc], vc6, vl);
+    if (R > 7) __riscv_vse32_v_f32m2(&C[7 * ldc], vc7, vl);
+}
+
+static void q4_rows(const float* A, const float* panel, const uint8_t* B, const float* scales, float* C, int R,
+                    int K, int lda, int ldb, int lds, int ldc, int group, int Tw, size_t vl) {
+    switch (R) {
+        case 1:  q4_tile(A, panel, B, scales, C, 1, K, lda, ldb, lds, ldc, group, Tw, vl); break;
+        case 2:  q4_tile(A, panel, B, scales, C, 2, K, lda, ldb, lds, ldc, group, Tw, vl); break;
+        case 3:  q4_tile(A, panel, B, scales, C, 3, K, lda, ldb, lds, ldc, group, Tw, vl); break;
+        case 4:  q4_tile(A, panel, B, scales, C, 4, K, lda, ldb, lds, ldc, group, Tw, vl); break;
+        case 5:  q4_tile(A, panel, B, scales, C, 5, K, lda, ldb, lds, ldc, group, Tw, vl); break;
+        case 6:  q4_tile(A, panel, B, scales, C, 6, K, lda, ldb, lds, ldc, group, Tw, vl); break;
+        case 7:  q4_tile(A, panel, B, scales, C, 7, K, lda, ldb, lds, ldc, group, Tw, vl); break;
+        default: q4_tile(A, panel, B, scales, C, 8, K, lda, ldb, lds, ldc, group, Tw, vl); break;
+    }
+}
+
+// ldb in bytes, lds: row stride of the scales; ws: K * Tw floats (NULL: allocated here, unused for M <= 8)
+void kernel_q4_8_m2(const float* A, const uint8_t* B, const float* scales, int group, float* C, int M, int N, int K,
+                    int lda, int ldb, int lds, int ldc, float* ws) {
+
+    const int Th = 8;
+    int Tw = __riscv_vsetvl_e32m2(N);
+
+    // decode: no reuse of the panel, dequantise in registers
+    const int fused = M <= Th;
+    float* oB = fused ? NULL : ws ? ws : malloc(sizeof(float) * K * Tw);
+
+    size_t vl;
+
+    for (int jh = 0; jh < N; jh += Tw) {
+        vl = __riscv_vsetvl_e32m2(N - jh);
+
+        if (!fused) reordering_q4(&B[jh / 2], &scales[jh], oB, K, ldb, lds, group, Tw, N - jh);
+
+        for (int ih = 0; ih < M; ih += Th)
+            q4_rows(&A[(size_t)ih * lda], oB, &B[jh / 2], &scales[jh], &C[(size_t)ih * ldc + jh],
+                    M - ih < Th ? M - ih : Th, K, lda, ldb, lds, ldc, group, Tw, vl);
+    }
+
+    if (oB != ws) free(oB);
+}
+
+void multiply_gemm_q4(const float* A, const uint8_t* B, const float* scales, int group, float* C, int M, int N, int K) {
+    kernel_q4_8_m2(A, B, scales, group, C, M, N, K, K, (N + 1) / 2, N, N, NULL);
+}
+
+// symmetric, scale = max |b| / 7 over the group of rows, per column
+void quantize_q4(const float* B, uint8_t* Bq, float* scales, int K, int N, int group) {
+    const int ldb = (N + 1) / 2;
+    memset(Bq, 0, (size_t)K * ldb);
+
+    for (int kg = 0; kg < K; kg += group) {
+        const int ke = kg + group < K ? kg + group : K;
+
+        for (int j = 0; j < N; j++) {
+            float amax = 0.0f;
+            for (int k = kg; k < ke; k++) {
+                float b = B[(size_t)k * N + j];
+                if (b > amax) amax = b;
+                if (-b > amax) amax = -b;
+            }
+
+            float s = amax / 7.0f;
+            scales[(size_t)(kg / group) * N + j] = s;
+
+            for (int k = kg; k < ke; k++) {
+                float x = s > 0.0f ? B[(size_t)k * N + j] / s : 0.0f;
+                int q = (int)(x < 0.0f ? x - 0.5f : x + 0.5f);
+                q = (q < -8 ? -8 : q > 7 ? 7 : q) + 8;
+                Bq[(size_t)k * ldb + j / 2] |= (uint8_t)(q << (4 * (j & 1)));
+            }
+        }
+    }
+}
+
+void dequantize_q4(const uint8_t* Bq, const float* scales, float* B, int K, int N, int group) {
+    const int ldb = (N + 1) / 2;
+
+    for (int k = 0; k < K; k++)
+        for (int j = 0; j < N; j++)
+            B[(size_t)k * N + j] = (float)(((Bq[(size_t)k * ldb + j / 2] >> (4 * (j & 1))) & 0xf) - 8) * scales[(size_t)(k / group) * N + j];
+}
@@ -0,0 +1,102 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <riscv_vector.h>
+#include "reordered_gemm.h"
+#include "reordered_gemm_kernel.h"
+
+/*
+ * SEMIRING GEMM
+ * C[i][j] = (+)_k A[i][k] (x) B[k][j] on the tropical semirings: min-plus
+ * ((+) = min, (x) = +, zero +inf) for shortest paths, max-plus ((+) = max,
+ * zero -inf) for longest / critical paths. Same tile as kernel_8_m2 (Th=8 x
+ * Tw = VLMAX(e32m2), oB from reordering or a pre-packed panel) with
+ * (vfmacc, 0) replaced by (vfmin / vfmax of vfadd, +inf / -inf): one more
+ * instruction per row and k, no fused form. The kernels have the
+ * os_kernel_t signature, gemm_plan runs them in place of kernel_8_m2
+ * (gemm_hints_t.semiring), tail rows included.
+ */
+
+// vc = vc (+) (a (x) vb)
+#define SR_OP(vc, a, vb, vl)                                                                        \
+    (semiring == SEMIRING_MIN_PLUS ? __riscv_vfmin_vv_f32m2((vc), __riscv_vfadd_vf_f32m2((vb), (a), (vl)), (vl)) \
+                                   : __riscv_vfmax_vv_f32m2((vc), __riscv_vfadd_vf_f32m2((vb), (a), (vl)), (vl)))
+
+// R rows and the semiring constant once inlined; A, C point to the first row
+static inline __attribute__((always_inline))
+void sr_tile(const float* A, const float* pB, float* C, const int R, int K, int lda, int ldp, int ldc,
+             size_t vl, const int semiring) {
+
+    const float zero = semiring == SEMIRING_MIN_PLUS ? __builtin_inff() : -__builtin_inff();
+
+    OS_TILE_F32M2_OP(A, lda, pB, ldp, R, K, vl, zero, SR_OP, OS_STORE);
+}
+
+static inline __attribute__((always_inline))
+void kernel_sr_8_m2(float* mat1, float* mat2, float* res, int M, int N, int K, int lda, int ldb, int ldc,
+                    float* ws, int pack_mode, const int semiring) {
+
+    const int Th = 8;
+    int Tw = __riscv_vsetvl_e32m2(N);
+
+    // ordered B: K x Tw, in the caller workspace ws if given (pre-packed mode: the panels are already in mat2)
+    float* oB = (ws || pack_mode == PACK_PREPACKED) ? ws : malloc(sizeof(float) * K * Tw);
+
+    size_t vl;
+
+    for (int jh = 0; jh < N; jh += Tw) {
+        const float* pB = oB;
+        int ldp = Tw;
+
+        // pre-packed mode: panel jh / Tw is read in place from mat2, ldb is the panel width
+        if (pack_mode == PACK_PREPACKED) {
+            pB = mat2 + (size_t)(jh / Tw) * K * ldb;
+            ldp = ldb;
+        }
+        else {
+            reordering_rvv(&mat2[jh], oB, K, ldb, Tw, N - jh);
+        }
+
+        vl = __riscv_vsetvl_e32m2(N - jh);
+
+        int ih = 0;
+        for (; ih + Th <= M; ih += Th)
+            sr_tile(&mat1[(size_t)ih * lda], pB, &res[(size_t)ih * ldc + jh], 8, K, lda, ldp, ldc, vl, semiring);
+
+        // tail rows (M % Th) on the same panel
+        float* a = &mat1[(size_t)ih * lda];
+        float* c = &res[(size_t)ih * ldc + jh];
+        switch (M - ih) {
+            case 7:  sr_tile(a, pB, c, 7, K, lda, ldp, ldc, vl, semiring); break;
+            case 6:  sr_tile(a, pB, c, 6, K, lda, ldp, ldc, vl, semiring); break;
+            case 5:  sr_tile(a, pB, c, 5, K, lda, ldp, ldc, vl, semiring); break;
+            case 4:  sr_tile(a, pB, c, 4, K, lda, ldp, ldc, vl, semiring); break;
+            case 3:  sr_tile(a, pB, c, 3, K, lda, ldp, ldc, vl, semiring); break;
+            case 2:  sr_tile(a, pB, c, 2, K, lda, ldp, ldc, vl, semiring); break;
+            case 1:  sr_tile(a, pB, c, 1, K, lda, ldp, ldc, vl, semiring); break;
+            default: break;
+        }
+    }
+
+    if (oB != ws) free(oB);
+}
+
+void kernel_minplus_8_m2(float* mat1, float* mat2, float* res, int M, int N, int K, int lda, int ldb, int ldc, float* ws, int pack_mode) {
+    kernel_sr_8_m2(mat1, mat2, res, M, N, K, lda, ldb, ldc, ws, pack_mode, SEMIRING_MIN_PLUS);
+}
+
+void kernel_maxplus_8_m2(float* mat1, float* mat2, float* res, int M, int N, int K, int lda, int ldb, int ldc, float* ws, int pack_mode) {
+    kernel_sr_8_m2(mat1, mat2, res, M, N, K, lda, ldb, ldc, ws, pack_mode, SEMIRING_MAX_PLUS);
+}
+
+void multiply_gemm_semiring(float* A, float* B, float* C, int M, int N, int K, int semiring) {
+
+    gemm_shape_t shape = { M, N, K };
+    gemm_strides_t strides = { K, N, N };
+    gemm_hints_t hints = { DATAFLOW_AUTO, 0, 0, PACK_SEPARATE, NULL, NULL, semiring, NULL };
+
+    gemm_plan_t* plan = gemm_plan(NULL, shape, strides, GEMM_F32, 1, &hints);
+    if (plan == NULL) return;
+
+    gemm_execute(NULL, plan, A, B, C);
+    gemm_destroy(plan);
+}
@@ -3,7 +3,11 @@
 #include <string.h>
 #include <time.h>
 #include <riscv_vector.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 #include "utils.h"
+#include "reordered_gemm.h"
 
 #define DEBUG_ENABLED 0
 int DEBUG_LEVEL;
@@ -17,2111 +21,86 @@ int DEBUG_LEVEL;
 
 #define DEFAULT_LMUL 1
 
-inline int get_vlen(){
-    size_t VLMAX8 = __riscv_vsetvlmax_e8m1();
-    int VLEN = VLMAX8 * 8;
-    return VLEN;
-}
-
-inline void reordering_rvv(float* mat2, float* omat2, int size, int ts) {
-    for (int i = 0; i < size; i++) {
-        const float* src = mat2 + (size * i);
-        float* dst = omat2 + (ts * i);
-        size_t remaining = ts;
-        
-        while (remaining > 0) {
-            size_t vl = __riscv_vsetvl_e32m8(remaining);  // LMUL=8
-            
-            vfloat32m8_t vec = __riscv_vle32_v_f32m8(src, vl);
-            __riscv_vse32_v_f32m8(dst, vec, vl);
-            
-            src += vl;
-            dst += vl;
-            remaining -= vl;
-        }
-    }
-}
-
-
-void kernel_2_m1(float* mat1, float* mat2, float* res, int N) {
-
-    float (*A)[N] = (float (*)[N]) mat1;
-    float (*B)[N] = (float (*)[N]) mat2;
-    float (*C)[N] = (float (*)[N]) res;
-
-    const int Th = 2;
-    int Tw = __riscv_vsetvl_e32m1(N);
-
-    //printf("Tw:%d\n", Tw);
-    
-    // ordered B: size x 2
-    float* oB = malloc(sizeof(float) * N * Tw);
-
-    size_t vl;
-
-    for (int jh = 0; jh < N; jh += vl) {
-        for (int ih = 0; ih < N; ih += Th) {
-        
-            if (ih == 0 && jh % Tw == 0) {
-                reordering_rvv(&B[ih][jh], oB, N, Tw);
-
-                if( DEBUG_ENABLED && DEBUG_LEVEL >= 3 ){
-                    printf("ih==0 ==> orderedB");
-                    print_lmatrixf32(oB, Tw, N * Tw);
-                }
-            }
-
-            // Tw deciso a runtime
-            vl = __riscv_vsetvl_e32m1(N - jh);
-
-            // accumulatori: uno per ogni riga del tile
-            vfloat32m1_t vc0 = __riscv_vfmv_v_f_f32m1(0.0f, vl);
-            vfloat32m1_t vc1 = __riscv_vfmv_v_f_f32m1(0.0f, vl);
-
-            #if UNROLL == 2
-            #pragma GCC unroll 2
-            #elif UNROLL == 4
-            #pragma GCC unroll 4
-            #elif UNROLL == 8
-            #pragma GCC unroll 8
-            #elif UNROLL == 16
-            #pragma GCC unroll 16
-            #else
-            #pragma GCC unroll 1
-            #endif
-            for (int k = 0; k < N; ++k) {
-
-                // carica B[k][jh : jh+vl]
-                vfloat32m1_t vb =
-                    __riscv_vle32_v_f32m1(&oB[k * Tw], vl);
-
-                // outer product
-                vc0 = __riscv_vfmacc_vf_f32m1(
-                    vc0, A[ih + 0][k], vb, vl);
-
-                vc1 = __riscv_vfmacc_vf_f32m1(
-                    vc1, A[ih + 1][k], vb, vl);
-            }
-
-            // store
-            __riscv_vse32_v_f32m1(&C[ih + 0][jh], vc0, vl);
-            __riscv_vse32_v_f32m1(&C[ih + 1][jh], vc1, vl);
-
-            if( DEBUG_ENABLED && DEBUG_LEVEL >= 3 ){
-                ///printf("Computation block C(%d:%d) finished! \n", ih, jh);
-                printf("> C  iter!!\n");
-                print_lmatrixf32((float*) C, N, N * N);
-            }
-
-        }
-    }
-}
-
-void kernel_2_m2(float* mat1, float* mat2, float* res, int N) {
-
-    float (*A)[N] = (float (*)[N]) mat1;
-    float (*B)[N] = (float (*)[N]) mat2;
-    float (*C)[N] = (float (*)[N]) res;
-
-    const int Th = 2;
-    int Tw = __riscv_vsetvl_e32m2(N);
-
-    //printf("Tw:%d\n", Tw);
-    
-    // ordered B: size x 2
-    float* oB = malloc(sizeof(float) * N * Tw);
-
-    size_t vl;
-
-    for (int jh = 0; jh < N; jh += vl) {
-        for (int ih = 0; ih < N; ih += Th) {
-        
-            if (ih == 0 && jh % Tw == 0) {
-                reordering_rvv(&B[ih][jh], oB, N, Tw);
-
-                if( DEBUG_ENABLED && DEBUG_LEVEL >= 3 ){
-                    printf("ih==0 ==> orderedB");
-                    print_lmatrixf32(oB, Tw, N * Tw);
-                }
-            }
-
-            // Tw deciso a runtime
-            vl = __riscv_vsetvl_e32m2(N - jh);
-
-            // accumulatori: uno per ogni riga del tile
-            vfloat32m2_t vc0 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
-            vfloat32m2_t vc1 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
-
-            #if UNROLL == 2
-            #pragma GCC unroll 2
-            #elif UNROLL == 4
-            #pragma GCC unroll 4
-            #elif UNROLL == 8
-            #pragma GCC unroll 8
-            #elif UNROLL == 16
-            #pragma GCC unroll 16
-            #else
-            #pragma GCC unroll 1
-            #endif
-            for (int k = 0; k < N; ++k) {
-
-                // carica B[k][jh : jh+vl]
-                vfloat32m2_t vb =
-                    __riscv_vle32_v_f32m2(&oB[k * Tw], vl);
-
-                // outer product
-                vc0 = __riscv_vfmacc_vf_f32m2(
-                    vc0, A[ih + 0][k], vb, vl);
-
-                vc1 = __riscv_vfmacc_vf_f32m2(
-                    vc1, A[ih + 1][k], vb, vl);
-            }
-
-            // store
-            __riscv_vse32_v_f32m2(&C[ih + 0][jh], vc0, vl);
-            __riscv_vse32_v_f32m2(&C[ih + 1][jh], vc1, vl);
-
-            if( DEBUG_ENABLED && DEBUG_LEVEL >= 3 ){
-                ///printf("Computation block C(%d:%d) finished! \n", ih, jh);
-                printf("> C  iter!!\n");
-                print_lmatrixf32((float*) C, N, N * N);
-            }
-
-        }
-    }
-}
-
-void kernel_2_m4(float* mat1, float* mat2, float* res, int N) {
-
-    float (*A)[N] = (float (*)[N]) mat1;
-    float (*B)[N] = (float (*)[N]) mat2;
-    float (*C)[N] = (float (*)[N]) res;
-
-    const int Th = 2;
-    int Tw = __riscv_vsetvl_e32m4(N);
-
-    //printf("Tw:%d\n", Tw);
-    
-    // ordered B: size x 2
-    float* oB = malloc(sizeof(float) * N * Tw);
-
-    size_t vl;
-
-    for (int jh = 0; jh < N; jh += vl) {
-        for (int ih = 0; ih < N; ih += Th) {
-        
-            if (ih == 0 && jh % Tw == 0) {
-                reordering_rvv(&B[ih][jh], oB, N, Tw);
-
-                if( DEBUG_ENABLED && DEBUG_LEVEL >= 3 ){
-                    printf("ih==0 ==> orderedB");
-                    print_lmatrixf32(oB, Tw, N * Tw);
-                }
-            }
-
-            // Tw deciso a runtime
-            vl = __riscv_vsetvl_e32m4(N - jh);
-
-            // accumulatori: uno per ogni riga del tile
-            vfloat32m4_t vc0 = __riscv_vfmv_v_f_f32m4(0.0f, vl);
-            vfloat32m4_t vc1 = __riscv_vfmv_v_f_f32m4(0.0f, vl);
-
-            #if UNROLL == 2
-            #pragma GCC unroll 2
-            #elif UNROLL == 4
-            #pragma GCC unroll 4
-            #elif UNROLL == 8
-            #pragma GCC unroll 8
-            #elif UNROLL == 16
-            #pragma GCC unroll 16
-            #else
-            #pragma GCC unroll 1
-            #endif
-            for (int k = 0; k < N; ++k) {
-
-                // carica B[k][jh : jh+vl]
-                vfloat32m4_t vb =
-                    __riscv_vle32_v_f32m4(&oB[k * Tw], vl);
-
-                // outer product
-                vc0 = __riscv_vfmacc_vf_f32m4(
-                    vc0, A[ih + 0][k], vb, vl);
-
-                vc1 = __riscv_vfmacc_vf_f32m4(
-                    vc1, A[ih + 1][k], vb, vl);
-            }
-
-            // store
-            __riscv_vse32_v_f32m4(&C[ih + 0][jh], vc0, vl);
-            __riscv_vse32_v_f32m4(&C[ih + 1][jh], vc1, vl);
-
-            if( DEBUG_ENABLED && DEBUG_LEVEL >= 3 ){
-                ///printf("Computation block C(%d:%d) finished! \n", ih, jh);
-                printf("> C  iter!!\n");
-                print_lmatrixf32((float*) C, N, N * N);
-            }
-
-        }
-    }
-}
-
-void kernel_2_m8(float* mat1, float* mat2, float* res, int N) {
-
-    float (*A)[N] = (float (*)[N]) mat1;
-    float (*B)[N] = (float (*)[N]) mat2;
-    float (*C)[N] = (float (*)[N]) res;
-
-    const int Th = 2;
-    int Tw = __riscv_vsetvl_e32m8(N);
-
-    //printf("Tw:%d\n", Tw);
-    
-    // ordered B: size x 2
-    float* oB = malloc(sizeof(float) * N * Tw);
-
-    size_t vl;
-
-    for (int jh = 0; jh < N; jh += vl) {
-        for (int ih = 0; ih < N; ih += Th) {
-        
-            if (ih == 0 && jh % Tw == 0) {
-                reordering_rvv(&B[ih][jh], oB, N, Tw);
-
-                if( DEBUG_ENABLED && DEBUG_LEVEL >= 3 ){
-                    printf("ih==0 ==> orderedB");
-                    print_lmatrixf32(oB, Tw, N * Tw);
-                }
-            }
-
-            // Tw deciso a runtime
-            vl = __riscv_vsetvl_e32m8(N - jh);
-
-            // accumulatori: uno per ogni riga del tile
-            vfloat32m8_t vc0 = __riscv_vfmv_v_f_f32m8(0.0f, vl);
-            vfloat32m8_t vc1 = __riscv_vfmv_v_f_f32m8(0.0f, vl);
-
-            #if UNROLL == 2
-            #pragma GCC unroll 2
-            #elif UNROLL == 4
-            #pragma GCC unroll 4
-            #elif UNROLL == 8
-            #pragma GCC unroll 8
-            #elif UNROLL == 16
-            #pragma GCC unroll 16
-            #else
-            #pragma GCC unroll 1
-            #endif
-            for (int k = 0; k < N; ++k) {
-
-                // carica B[k][jh : jh+vl]
-                vfloat32m8_t vb =
-                    __riscv_vle32_v_f32m8(&oB[k * Tw], vl);
-
-                // outer product
-                vc0 = __riscv_vfmacc_vf_f32m8(
-                    vc0, A[ih + 0][k], vb, vl);
-
-                vc1 = __riscv_vfmacc_vf_f32m8(
-                    vc1, A[ih + 1][k], vb, vl);
-            }
-
-            // store
-            __riscv_vse32_v_f32m8(&C[ih + 0][jh], vc0, vl);
-            __riscv_vse32_v_f32m8(&C[ih + 1][jh], vc1, vl);
-
-            if( DEBUG_ENABLED && DEBUG_LEVEL >= 3 ){
-                ///printf("Computation block C(%d:%d) finished! \n", ih, jh);
-                printf("> C  iter!!\n");
-                print_lmatrixf32((float*) C, N, N * N);
-            }
-
-        }
-    }
-}
+#define DEFAULT_DATAFLOW DATAFLOW_AUTO
 
-void kernel_2_mf2(float* mat1, float* mat2, float* res, int N) {
+#define DEFAULT_PACK PACK_SEPARATE
 
-    float (*A)[N] = (float (*)[N]) mat1;
-    float (*B)[N] = (float (*)[N]) mat2;
-    float (*C)[N] = (float (*)[N]) res;
+// [0, 1] pack B once with pack_b, outside the timed region
+#define DEFAULT_PREPACK 0
 
-    const int Th = 2;
-    int Tw = __riscv_vsetvl_e32mf2(N);
+// GEMM calls on the same B, the time is the average per call
+#define DEFAULT_REPEAT 1
 
-    //printf("Tw:%d\n", Tw);
-    
-    // ordered B: size x 2
-    float* oB = malloc(sizeof(float) * N * Tw);
-
-    size_t vl;
-
-    for (int jh = 0; jh < N; jh += vl) {
-        for (int ih = 0; ih < N; ih += Th) {
-        
-            if (ih == 0 && jh % Tw == 0) {
-                reordering_rvv(&B[ih][jh], oB, N, Tw);
-
-                if( DEBUG_ENABLED && DEBUG_LEVEL >= 3 ){
-                    printf("ih==0 ==> orderedB");
-                    print_lmatrixf32(oB, Tw, N * Tw);
-                }
-            }
-
-            // Tw deciso a runtime
-            vl = __riscv_vsetvl_e32mf2(N - jh);
-
-            // accumulatori: uno per ogni riga del tile
-            vfloat32mf2_t vc0 = __riscv_vfmv_v_f_f32mf2(0.0f, vl);
-            vfloat32mf2_t vc1 = __riscv_vfmv_v_f_f32mf2(0.0f, vl);
-
-            #if UNROLL == 2
-            #pragma GCC unroll 2
-            #elif UNROLL == 4
-            #pragma GCC unroll 4
-            #elif UNROLL == 8
-            #pragma GCC unroll 8
-            #elif UNROLL == 16
-            #pragma GCC unroll 16
-            #else
-            #pragma GCC unroll 1
-            #endif
-            for (int k = 0; k < N; ++k) {
-
-                // carica B[k][jh : jh+vl]
-                vfloat32mf2_t vb =
-                    __riscv_vle32_v_f32mf2(&oB[k * Tw], vl);
-
-                // outer product
-                vc0 = __riscv_vfmacc_vf_f32mf2(
-                    vc0, A[ih + 0][k], vb, vl);
-
-                vc1 = __riscv_vfmacc_vf_f32mf2(
-                    vc1, A[ih + 1][k], vb, vl);
-            }
-
-            // store
-            __riscv_vse32_v_f32mf2(&C[ih + 0][jh], vc0, vl);
-            __riscv_vse32_v_f32mf2(&C[ih + 1][jh], vc1, vl);
-
-            if( DEBUG_ENABLED && DEBUG_LEVEL >= 3 ){
-                ///printf("Computation block C(%d:%d) finished! \n", ih, jh);
-                printf("> C  iter!!\n");
-                print_lmatrixf32((float*) C, N, N * N);
-            }
-
-        }
-    }
-}
+// [0, 1] gemm_plan outside the timed region, gemm_execute in the timed region
+#define DEFAULT_PLAN 0
 
+// threads of the plan (columns of C split in whole panels)
+#define DEFAULT_THREADS 1
 
+// problems of the same shape in one gemm_execute_strided_batch call
+#define DEFAULT_BATCH 1
 
-void kernel_4_m1(float* mat1, float* mat2, float* res, int N) {
+// problems in one gemm_execute_grouped call, problem i has M * (i + 1) / group rows
+#define DEFAULT_GROUP 1
 
-    float (*A)[N] = (float (*)[N]) mat1;
-    float (*B)[N] = (float (*)[N]) mat2;
-    float (*C)[N] = (float (*)[N]) res;
+// [0, 1] multiply_gemm_indexed, rows of A read and rows of C written in reverse order
+#define DEFAULT_INDEXED 0
 
-    const int Th = 4;
-    int Tw = __riscv_vsetvl_e32m1(N);
+// GEMM_F32, GEMM_F16 (fp16 A/B, fp32 C), GEMM_F16_F16 (fp16 A/B/C), GEMM_BF16 (bf16 A/B, fp32 C), GEMM_F64
+#define DEFAULT_DTYPE GEMM_F32
 
-    //printf("Tw:%d\n", Tw);
-    
-    // ordered B: size x 2
-    float* oB = malloc(sizeof(float) * N * Tw);
+// SEMIRING_PLUS_TIMES, SEMIRING_MIN_PLUS, SEMIRING_MAX_PLUS (fp32, plan or multiply_gemm_semiring)
+#define DEFAULT_SEMIRING SEMIRING_PLUS_TIMES
 
-    size_t vl;
+// epilogue steps (fp32): EPILOGUE_* bits, activation ACT_NONE / ACT_RELU / ACT_GELU / ACT_SILU
+// fused with PLAN=1, multiply_gemm + gemm_epilogue_apply pass otherwise
+#define DEFAULT_EPILOGUE 0
+#define DEFAULT_ACT ACT_NONE
+#define EPILOGUE_BIAS 1
+#define EPILOGUE_COL_SCALE 2
+#define EPILOGUE_ROW_SCALE 4
+#define EPILOGUE_CLAMP 8
+#define EPILOGUE_RESIDUAL 16
 
-    for (int jh = 0; jh < N; jh += vl) {
-        for (int ih = 0; ih < N; ih += Th) {
-        
-            if (ih == 0 && jh % Tw == 0) {
-                reordering_rvv(&B[ih][jh], oB, N, Tw);
+// hidden size H of a fused MLP, 0: off. C (M x N) = act(A (M x K) W1 (K x H)) W2 (H x N)
+// PLAN=1: gemm_mlp (hidden tile in L2), PLAN=0: two multiply_gemm and an activation pass
+#define DEFAULT_MLP 0
 
-                if( DEBUG_ENABLED && DEBUG_LEVEL >= 3 ){
-                    printf("ih==0 ==> orderedB");
-                    print_lmatrixf32(oB, Tw, N * Tw);
-                }
-            }
+// heads of an attention softmax(Q K^T / sqrt(K)) V, 0: off. Q M x K, K and V N x K per head, O M x K
+// PLAN=1: multiply_attention (online softmax), PLAN=0: two multiply_gemm with the M x N scores in memory
+#define DEFAULT_ATTENTION 0
+#define DEFAULT_CAUSAL 0
 
-            // Tw deciso a runtime
-            ////vl = __riscv_vsetvl_e32m1(N - jh);
-            vl = __riscv_vsetvl_e32m1(N - jh);
-
-            // accumulatori: uno per ogni riga del tile
-            vfloat32m1_t vc0 = __riscv_vfmv_v_f_f32m1(0.0f, vl);
-            vfloat32m1_t vc1 = __riscv_vfmv_v_f_f32m1(0.0f, vl);
-            vfloat32m1_t vc2 = __riscv_vfmv_v_f_f32m1(0.0f, vl);
-            vfloat32m1_t vc3 = __riscv_vfmv_v_f_f32m1(0.0f, vl);
-
-            #if UNROLL == 2
-            #pragma GCC unroll 2
-            #elif UNROLL == 4
-            #pragma GCC unroll 4
-            #elif UNROLL == 8
-            #pragma GCC unroll 8
-            #elif UNROLL == 16
-            #pragma GCC unroll 16
-            #else
-            #pragma GCC unroll 1
-            #endif
-            for (int k = 0; k < N; ++k) {
-
-                // carica B[k][jh : jh+vl]
-                vfloat32m1_t vb =
-                    __riscv_vle32_v_f32m1(&oB[k * Tw], vl);
-
-                // outer product
-                vc0 = __riscv_vfmacc_vf_f32m1(
-                    vc0, A[ih + 0][k], vb, vl);
-
-                vc1 = __riscv_vfmacc_vf_f32m1(
-                    vc1, A[ih + 1][k], vb, vl);
-
-                vc2 = __riscv_vfmacc_vf_f32m1(
-                    vc2, A[ih + 2][k], vb, vl);
-
-                vc3 = __riscv_vfmacc_vf_f32m1(
-                    vc3, A[ih + 3][k], vb, vl);
-            }
+// k nearest neighbours, 0: off. queries A (M x K), corpus B^T (N points of K), distances and indices M x k
+// PLAN=1: knn_search (top-k heaps fed by the tile), PLAN=0: multiply_gemm, M x N distances, knn_select pass
+#define DEFAULT_KNN 0
 
-            // store
-            __riscv_vse32_v_f32m1(&C[ih + 0][jh], vc0, vl);
-            __riscv_vse32_v_f32m1(&C[ih + 1][jh], vc1, vl);
-            __riscv_vse32_v_f32m1(&C[ih + 2][jh], vc2, vl);
-            __riscv_vse32_v_f32m1(&C[ih + 3][jh], vc3, vl);
+// convolution, 0: off, 1: NCHW, 2: NHWC (CONV_NCHW + 1, CONV_NHWC + 1). BATCH images of
+// K channels, M x M pixels, N output channels, FILTER x FILTER, PAD -1: FILTER / 2 * DILATION
+// PLAN=1: gemm_conv CONV_AUTO (direct 1x1 or implicit GEMM), PLAN=0: CONV_IM2COL
+#define DEFAULT_CONV 0
+#define DEFAULT_FILTER 3
+#define DEFAULT_STRIDE 1
+#define DEFAULT_PAD -1
+#define DEFAULT_DILATION 1
+#define DEFAULT_GROUPS 1
 
-            if( DEBUG_ENABLED && DEBUG_LEVEL >= 3 ){
-                ///printf("Computation block C(%d:%d) finished! \n", ih, jh);
-                printf("> C  iter!!\n");
-                print_lmatrixf32((float*) C, N, N * N);
-            }
+// DTYPE values of the kernels outside the plan API, clear of the GemmDtype ones
+// DTYPE: multiply_gemm_i8, u8 A, s8 B, fp32 C with unit scales (inputs must fit int8)
+#define DTYPE_I8 16
 
-        }
-    }
-}
-
-void kernel_4_m2(float* mat1, float* mat2, float* res, int N) {
-
-    float (*A)[N] = (float (*)[N]) mat1;
-    float (*B)[N] = (float (*)[N]) mat2;
-    float (*C)[N] = (float (*)[N]) res;
-
-    const int Th = 4;
-    int Tw = __riscv_vsetvl_e32m2(N);
-
-    //printf("Tw:%d\n", Tw);
-    
-    // ordered B: size x 2
-    float* oB = malloc(sizeof(float) * N * Tw);
+// DTYPE: multiply_gemm_q4, fp32 A, int4 B with one scale per Q4_GROUP rows, fp32 C
+#define DTYPE_Q4 17
+#define Q4_GROUP 32
 
-    size_t vl;
+// DTYPE: multiply_gemm_c32, complex A, B, C with zero imaginary parts (C real part printed)
+#define DTYPE_C32 18
 
-    for (int jh = 0; jh < N; jh += vl) {
-        for (int ih = 0; ih < N; ih += Th) {
-        
-            if (ih == 0 && jh % Tw == 0) {
-                reordering_rvv(&B[ih][jh], oB, N, Tw);
+// DTYPE: multiply_gemm_q15, int16 A, B, C, shift 0 (exact while C fits int16, saturated otherwise)
+#define DTYPE_Q15 19
 
-                if( DEBUG_ENABLED && DEBUG_LEVEL >= 3 ){
-                    printf("ih==0 ==> orderedB");
-                    print_lmatrixf32(oB, Tw, N * Tw);
-                }
-            }
-
-            // Tw deciso a runtime
-            ////vl = __riscv_vsetvl_e32m1(N - jh);
-            vl = __riscv_vsetvl_e32m2(N - jh);
-
-            // accumulatori: uno per ogni riga del tile
-            vfloat32m2_t vc0 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
-            vfloat32m2_t vc1 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
-            vfloat32m2_t vc2 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
-            vfloat32m2_t vc3 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
-
-            #if UNROLL == 2
-            #pragma GCC unroll 2
-            #elif UNROLL == 4
-            #pragma GCC unroll 4
-            #elif UNROLL == 8
-            #pragma GCC unroll 8
-            #elif UNROLL == 16
-            #pragma GCC unroll 16
-            #else
-            #pragma GCC unroll 1
-            #endif
-            for (int k = 0; k < N; ++k) {
-
-                // carica B[k][jh : jh+vl]
-                vfloat32m2_t vb =
-                    __riscv_vle32_v_f32m2(&oB[k * Tw], vl);
-
-                // outer product
-                vc0 = __riscv_vfmacc_vf_f32m2(
-                    vc0, A[ih + 0][k], vb, vl);
-
-                vc1 = __riscv_vfmacc_vf_f32m2(
-                    vc1, A[ih + 1][k], vb, vl);
-
-                vc2 = __riscv_vfmacc_vf_f32m2(
-                    vc2, A[ih + 2][k], vb, vl);
-
-                vc3 = __riscv_vfmacc_vf_f32m2(
-                    vc3, A[ih + 3][k], vb, vl);
-            }
-
-            // store
-            __riscv_vse32_v_f32m2(&C[ih + 0][jh], vc0, vl);
-            __riscv_vse32_v_f32m2(&C[ih + 1][jh], vc1, vl);
-            __riscv_vse32_v_f32m2(&C[ih + 2][jh], vc2, vl);
-            __riscv_vse32_v_f32m2(&C[ih + 3][jh], vc3, vl);
-
-            if( DEBUG_ENABLED && DEBUG_LEVEL >= 3 ){
-                ///printf("Computation block C(%d:%d) finished! \n", ih, jh);
-                printf("> C  iter!!\n");
-                print_lmatrixf32((float*) C, N, N * N);
-            }
-
-        }
-    }
-}
-
-void kernel_4_m4(float* mat1, float* mat2, float* res, int N) {
-
-    float (*A)[N] = (float (*)[N]) mat1;
-    float (*B)[N] = (float (*)[N]) mat2;
-    float (*C)[N] = (float (*)[N]) res;
-
-    const int Th = 4;
-    int Tw = __riscv_vsetvl_e32m4(N);
-
-    //printf("Tw:%d\n", Tw);
-    
-    // ordered B: size x 2
-    float* oB = malloc(sizeof(float) * N * Tw);
-
-    size_t vl;
-
-    for (int jh = 0; jh < N; jh += vl) {
-        for (int ih = 0; ih < N; ih += Th) {
-        
-            if (ih == 0 && jh % Tw == 0) {
-                reordering_rvv(&B[ih][jh], oB, N, Tw);
-
-                if( DEBUG_ENABLED && DEBUG_LEVEL >= 3 ){
-                    printf("ih==0 ==> orderedB");
-                    print_lmatrixf32(oB, Tw, N * Tw);
-                }
-            }
-
-            // Tw deciso a runtime
-            ////vl = __riscv_vsetvl_e32m1(N - jh);
-            vl = __riscv_vsetvl_e32m4(N - jh);
-
-            // accumulatori: uno per ogni riga del tile
-            vfloat32m4_t vc0 = __riscv_vfmv_v_f_f32m4(0.0f, vl);
-            vfloat32m4_t vc1 = __riscv_vfmv_v_f_f32m4(0.0f, vl);
-            vfloat32m4_t vc2 = __riscv_vfmv_v_f_f32m4(0.0f, vl);
-            vfloat32m4_t vc3 = __riscv_vfmv_v_f_f32m4(0.0f, vl);
-
-            #if UNROLL == 2
-            #pragma GCC unroll 2
-            #elif UNROLL == 4
-            #pragma GCC unroll 4
-            #elif UNROLL == 8
-            #pragma GCC unroll 8
-            #elif UNROLL == 16
-            #pragma GCC unroll 16
-            #else
-            #pragma GCC unroll 1
-            #endif
-            for (int k = 0; k < N; ++k) {
-
-                // carica B[k][jh : jh+vl]
-                vfloat32m4_t vb =
-                    __riscv_vle32_v_f32m4(&oB[k * Tw], vl);
-
-                // outer product
-                vc0 = __riscv_vfmacc_vf_f32m4(
-                    vc0, A[ih + 0][k], vb, vl);
-
-                vc1 = __riscv_vfmacc_vf_f32m4(
-                    vc1, A[ih + 1][k], vb, vl);
-
-                vc2 = __riscv_vfmacc_vf_f32m4(
-                    vc2, A[ih + 2][k], vb, vl);
-
-                vc3 = __riscv_vfmacc_vf_f32m4(
-                    vc3, A[ih + 3][k], vb, vl);
-            }
-
-            // store
-            __riscv_vse32_v_f32m4(&C[ih + 0][jh], vc0, vl);
-            __riscv_vse32_v_f32m4(&C[ih + 1][jh], vc1, vl);
-            __riscv_vse32_v_f32m4(&C[ih + 2][jh], vc2, vl);
-            __riscv_vse32_v_f32m4(&C[ih + 3][jh], vc3, vl);
-
-            if( DEBUG_ENABLED && DEBUG_LEVEL >= 3 ){
-                ///printf("Computation block C(%d:%d) finished! \n", ih, jh);
-                printf("> C  iter!!\n");
-                print_lmatrixf32((float*) C, N, N * N);
-            }
-        }
-    }
-}
-
-void kernel_4_m8(float* mat1, float* mat2, float* res, int N) {
-
-    float (*A)[N] = (float (*)[N]) mat1;
-    float (*B)[N] = (float (*)[N]) mat2;
-    float (*C)[N] = (float (*)[N]) res;
-
-    const int Th = 4;
-    int Tw = __riscv_vsetvl_e32m8(N);
-
-    //printf("Tw:%d\n", Tw);
-    
-    // ordered B: size x 2
-    float* oB = malloc(sizeof(float) * N * Tw);
-
-    size_t vl;
-
-    for (int jh = 0; jh < N; jh += vl) {
-        for (int ih = 0; ih < N; ih += Th) {
-        
-            if (ih == 0 && jh % Tw == 0) {
-                reordering_rvv(&B[ih][jh], oB, N, Tw);
-
-                if( DEBUG_ENABLED && DEBUG_LEVEL >= 3 ){
-                    printf("ih==0 ==> orderedB");
-                    print_lmatrixf32(oB, Tw, N * Tw);
-                }
-            }
-
-            // Tw deciso a runtime
-            ////vl = __riscv_vsetvl_e32m1(N - jh);
-            vl = __riscv_vsetvl_e32m8(N - jh);
-
-            // accumulatori: uno per ogni riga del tile
-            vfloat32m8_t vc0 = __riscv_vfmv_v_f_f32m8(0.0f, vl);
-            vfloat32m8_t vc1 = __riscv_vfmv_v_f_f32m8(0.0f, vl);
-            vfloat32m8_t vc2 = __riscv_vfmv_v_f_f32m8(0.0f, vl);
-            vfloat32m8_t vc3 = __riscv_vfmv_v_f_f32m8(0.0f, vl);
-
-            #if UNROLL == 2
-            #pragma GCC unroll 2
-            #elif UNROLL == 4
-            #pragma GCC unroll 4
-            #elif UNROLL == 8
-            #pragma GCC unroll 8
-            #elif UNROLL == 16
-            #pragma GCC unroll 16
-            #else
-            #pragma GCC unroll 1
-            #endif
-            for (int k = 0; k < N; ++k) {
-
-                // carica B[k][jh : jh+vl]
-                vfloat32m8_t vb =
-                    __riscv_vle32_v_f32m8(&oB[k * Tw], vl);
-
-                // outer product
-                vc0 = __riscv_vfmacc_vf_f32m8(
-                    vc0, A[ih + 0][k], vb, vl);
-
-                vc1 = __riscv_vfmacc_vf_f32m8(
-                    vc1, A[ih + 1][k], vb, vl);
-
-                vc2 = __riscv_vfmacc_vf_f32m8(
-                    vc2, A[ih + 2][k], vb, vl);
-
-                vc3 = __riscv_vfmacc_vf_f32m8(
-                    vc3, A[ih + 3][k], vb, vl);
-            }
-
-            // store
-            __riscv_vse32_v_f32m8(&C[ih + 0][jh], vc0, vl);
-            __riscv_vse32_v_f32m8(&C[ih + 1][jh], vc1, vl);
-            __riscv_vse32_v_f32m8(&C[ih + 2][jh], vc2, vl);
-            __riscv_vse32_v_f32m8(&C[ih + 3][jh], vc3, vl);
-
-            if( DEBUG_ENABLED && DEBUG_LEVEL >= 3 ){
-                ///printf("Computation block C(%d:%d) finished! \n", ih, jh);
-                printf("> C  iter!!\n");
-                print_lmatrixf32((float*) C, N, N * N);
-            }
-
-        }
-    }
-}
-
-void kernel_4_mf2(float* mat1, float* mat2, float* res, int N) {
-
-    float (*A)[N] = (float (*)[N]) mat1;
-    float (*B)[N] = (float (*)[N]) mat2;
-    float (*C)[N] = (float (*)[N]) res;
-
-    const int Th = 4;
-    int Tw = __riscv_vsetvl_e32mf2(N);
-
-    //printf("Tw:%d\n", Tw);
-    
-    // ordered B: size x 2
-    float* oB = malloc(sizeof(float) * N * Tw);
-
-    size_t vl;
-
-    for (int jh = 0; jh < N; jh += vl) {
-        for (int ih = 0; ih < N; ih += Th) {
-        
-            if (ih == 0 && jh % Tw == 0) {
-                reordering_rvv(&B[ih][jh], oB, N, Tw);
-
-                if( DEBUG_ENABLED && DEBUG_LEVEL >= 3 ){
-                    printf("ih==0 ==> orderedB");
-                    print_lmatrixf32(oB, Tw, N * Tw);
-                }
-            }
-
-            // Tw deciso a runtime
-            ////vl = __riscv_vsetvl_e32mf2(N - jh);
-            vl = __riscv_vsetvl_e32mf2(N - jh);
-
-            // accumulatori: uno per ogni riga del tile
-            vfloat32mf2_t vc0 = __riscv_vfmv_v_f_f32mf2(0.0f, vl);
-            vfloat32mf2_t vc1 = __riscv_vfmv_v_f_f32mf2(0.0f, vl);
-            vfloat32mf2_t vc2 = __riscv_vfmv_v_f_f32mf2(0.0f, vl);
-            vfloat32mf2_t vc3 = __riscv_vfmv_v_f_f32mf2(0.0f, vl);
-
-            #if UNROLL == 2
-            #pragma GCC unroll 2
-            #elif UNROLL == 4
-            #pragma GCC unroll 4
-            #elif UNROLL == 8
-            #pragma GCC unroll 8
-            #elif UNROLL == 16
-            #pragma GCC unroll 16
-            #else
-            #pragma GCC unroll 1
-            #endif
-            for (int k = 0; k < N; ++k) {
-
-                // carica B[k][jh : jh+vl]
-                vfloat32mf2_t vb =
-                    __riscv_vle32_v_f32mf2(&oB[k * Tw], vl);
-
-                // outer product
-                vc0 = __riscv_vfmacc_vf_f32mf2(
-                    vc0, A[ih + 0][k], vb, vl);
-
-                vc1 = __riscv_vfmacc_vf_f32mf2(
-                    vc1, A[ih + 1][k], vb, vl);
-
-                vc2 = __riscv_vfmacc_vf_f32mf2(
-                    vc2, A[ih + 2][k], vb, vl);
-
-                vc3 = __riscv_vfmacc_vf_f32mf2(
-                    vc3, A[ih + 3][k], vb, vl);
-            }
-
-            // store
-            __riscv_vse32_v_f32mf2(&C[ih + 0][jh], vc0, vl);
-            __riscv_vse32_v_f32mf2(&C[ih + 1][jh], vc1, vl);
-            __riscv_vse32_v_f32mf2(&C[ih + 2][jh], vc2, vl);
-            __riscv_vse32_v_f32mf2(&C[ih + 3][jh], vc3, vl);
-
-            if( DEBUG_ENABLED && DEBUG_LEVEL >= 3 ){
-                ///printf("Computation block C(%d:%d) finished! \n", ih, jh);
-                printf("> C  iter!!\n");
-                print_lmatrixf32((float*) C, N, N * N);
-            }
-
-        }
-    }
-}
-
-
-void kernel_8_m1(float* mat1, float* mat2, float* res, int N) {
-
-    float (*A)[N] = (float (*)[N]) mat1;
-    float (*B)[N] = (float (*)[N]) mat2;
-    float (*C)[N] = (float (*)[N]) res;
-
-    const int Th = 8;
-    int Tw = __riscv_vsetvl_e32m1(N);
-
-    //printf("Tw:%d\n", Tw);
-    
-    // ordered B: size x 2
-    float* oB = malloc(sizeof(float) * N * Tw);
-
-    size_t vl;
-
-    for (int jh = 0; jh < N; jh += vl) {
-        for (int ih = 0; ih < N; ih += Th) {
-        
-            if (ih == 0 && jh % Tw == 0) {
-                reordering_rvv(&B[ih][jh], oB, N, Tw);
-
-                if( DEBUG_ENABLED && DEBUG_LEVEL >= 3 ){
-                    printf("ih==0 ==> orderedB");
-                    print_lmatrixf32(oB, Tw, N * Tw);
-                }
-            }
-
-            // Tw deciso a runtime
-            ////vl = __riscv_vsetvl_e32m1(N - jh);
-            vl = __riscv_vsetvl_e32m1(N - jh);
-
-            // accumulatori: uno per ogni riga del tile
-            vfloat32m1_t vc0 = __riscv_vfmv_v_f_f32m1(0.0f, vl);
-            vfloat32m1_t vc1 = __riscv_vfmv_v_f_f32m1(0.0f, vl);
-            vfloat32m1_t vc2 = __riscv_vfmv_v_f_f32m1(0.0f, vl);
-            vfloat32m1_t vc3 = __riscv_vfmv_v_f_f32m1(0.0f, vl);
-            vfloat32m1_t vc4 = __riscv_vfmv_v_f_f32m1(0.0f, vl);
-            vfloat32m1_t vc5 = __riscv_vfmv_v_f_f32m1(0.0f, vl);
-            vfloat32m1_t vc6 = __riscv_vfmv_v_f_f32m1(0.0f, vl);
-            vfloat32m1_t vc7 = __riscv_vfmv_v_f_f32m1(0.0f, vl);
-
-            #if UNROLL == 2
-            #pragma GCC unroll 2
-            #elif UNROLL == 4
-            #pragma GCC unroll 4
-            #elif UNROLL == 8
-            #pragma GCC unroll 8
-            #elif UNROLL == 16
-            #pragma GCC unroll 16
-            #else
-            #pragma GCC unroll 1
-            #endif
-            for (int k = 0; k < N; ++k) {
-
-                // carica B[k][jh : jh+vl]
-                vfloat32m1_t vb =
-                    __riscv_vle32_v_f32m1(&oB[k * Tw], vl);
-
-                // outer product
-                vc0 = __riscv_vfmacc_vf_f32m1(
-                    vc0, A[ih + 0][k], vb, vl);
-
-                vc1 = __riscv_vfmacc_vf_f32m1(
-                    vc1, A[ih + 1][k], vb, vl);
-
-                vc2 = __riscv_vfmacc_vf_f32m1(
-                    vc2, A[ih + 2][k], vb, vl);
-
-                vc3 = __riscv_vfmacc_vf_f32m1(
-                    vc3, A[ih + 3][k], vb, vl);
-
-                vc4 = __riscv_vfmacc_vf_f32m1(
-                    vc4, A[ih + 4][k], vb, vl);
-
-                vc5 = __riscv_vfmacc_vf_f32m1(
-                    vc5, A[ih + 5][k], vb, vl);
-
-                vc6 = __riscv_vfmacc_vf_f32m1(
-                    vc6, A[ih + 6][k], vb, vl);
-
-                vc7 = __riscv_vfmacc_vf_f32m1(
-                    vc7, A[ih + 7][k], vb, vl);
-            }
-
-            // store
-            __riscv_vse32_v_f32m1(&C[ih + 0][jh], vc0, vl);
-            __riscv_vse32_v_f32m1(&C[ih + 1][jh], vc1, vl);
-            __riscv_vse32_v_f32m1(&C[ih + 2][jh], vc2, vl);
-            __riscv_vse32_v_f32m1(&C[ih + 3][jh], vc3, vl);
-            __riscv_vse32_v_f32m1(&C[ih + 4][jh], vc4, vl);
-            __riscv_vse32_v_f32m1(&C[ih + 5][jh], vc5, vl);
-            __riscv_vse32_v_f32m1(&C[ih + 6][jh], vc6, vl);
-            __riscv_vse32_v_f32m1(&C[ih + 7][jh], vc7, vl);
-
-            if( DEBUG_ENABLED && DEBUG_LEVEL >= 3 ){
-                ///printf("Computation block C(%d:%d) finished! \n", ih, jh);
-                printf("> C  iter!!\n");
-                print_lmatrixf32((float*) C, N, N * N);
-            }
-
-        }
-    }
-}
-
-void kernel_8_m2(float* mat1, float* mat2, float* res, int N) {
-
-    float (*A)[N] = (float (*)[N]) mat1;
-    float (*B)[N] = (float (*)[N]) mat2;
-    float (*C)[N] = (float (*)[N]) res;
-
-    const int Th = 8;
-    int Tw = __riscv_vsetvl_e32m2(N);
-
-    //printf("Tw:%d\n", Tw);
-    
-    // ordered B: size x 2
-    float* oB = malloc(sizeof(float) * N * Tw);
-
-    size_t vl;
-
-    for (int jh = 0; jh < N; jh += vl) {
-        for (int ih = 0; ih < N; ih += Th) {
-        
-            if (ih == 0 && jh % Tw == 0) {
-                reordering_rvv(&B[ih][jh], oB, N, Tw);
-
-                if( DEBUG_ENABLED && DEBUG_LEVEL >= 3 ){
-                    printf("ih==0 ==> orderedB");
-                    print_lmatrixf32(oB, Tw, N * Tw);
-                }
-            }
-
-            // Tw deciso a runtime
-            ////vl = __riscv_vsetvl_e32m1(N - jh);
-            vl = __riscv_vsetvl_e32m2(N - jh);
-
-            // accumulatori: uno per ogni riga del tile
-            vfloat32m2_t vc0 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
-            vfloat32m2_t vc1 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
-            vfloat32m2_t vc2 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
-            vfloat32m2_t vc3 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
-            vfloat32m2_t vc4 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
-            vfloat32m2_t vc5 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
-            vfloat32m2_t vc6 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
-            vfloat32m2_t vc7 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
-
-            #if UNROLL == 2
-            #pragma GCC unroll 2
-            #elif UNROLL == 4
-            #pragma GCC unroll 4
-            #elif UNROLL == 8
-            #pragma GCC unroll 8
-            #elif UNROLL == 16
-            #pragma GCC unroll 16
-            #else
-            #pragma GCC unroll 1
-            #endif
-            for (int k = 0; k < N; ++k) {
-
-                // carica B[k][jh : jh+vl]
-                vfloat32m2_t vb =
-                    __riscv_vle32_v_f32m2(&oB[k * Tw], vl);
-
-                // outer product
-                vc0 = __riscv_vfmacc_vf_f32m2(
-                    vc0, A[ih + 0][k], vb, vl);
-
-                vc1 = __riscv_vfmacc_vf_f32m2(
-                    vc1, A[ih + 1][k], vb, vl);
-
-                vc2 = __riscv_vfmacc_vf_f32m2(
-                    vc2, A[ih + 2][k], vb, vl);
-
-                vc3 = __riscv_vfmacc_vf_f32m2(
-                    vc3, A[ih + 3][k], vb, vl);
-
-                vc4 = __riscv_vfmacc_vf_f32m2(
-                    vc4, A[ih + 4][k], vb, vl);
-
-                vc5 = __riscv_vfmacc_vf_f32m2(
-                    vc5, A[ih + 5][k], vb, vl);
-
-                vc6 = __riscv_vfmacc_vf_f32m2(
-                    vc6, A[ih + 6][k], vb, vl);
-
-                vc7 = __riscv_vfmacc_vf_f32m2(
-                    vc7, A[ih + 7][k], vb, vl);
-            }
-
-            // store
-            __riscv_vse32_v_f32m2(&C[ih + 0][jh], vc0, vl);
-            __riscv_vse32_v_f32m2(&C[ih + 1][jh], vc1, vl);
-            __riscv_vse32_v_f32m2(&C[ih + 2][jh], vc2, vl);
-            __riscv_vse32_v_f32m2(&C[ih + 3][jh], vc3, vl);
-            __riscv_vse32_v_f32m2(&C[ih + 4][jh], vc4, vl);
-            __riscv_vse32_v_f32m2(&C[ih + 5][jh], vc5, vl);
-            __riscv_vse32_v_f32m2(&C[ih + 6][jh], vc6, vl);
-            __riscv_vse32_v_f32m2(&C[ih + 7][jh], vc7, vl);
-
-            if( DEBUG_ENABLED && DEBUG_LEVEL >= 3 ){
-                ///printf("Computation block C(%d:%d) finished! \n", ih, jh);
-                printf("> C  iter!!\n");
-                print_lmatrixf32((float*) C, N, N * N);
-            }
-
-        }
-    }
-}
-
-void kernel_8_m4(float* mat1, float* mat2, float* res, int N) {
-
-    float (*A)[N] = (float (*)[N]) mat1;
-    float (*B)[N] = (float (*)[N]) mat2;
-    float (*C)[N] = (float (*)[N]) res;
-
-    const int Th = 8;
-    int Tw = __riscv_vsetvl_e32m4(N);
-
-    //printf("Tw:%d\n", Tw);
-    
-    // ordered B: size x 2
-    float* oB = malloc(sizeof(float) * N * Tw);
-
-    size_t vl;
-
-    for (int jh = 0; jh < N; jh += vl) {
-        for (int ih = 0; ih < N; ih += Th) {
-        
-            if (ih == 0 && jh % Tw == 0) {
-                reordering_rvv(&B[ih][jh], oB, N, Tw);
-
-                if( DEBUG_ENABLED && DEBUG_LEVEL >= 3 ){
-                    printf("ih==0 ==> orderedB");
-                    print_lmatrixf32(oB, Tw, N * Tw);
-                }
-            }
-
-            // Tw deciso a runtime
-            ////vl = __riscv_vsetvl_e32m1(N - jh);
-            vl = __riscv_vsetvl_e32m2(N - jh);
-
-            // accumulatori: uno per ogni riga del tile
-            vfloat32m4_t vc0 = __riscv_vfmv_v_f_f32m4(0.0f, vl);
-            vfloat32m4_t vc1 = __riscv_vfmv_v_f_f32m4(0.0f, vl);
-            vfloat32m4_t vc2 = __riscv_vfmv_v_f_f32m4(0.0f, vl);
-            vfloat32m4_t vc3 = __riscv_vfmv_v_f_f32m4(0.0f, vl);
-            vfloat32m4_t vc4 = __riscv_vfmv_v_f_f32m4(0.0f, vl);
-            vfloat32m4_t vc5 = __riscv_vfmv_v_f_f32m4(0.0f, vl);
-            vfloat32m4_t vc6 = __riscv_vfmv_v_f_f32m4(0.0f, vl);
-            vfloat32m4_t vc7 = __riscv_vfmv_v_f_f32m4(0.0f, vl);
-
-            #if UNROLL == 2
-            #pragma GCC unroll 2
-            #elif UNROLL == 4
-            #pragma GCC unroll 4
-            #elif UNROLL == 8
-            #pragma GCC unroll 8
-            #elif UNROLL == 16
-            #pragma GCC unroll 16
-            #else
-            #pragma GCC unroll 1
-            #endif
-            for (int k = 0; k < N; ++k) {
-
-                // carica B[k][jh : jh+vl]
-                vfloat32m4_t vb =
-                    __riscv_vle32_v_f32m4(&oB[k * Tw], vl);
-
-                // outer product
-                vc0 = __riscv_vfmacc_vf_f32m4(
-                    vc0, A[ih + 0][k], vb, vl);
-
-                vc1 = __riscv_vfmacc_vf_f32m4(
-                    vc1, A[ih + 1][k], vb, vl);
-
-                vc2 = __riscv_vfmacc_vf_f32m4(
-                    vc2, A[ih + 2][k], vb, vl);
-
-                vc3 = __riscv_vfmacc_vf_f32m4(
-                    vc3, A[ih + 3][k], vb, vl);
-
-                vc4 = __riscv_vfmacc_vf_f32m4(
-                    vc4, A[ih + 4][k], vb, vl);
-
-                vc5 = __riscv_vfmacc_vf_f32m4(
-                    vc5, A[ih + 5][k], vb, vl);
-
-                vc6 = __riscv_vfmacc_vf_f32m4(
-                    vc6, A[ih + 6][k], vb, vl);
-
-                vc7 = __riscv_vfmacc_vf_f32m4(
-                    vc7, A[ih + 7][k], vb, vl);
-            }
-
-            // store
-            __riscv_vse32_v_f32m4(&C[ih + 0][jh], vc0, vl);
-            __riscv_vse32_v_f32m4(&C[ih + 1][jh], vc1, vl);
-            __riscv_vse32_v_f32m4(&C[ih + 2][jh], vc2, vl);
-            __riscv_vse32_v_f32m4(&C[ih + 3][jh], vc3, vl);
-            __riscv_vse32_v_f32m4(&C[ih + 4][jh], vc4, vl);
-            __riscv_vse32_v_f32m4(&C[ih + 5][jh], vc5, vl);
-            __riscv_vse32_v_f32m4(&C[ih + 6][jh], vc6, vl);
-            __riscv_vse32_v_f32m4(&C[ih + 7][jh], vc7, vl);
-
-            if( DEBUG_ENABLED && DEBUG_LEVEL >= 3 ){
-                ///printf("Computation block C(%d:%d) finished! \n", ih, jh);
-                printf("> C  iter!!\n");
-                print_lmatrixf32((float*) C, N, N * N);
-            }
-
-        }
-    }
-}
-
-void kernel_8_m8(float* mat1, float* mat2, float* res, int N) {
-
-    float (*A)[N] = (float (*)[N]) mat1;
-    float (*B)[N] = (float (*)[N]) mat2;
-    float (*C)[N] = (float (*)[N]) res;
-
-    const int Th = 8;
-    int Tw = __riscv_vsetvl_e32m8(N);
-
-    //printf("Tw:%d\n", Tw);
-    
-    // ordered B: size x 2
-    float* oB = malloc(sizeof(float) * N * Tw);
-
-    size_t vl;
-
-    for (int jh = 0; jh < N; jh += vl) {
-        for (int ih = 0; ih < N; ih += Th) {
-        
-            if (ih == 0 && jh % Tw == 0) {
-                reordering_rvv(&B[ih][jh], oB, N, Tw);
-
-                if( DEBUG_ENABLED && DEBUG_LEVEL >= 3 ){
-                    printf("ih==0 ==> orderedB");
-                    print_lmatrixf32(oB, Tw, N * Tw);
-                }
-            }
-
-            // Tw deciso a runtime
-            ////vl = __riscv_vsetvl_e32m1(N - jh);
-            vl = __riscv_vsetvl_e32m8(N - jh);
-
-            // accumulatori: uno per ogni riga del tile
-            vfloat32m8_t vc0 = __riscv_vfmv_v_f_f32m8(0.0f, vl);
-            vfloat32m8_t vc1 = __riscv_vfmv_v_f_f32m8(0.0f, vl);
-            vfloat32m8_t vc2 = __riscv_vfmv_v_f_f32m8(0.0f, vl);
-            vfloat32m8_t vc3 = __riscv_vfmv_v_f_f32m8(0.0f, vl);
-            vfloat32m8_t vc4 = __riscv_vfmv_v_f_f32m8(0.0f, vl);
-            vfloat32m8_t vc5 = __riscv_vfmv_v_f_f32m8(0.0f, vl);
-            vfloat32m8_t vc6 = __riscv_vfmv_v_f_f32m8(0.0f, vl);
-            vfloat32m8_t vc7 = __riscv_vfmv_v_f_f32m8(0.0f, vl);
-
-            #if UNROLL == 2
-            #pragma GCC unroll 2
-            #elif UNROLL == 4
-            #pragma GCC unroll 4
-            #elif UNROLL == 8
-            #pragma GCC unroll 8
-            #elif UNROLL == 16
-            #pragma GCC unroll 16
-            #else
-            #pragma GCC unroll 1
-            #endif
-            for (int k = 0; k < N; ++k) {
-
-                // carica B[k][jh : jh+vl]
-                vfloat32m8_t vb =
-                    __riscv_vle32_v_f32m8(&oB[k * Tw], vl);
-
-                // outer product
-                vc0 = __riscv_vfmacc_vf_f32m8(
-                    vc0, A[ih + 0][k], vb, vl);
-
-                vc1 = __riscv_vfmacc_vf_f32m8(
-                    vc1, A[ih + 1][k], vb, vl);
-
-                vc2 = __riscv_vfmacc_vf_f32m8(
-                    vc2, A[ih + 2][k], vb, vl);
-
-                vc3 = __riscv_vfmacc_vf_f32m8(
-                    vc3, A[ih + 3][k], vb, vl);
-
-                vc4 = __riscv_vfmacc_vf_f32m8(
-                    vc4, A[ih + 4][k], vb, vl);
-
-                vc5 = __riscv_vfmacc_vf_f32m8(
-                    vc5, A[ih + 5][k], vb, vl);
-
-                vc6 = __riscv_vfmacc_vf_f32m8(
-                    vc6, A[ih + 6][k], vb, vl);
-
-                vc7 = __riscv_vfmacc_vf_f32m8(
-                    vc7, A[ih + 7][k], vb, vl);
-            }
-
-            // store
-            __riscv_vse32_v_f32m8(&C[ih + 0][jh], vc0, vl);
-            __riscv_vse32_v_f32m8(&C[ih + 1][jh], vc1, vl);
-            __riscv_vse32_v_f32m8(&C[ih + 2][jh], vc2, vl);
-            __riscv_vse32_v_f32m8(&C[ih + 3][jh], vc3, vl);
-            __riscv_vse32_v_f32m8(&C[ih + 4][jh], vc4, vl);
-            __riscv_vse32_v_f32m8(&C[ih + 5][jh], vc5, vl);
-            __riscv_vse32_v_f32m8(&C[ih + 6][jh], vc6, vl);
-            __riscv_vse32_v_f32m8(&C[ih + 7][jh], vc7, vl);
-
-            if( DEBUG_ENABLED && DEBUG_LEVEL >= 3 ){
-                ///printf("Computation block C(%d:%d) finished! \n", ih, jh);
-                printf("> C  iter!!\n");
-                print_lmatrixf32((float*) C, N, N * N);
-            }
-
-        }
-    }
-}
-
-void kernel_8_mf2(float* mat1, float* mat2, float* res, int N) {
-
-    float (*A)[N] = (float (*)[N]) mat1;
-    float (*B)[N] = (float (*)[N]) mat2;
-    float (*C)[N] = (float (*)[N]) res;
-
-    const int Th = 8;
-    int Tw = __riscv_vsetvl_e32mf2(N);
-
-    //printf("Tw:%d\n", Tw);
-    
-    // ordered B: size x 2
-    float* oB = malloc(sizeof(float) * N * Tw);
-
-    size_t vl;
-
-    for (int jh = 0; jh < N; jh += vl) {
-        for (int ih = 0; ih < N; ih += Th) {
-        
-            if (ih == 0 && jh % Tw == 0) {
-                reordering_rvv(&B[ih][jh], oB, N, Tw);
-
-                if( DEBUG_ENABLED && DEBUG_LEVEL >= 3 ){
-                    printf("ih==0 ==> orderedB");
-                    print_lmatrixf32(oB, Tw, N * Tw);
-                }
-            }
-
-            // Tw deciso a runtime
-            ////vl = __riscv_vsetvl_e32mf2(N - jh);
-            vl = __riscv_vsetvl_e32mf2(N - jh);
-
-            // accumulatori: uno per ogni riga del tile
-            vfloat32mf2_t vc0 = __riscv_vfmv_v_f_f32mf2(0.0f, vl);
-            vfloat32mf2_t vc1 = __riscv_vfmv_v_f_f32mf2(0.0f, vl);
-            vfloat32mf2_t vc2 = __riscv_vfmv_v_f_f32mf2(0.0f, vl);
-            vfloat32mf2_t vc3 = __riscv_vfmv_v_f_f32mf2(0.0f, vl);
-            vfloat32mf2_t vc4 = __riscv_vfmv_v_f_f32mf2(0.0f, vl);
-            vfloat32mf2_t vc5 = __riscv_vfmv_v_f_f32mf2(0.0f, vl);
-            vfloat32mf2_t vc6 = __riscv_vfmv_v_f_f32mf2(0.0f, vl);
-            vfloat32mf2_t vc7 = __riscv_vfmv_v_f_f32mf2(0.0f, vl);
-
-            #if UNROLL == 2
-            #pragma GCC unroll 2
-            #elif UNROLL == 4
-            #pragma GCC unroll 4
-            #elif UNROLL == 8
-            #pragma GCC unroll 8
-            #elif UNROLL == 16
-            #pragma GCC unroll 16
-            #else
-            #pragma GCC unroll 1
-            #endif
-            for (int k = 0; k < N; ++k) {
-
-                // carica B[k][jh : jh+vl]
-                vfloat32mf2_t vb =
-                    __riscv_vle32_v_f32mf2(&oB[k * Tw], vl);
-
-                // outer product
-                vc0 = __riscv_vfmacc_vf_f32mf2(
-                    vc0, A[ih + 0][k], vb, vl);
-
-                vc1 = __riscv_vfmacc_vf_f32mf2(
-                    vc1, A[ih + 1][k], vb, vl);
-
-                vc2 = __riscv_vfmacc_vf_f32mf2(
-                    vc2, A[ih + 2][k], vb, vl);
-
-                vc3 = __riscv_vfmacc_vf_f32mf2(
-                    vc3, A[ih + 3][k], vb, vl);
-
-                vc4 = __riscv_vfmacc_vf_f32mf2(
-                    vc4, A[ih + 4][k], vb, vl);
-
-                vc5 = __riscv_vfmacc_vf_f32mf2(
-                    vc5, A[ih + 5][k], vb, vl);
-
-                vc6 = __riscv_vfmacc_vf_f32mf2(
-                    vc6, A[ih + 6][k], vb, vl);
-
-                vc7 = __riscv_vfmacc_vf_f32mf2(
-                    vc7, A[ih + 7][k], vb, vl);
-            }
-
-            // store
-            __riscv_vse32_v_f32mf2(&C[ih + 0][jh], vc0, vl);
-            __riscv_vse32_v_f32mf2(&C[ih + 1][jh], vc1, vl);
-            __riscv_vse32_v_f32mf2(&C[ih + 2][jh], vc2, vl);
-            __riscv_vse32_v_f32mf2(&C[ih + 3][jh], vc3, vl);
-            __riscv_vse32_v_f32mf2(&C[ih + 4][jh], vc4, vl);
-            __riscv_vse32_v_f32mf2(&C[ih + 5][jh], vc5, vl);
-            __riscv_vse32_v_f32mf2(&C[ih + 6][jh], vc6, vl);
-            __riscv_vse32_v_f32mf2(&C[ih + 7][jh], vc7, vl);
-
-            if( DEBUG_ENABLED && DEBUG_LEVEL >= 3 ){
-                ///printf("Computation block C(%d:%d) finished! \n", ih, jh);
-                printf("> C  iter!!\n");
-                print_lmatrixf32((float*) C, N, N * N);
-            }
-
-        }
-    }
-}
-
-
-void kernel_16_m1(float* mat1, float* mat2, float* res, int N) {
-
-    float (*A)[N] = (float (*)[N]) mat1;
-    float (*B)[N] = (float (*)[N]) mat2;
-    float (*C)[N] = (float (*)[N]) res;
-
-    const int Th = 16;
-    int Tw = __riscv_vsetvl_e32m1(N);
-
-    //printf("Tw:%d\n", Tw);
-    
-    // ordered B: size x 2
-    float* oB = malloc(sizeof(float) * N * Tw);
-
-    size_t vl;
-
-    for (int jh = 0; jh < N; jh += vl) {
-        for (int ih = 0; ih < N; ih += Th) {
-        
-            if (ih == 0 && jh % Tw == 0) {
-                reordering_rvv(&B[ih][jh], oB, N, Tw);
-
-                if( DEBUG_ENABLED && DEBUG_LEVEL >= 3 ){
-                    printf("ih==0 ==> orderedB");
-                    print_lmatrixf32(oB, Tw, N * Tw);
-                }
-            }
-
-            // Tw deciso a runtime
-            ////vl = __riscv_vsetvl_e32m1(N - jh);
-            vl = __riscv_vsetvl_e32m1(N - jh);
-
-            // accumulatori: uno per ogni riga del tile
-            vfloat32m1_t vc0 = __riscv_vfmv_v_f_f32m1(0.0f, vl);
-            vfloat32m1_t vc1 = __riscv_vfmv_v_f_f32m1(0.0f, vl);
-            vfloat32m1_t vc2 = __riscv_vfmv_v_f_f32m1(0.0f, vl);
-            vfloat32m1_t vc3 = __riscv_vfmv_v_f_f32m1(0.0f, vl);
-            vfloat32m1_t vc4 = __riscv_vfmv_v_f_f32m1(0.0f, vl);
-            vfloat32m1_t vc5 = __riscv_vfmv_v_f_f32m1(0.0f, vl);
-            vfloat32m1_t vc6 = __riscv_vfmv_v_f_f32m1(0.0f, vl);
-            vfloat32m1_t vc7 = __riscv_vfmv_v_f_f32m1(0.0f, vl);
-            vfloat32m1_t vc8 = __riscv_vfmv_v_f_f32m1(0.0f, vl);
-            vfloat32m1_t vc9 = __riscv_vfmv_v_f_f32m1(0.0f, vl);
-            vfloat32m1_t vc10 = __riscv_vfmv_v_f_f32m1(0.0f, vl);
-            vfloat32m1_t vc11 = __riscv_vfmv_v_f_f32m1(0.0f, vl);
-            vfloat32m1_t vc12 = __riscv_vfmv_v_f_f32m1(0.0f, vl);
-            vfloat32m1_t vc13 = __riscv_vfmv_v_f_f32m1(0.0f, vl);
-            vfloat32m1_t vc14 = __riscv_vfmv_v_f_f32m1(0.0f, vl);
-            vfloat32m1_t vc15 = __riscv_vfmv_v_f_f32m1(0.0f, vl);
-
-            #if UNROLL == 2
-            #pragma GCC unroll 2
-            #elif UNROLL == 4
-            #pragma GCC unroll 4
-            #elif UNROLL == 8
-            #pragma GCC unroll 8
-            #elif UNROLL == 16
-            #pragma GCC unroll 16
-            #else
-            #pragma GCC unroll 1
-            #endif
-            for (int k = 0; k < N; ++k) {
-
-                // carica B[k][jh : jh+vl]
-                vfloat32m1_t vb =
-                    __riscv_vle32_v_f32m1(&oB[k * Tw], vl);
-
-                // outer product
-                vc0 = __riscv_vfmacc_vf_f32m1(
-                    vc0, A[ih + 0][k], vb, vl);
-
-                vc1 = __riscv_vfmacc_vf_f32m1(
-                    vc1, A[ih + 1][k], vb, vl);
-
-                vc2 = __riscv_vfmacc_vf_f32m1(
-                    vc2, A[ih + 2][k], vb, vl);
-
-                vc3 = __riscv_vfmacc_vf_f32m1(
-                    vc3, A[ih + 3][k], vb, vl);
-
-                vc4 = __riscv_vfmacc_vf_f32m1(
-                    vc4, A[ih + 4][k], vb, vl);
-
-                vc5 = __riscv_vfmacc_vf_f32m1(
-                    vc5, A[ih + 5][k], vb, vl);
-
-                vc6 = __riscv_vfmacc_vf_f32m1(
-                    vc6, A[ih + 6][k], vb, vl);
-
-                vc7 = __riscv_vfmacc_vf_f32m1(
-                    vc7, A[ih + 7][k], vb, vl);
-
-                vc8 = __riscv_vfmacc_vf_f32m1(
-                    vc8, A[ih + 8][k], vb, vl);
-
-                vc9 = __riscv_vfmacc_vf_f32m1(
-                    vc9, A[ih + 9][k], vb, vl);
-
-                vc10 = __riscv_vfmacc_vf_f32m1(
-                    vc10, A[ih + 10][k], vb, vl);
-
-                vc11 = __riscv_vfmacc_vf_f32m1(
-                    vc11, A[ih + 11][k], vb, vl);
-
-                vc12 = __riscv_vfmacc_vf_f32m1(
-                    vc12, A[ih + 12][k], vb, vl);
-
-                vc13 = __riscv_vfmacc_vf_f32m1(
-                    vc13, A[ih + 13][k], vb, vl);
-
-                vc14 = __riscv_vfmacc_vf_f32m1(
-                    vc14, A[ih + 14][k], vb, vl);
-
-                vc15 = __riscv_vfmacc_vf_f32m1(
-                    vc15, A[ih + 15][k], vb, vl);
-            }
-
-            // store
-            __riscv_vse32_v_f32m1(&C[ih + 0][jh], vc0, vl);
-            __riscv_vse32_v_f32m1(&C[ih + 1][jh], vc1, vl);
-            __riscv_vse32_v_f32m1(&C[ih + 2][jh], vc2, vl);
-            __riscv_vse32_v_f32m1(&C[ih + 3][jh], vc3, vl);
-            __riscv_vse32_v_f32m1(&C[ih + 4][jh], vc4, vl);
-            __riscv_vse32_v_f32m1(&C[ih + 5][jh], vc5, vl);
-            __riscv_vse32_v_f32m1(&C[ih + 6][jh], vc6, vl);
-            __riscv_vse32_v_f32m1(&C[ih + 7][jh], vc7, vl);
-            __riscv_vse32_v_f32m1(&C[ih + 8][jh], vc8, vl);
-            __riscv_vse32_v_f32m1(&C[ih + 9][jh], vc9, vl);
-            __riscv_vse32_v_f32m1(&C[ih + 10][jh], vc10, vl);
-            __riscv_vse32_v_f32m1(&C[ih + 11][jh], vc11, vl);
-            __riscv_vse32_v_f32m1(&C[ih + 12][jh], vc12, vl);
-            __riscv_vse32_v_f32m1(&C[ih + 13][jh], vc13, vl);
-            __riscv_vse32_v_f32m1(&C[ih + 14][jh], vc14, vl);
-            __riscv_vse32_v_f32m1(&C[ih + 15][jh], vc15, vl);
-
-            if( DEBUG_ENABLED && DEBUG_LEVEL >= 3 ){
-                ///printf("Computation block C(%d:%d) finished! \n", ih, jh);
-                printf("> C  iter!!\n");
-                print_lmatrixf32((float*) C, N, N * N);
-            }
-
-        }
-    }
-}
-
-void kernel_16_m2(float* mat1, float* mat2, float* res, int N) {
-
-    float (*A)[N] = (float (*)[N]) mat1;
-    float (*B)[N] = (float (*)[N]) mat2;
-    float (*C)[N] = (float (*)[N]) res;
-
-    const int Th = 16;
-    int Tw = __riscv_vsetvl_e32m2(N);
-
-    //printf("Tw:%d\n", Tw);
-    
-    // ordered B: size x 2
-    float* oB = malloc(sizeof(float) * N * Tw);
-
-    size_t vl;
-
-    for (int jh = 0; jh < N; jh += vl) {
-        for (int ih = 0; ih < N; ih += Th) {
-        
-            if (ih == 0 && jh % Tw == 0) {
-                reordering_rvv(&B[ih][jh], oB, N, Tw);
-
-                if( DEBUG_ENABLED && DEBUG_LEVEL >= 3 ){
-                    printf("ih==0 ==> orderedB");
-                    print_lmatrixf32(oB, Tw, N * Tw);
-                }
-            }
-
-            // Tw deciso a runtime
-            ////vl = __riscv_vsetvl_e32m2(N - jh);
-            vl = __riscv_vsetvl_e32m2(N - jh);
-
-            // accumulatori: uno per ogni riga del tile
-            vfloat32m2_t vc0 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
-            vfloat32m2_t vc1 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
-            vfloat32m2_t vc2 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
-            vfloat32m2_t vc3 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
-            vfloat32m2_t vc4 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
-            vfloat32m2_t vc5 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
-            vfloat32m2_t vc6 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
-            vfloat32m2_t vc7 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
-            vfloat32m2_t vc8 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
-            vfloat32m2_t vc9 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
-            vfloat32m2_t vc10 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
-            vfloat32m2_t vc11 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
-            vfloat32m2_t vc12 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
-            vfloat32m2_t vc13 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
-            vfloat32m2_t vc14 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
-            vfloat32m2_t vc15 = __riscv_vfmv_v_f_f32m2(0.0f, vl);
-
-            #if UNROLL == 2
-            #pragma GCC unroll 2
-            #elif UNROLL == 4
-            #pragma GCC unroll 4
-            #elif UNROLL == 8
-            #pragma GCC unroll 8
-            #elif UNROLL == 16
-            #pragma GCC unroll 16
-            #else
-            #pragma GCC unroll 1
-            #endif
-            for (int k = 0; k < N; ++k) {
-
-                // carica B[k][jh : jh+vl]
-                vfloat32m2_t vb =
-                    __riscv_vle32_v_f32m2(&oB[k * Tw], vl);
-
-                // outer product
-                vc0 = __riscv_vfmacc_vf_f32m2(
-                    vc0, A[ih + 0][k], vb, vl);
-
-                vc1 = __riscv_vfmacc_vf_f32m2(
-                    vc1, A[ih + 1][k], vb, vl);
-
-                vc2 = __riscv_vfmacc_vf_f32m2(
-                    vc2, A[ih + 2][k], vb, vl);
-
-                vc3 = __riscv_vfmacc_vf_f32m2(
-                    vc3, A[ih + 3][k], vb, vl);
-
-                vc4 = __riscv_vfmacc_vf_f32m2(
-                    vc4, A[ih + 4][k], vb, vl);
-
-                vc5 = __riscv_vfmacc_vf_f32m2(
-                    vc5, A[ih + 5][k], vb, vl);
-
-                vc6 = __riscv_vfmacc_vf_f32m2(
-                    vc6, A[ih + 6][k], vb, vl);
-
-                vc7 = __riscv_vfmacc_vf_f32m2(
-                    vc7, A[ih + 7][k], vb, vl);
-
-                vc8 = __riscv_vfmacc_vf_f32m2(
-                    vc8, A[ih + 8][k], vb, vl);
-
-                vc9 = __riscv_vfmacc_vf_f32m2(
-                    vc9, A[ih + 9][k], vb, vl);
-
-                vc10 = __riscv_vfmacc_vf_f32m2(
-                    vc10, A[ih + 10][k], vb, vl);
-
-                vc11 = __riscv_vfmacc_vf_f32m2(
-                    vc11, A[ih + 11][k], vb, vl);
-
-                vc12 = __riscv_vfmacc_vf_f32m2(
-                    vc12, A[ih + 12][k], vb, vl);
-
-                vc13 = __riscv_vfmacc_vf_f32m2(
-                    vc13, A[ih + 13][k], vb, vl);
-
-                vc14 = __riscv_vfmacc_vf_f32m2(
-                    vc14, A[ih + 14][k], vb, vl);
-
-                vc15 = __riscv_vfmacc_vf_f32m2(
-                    vc15, A[ih + 15][k], vb, vl);
-            }
-
-            // store
-            __riscv_vse32_v_f32m2(&C[ih + 0][jh], vc0, vl);
-            __riscv_vse32_v_f32m2(&C[ih + 1][jh], vc1, vl);
-            __riscv_vse32_v_f32m2(&C[ih + 2][jh], vc2, vl);
-            __riscv_vse32_v_f32m2(&C[ih + 3][jh], vc3, vl);
-            __riscv_vse32_v_f32m2(&C[ih + 4][jh], vc4, vl);
-            __riscv_vse32_v_f32m2(&C[ih + 5][jh], vc5, vl);
-            __riscv_vse32_v_f32m2(&C[ih + 6][jh], vc6, vl);
-            __riscv_vse32_v_f32m2(&C[ih + 7][jh], vc7, vl);
-            __riscv_vse32_v_f32m2(&C[ih + 8][jh], vc8, vl);
-            __riscv_vse32_v_f32m2(&C[ih + 9][jh], vc9, vl);
-            __riscv_vse32_v_f32m2(&C[ih + 10][jh], vc10, vl);
-            __riscv_vse32_v_f32m2(&C[ih + 11][jh], vc11, vl);
-            __riscv_vse32_v_f32m2(&C[ih + 12][jh], vc12, vl);
-            __riscv_vse32_v_f32m2(&C[ih + 13][jh], vc13, vl);
-            __riscv_vse32_v_f32m2(&C[ih + 14][jh], vc14, vl);
-            __riscv_vse32_v_f32m2(&C[ih + 15][jh], vc15, vl);
-
-            if( DEBUG_ENABLED && DEBUG_LEVEL >= 3 ){
-                ///printf("Computation block C(%d:%d) finished! \n", ih, jh);
-                printf("> C  iter!!\n");
-                print_lmatrixf32((float*) C, N, N * N);
-            }
-
-        }
-    }
-}
-
-void kernel_16_m4(float* mat1, float* mat2, float* res, int N) {
-
-    float (*A)[N] = (float (*)[N]) mat1;
-    float (*B)[N] = (float (*)[N]) mat2;
-    float (*C)[N] = (float (*)[N]) res;
-
-    const int Th = 16;
-    int Tw = __riscv_vsetvl_e32m4(N);
-
-    //printf("Tw:%d\n", Tw);
-    
-    // ordered B: size x 2
-    float* oB = malloc(sizeof(float) * N * Tw);
-
-    size_t vl;
-
-    for (int jh = 0; jh < N; jh += vl) {
-        for (int ih = 0; ih < N; ih += Th) {
-        
-            if (ih == 0 && jh % Tw == 0) {
-                reordering_rvv(&B[ih][jh], oB, N, Tw);
-
-                if( DEBUG_ENABLED && DEBUG_LEVEL >= 3 ){
-                    printf("ih==0 ==> orderedB");
-                    print_lmatrixf32(oB, Tw, N * Tw);
-                }
-            }
-
-            // Tw deciso a runtime
-            ////vl = __riscv_vsetvl_e32m4(N - jh);
-            vl = __riscv_vsetvl_e32m4(N - jh);
-
-            // accumulatori: uno per ogni riga del tile
-            vfloat32m4_t vc0 = __riscv_vfmv_v_f_f32m4(0.0f, vl);
-            vfloat32m4_t vc1 = __riscv_vfmv_v_f_f32m4(0.0f, vl);
-            vfloat32m4_t vc2 = __riscv_vfmv_v_f_f32m4(0.0f, vl);
-            vfloat32m4_t vc3 = __riscv_vfmv_v_f_f32m4(0.0f, vl);
-            vfloat32m4_t vc4 = __riscv_vfmv_v_f_f32m4(0.0f, vl);
-            vfloat32m4_t vc5 = __riscv_vfmv_v_f_f32m4(0.0f, vl);
-            vfloat32m4_t vc6 = __riscv_vfmv_v_f_f32m4(0.0f, vl);
-            vfloat32m4_t vc7 = __riscv_vfmv_v_f_f32m4(0.0f, vl);
-            vfloat32m4_t vc8 = __riscv_vfmv_v_f_f32m4(0.0f, vl);
-            vfloat32m4_t vc9 = __riscv_vfmv_v_f_f32m4(0.0f, vl);
-            vfloat32m4_t vc10 = __riscv_vfmv_v_f_f32m4(0.0f, vl);
-            vfloat32m4_t vc11 = __riscv_vfmv_v_f_f32m4(0.0f, vl);
-            vfloat32m4_t vc12 = __riscv_vfmv_v_f_f32m4(0.0f, vl);
-            vfloat32m4_t vc13 = __riscv_vfmv_v_f_f32m4(0.0f, vl);
-            vfloat32m4_t vc14 = __riscv_vfmv_v_f_f32m4(0.0f, vl);
-            vfloat32m4_t vc15 = __riscv_vfmv_v_f_f32m4(0.0f, vl);
-
-            #if UNROLL == 2
-            #pragma GCC unroll 2
-            #elif UNROLL == 4
-            #pragma GCC unroll 4
-            #elif UNROLL == 8
-            #pragma GCC unroll 8
-            #elif UNROLL == 16
-            #pragma GCC unroll 16
-            #else
-            #pragma GCC unroll 1
-            #endif
-            for (int k = 0; k < N; ++k) {
-
-                // carica B[k][jh : jh+vl]
-                vfloat32m4_t vb =
-                    __riscv_vle32_v_f32m4(&oB[k * Tw], vl);
-
-                // outer product
-                vc0 = __riscv_vfmacc_vf_f32m4(
-                    vc0, A[ih + 0][k], vb, vl);
-
-                vc1 = __riscv_vfmacc_vf_f32m4(
-                    vc1, A[ih + 1][k], vb, vl);
-
-                vc2 = __riscv_vfmacc_vf_f32m4(
-                    vc2, A[ih + 2][k], vb, vl);
-
-                vc3 = __riscv_vfmacc_vf_f32m4(
-                    vc3, A[ih + 3][k], vb, vl);
-
-                vc4 = __riscv_vfmacc_vf_f32m4(
-                    vc4, A[ih + 4][k], vb, vl);
-
-                vc5 = __riscv_vfmacc_vf_f32m4(
-                    vc5, A[ih + 5][k], vb, vl);
-
-                vc6 = __riscv_vfmacc_vf_f32m4(
-                    vc6, A[ih + 6][k], vb, vl);
-
-                vc7 = __riscv_vfmacc_vf_f32m4(
-                    vc7, A[ih + 7][k], vb, vl);
-
-                vc8 = __riscv_vfmacc_vf_f32m4(
-                    vc8, A[ih + 8][k], vb, vl);
-
-                vc9 = __riscv_vfmacc_vf_f32m4(
-                    vc9, A[ih + 9][k], vb, vl);
-
-                vc10 = __riscv_vfmacc_vf_f32m4(
-                    vc10, A[ih + 10][k], vb, vl);
-
-                vc11 = __riscv_vfmacc_vf_f32m4(
-                    vc11, A[ih + 11][k], vb, vl);
-
-                vc12 = __riscv_vfmacc_vf_f32m4(
-                    vc12, A[ih + 12][k], vb, vl);
-
-                vc13 = __riscv_vfmacc_vf_f32m4(
-                    vc13, A[ih + 13][k], vb, vl);
-
-                vc14 = __riscv_vfmacc_vf_f32m4(
-                    vc14, A[ih + 14][k], vb, vl);
-
-                vc15 = __riscv_vfmacc_vf_f32m4(
-                    vc15, A[ih + 15][k], vb, vl);
-            }
-
-            // store
-            __riscv_vse32_v_f32m4(&C[ih + 0][jh], vc0, vl);
-            __riscv_vse32_v_f32m4(&C[ih + 1][jh], vc1, vl);
-            __riscv_vse32_v_f32m4(&C[ih + 2][jh], vc2, vl);
-            __riscv_vse32_v_f32m4(&C[ih + 3][jh], vc3, vl);
-            __riscv_vse32_v_f32m4(&C[ih + 4][jh], vc4, vl);
-            __riscv_vse32_v_f32m4(&C[ih + 5][jh], vc5, vl);
-            __riscv_vse32_v_f32m4(&C[ih + 6][jh], vc6, vl);
-            __riscv_vse32_v_f32m4(&C[ih + 7][jh], vc7, vl);
-            __riscv_vse32_v_f32m4(&C[ih + 8][jh], vc8, vl);
-            __riscv_vse32_v_f32m4(&C[ih + 9][jh], vc9, vl);
-            __riscv_vse32_v_f32m4(&C[ih + 10][jh], vc10, vl);
-            __riscv_vse32_v_f32m4(&C[ih + 11][jh], vc11, vl);
-            __riscv_vse32_v_f32m4(&C[ih + 12][jh], vc12, vl);
-            __riscv_vse32_v_f32m4(&C[ih + 13][jh], vc13, vl);
-            __riscv_vse32_v_f32m4(&C[ih + 14][jh], vc14, vl);
-            __riscv_vse32_v_f32m4(&C[ih + 15][jh], vc15, vl);
-
-            if( DEBUG_ENABLED && DEBUG_LEVEL >= 3 ){
-                ///printf("Computation block C(%d:%d) finished! \n", ih, jh);
-                printf("> C  iter!!\n");
-                print_lmatrixf32((float*) C, N, N * N);
-            }
-
-        }
-    }
-}
-
-void kernel_16_m8(float* mat1, float* mat2, float* res, int N) {
-
-    float (*A)[N] = (float (*)[N]) mat1;
-    float (*B)[N] = (float (*)[N]) mat2;
-    float (*C)[N] = (float (*)[N]) res;
-
-    const int Th = 16;
-    int Tw = __riscv_vsetvl_e32m8(N);
-
-    //printf("Tw:%d\n", Tw);
-    
-    // ordered B: size x 2
-    float* oB = malloc(sizeof(float) * N * Tw);
-
-    size_t vl;
-
-    for (int jh = 0; jh < N; jh += vl) {
-        for (int ih = 0; ih < N; ih += Th) {
-        
-            if (ih == 0 && jh % Tw == 0) {
-                reordering_rvv(&B[ih][jh], oB, N, Tw);
-
-                if( DEBUG_ENABLED && DEBUG_LEVEL >= 3 ){
-                    printf("ih==0 ==> orderedB");
-                    print_lmatrixf32(oB, Tw, N * Tw);
-                }
-            }
-
-            // Tw deciso a runtime
-            ////vl = __riscv_vsetvl_e32m8(N - jh);
-            vl = __riscv_vsetvl_e32m8(N - jh);
-
-            // accumulatori: uno per ogni riga del tile
-            vfloat32m8_t vc0 = __riscv_vfmv_v_f_f32m8(0.0f, vl);
-            vfloat32m8_t vc1 = __riscv_vfmv_v_f_f32m8(0.0f, vl);
-            vfloat32m8_t vc2 = __riscv_vfmv_v_f_f32m8(0.0f, vl);
-            vfloat32m8_t vc3 = __riscv_vfmv_v_f_f32m8(0.0f, vl);
-            vfloat32m8_t vc4 = __riscv_vfmv_v_f_f32m8(0.0f, vl);
-            vfloat32m8_t vc5 = __riscv_vfmv_v_f_f32m8(0.0f, vl);
-            vfloat32m8_t vc6 = __riscv_vfmv_v_f_f32m8(0.0f, vl);
-            vfloat32m8_t vc7 = __riscv_vfmv_v_f_f32m8(0.0f, vl);
-            vfloat32m8_t vc8 = __riscv_vfmv_v_f_f32m8(0.0f, vl);
-            vfloat32m8_t vc9 = __riscv_vfmv_v_f_f32m8(0.0f, vl);
-            vfloat32m8_t vc10 = __riscv_vfmv_v_f_f32m8(0.0f, vl);
-            vfloat32m8_t vc11 = __riscv_vfmv_v_f_f32m8(0.0f, vl);
-            vfloat32m8_t vc12 = __riscv_vfmv_v_f_f32m8(0.0f, vl);
-            vfloat32m8_t vc13 = __riscv_vfmv_v_f_f32m8(0.0f, vl);
-            vfloat32m8_t vc14 = __riscv_vfmv_v_f_f32m8(0.0f, vl);
-            vfloat32m8_t vc15 = __riscv_vfmv_v_f_f32m8(0.0f, vl);
-
-            #if UNROLL == 2
-            #pragma GCC unroll 2
-            #elif UNROLL == 4
-            #pragma GCC unroll 4
-            #elif UNROLL == 8
-            #pragma GCC unroll 8
-            #elif UNROLL == 16
-            #pragma GCC unroll 16
-            #else
-            #pragma GCC unroll 1
-            #endif
-            for (int k = 0; k < N; ++k) {
-
-                // carica B[k][jh : jh+vl]
-                vfloat32m8_t vb =
-                    __riscv_vle32_v_f32m8(&oB[k * Tw], vl);
-
-                // outer product
-                vc0 = __riscv_vfmacc_vf_f32m8(
-                    vc0, A[ih + 0][k], vb, vl);
-
-                vc1 = __riscv_vfmacc_vf_f32m8(
-                    vc1, A[ih + 1][k], vb, vl);
-
-                vc2 = __riscv_vfmacc_vf_f32m8(
-                    vc2, A[ih + 2][k], vb, vl);
-
-                vc3 = __riscv_vfmacc_vf_f32m8(
-                    vc3, A[ih + 3][k], vb, vl);
-
-                vc4 = __riscv_vfmacc_vf_f32m8(
-                    vc4, A[ih + 4][k], vb, vl);
-
-                vc5 = __riscv_vfmacc_vf_f32m8(
-                    vc5, A[ih + 5][k], vb, vl);
-
-                vc6 = __riscv_vfmacc_vf_f32m8(
-                    vc6, A[ih + 6][k], vb, vl);
-
-                vc7 = __riscv_vfmacc_vf_f32m8(
-                    vc7, A[ih + 7][k], vb, vl);
-
-                vc8 = __riscv_vfmacc_vf_f32m8(
-                    vc8, A[ih + 8][k], vb, vl);
-
-                vc9 = __riscv_vfmacc_vf_f32m8(
-                    vc9, A[ih + 9][k], vb, vl);
-
-                vc10 = __riscv_vfmacc_vf_f32m8(
-                    vc10, A[ih + 10][k], vb, vl);
-
-                vc11 = __riscv_vfmacc_vf_f32m8(
-                    vc11, A[ih + 11][k], vb, vl);
-
-                vc12 = __riscv_vfmacc_vf_f32m8(
-                    vc12, A[ih + 12][k], vb, vl);
-
-                vc13 = __riscv_vfmacc_vf_f32m8(
-                    vc13, A[ih + 13][k], vb, vl);
-
-                vc14 = __riscv_vfmacc_vf_f32m8(
-                    vc14, A[ih + 14][k], vb, vl);
-
-                vc15 = __riscv_vfmacc_vf_f32m8(
-                    vc15, A[ih + 15][k], vb, vl);
-            }
-
-            // store
-            __riscv_vse32_v_f32m8(&C[ih + 0][jh], vc0, vl);
-            __riscv_vse32_v_f32m8(&C[ih + 1][jh], vc1, vl);
-            __riscv_vse32_v_f32m8(&C[ih + 2][jh], vc2, vl);
-            __riscv_vse32_v_f32m8(&C[ih + 3][jh], vc3, vl);
-            __riscv_vse32_v_f32m8(&C[ih + 4][jh], vc4, vl);
-            __riscv_vse32_v_f32m8(&C[ih + 5][jh], vc5, vl);
-            __riscv_vse32_v_f32m8(&C[ih + 6][jh], vc6, vl);
-            __riscv_vse32_v_f32m8(&C[ih + 7][jh], vc7, vl);
-            __riscv_vse32_v_f32m8(&C[ih + 8][jh], vc8, vl);
-            __riscv_vse32_v_f32m8(&C[ih + 9][jh], vc9, vl);
-            __riscv_vse32_v_f32m8(&C[ih + 10][jh], vc10, vl);
-            __riscv_vse32_v_f32m8(&C[ih + 11][jh], vc11, vl);
-            __riscv_vse32_v_f32m8(&C[ih + 12][jh], vc12, vl);
-            __riscv_vse32_v_f32m8(&C[ih + 13][jh], vc13, vl);
-            __riscv_vse32_v_f32m8(&C[ih + 14][jh], vc14, vl);
-            __riscv_vse32_v_f32m8(&C[ih + 15][jh], vc15, vl);
-
-            if( DEBUG_ENABLED && DEBUG_LEVEL >= 3 ){
-                ///printf("Computation block C(%d:%d) finished! \n", ih, jh);
-                printf("> C  iter!!\n");
-                print_lmatrixf32((float*) C, N, N * N);
-            }
-
-        }
-    }
-}
-
-void kernel_16_mf2(float* mat1, float* mat2, float* res, int N) {
-
-    float (*A)[N] = (float (*)[N]) mat1;
-    float (*B)[N] = (float (*)[N]) mat2;
-    float (*C)[N] = (float (*)[N]) res;
-
-    const int Th = 16;
-    int Tw = __riscv_vsetvl_e32mf2(N);
-
-    //printf("Tw:%d\n", Tw);
-    
-    // ordered B: size x 2
-    float* oB = malloc(sizeof(float) * N * Tw);
-
-    size_t vl;
-
-    for (int jh = 0; jh < N; jh += vl) {
-        for (int ih = 0; ih < N; ih += Th) {
-        
-            if (ih == 0 && jh % Tw == 0) {
-                reordering_rvv(&B[ih][jh], oB, N, Tw);
-
-                if( DEBUG_ENABLED && DEBUG_LEVEL >= 3 ){
-                    printf("ih==0 ==> orderedB");
-                    print_lmatrixf32(oB, Tw, N * Tw);
-                }
-            }
-
-            // Tw deciso a runtime
-            ////vl = __riscv_vsetvl_e32mf2(N - jh);
-            vl = __riscv_vsetvl_e32mf2(N - jh);
-
-            // accumulatori: uno per ogni riga del tile
-            vfloat32mf2_t vc0 = __riscv_vfmv_v_f_f32mf2(0.0f, vl);
-            vfloat32mf2_t vc1 = __riscv_vfmv_v_f_f32mf2(0.0f, vl);
-            vfloat32mf2_t vc2 = __riscv_vfmv_v_f_f32mf2(0.0f, vl);
-            vfloat32mf2_t vc3 = __riscv_vfmv_v_f_f32mf2(0.0f, vl);
-            vfloat32mf2_t vc4 = __riscv_vfmv_v_f_f32mf2(0.0f, vl);
-            vfloat32mf2_t vc5 = __riscv_vfmv_v_f_f32mf2(0.0f, vl);
-            vfloat32mf2_t vc6 = __riscv_vfmv_v_f_f32mf2(0.0f, vl);
-            vfloat32mf2_t vc7 = __riscv_vfmv_v_f_f32mf2(0.0f, vl);
-            vfloat32mf2_t vc8 = __riscv_vfmv_v_f_f32mf2(0.0f, vl);
-            vfloat32mf2_t vc9 = __riscv_vfmv_v_f_f32mf2(0.0f, vl);
-            vfloat32mf2_t vc10 = __riscv_vfmv_v_f_f32mf2(0.0f, vl);
-            vfloat32mf2_t vc11 = __riscv_vfmv_v_f_f32mf2(0.0f, vl);
-            vfloat32mf2_t vc12 = __riscv_vfmv_v_f_f32mf2(0.0f, vl);
-            vfloat32mf2_t vc13 = __riscv_vfmv_v_f_f32mf2(0.0f, vl);
-            vfloat32mf2_t vc14 = __riscv_vfmv_v_f_f32mf2(0.0f, vl);
-            vfloat32mf2_t vc15 = __riscv_vfmv_v_f_f32mf2(0.0f, vl);
-
-            #if UNROLL == 2
-            #pragma GCC unroll 2
-            #elif UNROLL == 4
-            #pragma GCC unroll 4
-            #elif UNROLL == 8
-            #pragma GCC unroll 8
-            #elif UNROLL == 16
-            #pragma GCC unroll 16
-            #else
-            #pragma GCC unroll 1
-            #endif
-            for (int k = 0; k < N; ++k) {
-
-                // carica B[k][jh : jh+vl]
-                vfloat32mf2_t vb =
-                    __riscv_vle32_v_f32mf2(&oB[k * Tw], vl);
-
-                // outer product
-                vc0 = __riscv_vfmacc_vf_f32mf2(
-                    vc0, A[ih + 0][k], vb, vl);
-
-                vc1 = __riscv_vfmacc_vf_f32mf2(
-                    vc1, A[ih + 1][k], vb, vl);
-
-                vc2 = __riscv_vfmacc_vf_f32mf2(
-                    vc2, A[ih + 2][k], vb, vl);
-
-                vc3 = __riscv_vfmacc_vf_f32mf2(
-                    vc3, A[ih + 3][k], vb, vl);
-
-                vc4 = __riscv_vfmacc_vf_f32mf2(
-                    vc4, A[ih + 4][k], vb, vl);
-
-                vc5 = __riscv_vfmacc_vf_f32mf2(
-                    vc5, A[ih + 5][k], vb, vl);
-
-                vc6 = __riscv_vfmacc_vf_f32mf2(
-                    vc6, A[ih + 6][k], vb, vl);
-
-                vc7 = __riscv_vfmacc_vf_f32mf2(
-                    vc7, A[ih + 7][k], vb, vl);
-
-                vc8 = __riscv_vfmacc_vf_f32mf2(
-                    vc8, A[ih + 8][k], vb, vl);
-
-                vc9 = __riscv_vfmacc_vf_f32mf2(
-                    vc9, A[ih + 9][k], vb, vl);
-
-                vc10 = __riscv_vfmacc_vf_f32mf2(
-                    vc10, A[ih + 10][k], vb, vl);
-
-                vc11 = __riscv_vfmacc_vf_f32mf2(
-                    vc11, A[ih + 11][k], vb, vl);
-
-                vc12 = __riscv_vfmacc_vf_f32mf2(
-                    vc12, A[ih + 12][k], vb, vl);
-
-                vc13 = __riscv_vfmacc_vf_f32mf2(
-                    vc13, A[ih + 13][k], vb, vl);
-
-                vc14 = __riscv_vfmacc_vf_f32mf2(
-                    vc14, A[ih + 14][k], vb, vl);
-
-                vc15 = __riscv_vfmacc_vf_f32mf2(
-                    vc15, A[ih + 15][k], vb, vl);
-            }
-
-            // store
-            __riscv_vse32_v_f32mf2(&C[ih + 0][jh], vc0, vl);
-            __riscv_vse32_v_f32mf2(&C[ih + 1][jh], vc1, vl);
-            __riscv_vse32_v_f32mf2(&C[ih + 2][jh], vc2, vl);
-            __riscv_vse32_v_f32mf2(&C[ih + 3][jh], vc3, vl);
-            __riscv_vse32_v_f32mf2(&C[ih + 4][jh], vc4, vl);
-            __riscv_vse32_v_f32mf2(&C[ih + 5][jh], vc5, vl);
-            __riscv_vse32_v_f32mf2(&C[ih + 6][jh], vc6, vl);
-            __riscv_vse32_v_f32mf2(&C[ih + 7][jh], vc7, vl);
-            __riscv_vse32_v_f32mf2(&C[ih + 8][jh], vc8, vl);
-            __riscv_vse32_v_f32mf2(&C[ih + 9][jh], vc9, vl);
-            __riscv_vse32_v_f32mf2(&C[ih + 10][jh], vc10, vl);
-            __riscv_vse32_v_f32mf2(&C[ih + 11][jh], vc11, vl);
-            __riscv_vse32_v_f32mf2(&C[ih + 12][jh], vc12, vl);
-            __riscv_vse32_v_f32mf2(&C[ih + 13][jh], vc13, vl);
-            __riscv_vse32_v_f32mf2(&C[ih + 14][jh], vc14, vl);
-            __riscv_vse32_v_f32mf2(&C[ih + 15][jh], vc15, vl);
-
-            if( DEBUG_ENABLED && DEBUG_LEVEL >= 3 ){
-                ///printf("Computation block C(%d:%d) finished! \n", ih, jh);
-                printf("> C  iter!!\n");
-                print_lmatrixf32((float*) C, N, N * N);
-            }
-
-        }
-    }
-}
-
-
-void multiply_gemm(float* A, float* B, float* C, int N, int th, int lmul) {
-
-    if( DEBUG_ENABLED && DEBUG_LEVEL >= 0 ){
-        printf("kernel> th=%d lmul=%d\n", th, lmul);
-    }
-    
-         if( th == 2 && lmul == 1 ) kernel_2_m1(A, B, C, N);
-    else if( th == 2 && lmul == 2 ) kernel_2_m2(A, B, C, N);
-    else if( th == 2 && lmul == 4 ) kernel_2_m4(A, B, C, N);
-    else if( th == 2 && lmul == 8 ) kernel_2_m8(A, B, C, N);
-    else if( th == 2 && lmul == -2 ) kernel_2_mf2(A, B, C, N);
-
-    else if( th == 4 && lmul == 1 ) kernel_4_m1(A, B, C, N);
-    else if( th == 4 && lmul == 2 ) kernel_4_m2(A, B, C, N);
-    else if( th == 4 && lmul == 4 ) kernel_4_m4(A, B, C, N);
-    else if( th == 4 && lmul == 8 ) kernel_4_m8(A, B, C, N);
-    else if( th == 4 && lmul == -2 ) kernel_4_mf2(A, B, C, N);
-
-    else if( th == 8 && lmul == 1 ) kernel_8_m1(A, B, C, N);
-    else if( th == 8 && lmul == 2 ) kernel_8_m2(A, B, C, N);
-    else if( th == 8 && lmul == 4 ) kernel_8_m4(A, B, C, N);
-    else if( th == 8 && lmul == 8 ) kernel_8_m8(A, B, C, N);
-    else if( th == 8 && lmul == -2 ) kernel_8_mf2(A, B, C, N);
-
-    else if( th == 16 && lmul == 1 ) kernel_16_m1(A, B, C, N);
-    else if( th == 16 && lmul == 2 ) kernel_16_m2(A, B, C, N);
-    else if( th == 16 && lmul == 4 ) kernel_16_m4(A, B, C, N);
-    else if( th == 16 && lmul == 8 ) kernel_16_m8(A, B, C, N);
-    else if( th == 16 && lmul == -2 ) kernel_16_mf2(A, B, C, N);
-}
+// DTYPE: multiply_gemm_bin, inputs mapped to +1 (odd) / -1 (even) and bit-packed, int32 C
+#define DTYPE_BIN 20
 
 int main(int argc, char* argv[]) {
 
@@ -2134,16 +113,48 @@ int main(int argc, char* argv[]) {
     DEBUG_LEVEL = 0;
     int DEBUG_PRINT_IO = 0;
     int lmul = DEFAULT_LMUL;
+    int dataflow = DEFAULT_DATAFLOW;
+    int pack_mode = DEFAULT_PACK;
+    int prepack = DEFAULT_PREPACK;
+    int repeat = DEFAULT_REPEAT;
+    const char* save_packed = NULL;
+    const char* load_packed = NULL;
+    int use_plan = DEFAULT_PLAN;
+    int threads = DEFAULT_THREADS;
+    int lmul_set = 0;
+    int batch = DEFAULT_BATCH;
+    int group = DEFAULT_GROUP;
+    int indexed = DEFAULT_INDEXED;
+    int dtype = DEFAULT_DTYPE;
+    int semiring = DEFAULT_SEMIRING;
+    int epilogue = DEFAULT_EPILOGUE;
+    int act = DEFAULT_ACT;
+    int mlp_hidden = DEFAULT_MLP;
+    int heads = DEFAULT_ATTENTION;
+    int causal = DEFAULT_CAUSAL;
+    int knn = DEFAULT_KNN;
+    int conv = DEFAULT_CONV;
+    int filter = DEFAULT_FILTER;
+    int stride = DEFAULT_STRIDE;
+    int pad = DEFAULT_PAD;
+    int dilation = DEFAULT_DILATION;
+    int groups = DEFAULT_GROUPS;
+    int M = -1, N = -1, K = -1;
 
     if(IS_HELP){
         printf("options:\n");
-        printf("> DEBUG_PRINT_IO\n> DEBUG_LEVEL\n> SIZE\n> KERNEL\n> INPUT_CASE\n> LMUL\n\n");
+        printf("> DEBUG_PRINT_IO\n> DEBUG_LEVEL\n> SIZE\n> M\n> N\n> K\n> KERNEL\n> INPUT_CASE\n> LMUL\n> DATAFLOW\n> PACK\n> PREPACK\n> REPEAT\n> SAVE_PACKED (file)\n> LOAD_PACKED (file)\n> PLAN\n> THREADS\n> BATCH\n> GROUP\n> INDEXED\n> DTYPE\n> SEMIRING\n> EPILOGUE (1 bias, 2 col scale, 4 row scale, 8 clamp, 16 residual)\n> ACT\n> MLP (hidden size)\n> ATTENTION (heads)\n> CAUSAL\n> KNN (k)\n> CONV (1 NCHW, 2 NHWC)\n> FILTER\n> STRIDE\n> PAD\n> DILATION\n> GROUPS\n\n");
         printf("default values:\n");
-        printf("> size: %d x %d \n> kernel_size:%d lmul:%d \n> input_case:%d (%s)\n", 
+        printf("> size: %d x %d (M, N, K default to size)\n> kernel_size:%d lmul:%d \n> input_case:%d (%s)\n> dataflow:%d (%s)\n> pack:%d (0 separate, 1 fused)\n> prepack:%d repeat:%d\n> plan:%d threads:%d batch:%d group:%d indexed:%d dtype:%d semiring:%d epilogue:%d act:%d mlp:%d attention:%d causal:%d knn:%d\n> conv:%d filter:%d stride:%d pad:%d dilation:%d groups:%d\n", 
             size, size, 
             kernel_size,
             lmul,
-            input_case, input_case_name(input_case)
+            input_case, input_case_name(input_case),
+            dataflow, dataflow_name(dataflow),
+            pack_mode,
+            prepack, repeat,
+            use_plan, threads, batch, group, indexed, dtype, semiring, epilogue, act, mlp_hidden, heads, causal, knn,
+            conv, filter, stride, pad, dilation, groups
         );
         exit(0);
     }
@@ -2176,73 +187,671 @@ int main(int argc, char* argv[]) {
     if( ARG("LMUL") ){
         printf("> passing LMUL");
         lmul = atoi( ARG("LMUL") );
+        lmul_set = 1;
         printf(" %d%s\n", lmul, lmul < 0 ? " (FRACTIONAL)\0" : "\0");
     }
-
-
-    printf("size: %d x %d  kernel_size:%d %s  lmul:%d  input_case:%d (%s)\n", 
+    if( ARG("DATAFLOW") ){
+        printf("> passing DATAFLOW");
+        dataflow = atoi( ARG("DATAFLOW") );
+        printf(" %d (%s)\n", dataflow, dataflow_name(dataflow));
+    }
+    if( ARG("PACK") ){
+        printf("> passing PACK");
+        pack_mode = atoi( ARG("PACK") );
+        printf(" %d (%s)\n", pack_mode, pack_mode_name(pack_mode));
+    }
+    if( ARG("PREPACK") ){
+        printf("> passing PREPACK");
+        prepack = atoi( ARG("PREPACK") );
+        printf(" %d\n", prepack);
+    }
+    if( ARG("REPEAT") ){
+        printf("> passing REPEAT");
+        repeat = atoi( ARG("REPEAT") );
+        printf(" %d\n", repeat);
+    }
+    if( ARG("SAVE_PACKED") ){
+        printf("> passing SAVE_PACKED");
+        save_packed = ARG("SAVE_PACKED");
+        prepack = 1;
+        printf(" %s\n", save_packed);
+    }
+    if( ARG("LOAD_PACKED") ){
+        printf("> passing LOAD_PACKED");
+        load_packed = ARG("LOAD_PACKED");
+        prepack = 1;
+        printf(" %s\n", load_packed);
+    }
+    if( ARG("PLAN") ){
+        printf("> passing PLAN");
+        use_plan = atoi( ARG("PLAN") );
+        printf(" %d\n", use_plan);
+    }
+    if( ARG("THREADS") ){
+        printf("> passing THREADS");
+        threads = atoi( ARG("THREADS") );
+        use_plan = 1;
+        printf(" %d\n", threads);
+    }
+    if( ARG("BATCH") ){
+        printf("> passing BATCH");
+        batch = atoi( ARG("BATCH") );
+        use_plan = 1;
+        printf(" %d\n", batch);
+    }
+    if( ARG("GROUP") ){
+        printf("> passing GROUP");
+        group = atoi( ARG("GROUP") );
+        printf(" %d\n", group);
+    }
+    if( ARG("INDEXED") ){
+        printf("> passing INDEXED");
+        indexed = atoi( ARG("INDEXED") );
+        printf(" %d\n", indexed);
+    }
+    if( ARG("DTYPE") ){
+        printf("> passing DTYPE");
+        dtype = atoi( ARG("DTYPE") );
+        printf(" %d\n", dtype);
+    }
+    if( ARG("SEMIRING") ){
+        printf("> passing SEMIRING");
+        semiring = atoi( ARG("SEMIRING") );
+        printf(" %d\n", semiring);
+    }
+    if( ARG("EPILOGUE") ){
+        printf("> passing EPILOGUE");
+        epilogue = atoi( ARG("EPILOGUE") );
+        printf(" %d\n", epilogue);
+    }
+    if( ARG("ACT") ){
+        printf("> passing ACT");
+        act = atoi( ARG("ACT") );
+        printf(" %d\n", act);
+    }
+    if( ARG("MLP") ){
+        printf("> passing MLP");
+        mlp_hidden = atoi( ARG("MLP") );
+        printf(" %d\n", mlp_hidden);
+    }
+    if( ARG("ATTENTION") ){
+        printf("> passing ATTENTION");
+        heads = atoi( ARG("ATTENTION") );
+        printf(" %d\n", heads);
+    }
+    if( ARG("CAUSAL") ){
+        printf("> passing CAUSAL");
+        causal = atoi( ARG("CAUSAL") );
+        printf(" %d\n", causal);
+    }
+    if( ARG("KNN") ){
+        printf("> passing KNN");
+        knn = atoi( ARG("KNN") );
+        printf(" %d\n", knn);
+    }
+    if( ARG("CONV") ){
+        printf("> passing CONV");
+        conv = atoi( ARG("CONV") );
+        printf(" %d\n", conv);
+    }
+    if( ARG("FILTER") ){
+        printf("> passing FILTER");
+        filter = atoi( ARG("FILTER") );
+        printf(" %d\n", filter);
+    }
+    if( ARG("STRIDE") ){
+        printf("> passing STRIDE");
+        stride = atoi( ARG("STRIDE") );
+        printf(" %d\n", stride);
+    }
+    if( ARG("PAD") ){
+        printf("> passing PAD");
+        pad = atoi( ARG("PAD") );
+        printf(" %d\n", pad);
+    }
+    if( ARG("DILATION") ){
+        printf("> passing DILATION");
+        dilation = atoi( ARG("DILATION") );
+        printf(" %d\n", dilation);
+    }
+    if( ARG("GROUPS") ){
+        printf("> passing GROUPS");
+        groups = atoi( ARG("GROUPS") );
+        printf(" %d\n", groups);
+    }
+    if( ARG("M") ){
+        printf("> passing M");
+        M = atoi( ARG("M") );
+        printf(" %d\n", M);
+    }
+    if( ARG("N") ){
+        printf("> passing N");
+        N = atoi( ARG("N") );
+        printf(" %d\n", N);
+    }
+    if( ARG("K") ){
+        printf("> passing K");
+        K = atoi( ARG("K") );
+        printf(" %d\n", K);
+    }
+
+    // rectangular shapes: missing dimensions default to size
+    if( M < 0 ) M = size;
+    if( N < 0 ) N = size;
+    if( K < 0 ) K = size;
+
+
+    printf("size: %d x %d  M:%d N:%d K:%d  kernel_size:%d %s  lmul:%d  dataflow:%s  input_case:%d (%s)\n", 
             size, size, 
+            M, N, K,
             kernel_size, kernel_size==0 ? "AUTO\0" : "",
             lmul,
+            dataflow_name(dataflow),
             input_case, input_case_name(input_case)
     );
     ///printf("Num proc: %d\n", omp_get_max_threads());
 
-    // check tile_size is correct ( tile_size <= size )
-    if( kernel_size > size ){
-        printf("ERROR: kernel_size:%d must be less than or equal to size:%d\n", kernel_size, size);
+    // check tile_size is correct ( tile_size <= M )
+    if( kernel_size > M ){
+        printf("ERROR: kernel_size:%d must be less than or equal to M:%d\n", kernel_size, M);
+        exit(EXIT_FAILURE);
+    }
+    if( batch < 1 || group < 1 ){
+        printf("ERROR: batch:%d and group:%d must be at least 1\n", batch, group);
+        exit(EXIT_FAILURE);
+    }
+    if( repeat < 1 ){
+        printf("ERROR: repeat:%d must be at least 1\n", repeat);
+        exit(EXIT_FAILURE);
+    }
+    if( semiring != SEMIRING_PLUS_TIMES && (dtype != GEMM_F32 || group > 1 || indexed) ){
+        printf("ERROR: semiring:%d needs dtype:%d, no group, no indexed\n", semiring, GEMM_F32);
+        exit(EXIT_FAILURE);
+    }
+    if( pad < 0 ) pad = filter / 2 * dilation;
+    if( conv < 0 || conv > 2 || (conv && (knn || heads || mlp_hidden || epilogue || act || dtype != GEMM_F32 || semiring != SEMIRING_PLUS_TIMES || group > 1 || indexed || prepack || load_packed)) ){
+        printf("ERROR: conv:%d needs dtype:%d, no knn, attention, mlp, epilogue, semiring, group, indexed, prepack\n", conv, GEMM_F32);
+        exit(EXIT_FAILURE);
+    }
+    if( knn < 0 || (knn && (heads || mlp_hidden || epilogue || act || dtype != GEMM_F32 || semiring != SEMIRING_PLUS_TIMES || group > 1 || indexed || batch > 1 || prepack || load_packed)) ){
+        printf("ERROR: knn:%d needs dtype:%d, no attention, mlp, epilogue, semiring, group, indexed, batch, prepack\n", knn, GEMM_F32);
+        exit(EXIT_FAILURE);
+    }
+    if( heads && (mlp_hidden || epilogue || act || dtype != GEMM_F32 || semiring != SEMIRING_PLUS_TIMES || group > 1 || indexed || batch > 1 || prepack || load_packed) ){
+        printf("ERROR: attention:%d needs dtype:%d, no mlp, epilogue, semiring, group, indexed, batch, prepack\n", heads, GEMM_F32);
+        exit(EXIT_FAILURE);
+    }
+    if( mlp_hidden && (epilogue || dtype != GEMM_F32 || semiring != SEMIRING_PLUS_TIMES || group > 1 || indexed || batch > 1 || prepack || load_packed) ){
+        printf("ERROR: mlp:%d needs dtype:%d, no epilogue, semiring, group, indexed, batch, prepack\n", mlp_hidden, GEMM_F32);
+        exit(EXIT_FAILURE);
+    }
+    if( !mlp_hidden && (epilogue || act) && (dtype != GEMM_F32 || semiring != SEMIRING_PLUS_TIMES || group > 1 || indexed) ){
+        printf("ERROR: epilogue:%d act:%d need dtype:%d, no semiring, no group, no indexed\n", epilogue, act, GEMM_F32);
         exit(EXIT_FAILURE);
     }
     
-    // Allocate memory for matrices
-    float *A = (float*)malloc(size * size * sizeof(float));
-    float *B = (float*)malloc(size * size * sizeof(float));
-    float *C = (float*)malloc(size * size * sizeof(float));
+    // Allocate memory for matrices (batch / group problems, one after the other)
+    int count = group > 1 ? group : batch;
+    float *A = (float*)malloc((size_t)count * M * K * sizeof(float));
+    float *B = (float*)malloc((size_t)count * K * N * sizeof(float));
+    float *C = (float*)malloc((size_t)count * M * N * sizeof(float));
 
     // Init matrix values pseudorandom
 
     // set initial seed for rand if required
     srand( RANDOM ? time(NULL) : 1  );
     
-    init_matrix_input(input_case, A, B, size, size, size);
+    for (int b = 0; b < count; b++)
+        init_matrix_input(input_case, A + (size_t)b * M * K, B + (size_t)b * K * N, M, N, K);
+
+    // grouped: same K/N, growing M (the last problem is M x N x K)
+    gemm_group_entry_t* entries = NULL;
+    if( group > 1 ){
+        entries = malloc(sizeof(gemm_group_entry_t) * group);
+        for (int g = 0; g < group; g++) {
+            gemm_group_entry_t e = { M * (g + 1) / group, N, K,
+                A + (size_t)g * M * K, B + (size_t)g * K * N, C + (size_t)g * M * N, 0, 0, 0 };
+            entries[g] = e;
+        }
+    }
+
+    // epilogue operands: small exact values, the residual shared by a batch
+    gemm_epilogue_t ep = { NULL, NULL, NULL, act, (epilogue & EPILOGUE_CLAMP) != 0, -100.0f, 100.0f, NULL, 0 };
+    float *ep_bias = NULL, *ep_col_scale = NULL, *ep_row_scale = NULL, *ep_residual = NULL;
+    if( epilogue & EPILOGUE_BIAS ){
+        ep_bias = malloc(sizeof(float) * N);
+        for (int j = 0; j < N; j++) ep_bias[j] = (float)(j % 5 - 2);
+        ep.bias = ep_bias;
+    }
+    if( epilogue & EPILOGUE_COL_SCALE ){
+        ep_col_scale = malloc(sizeof(float) * N);
+        for (int j = 0; j < N; j++) ep_col_scale[j] = 0.5f + 0.25f * (j % 4);
+        ep.col_scale = ep_col_scale;
+    }
+    if( epilogue & EPILOGUE_ROW_SCALE ){
+        ep_row_scale = malloc(sizeof(float) * M);
+        for (int i = 0; i < M; i++) ep_row_scale[i] = 1.0f / (1 + i % 2);
+        ep.row_scale = ep_row_scale;
+    }
+    if( epilogue & EPILOGUE_RESIDUAL ){
+        ep_residual = malloc(sizeof(float) * M * N);
+        for (size_t i = 0; i < (size_t)M * N; i++) ep_residual[i] = (float)(i % 3) - 1.0f;
+        ep.residual = ep_residual;
+    }
+    const int use_epilogue = (epilogue || act) && !mlp_hidden;
+
+    // MLP weights: small exact values, hidden stored only by the unfused path
+    float *W1 = NULL, *W2 = NULL, *hidden = NULL;
+    gemm_mlp_t* mlp = NULL;
+    const gemm_epilogue_t mlp_act = { NULL, NULL, NULL, act, 0, 0.0f, 0.0f, NULL, 0 };
+    if( mlp_hidden ){
+        W1 = malloc(sizeof(float) * K * mlp_hidden);
+        W2 = malloc(sizeof(float) * mlp_hidden * N);
+        for (size_t i = 0; i < (size_t)K * mlp_hidden; i++) W1[i] = (float)(rand() % 9 - 4) / 8.0f;
+        for (size_t i = 0; i < (size_t)mlp_hidden * N; i++) W2[i] = (float)(rand() % 9 - 4) / 8.0f;
+        if( !use_plan ) hidden = malloc(sizeof(float) * M * mlp_hidden);
+    }
+
+    // attention heads: small values (softmax of moderate scores); the unfused path
+    // gets K^T (the B of multiply_gemm) outside the timed region and stores the scores
+    float *Qa = NULL, *Ka = NULL, *Va = NULL, *Oa = NULL, *Kta = NULL, *scores = NULL;
+    float att_scale = 0.0f;
+    if( heads ){
+        // 1 / sqrt(K), no libm
+        att_scale = 1.0f / __riscv_vfmv_f_s_f32m1_f32(__riscv_vfsqrt_v_f32m1(__riscv_vfmv_v_f_f32m1((float)K, 1), 1));
+        Qa = malloc(sizeof(float) * heads * M * K);
+        Ka = malloc(sizeof(float) * heads * N * K);
+        Va = malloc(sizeof(float) * heads * N * K);
+        Oa = malloc(sizeof(float) * heads * M * K);
+        for (size_t i = 0; i < (size_t)heads * M * K; i++) Qa[i] = (float)(rand() % 9 - 4) / 4.0f;
+        for (size_t i = 0; i < (size_t)heads * N * K; i++) Ka[i] = (float)(rand() % 9 - 4) / 4.0f;
+        for (size_t i = 0; i < (size_t)heads * N * K; i++) Va[i] = (float)(rand() % 9 - 4) / 4.0f;
+        if( !use_plan ){
+            Kta = malloc(sizeof(float) * heads * K * N);
+            scores = malloc(sizeof(float) * M * N);
+            for (int h = 0; h < heads; h++)
+                for (int j = 0; j < N; j++)
+                    for (int k = 0; k < K; k++) Kta[((size_t)h * K + k) * N + j] = Ka[((size_t)h * N + j) * K + k];
+        }
+    }
+
+    // nearest neighbours: A the queries, B (K x N) the corpus transposed, the corpus
+    // by rows for knn_search made outside the timed region; C holds the dot products
+    // of the unfused path
+    float *Ykn = NULL, *kdist = NULL, *xnorm = NULL, *ynorm = NULL;
+    int* kidx = NULL;
+    if( knn ){
+        Ykn = malloc(sizeof(float) * N * K);
+        kdist = malloc(sizeof(float) * M * knn);
+        kidx = malloc(sizeof(int) * M * knn);
+        for (int j = 0; j < N; j++)
+            for (int k = 0; k < K; k++) Ykn[(size_t)j * K + k] = B[(size_t)k * N + j];
+        if( !use_plan ){
+            xnorm = malloc(sizeof(float) * M);
+            ynorm = malloc(sizeof(float) * N);
+        }
+    }
+
+    // convolution: BATCH images, small exact values
+    gemm_conv_t cv = { batch, K, M, M, N, filter, filter, stride, stride, pad, pad, dilation, dilation, groups, conv - 1 };
+    float *Xc = NULL, *Wc = NULL, *Yc = NULL;
+    size_t conv_out = 0;
+    if( conv ){
+        if( filter < 1 || stride < 1 || dilation < 1 || groups < 1 || K % groups || N % groups
+            || gemm_conv_out_h(&cv) < 1 || gemm_conv_out_w(&cv) < 1 ){
+            printf("ERROR: conv: no output for M:%d K:%d N:%d filter:%d stride:%d pad:%d dilation:%d groups:%d\n",
+                   M, K, N, filter, stride, pad, dilation, groups);
+            exit(EXIT_FAILURE);
+        }
+        conv_out = (size_t)batch * N * gemm_conv_out_h(&cv) * gemm_conv_out_w(&cv);
+        Xc = malloc(sizeof(float) * batch * K * M * M);
+        Wc = malloc(sizeof(float) * N * (K / groups) * filter * filter);
+        Yc = malloc(sizeof(float) * conv_out);
+        for (size_t i = 0; i < (size_t)batch * K * M * M; i++) Xc[i] = (float)(rand() % 9 - 4) / 4.0f;
+        for (size_t i = 0; i < (size_t)N * (K / groups) * filter * filter; i++) Wc[i] = (float)(rand() % 9 - 4) / 4.0f;
+    }
+
+    // indexed: C[M-1-i] = A[M-1-i] * B, the same product as the plain GEMM
+    int* rows = NULL;
+    if( indexed ){
+        rows = malloc(sizeof(int) * M);
+        for (int i = 0; i < M; i++) rows[i] = M - 1 - i;
+    }
+
+    // half precision: A and B rounded to fp16 once, outside the timed region
+    // (the float copies are rounded too, so the printed inputs are the real ones)
+    _Float16 *Ah = NULL, *Bh = NULL, *Ch = NULL;
+    if( dtype == GEMM_F16 || dtype == GEMM_F16_F16 ){
+        Ah = malloc((size_t)count * M * K * sizeof(_Float16));
+        Bh = malloc((size_t)count * K * N * sizeof(_Float16));
+        for (size_t i = 0; i < (size_t)count * M * K; i++) { Ah[i] = (_Float16)A[i]; A[i] = (float)Ah[i]; }
+        for (size_t i = 0; i < (size_t)count * K * N; i++) { Bh[i] = (_Float16)B[i]; B[i] = (float)Bh[i]; }
+        if( dtype == GEMM_F16_F16 ) Ch = malloc((size_t)count * M * N * sizeof(_Float16));
+    }
+    __bf16 *Ab = NULL, *Bb = NULL;
+    if( dtype == GEMM_BF16 ){
+        Ab = malloc((size_t)count * M * K * sizeof(__bf16));
+        Bb = malloc((size_t)count * K * N * sizeof(__bf16));
+        for (size_t i = 0; i < (size_t)count * M * K; i++) { Ab[i] = f32_to_bf16(A[i]); A[i] = bf16_to_f32(Ab[i]); }
+        for (size_t i = 0; i < (size_t)count * K * N; i++) { Bb[i] = f32_to_bf16(B[i]); B[i] = bf16_to_f32(Bb[i]); }
+    }
+    // double precision: own inputs (same values), the float copies only for printing
+    double *Ad = NULL, *Bd = NULL, *Cd = NULL;
+    if( dtype == GEMM_F64 ){
+        Ad = malloc((size_t)count * M * K * sizeof(double));
+        Bd = malloc((size_t)count * K * N * sizeof(double));
+        Cd = malloc((size_t)count * M * N * sizeof(double));
+        for (int b = 0; b < count; b++)
+            init_matrix_input_f64(input_case, Ad + (size_t)b * M * K, Bd + (size_t)b * K * N, M, N, K);
+        for (size_t i = 0; i < (size_t)count * M * K; i++) A[i] = (float)Ad[i];
+        for (size_t i = 0; i < (size_t)count * K * N; i++) B[i] = (float)Bd[i];
+    }
+    uint8_t* Aq = NULL;
+    int8_t* Bq = NULL;
+    void* wq = NULL;
+    if( dtype == DTYPE_I8 ){
+        Aq = malloc((size_t)count * M * K);
+        Bq = malloc((size_t)count * K * N);
+        wq = malloc(gemm_i8_ws_size(N, K));
+        for (size_t i = 0; i < (size_t)count * M * K; i++) { Aq[i] = (uint8_t)A[i]; A[i] = Aq[i]; }
+        for (size_t i = 0; i < (size_t)count * K * N; i++) { Bq[i] = (int8_t)B[i]; B[i] = Bq[i]; }
+    }
+    uint8_t* Bq4 = NULL;
+    float* Sq4 = NULL;
+    if( dtype == DTYPE_Q4 ){
+        Bq4 = malloc((size_t)K * ((N + 1) / 2));
+        Sq4 = malloc(sizeof(float) * ((K + Q4_GROUP - 1) / Q4_GROUP) * N);
+        quantize_q4(B, Bq4, Sq4, K, N, Q4_GROUP);
+        dequantize_q4(Bq4, Sq4, B, K, N, Q4_GROUP);
+    }
+    float *Ac = NULL, *Bc = NULL, *Cc = NULL;
+    if( dtype == DTYPE_C32 ){
+        Ac = calloc((size_t)2 * M * K, sizeof(float));
+        Bc = calloc((size_t)2 * K * N, sizeof(float));
+        Cc = malloc(sizeof(float) * 2 * M * N);
+        for (size_t i = 0; i < (size_t)M * K; i++) Ac[2 * i] = A[i];
+        for (size_t i = 0; i < (size_t)K * N; i++) Bc[2 * i] = B[i];
+    }
+    int16_t *As = NULL, *Bs = NULL, *Cs = NULL;
+    if( dtype == DTYPE_Q15 ){
+        As = malloc(sizeof(int16_t) * M * K);
+        Bs = malloc(sizeof(int16_t) * K * N);
+        Cs = malloc(sizeof(int16_t) * M * N);
+        for (size_t i = 0; i < (size_t)M * K; i++) As[i] = (int16_t)A[i];
+        for (size_t i = 0; i < (size_t)K * N; i++) Bs[i] = (int16_t)B[i];
+    }
+    uint32_t *Abin = NULL, *Bbin = NULL;
+    int32_t* Cbin = NULL;
+    if( dtype == DTYPE_BIN ){
+        for (size_t i = 0; i < (size_t)M * K; i++) A[i] = (int)A[i] % 2 ? 1.0f : -1.0f;
+        for (size_t i = 0; i < (size_t)K * N; i++) B[i] = (int)B[i] % 2 ? 1.0f : -1.0f;
+        Abin = malloc(sizeof(uint32_t) * M * ((K + 31) / 32));
+        Bbin = malloc(sizeof(uint32_t) * N * ((K + 31) / 32));
+        Cbin = malloc(sizeof(int32_t) * M * N);
+        binarize_rows(A, Abin, M, K, K);
+        binarize_cols(B, Bbin, K, N, N);
+    }
+    gemm_quant_t quant = { 1, 0, 1.0f, NULL, QUANT_OUT_F32, 1.0f, 0 };
+
+    const void* pA = Ah ? (const void*)Ah : Ab ? (const void*)Ab : Ad ? (const void*)Ad : (const void*)A;
+    const void* pB = Bh ? (const void*)Bh : Bb ? (const void*)Bb : Bd ? (const void*)Bd : (const void*)B;
+    void* pC = Ch ? (void*)Ch : Cd ? (void*)Cd : (void*)C;
+
+    // printed problem: the last one of the batch / group
+    size_t last = count - 1;
 
     if(DEBUG_PRINT_IO){
         printf("A");
-        print_matrixf32(A, size, size, 0);
+        print_lmatrixf32(A + last * M * K, K, M * K);
         printf("B");
-        print_matrixf32(B, size, size, 0);
+        print_lmatrixf32(B + last * K * N, N, K * N);
+    }
+
+    // pack the weights once: every call below skips reordering_rvv
+    packed_b_t* packed = NULL;
+    if( load_packed ){
+        clock_t load_start = clock();
+        packed = packed_b_load(load_packed);
+        clock_t load_end = clock();
+        if( packed == NULL ){
+            printf("ERROR: cannot load packed B from %s\n", load_packed);
+            exit(EXIT_FAILURE);
+        }
+        if( packed_b_k(packed) != K || packed_b_n(packed) != N ){
+            printf("ERROR: packed B in %s is %d x %d, expected K:%d N:%d\n", load_packed,
+                packed_b_k(packed), packed_b_n(packed), K, N);
+            exit(EXIT_FAILURE);
+        }
+        printf("> loaded packed B: lmul:%d tw:%d panels:%d %s (%f seconds)\n",
+            packed_b_lmul(packed), packed_b_tw(packed), packed_b_panels(packed),
+            packed_b_is_mapped(packed) ? "mapped\0" : "repacked\0",
+            ((double)(load_end - load_start)) / CLOCKS_PER_SEC);
+    }
+    else if( prepack ){
+        packed = pack_b(B, K, N, lmul);
+        if( packed == NULL ){
+            printf("ERROR: cannot pack B (K:%d N:%d) for lmul:%d\n", K, N, lmul);
+            exit(EXIT_FAILURE);
+        }
+        printf("> packed B: tw:%d panels:%d\n", packed_b_tw(packed), packed_b_panels(packed));
+    }
+    if( save_packed ){
+        if( packed_b_save(packed, save_packed) != 0 ){
+            printf("ERROR: cannot write packed B to %s\n", save_packed);
+            exit(EXIT_FAILURE);
+        }
+        printf("> saved packed B: %s\n", save_packed);
+    }
+
+    // plan once: kernel selection (LMUL from the tuning table unless passed), workspace in ctx
+    gemm_ctx_t* ctx = NULL;
+    gemm_plan_t* plan = NULL;
+    if( use_plan || group > 1 ){
+        ctx = gemm_ctx_create(DEBUG_LEVEL);
+        if( ctx == NULL ){
+            printf("ERROR: cannot create the gemm context\n");
+            exit(EXIT_FAILURE);
+        }
+        printf("> ctx: vlen:%d ncpu:%d l1d:%ld\n", gemm_ctx_vlen(ctx), gemm_ctx_ncpu(ctx), gemm_ctx_l1d_size(ctx));
+    }
+    // no plan for attention / knn / conv: multiply_attention / knn_search / implicit conv (PLAN=1) or the unfused GEMMs
+    if( !heads && !knn && !conv && use_plan && mlp_hidden ){
+        mlp = gemm_mlp_create(ctx, K, mlp_hidden, N, W1, NULL, W2, NULL, act, threads);
+        if( mlp == NULL ){
+            printf("ERROR: no mlp for M:%d K:%d H:%d N:%d\n", M, K, mlp_hidden, N);
+            exit(EXIT_FAILURE);
+        }
+        printf("> mlp: rows per block:%d hidden tile:%ld bytes\n", gemm_mlp_rows(mlp), (long)sizeof(float) * gemm_mlp_rows(mlp) * mlp_hidden);
+    }
+    else if( !heads && !knn && !conv && use_plan && group == 1 ){
+
+        gemm_shape_t shape = { M, N, K };
+        gemm_strides_t strides = { 0, 0, 0 };
+        gemm_hints_t hints = { dataflow, kernel_size, lmul_set ? lmul : 0, pack_mode, NULL, packed, semiring, use_epilogue ? &ep : NULL };
+
+        plan = gemm_plan(ctx, shape, strides, dtype, threads, &hints);
+        if( plan == NULL ){
+            printf("ERROR: no plan for M:%d N:%d K:%d\n", M, N, K);
+            exit(EXIT_FAILURE);
+        }
+        gemm_plan_print(plan);
     }
 
     // Start timer
-    //double start_time = omp_get_wtime();
+    #ifdef _OPENMP
+    double start_time = omp_get_wtime();
+    #else
     clock_t start_time = clock();
+    #endif
+
+    gemm_hints_t group_hints = { dataflow, kernel_size, lmul_set ? lmul : 0, pack_mode, NULL, NULL, semiring, NULL };
 
     // Perform matrix multiplication (GEMM)
-    multiply_gemm(A, B, C, size, kernel_size, lmul);
+    for (int r = 0; r < repeat; r++) {
+        if( heads && use_plan ){
+            if( multiply_attention(Qa, Ka, Va, Oa, heads, M, N, K, K, att_scale, causal, threads) != 0 ){
+                printf("ERROR: attention failed for heads:%d M:%d N:%d K:%d\n", heads, M, N, K);
+                exit(EXIT_FAILURE);
+            }
+        }
+        else if( heads ){
+            for (int h = 0; h < heads; h++) {
+                multiply_gemm(Qa + (size_t)h * M * K, Kta + (size_t)h * K * N, scores, M, N, K, kernel_size, lmul, dataflow, pack_mode);
+                softmax_rows(scores, M, N, N, att_scale, causal);
+                multiply_gemm(scores, Va + (size_t)h * N * K, Oa + (size_t)h * M * K, M, K, N, kernel_size, lmul, dataflow, pack_mode);
+            }
+        }
+        else if( conv ){
+            if( gemm_conv(ctx, &cv, Xc, Wc, Yc, use_plan ? CONV_AUTO : CONV_IM2COL, threads) != 0 ){
+                printf("ERROR: conv failed for M:%d K:%d N:%d filter:%d\n", M, K, N, filter);
+                exit(EXIT_FAILURE);
+            }
+        }
+        else if( knn ){
+            int ret;
+            if( use_plan ) ret = knn_search(A, Ykn, M, N, K, knn, kidx, kdist, threads);
+            else {
+                row_sqnorms(A, M, K, K, xnorm);
+                row_sqnorms(Ykn, N, K, K, ynorm);
+                multiply_gemm(A, B, C, M, N, K, kernel_size, lmul, dataflow, pack_mode);
+                ret = knn_select(C, xnorm, ynorm, M, N, N, knn, kidx, kdist);
+            }
+            if( ret != 0 ){
+                printf("ERROR: knn failed for M:%d N:%d K:%d knn:%d\n", M, N, K, knn);
+                exit(EXIT_FAILURE);
+            }
+        }
+        else if( mlp ){
+            if( gemm_mlp_execute(ctx, mlp, A, C, M) != 0 ){
+                printf("ERROR: mlp execute failed for M:%d\n", M);
+                exit(EXIT_FAILURE);
+            }
+        }
+        else if( hidden ){
+            multiply_gemm(A, W1, hidden, M, mlp_hidden, K, kernel_size, lmul, dataflow, pack_mode);
+            if( act ) gemm_epilogue_apply(hidden, M, mlp_hidden, mlp_hidden, &mlp_act);
+            multiply_gemm(hidden, W2, C, M, N, mlp_hidden, kernel_size, lmul, dataflow, pack_mode);
+        }
+        else if( entries ) gemm_execute_grouped(ctx, group, entries, threads, &group_hints);
+        else if( rows ){
+            if( multiply_gemm_indexed(A, rows, B, C, rows, M, N, K, K, N, N) != 0 ){
+                printf("ERROR: indexed gemm failed for M:%d N:%d K:%d\n", M, N, K);
+                exit(EXIT_FAILURE);
+            }
+        }
+        else if( plan && batch > 1 ) gemm_execute_strided_batch(ctx, plan, batch, pA, M * K, pB, K * N, pC, M * N);
+        else if( plan ) gemm_execute(ctx, plan, pA, pB, pC);
+        else if( Ah ) multiply_gemm_f16(Ah, Bh, pC, M, N, K, dtype == GEMM_F16_F16);
+        else if( Ab ) multiply_gemm_bf16(Ab, Bb, C, M, N, K);
+        else if( Ad ) multiply_gemm_f64(Ad, Bd, Cd, M, N, K, kernel_size, lmul_set ? lmul : 0);
+        else if( Aq ) multiply_gemm_i8(Aq, Bq, C, M, N, K, &quant, wq);
+        else if( Bq4 ) multiply_gemm_q4(A, Bq4, Sq4, Q4_GROUP, C, M, N, K);
+        else if( Ac ) multiply_gemm_c32(Ac, Bc, Cc, M, N, K);
+        else if( As ) multiply_gemm_q15(As, Bs, Cs, M, N, K, 0);
+        else if( Abin ) multiply_gemm_bin(Abin, Bbin, Cbin, M, N, K);
+        else if( semiring ) multiply_gemm_semiring(A, B, C, M, N, K, semiring);
+        else if( packed ) multiply_gemm_packed(A, packed, C, M, kernel_size);
+        else multiply_gemm(A, B, C, M, N, K, kernel_size, lmul, dataflow, pack_mode);
+
+        // unfused: the epilogue as a second pass over C
+        if( use_epilogue && !plan ) gemm_epilogue_apply(C, M, N, N, &ep);
+    }
 
     // Stop timer
-    //double end_time = omp_get_wtime();
+    #ifdef _OPENMP
+    double end_time = omp_get_wtime();
+    #else
     clock_t end_time = clock();
+    #endif
+
+    if( Ch ){
+        for (size_t i = 0; i < (size_t)count * M * N; i++) C[i] = (float)Ch[i];
+    }
+    if( Cc ){
+        for (size_t i = 0; i < (size_t)M * N; i++) C[i] = Cc[2 * i];
+    }
+    if( Cs ){
+        for (size_t i = 0; i < (size_t)M * N; i++) C[i] = Cs[i];
+    }
+    if( Cbin ){
+        for (size_t i = 0; i < (size_t)M * N; i++) C[i] = (float)Cbin[i];
+    }
 
     if(DEBUG_PRINT_IO){
         printf("C");
-        print_matrixf32(C, size, size, 0);
+        if( Cd ) print_lmatrixf64(Cd + last * M * N, N, M * N);
+        else if( Oa ) print_lmatrixf32(Oa + (size_t)(heads - 1) * M * K, K, M * K);
+        else if( kdist ) print_lmatrixf32(kdist, knn, M * knn);
+        else if( Yc ) print_lmatrixf32(Yc, gemm_conv_out_w(&cv), conv_out);
+        else print_lmatrixf32(C + last * M * N, N, M * N);
     }
 
     // Calculate and print execution time
-    //double execution_time = (end_time - start_time); // [sec]
-    double execution_time = ((double)(end_time - start_time)) / CLOCKS_PER_SEC;
+    #ifdef _OPENMP
+    double execution_time = (end_time - start_time) / repeat; // [sec]
+    #else
+    double execution_time = ((double)(end_time - start_time)) / CLOCKS_PER_SEC / repeat;
+    #endif
 
     printf("Execution time: %f seconds\n", execution_time);
 
     // line to grep results in benchmark phase
     #ifdef UNROLL
-        printf("> BENCHMARK_RECORD : version=%s, time=%f, size=%d, kernel=%d, lmul=%d, unroll=%d\n", version(argv[0]), execution_time, size, kernel_size, lmul, UNROLL);
+        printf("> BENCHMARK_RECORD : version=%s, time=%f, size=%d, kernel=%d, lmul=%d, unroll=%d, dataflow=%d, pack=%d, prepack=%d, repeat=%d, plan=%d, threads=%d, batch=%d, group=%d, indexed=%d, dtype=%d, semiring=%d, epilogue=%d, act=%d, mlp=%d, attention=%d, causal=%d, knn=%d, conv=%d, filter=%d, stride=%d, pad=%d, dilation=%d, groups=%d, m=%d, n=%d, k=%d\n", version(argv[0]), execution_time, size, kernel_size, lmul, UNROLL, dataflow, pack_mode, prepack, repeat, use_plan, threads, batch, group, indexed, dtype, semiring, epilogue, act, mlp_hidden, heads, causal, knn, conv, filter, stride, pad, dilation, groups, M, N, K);
     #else
-        printf("> BENCHMARK_RECORD : version=%s, time=%f, size=%d, kernel=%d, lmul=%d\n", version(argv[0]), execution_time, size, kernel_size, lmul);
+        printf("> BENCHMARK_RECORD : version=%s, time=%f, size=%d, kernel=%d, lmul=%d, dataflow=%d, pack=%d, prepack=%d, repeat=%d, plan=%d, threads=%d, batch=%d, group=%d, indexed=%d, dtype=%d, semiring=%d, epilogue=%d, act=%d, mlp=%d, attention=%d, causal=%d, knn=%d, conv=%d, filter=%d, stride=%d, pad=%d, dilation=%d, groups=%d, m=%d, n=%d, k=%d\n", version(argv[0]), execution_time, size, kernel_size, lmul, dataflow, pack_mode, prepack, repeat, use_plan, threads, batch, group, indexed, dtype, semiring, epilogue, act, mlp_hidden, heads, causal, knn, conv, filter, stride, pad, dilation, groups, M, N, K);
     #endif
 
     // Free memory
+    gemm_destroy(plan);
+    gemm_mlp_destroy(mlp);
+    gemm_ctx_destroy(ctx);
+    packed_b_free(packed);
+    free(entries);
+    free(rows);
+    free(Ah);
+    free(Bh);
+    free(Ch);
+    free(Ab);
+    free(Bb);
+    free(Ad);
+    free(Bd);
+    free(Cd);
+    free(Aq);
+    free(Bq);
+    free(wq);
+    free(Bq4);
+    free(Ac);
+    free(Bc);
+    free(Cc);
+    free(As);
+    free(Bs);
+    free(Cs);
+    free(Abin);
+    free(Bbin);
+    free(Cbin);
+    free(Sq4);
+    free(ep_bias);
+    free(ep_col_scale);
+    free(ep_row_scale);
+    free(ep_residual);
+    free(W1);
+    free(W2);
+    free(hidden);
+    free(Qa);
+    free(Ka);
+    free(Va);
+    free(Oa);
+    free(Kta);
+    free(scores);
+    free(Ykn);
+    free(kdist);
+    free(kidx);
+    free(xnorm);
+    free(ynorm);
+    free(Xc);
+    free(Wc);
+    free(Yc);
     free(A);
     free(B);
     free(C);
@@ -0,0 +1,36 @@
+#ifndef RVV_MATH_H_
+#define RVV_MATH_H_
+
+#include <riscv_vector.h>
+
+/*
+ * RVV MATH
+ * elementwise functions of the fused epilogues and of the attention softmax.
+ * No libm: exp(x) = 2^n * p(r), n = round(x / ln2), r = x - n ln2 (two-part ln2),
+ * p degree 6 (Cephes expf, ~1 ulp), 2^n built in the exponent bits. x clamped to
+ * [-87.3, 88.3]: exp(-inf) is ~1e-38, not 0 (masked lanes must be zeroed by the caller).
+ */
+
+static inline vfloat32m2_t exp_f32m2(vfloat32m2_t x, size_t vl) {
+    x = __riscv_vfmin_vf_f32m2(__riscv_vfmax_vf_f32m2(x, -87.3f, vl), 88.3f, vl);
+
+    vint32m2_t n = __riscv_vfcvt_x_f_v_i32m2(__riscv_vfmul_vf_f32m2(x, 1.44269504f, vl), vl);
+    vfloat32m2_t fn = __riscv_vfcvt_f_x_v_f32m2(n, vl);
+    vfloat32m2_t r = __riscv_vfnmsac_vf_f32m2(x, 0.693359375f, fn, vl);
+    r = __riscv_vfnmsac_vf_f32m2(r, -2.12194440e-4f, fn, vl);
+
+    vfloat32m2_t p = __riscv_vfmv_v_f_f32m2(1.9875691500e-4f, vl);
+    p = __riscv_vfmadd_vv_f32m2(p, r, __riscv_vfmv_v_f_f32m2(1.3981999507e-3f, vl), vl);
+    p = __riscv_vfmadd_vv_f32m2(p, r, __riscv_vfmv_v_f_f32m2(8.3334519073e-3f, vl), vl);
+    p = __riscv_vfmadd_vv_f32m2(p, r, __riscv_vfmv_v_f_f32m2(4.1665795894e-2f, vl), vl);
+    p = __riscv_vfmadd_vv_f32m2(p, r, __riscv_vfmv_v_f_f32m2(1.6666665459e-1f, vl), vl);
+    p = __riscv_vfmadd_vv_f32m2(p, r, __riscv_vfmv_v_f_f32m2(5.0000001201e-1f, vl), vl);
+
+    // 1 + r + p r^2
+    vfloat32m2_t y = __riscv_vfmadd_vv_f32m2(p, __riscv_vfmul_vv_f32m2(r, r, vl), __riscv_vfadd_vf_f32m2(r, 1.0f, vl), vl);
+
+    vint32m2_t e = __riscv_vsll_vx_i32m2(__riscv_vadd_vx_i32m2(n, 127, vl), 23, vl);
+    return __riscv_vfmul_vv_f32m2(y, __riscv_vreinterpret_v_i32m2_f32m2(e), vl);
+}
+
+#endif
@@ -80,7 +80,7 @@ def parse_benchmark_file(input_file, output_file):
     ordered_keys = ['version', 'size']
     
     # Parametri aggiuntivi nell'ordine specificato (solo quelli presenti)
-    additional_params = ['kernel', 'lmul', 'unroll']
+    additional_params = ['kernel', 'lmul', 'unroll', 'pack', 'prepack', 'repeat', 'plan', 'threads', 'batch', 'group', 'indexed', 'dtype', 'semiring', 'epilogue', 'act', 'mlp', 'attention', 'causal', 'knn', 'conv', 'filter', 'stride', 'pad', 'dilation', 'groups', 'dataflow', 'm', 'n', 'k']
     for param in additional_params:
         if param in all_keys:
             ordered_keys.append(param)
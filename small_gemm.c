@@ -0,0 +1,195 @@
+#include <stddef.h>
+#include <riscv_vector.h>
+#include "small_gemm.h"
+
+/*
+ * SMALL GEMM BLOCKS
+ * rows [i0, i0 + R) x columns [j0, j0 + ch) of C, R accumulators + 1 row of B in
+ * registers. Every call has constant N, K, j0, ch: once inlined in small_gemm_n{N}_k{K}
+ * the k loop is fully unrolled and vl is an immediate.
+ * ch never exceeds VLMAX at VLEN=128 (the minimum of the V extension): 4 with m1,
+ * 8 with m2, 16 with m4, 32 with m8, so the kernels are valid on every VLEN.
+ */
+static inline __attribute__((always_inline))
+void small_block_4_m1(const float* A, const float* B, float* C, const int N, const int K, const int i0, const int j0, const int ch) {
+
+    vfloat32m1_t vc0 = __riscv_vfmv_v_f_f32m1(0.0f, ch);
+    vfloat32m1_t vc1 = __riscv_vfmv_v_f_f32m1(0.0f, ch);
+    vfloat32m1_t vc2 = __riscv_vfmv_v_f_f32m1(0.0f, ch);
+    vfloat32m1_t vc3 = __riscv_vfmv_v_f_f32m1(0.0f, ch);
+
+    #pragma GCC unroll 64
+    for (int k = 0; k < K; k++) {
+        vfloat32m1_t vb = __riscv_vle32_v_f32m1(&B[k * N + j0], ch);
+
+        vc0 = __riscv_vfmacc_vf_f32m1(vc0, A[(i0 + 0) * K + k], vb, ch);
+        vc1 = __riscv_vfmacc_vf_f32m1(vc1, A[(i0 + 1) * K + k], vb, ch);
+        vc2 = __riscv_vfmacc_vf_f32m1(vc2, A[(i0 + 2) * K + k], vb, ch);
+        vc3 = __riscv_vfmacc_vf_f32m1(vc3, A[(i0 + 3) * K + k], vb, ch);
+    }
+
+    __riscv_vse32_v_f32m1(&C[(i0 + 0) * N + j0], vc0, ch);
+    __riscv_vse32_v_f32m1(&C[(i0 + 1) * N + j0], vc1, ch);
+    __riscv_vse32_v_f32m1(&C[(i0 + 2) * N + j0], vc2, ch);
+    __riscv_vse32_v_f32m1(&C[(i0 + 3) * N + j0], vc3, ch);
+}
+
+static inline __attribute__((always_inline))
+void small_block_8_m2(const float* A, const float* B, float* C, const int N, const int K, const int i0, const int j0, const int ch) {
+
+    vfloat32m2_t vc0 = __riscv_vfmv_v_f_f32m2(0.0f, ch);
+    vfloat32m2_t vc1 = __riscv_vfmv_v_f_f32m2(0.0f, ch);
+    vfloat32m2_t vc2 = __riscv_vfmv_v_f_f32m2(0.0f, ch);
+    vfloat32m2_t vc3 = __riscv_vfmv_v_f_f32m2(0.0f, ch);
+    vfloat32m2_t vc4 = __riscv_vfmv_v_f_f32m2(0.0f, ch);
+    vfloat32m2_t vc5 = __riscv_vfmv_v_f_f32m2(0.0f, ch);
+    vfloat32m2_t vc6 = __riscv_vfmv_v_f_f32m2(0.0f, ch);
+    vfloat32m2_t vc7 = __riscv_vfmv_v_f_f32m2(0.0f, ch);
+
+    #pragma GCC unroll 64
+    for (int k = 0; k < K; k++) {
+        vfloat32m2_t vb = __riscv_vle32_v_f32m2(&B[k * N + j0], ch);
+
+        vc0 = __riscv_vfmacc_vf_f32m2(vc0, A[(i0 + 0) * K + k], vb, ch);
+        vc1 = __riscv_vfmacc_vf_f32m2(vc1, A[(i0 + 1) * K + k], vb, ch);
+        vc2 = __riscv_vfmacc_vf_f32m2(vc2, A[(i0 + 2) * K + k], vb, ch);
+        vc3 = __riscv_vfmacc_vf_f32m2(vc3, A[(i0 + 3) * K + k], vb, ch);
+        vc4 = __riscv_vfmacc_vf_f32m2(vc4, A[(i0 + 4) * K + k], vb, ch);
+        vc5 = __riscv_vfmacc_vf_f32m2(vc5, A[(i0 + 5) * K + k], vb, ch);
+        vc6 = __riscv_vfmacc_vf_f32m2(vc6, A[(i0 + 6) * K + k], vb, ch);
+        vc7 = __riscv_vfmacc_vf_f32m2(vc7, A[(i0 + 7) * K + k], vb, ch);
+    }
+
+    __riscv_vse32_v_f32m2(&C[(i0 + 0) * N + j0], vc0, ch);
+    __riscv_vse32_v_f32m2(&C[(i0 + 1) * N + j0], vc1, ch);
+    __riscv_vse32_v_f32m2(&C[(i0 + 2) * N + j0], vc2, ch);
+    __riscv_vse32_v_f32m2(&C[(i0 + 3) * N + j0], vc3, ch);
+    __riscv_vse32_v_f32m2(&C[(i0 + 4) * N + j0], vc4, ch);
+    __riscv_vse32_v_f32m2(&C[(i0 + 5) * N + j0], vc5, ch);
+    __riscv_vse32_v_f32m2(&C[(i0 + 6) * N + j0], vc6, ch);
+    __riscv_vse32_v_f32m2(&C[(i0 + 7) * N + j0], vc7, ch);
+}
+
+static inline __attribute__((always_inline))
+void small_block_4_m4(const float* A, const float* B, float* C, const int N, const int K, const int i0, const int j0, const int ch) {
+
+    vfloat32m4_t vc0 = __riscv_vfmv_v_f_f32m4(0.0f, ch);
+    vfloat32m4_t vc1 = __riscv_vfmv_v_f_f32m4(0.0f, ch);
+    vfloat32m4_t vc2 = __riscv_vfmv_v_f_f32m4(0.0f, ch);
+    vfloat32m4_t vc3 = __riscv_vfmv_v_f_f32m4(0.0f, ch);
+
+    #pragma GCC unroll 64
+    for (int k = 0; k < K; k++) {
+        vfloat32m4_t vb = __riscv_vle32_v_f32m4(&B[k * N + j0], ch);
+
+        vc0 = __riscv_vfmacc_vf_f32m4(vc0, A[(i0 + 0) * K + k], vb, ch);
+        vc1 = __riscv_vfmacc_vf_f32m4(vc1, A[(i0 + 1) * K + k], vb, ch);
+        vc2 = __riscv_vfmacc_vf_f32m4(vc2, A[(i0 + 2) * K + k], vb, ch);
+        vc3 = __riscv_vfmacc_vf_f32m4(vc3, A[(i0 + 3) * K + k], vb, ch);
+    }
+
+    __riscv_vse32_v_f32m4(&C[(i0 + 0) * N + j0], vc0, ch);
+    __riscv_vse32_v_f32m4(&C[(i0 + 1) * N + j0], vc1, ch);
+    __riscv_vse32_v_f32m4(&C[(i0 + 2) * N + j0], vc2, ch);
+    __riscv_vse32_v_f32m4(&C[(i0 + 3) * N + j0], vc3, ch);
+}
+
+static inline __attribute__((always_inline))
+void small_block_2_m8(const float* A, const float* B, float* C, const int N, const int K, const int i0, const int j0, const int ch) {
+
+    vfloat32m8_t vc0 = __riscv_vfmv_v_f_f32m8(0.0f, ch);
+    vfloat32m8_t vc1 = __riscv_vfmv_v_f_f32m8(0.0f, ch);
+
+    #pragma GCC unroll 64
+    for (int k = 0; k < K; k++) {
+        vfloat32m8_t vb = __riscv_vle32_v_f32m8(&B[k * N + j0], ch);
+
+        vc0 = __riscv_vfmacc_vf_f32m8(vc0, A[(i0 + 0) * K + k], vb, ch);
+        vc1 = __riscv_vfmacc_vf_f32m8(vc1, A[(i0 + 1) * K + k], vb, ch);
+    }
+
+    __riscv_vse32_v_f32m8(&C[(i0 + 0) * N + j0], vc0, ch);
+    __riscv_vse32_v_f32m8(&C[(i0 + 1) * N + j0], vc1, ch);
+}
+
+
+/*
+ * SMALL GEMM KERNELS
+ * N split in column chunks: 32 with 2-row m8 blocks, then 16 with 4-row m4,
+ * 8 with 8-row m2 (4-row m1 pairs for the last 4 rows), 4 with 4-row m1.
+ * N and K are constants of the kernel, M (multiple of 4) a loop bound.
+ */
+static inline __attribute__((always_inline))
+void small_gemm_nk(const float* A, const float* B, float* C, int M, const int N, const int K) {
+
+    int j0 = 0;
+    for (; j0 + 32 <= N; j0 += 32)
+        for (int i = 0; i < M; i += 2)
+            small_block_2_m8(A, B, C, N, K, i, j0, 32);
+
+    if (N - j0 >= 16) {
+        for (int i = 0; i < M; i += 4)
+            small_block_4_m4(A, B, C, N, K, i, j0, 16);
+        j0 += 16;
+    }
+    if (N - j0 >= 8) {
+        int i = 0;
+        for (; i + 8 <= M; i += 8)
+            small_block_8_m2(A, B, C, N, K, i, j0, 8);
+        if (i < M) {
+            small_block_4_m1(A, B, C, N, K, i, j0, 4);
+            small_block_4_m1(A, B, C, N, K, i, j0 + 4, 4);
+        }
+        j0 += 8;
+    }
+    if (N - j0 >= 4) {
+        for (int i = 0; i < M; i += 4)
+            small_block_4_m1(A, B, C, N, K, i, j0, 4);
+    }
+}
+
+#define SMALL_GEMM(n, k)                                                                    \
+    static void small_gemm_n##n##_k##k(const float* A, const float* B, float* C, int M) {   \
+        small_gemm_nk(A, B, C, M, n, k);                                                    \
+    }
+
+#define SMALL_GEMM_K(n)                                                                     \
+    SMALL_GEMM(n, 4) SMALL_GEMM(n, 8) SMALL_GEMM(n, 16) SMALL_GEMM(n, 32) SMALL_GEMM(n, 48) SMALL_GEMM(n, 64)
+
+SMALL_GEMM_K(4)
+SMALL_GEMM_K(8)
+SMALL_GEMM_K(16)
+SMALL_GEMM_K(32)
+SMALL_GEMM_K(48)
+SMALL_GEMM_K(64)
+
+#define SMALL_GEMM_ROW(n)                                                                   \
+    { small_gemm_n##n##_k4, small_gemm_n##n##_k8, small_gemm_n##n##_k16,                    \
+      small_gemm_n##n##_k32, small_gemm_n##n##_k48, small_gemm_n##n##_k64 }
+
+// small_gemms[N bucket][K bucket]
+static const small_gemm_t small_gemms[6][6] = {
+    SMALL_GEMM_ROW(4), SMALL_GEMM_ROW(8), SMALL_GEMM_ROW(16),
+    SMALL_GEMM_ROW(32), SMALL_GEMM_ROW(48), SMALL_GEMM_ROW(64),
+};
+
+// index of the size bucket, -1 if none
+static int small_bucket(int s) {
+    switch (s) {
+        case 4:   return 0;
+        case 8:   return 1;
+        case 16:  return 2;
+        case 32:  return 3;
+        case 48:  return 4;
+        case 64:  return 5;
+        default:  return -1;
+    }
+}
+
+small_gemm_t small_gemm_lookup(int M, int N, int K) {
+
+    const int n = small_bucket(N), k = small_bucket(K);
+    if (M < 4 || M > 64 || M % 4 || n < 0 || k < 0) return NULL;
+
+    return small_gemms[n][k];
+}
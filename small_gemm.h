@@ -0,0 +1,15 @@
+#ifndef SMALL_GEMM_H_
+#define SMALL_GEMM_H_
+
+/*
+ * SMALL GEMM
+ * C (M x N) = A (M x K) * B (K x N), dense row-major, for N, K in 4, 8, 16, 32, 48, 64
+ * and M a multiple of 4 up to 64. One unrolled kernel per (N, K): constant vl (no
+ * vsetvl on N), k loop fully unrolled, no packing of B, no heap allocation.
+ */
+typedef void (*small_gemm_t)(const float* A, const float* B, float* C, int M);
+
+// NULL if there is no kernel for the shape
+small_gemm_t small_gemm_lookup(int M, int N, int K);
+
+#endif /* SMALL_GEMM_H_ */
@@ -9,7 +9,30 @@ make table-baseline \
     table-tiling_v2 \
     table-tiling_v3 \
     table-reordered_tiling \
-    table-reordered_tiling_unrolling
+    table-reordered_tiling_unrolling \
+    table-reordered_tiling_dataflow \
+    table-reordered_tiling_fused \
+    table-reordered_tiling_prepack \
+    table-reordered_tiling_plan \
+    table-reordered_tiling_batch \
+    table-reordered_tiling_group \
+    table-reordered_tiling_small \
+    table-reordered_tiling_skinny \
+    table-reordered_tiling_indexed \
+    table-reordered_tiling_f16 \
+    table-reordered_tiling_bf16 \
+    table-reordered_tiling_i8 \
+    table-reordered_tiling_q4 \
+    table-reordered_tiling_f64 \
+    table-reordered_tiling_c32 \
+    table-reordered_tiling_q15 \
+    table-reordered_tiling_bin \
+    table-reordered_tiling_semiring \
+    table-reordered_tiling_epilogue \
+    table-reordered_tiling_mlp \
+    table-reordered_tiling_attention \
+    table-reordered_tiling_knn \
+    table-reordered_tiling_conv
 
 
 
@@ -55,3 +78,5 @@ make speedup-reordered_tiling BASE=tiling_v3 CALC_OPT="-m time -k size,kernel,lm
 make speedup-reordered_tiling_unrolling BASE=baseline CALC_OPT="-m time -k size" PLOT_OPT="-g kernel,lmul,unroll --exclude-param unroll --exclude-value 1"
 make speedup-reordered_tiling_unrolling BASE=autovect CALC_OPT="-m time -k size" PLOT_OPT="-g kernel,lmul,unroll --exclude-param unroll --exclude-value 1"
 make speedup-reordered_tiling_unrolling BASE=reordered_tiling CALC_OPT="-m time -k size,kernel,lmul" PLOT_OPT="-g kernel,lmul,unroll --exclude-param unroll --exclude-value 1"
+
+make speedup-reordered_tiling_fused BASE=reordered_tiling CALC_OPT="-m time -k size,kernel,lmul" PLOT_OPT="-g kernel,lmul"
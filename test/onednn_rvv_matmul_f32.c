@@ -489,10 +489,9 @@ static void kernel_mxn_16x16(bool isTransA, bool isTransB, int K, const float *A
 
 void kernel_mxn(bool isTransA, bool isTransB, int K, const float *A, const int lda, const float *B,
         const int ldb, float *C, const int ldc, const float alpha,
-        const float beta, int ithr) 
+        const float beta, int n_unroll, int ithr) 
 {
     if(DEBUG_KERNEL > 0) printf("> kernel_mxn: alpha:%f  beta:%f\n", alpha, beta);
-    int n_unroll = get_n_unroll_factor();
 
     switch (n_unroll) {
         case 2:
@@ -520,10 +519,9 @@ void kernel_mxn(bool isTransA, bool isTransB, int K, const float *A, const int l
 void block_ker(bool isTransA, bool isTransB, const int M, const int N, const int K, const float *A,
         const int lda, const float *B, const int ldb, float *C,
         const int ldc, const float alpha, const float beta, float *ws,
-        bool do_copy, int ithr) 
+        bool do_copy, int n_unroll, int ithr) 
 {
 
-    const int n_unroll = get_n_unroll_factor();
     const int m_unroll = get_m_unroll_factor();
 
     int Nu = rnd_dn(N, n_unroll);
@@ -579,7 +577,7 @@ void block_ker(bool isTransA, bool isTransB, const int M, const int N, const int
                     ithr
                 );
 
-                kernel_mxn(false, isTransB, K, ws, m_unroll, b, ldb, &C[i + j * ldc], ldc, alpha, beta, ithr);
+                kernel_mxn(false, isTransB, K, ws, m_unroll, b, ldb, &C[i + j * ldc], ldc, alpha, beta, n_unroll, ithr);
                 
                 if(DEBUG_KERNEL > 0){
                     printf("Print C matrix\n");
@@ -606,7 +604,7 @@ void block_ker(bool isTransA, bool isTransB, const int M, const int N, const int
                     ithr
                 );
 
-                kernel_mxn(isTransA, isTransB, K, a, lda, b, ldb, &C[i + j * ldc], ldc, alpha, beta, ithr);
+                kernel_mxn(isTransA, isTransB, K, a, lda, b, ldb, &C[i + j * ldc], ldc, alpha, beta, n_unroll, ithr);
             }
         }
     }
@@ -702,7 +700,7 @@ void block_ker(bool isTransA, bool isTransB, const int M, const int N, const int
 void gemm_ithr(bool isTransA, bool isTransB, const int M, const int N, const int K, const float alpha,
         const float *A, const int lda, const float *B, const int ldb,
         const float beta, float *C, const int ldc, bool do_copy, float *ws,
-        int ithr) 
+        int n_unroll, int ithr) 
 {
 
 
@@ -767,7 +765,7 @@ void gemm_ithr(bool isTransA, bool isTransB, const int M, const int N, const int
                     ithr
                 );
 
-                block_ker(isTransA, isTransB, mb, nb, kb, curA, lda, curB,ldb, curC, ldc, alpha, beta, ws, do_copy, ithr);
+                block_ker(isTransA, isTransB, mb, nb, kb, curA, lda, curB,ldb, curC, ldc, alpha, beta, ws, do_copy, n_unroll, ithr);
 
 
             }
@@ -807,7 +805,10 @@ void multiply(
     float *ws_buffers = NULL;
 
 
-    bool do_copy = (NB / get_n_unroll_factor() > 3);
+    // L1D query (sysconf) once per call, passed down to block_ker / kernel_mxn
+    const int n_unroll = get_n_unroll_factor();
+
+    bool do_copy = (NB / n_unroll > 3);
     const int nthr_mn = nthr_m * nthr_n;       // --> 1
     const int nthr_to_use = nthr_mn * nthr_k;  // --> 1
 
@@ -900,7 +901,7 @@ void multiply(
         ithr
     );
 
-    gemm_ithr(isTransA, isTransB, myM, myN, myK, alpha, myA, lda, myB, ldb, myBeta, myC, ld, do_copy, ws, ithr);
+    gemm_ithr(isTransA, isTransB, myM, myN, myK, alpha, myA, lda, myB, ldb, myBeta, myC, ld, do_copy, ws, n_unroll, ithr);
 
     /// GEMM_ITHR(myM:1, myN:1, myK:1, alpha:1.000000, myA:&A[0], lda:8, myB:&B[0], ldb:8, myBeta:0.000000, myC:&C[0], ld:8, do_copy:FALSE, ws:0, ithr:0 )
 
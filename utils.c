@@ -109,6 +109,14 @@ void print_lmatrixf32(float* M, int row_size, int num_elements){
     }
 }
 
+void print_lmatrixf64(double* M, int row_size, int num_elements){
+    printf("> Print Matrix f64 (row_size:%d,  num_elements:%d):\n", row_size, num_elements);
+    for( int i = 0; i < num_elements; i++ ){
+        printf("%.1f\t", M[i]);
+        if( (i+1) % row_size == 0 ) printf("\n");
+    }
+}
+
 void init_matrix_input(int input_case, float* _A, float* _B, int M, int N, int K){
 
     float (*A)[K] = (float (*)[K]) _A;   // M x K
@@ -183,6 +191,20 @@ void init_matrix_input(int input_case, float* _A, float* _B, int M, int N, int K
     }
 }
 
+// same inputs as init_matrix_input (small integers, exact in both precisions)
+void init_matrix_input_f64(int input_case, double* A, double* B, int M, int N, int K){
+    float* Af = malloc(sizeof(float) * M * K);
+    float* Bf = malloc(sizeof(float) * K * N);
+
+    init_matrix_input(input_case, Af, Bf, M, N, K);
+
+    for(size_t i = 0; i < (size_t)M * K; i++) A[i] = Af[i];
+    for(size_t i = 0; i < (size_t)K * N; i++) B[i] = Bf[i];
+
+    free(Af);
+    free(Bf);
+}
+
 #ifdef __riscv
 
 void print_vmatrixf32(int size, vfloat32m1_t c1, vfloat32m1_t c2){
@@ -33,7 +33,10 @@ void print_matrixf32(float* M, int tile_size, int size, int print_inline);
 
 void print_lmatrixf32(float* M, int row_size, int num_elements);
 
+void print_lmatrixf64(double* M, int row_size, int num_elements);
+
 void init_matrix_input(int input_case, float* A, float* B, int M, int N, int K);
+void init_matrix_input_f64(int input_case, double* A, double* B, int M, int N, int K);
 
 #if defined(__riscv) && defined(__riscv_vector)
 void print_vmatrixf32(int size, vfloat32m1_t c1, vfloat32m1_t c2);